@@ -0,0 +1,797 @@
+/*
+   Copyright (c) 2017, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/*
+  InnoDB page compression benchmark.
+
+  Reads the pages of an InnoDB data file, compresses and decompresses
+  each of them with every page_compression algorithm that the server
+  was built with, and reports the compression ratio and the speed of
+  each algorithm, so that innodb_compression_algorithm and
+  PAGE_COMPRESSION_LEVEL can be chosen per table.
+*/
+
+#include <my_global.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <my_getopt.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include <welcome_copyright_notice.h> /* ORACLE_WELCOME_COPYRIGHT_NOTICE */
+
+/* Only parts of these files are included from the InnoDB codebase.
+The parts not included are excluded by #ifndef UNIV_INNOCHECKSUM. */
+
+typedef void fil_space_t;
+
+#include "univ.i"
+#include "page0size.h"
+
+#define FLST_BASE_NODE_SIZE (4 + 2 * FIL_ADDR_SIZE)
+#define FLST_NODE_SIZE (2 * FIL_ADDR_SIZE)
+#define FSEG_PAGE_DATA FIL_PAGE_DATA
+#define FSEG_HEADER_SIZE	10
+#define UT_BITS_IN_BYTES(b) (((b) + 7) / 8)
+
+#include "ut0ut.h"
+#include "ut0byte.h"
+#include "mtr0types.h"
+#include "mach0data.h"
+#include "fsp0types.h"
+#include "fil0fil.h"             /* FIL_* */
+#include "fsp0fsp.h"             /* FSP_*, XDES_* */
+#include "page0types.h"          /* page_t */
+#include "fsp0pagecompress.h"    /* PAGE_*_ALGORITHM, FSP_ZSTD_DICT_* */
+
+#include "zlib.h"
+#ifdef HAVE_LZ4
+#include "lz4.h"
+#endif
+#ifdef HAVE_LZO
+#include "lzo/lzo1x.h"
+#endif
+#ifdef HAVE_LZMA
+#include "lzma.h"
+#endif
+#ifdef HAVE_BZIP2
+#include "bzlib.h"
+#endif
+#ifdef HAVE_SNAPPY
+#include "snappy-c.h"
+#endif
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#include "zdict.h"
+#endif
+
+#ifdef UNIV_NONINL
+# include "fsp0fsp.ic"
+# include "mach0data.ic"
+#endif
+
+ulong				srv_page_size;
+page_size_t			univ_page_size(0, 0, false);
+
+/** Compression level (--level) */
+static uint			level;
+/** Largest number of pages to benchmark (--max-pages) */
+static ulong			max_pages;
+/** Number of passes over the pages (--repeat) */
+static uint			repeat;
+/** Granularity of the file system allocation (--block-size) */
+static ulong			block_size;
+/** Algorithm to benchmark, or all of them (--algorithm) */
+static const char*		algorithm_name;
+
+/** Number of bytes in front of the compressed payload of a
+page_compressed page */
+static const ulint	PAYLOAD = FIL_PAGE_DATA + FIL_PAGE_COMPRESSED_SIZE;
+
+/** Number of pages sampled for training a zstd dictionary;
+the same as in fil0pagecompress.cc */
+static const ulint	ZSTD_TRAIN_SAMPLES = 128;
+/** Maximum size of a zstd dictionary; the same as in fil0pagecompress.cc */
+static const ulint	ZSTD_DICT_MAX = 16384;
+
+/** A page compression algorithm */
+struct algorithm_t {
+	/** name, as in innodb_compression_algorithm */
+	const char*	name;
+	/** PAGE_*_ALGORITHM */
+	ulint		id;
+	/** whether a zstd dictionary is used */
+	bool		dict;
+};
+
+static const algorithm_t algorithms[] = {
+	{"zlib", PAGE_ZLIB_ALGORITHM, false},
+#ifdef HAVE_LZ4
+	{"lz4", PAGE_LZ4_ALGORITHM, false},
+#endif
+#ifdef HAVE_LZO
+	{"lzo", PAGE_LZO_ALGORITHM, false},
+#endif
+#ifdef HAVE_LZMA
+	{"lzma", PAGE_LZMA_ALGORITHM, false},
+#endif
+#ifdef HAVE_BZIP2
+	{"bzip2", PAGE_BZIP2_ALGORITHM, false},
+#endif
+#ifdef HAVE_SNAPPY
+	{"snappy", PAGE_SNAPPY_ALGORITHM, false},
+#endif
+#ifdef HAVE_ZSTD
+	{"zstd", PAGE_ZSTD_ALGORITHM, false},
+	{"zstd+dict", PAGE_ZSTD_ALGORITHM, true},
+#endif
+};
+
+#ifdef HAVE_ZSTD
+/** The zstd dictionary of the file, or NULL */
+static ZSTD_CDict*		zstd_cdict;
+/** The zstd dictionary of the file, or NULL */
+static ZSTD_DDict*		zstd_ddict;
+static ZSTD_CCtx*		zstd_cctx;
+static ZSTD_DCtx*		zstd_dctx;
+#endif
+#ifdef HAVE_LZO
+/** Work memory for lzo1x_1_15_compress() */
+static byte			lzo_mem[LZO1X_1_15_MEM_COMPRESS];
+#endif
+
+/** Compress a page.
+@param[in]	alg	algorithm
+@param[in]	src	page
+@param[in]	len	size of the page
+@param[out]	dst	compressed page
+@param[in]	dst_len	size of dst
+@return size of the compressed page, or 0 if it did not fit */
+static
+ulint
+compress_page(
+	const algorithm_t&	alg,
+	const byte*		src,
+	ulint			len,
+	byte*			dst,
+	ulint			dst_len)
+{
+	switch (alg.id) {
+	case PAGE_ZLIB_ALGORITHM: {
+		uLongf	out_len = dst_len;
+
+		return(compress2(dst, &out_len, src, uLong(len), int(level))
+		       == Z_OK ? ulint(out_len) : 0);
+	}
+#ifdef HAVE_LZ4
+	case PAGE_LZ4_ALGORITHM:
+#ifdef HAVE_LZ4_COMPRESS_DEFAULT
+		return(ulint(LZ4_compress_default(
+				     reinterpret_cast<const char*>(src),
+				     reinterpret_cast<char*>(dst),
+				     int(len), int(dst_len))));
+#else
+		return(ulint(LZ4_compress_limitedOutput(
+				     reinterpret_cast<const char*>(src),
+				     reinterpret_cast<char*>(dst),
+				     int(len), int(dst_len))));
+#endif /* HAVE_LZ4_COMPRESS_DEFAULT */
+#endif
+#ifdef HAVE_LZO
+	case PAGE_LZO_ALGORITHM: {
+		lzo_uint	out_len = dst_len;
+
+		return(lzo1x_1_15_compress(src, len, dst, &out_len, lzo_mem)
+		       == LZO_E_OK && out_len <= dst_len ? ulint(out_len) : 0);
+	}
+#endif
+#ifdef HAVE_LZMA
+	case PAGE_LZMA_ALGORITHM: {
+		size_t	out_pos = 0;
+
+		return(lzma_easy_buffer_encode(level, LZMA_CHECK_NONE, NULL,
+					       src, len, dst, &out_pos,
+					       dst_len) == LZMA_OK
+		       ? ulint(out_pos) : 0);
+	}
+#endif
+#ifdef HAVE_BZIP2
+	case PAGE_BZIP2_ALGORITHM: {
+		unsigned int	out_len = unsigned(dst_len);
+
+		return(BZ2_bzBuffToBuffCompress(
+			       reinterpret_cast<char*>(dst), &out_len,
+			       reinterpret_cast<char*>(const_cast<byte*>(src)),
+			       unsigned(len), 1, 0, 0) == BZ_OK
+		       ? ulint(out_len) : 0);
+	}
+#endif
+#ifdef HAVE_SNAPPY
+	case PAGE_SNAPPY_ALGORITHM: {
+		size_t	out_len = snappy_max_compressed_length(len);
+
+		if (out_len > dst_len) {
+			/* snappy needs a larger output buffer */
+			byte*	tmp = static_cast<byte*>(malloc(out_len));
+			bool	ok = snappy_compress(
+				reinterpret_cast<const char*>(src), len,
+				reinterpret_cast<char*>(tmp), &out_len)
+				== SNAPPY_OK && out_len <= dst_len;
+
+			if (ok) {
+				memcpy(dst, tmp, out_len);
+			}
+
+			free(tmp);
+			return(ok ? ulint(out_len) : 0);
+		}
+
+		return(snappy_compress(reinterpret_cast<const char*>(src), len,
+				       reinterpret_cast<char*>(dst), &out_len)
+		       == SNAPPY_OK ? ulint(out_len) : 0);
+	}
+#endif
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM: {
+		size_t	out_len = alg.dict
+			? ZSTD_compress_usingCDict(zstd_cctx, dst, dst_len,
+						   src, len, zstd_cdict)
+			: ZSTD_compressCCtx(zstd_cctx, dst, dst_len,
+					    src, len, int(level));
+
+		return(ZSTD_isError(out_len) ? 0 : ulint(out_len));
+	}
+#endif
+	}
+
+	return(0);
+}
+
+/** Decompress a page.
+@param[in]	alg	algorithm (PAGE_*_ALGORITHM)
+@param[in]	src	compressed page
+@param[in]	src_len	size of the compressed page
+@param[out]	dst	page
+@param[in]	len	size of the page
+@return whether the page was decompressed */
+static
+bool
+decompress_page(
+	ulint		alg,
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		len)
+{
+	switch (alg) {
+	case PAGE_ZLIB_ALGORITHM: {
+		uLongf	out_len = len;
+
+		return(uncompress(dst, &out_len, src, uLong(src_len)) == Z_OK
+		       && out_len == len);
+	}
+#ifdef HAVE_LZ4
+	case PAGE_LZ4_ALGORITHM:
+		return(LZ4_decompress_safe(
+			       reinterpret_cast<const char*>(src),
+			       reinterpret_cast<char*>(dst),
+			       int(src_len), int(len)) == int(len));
+#endif
+#ifdef HAVE_LZO
+	case PAGE_LZO_ALGORITHM: {
+		lzo_uint	out_len = len;
+
+		return(lzo1x_decompress_safe(src, src_len, dst, &out_len, NULL)
+		       == LZO_E_OK && out_len == len);
+	}
+#endif
+#ifdef HAVE_LZMA
+	case PAGE_LZMA_ALGORITHM: {
+		size_t		src_pos = 0;
+		size_t		dst_pos = 0;
+		uint64_t	memlimit = UINT64_MAX;
+
+		return(lzma_stream_buffer_decode(&memlimit, 0, NULL,
+						 src, &src_pos, src_len,
+						 dst, &dst_pos, len)
+		       == LZMA_OK && dst_pos == len);
+	}
+#endif
+#ifdef HAVE_BZIP2
+	case PAGE_BZIP2_ALGORITHM: {
+		unsigned int	out_len = unsigned(len);
+
+		return(BZ2_bzBuffToBuffDecompress(
+			       reinterpret_cast<char*>(dst), &out_len,
+			       reinterpret_cast<char*>(const_cast<byte*>(src)),
+			       unsigned(src_len), 1, 0) == BZ_OK
+		       && out_len == len);
+	}
+#endif
+#ifdef HAVE_SNAPPY
+	case PAGE_SNAPPY_ALGORITHM: {
+		size_t	out_len = len;
+
+		return(snappy_uncompress(reinterpret_cast<const char*>(src),
+					 src_len,
+					 reinterpret_cast<char*>(dst),
+					 &out_len) == SNAPPY_OK
+		       && out_len == len);
+	}
+#endif
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM: {
+		size_t	out_len = ZSTD_getDictID_fromFrame(src, src_len)
+			? (zstd_ddict
+			   ? ZSTD_decompress_usingDDict(zstd_dctx, dst, len,
+							src, src_len,
+							zstd_ddict)
+			   : size_t(-1))
+			: ZSTD_decompressDCtx(zstd_dctx, dst, len,
+					      src, src_len);
+
+		return(!ZSTD_isError(out_len) && out_len == len);
+	}
+#endif
+	}
+
+	return(false);
+}
+
+#ifdef HAVE_ZSTD
+/** Load the zstd dictionary that is stored in the first page,
+or train one on the index pages like the server would.
+@param[in]	page0		first page of the file
+@param[in]	pages		pages of the file, or NULL to only load
+				the dictionary from page 0
+@param[in]	n_pages		number of pages
+@param[in]	page_size	page size
+@return size of the dictionary in bytes, or 0 */
+static
+ulint
+zstd_dict_init(
+	const byte*		page0,
+	const byte*		pages,
+	ulint			n_pages,
+	const page_size_t&	page_size)
+{
+	const ulint	size = page_size.physical();
+	/* The same as fil_zstd_dict_offset() */
+	const ulint	offset = FSP_HEADER_OFFSET + XDES_ARR_OFFSET
+		+ XDES_SIZE * size / FSP_EXTENT_SIZE + FSP_ZSTD_DICT;
+	const byte*	d = page0 + offset;
+	const ulint	capacity = std::min(size - FIL_PAGE_DATA_END - offset
+					    - FSP_ZSTD_DICT_DATA,
+					    ZSTD_DICT_MAX);
+
+	if (mach_read_from_4(d + FSP_ZSTD_DICT_MAGIC)
+	    == FSP_ZSTD_DICT_MAGIC_N) {
+		ulint	len = mach_read_from_2(d + FSP_ZSTD_DICT_LEN);
+
+		if (len <= capacity) {
+			printf("Using the zstd dictionary of " ULINTPF
+			       " bytes from page 0\n", len);
+			zstd_cdict = ZSTD_createCDict(d + FSP_ZSTD_DICT_DATA,
+						      len, int(level));
+			zstd_ddict = ZSTD_createDDict(d + FSP_ZSTD_DICT_DATA,
+						      len);
+			return(len);
+		}
+	}
+
+	if (pages == NULL) {
+		return(0);
+	}
+
+	/* Sample index pages evenly from the whole file. */
+	byte*	samples = static_cast<byte*>(
+		malloc(ZSTD_TRAIN_SAMPLES * size));
+	size_t	sizes[ZSTD_TRAIN_SAMPLES];
+	ulint	n = 0;
+	ulint	step = std::max(n_pages / ZSTD_TRAIN_SAMPLES, ulint(1));
+
+	for (ulint i = 0; i < n_pages && n < ZSTD_TRAIN_SAMPLES; i += step) {
+		const byte*	page = pages + i * size;
+
+		const ulint	type = mach_read_from_2(page + FIL_PAGE_TYPE);
+
+		if (fil_page_type_is_index(type)) {
+			memcpy(samples + n * size, page, size);
+			sizes[n++] = size;
+		}
+	}
+
+	byte*	data = static_cast<byte*>(malloc(capacity));
+	size_t	len = n
+		? ZDICT_trainFromBuffer(data, capacity, samples, sizes,
+					unsigned(n))
+		: size_t(-1);
+
+	free(samples);
+
+	if (ZDICT_isError(len)) {
+		fprintf(stderr, "Training a zstd dictionary on " ULINTPF
+			" pages failed: %s\n",
+			n, n ? ZDICT_getErrorName(len) : "no index pages");
+		free(data);
+		return(0);
+	}
+
+	printf("Trained a zstd dictionary of " ULINTPF " bytes on "
+	       ULINTPF " pages\n", ulint(len), n);
+	zstd_cdict = ZSTD_createCDict(data, len, int(level));
+	zstd_ddict = ZSTD_createDDict(data, len);
+	free(data);
+	return(ulint(len));
+}
+#endif /* HAVE_ZSTD */
+
+/** Read the pages of a file, decompressing page_compressed pages.
+@param[in,out]	file		the file
+@param[in]	page_size	page size
+@param[in]	n_pages		number of pages in the file
+@param[out]	pages		pages that were read
+@param[out]	n_read		number of pages that were read
+@return whether the pages were read */
+static
+bool
+read_pages(
+	FILE*			file,
+	const page_size_t&	page_size,
+	ulint			n_pages,
+	byte*			pages,
+	ulint*			n_read)
+{
+	const ulint	size = page_size.physical();
+	ulint		step = (n_pages + max_pages - 1) / max_pages;
+	byte*		buf = static_cast<byte*>(malloc(size));
+	ulint		n_skipped = 0;
+	ulint		n = 0;
+
+	for (ulint i = 0; i < n_pages; i += step) {
+		if (my_fseek(file, my_off_t(i) * size, MY_SEEK_SET, MYF(0))
+		    == MY_FILEPOS_ERROR
+		    || my_fread(file, buf, size, MYF(MY_NABP))) {
+			fprintf(stderr, "Error: cannot read page " ULINTPF
+				"\n", i);
+			free(buf);
+			return(false);
+		}
+
+		byte*	page = pages + n * size;
+
+		switch (mach_read_from_2(buf + FIL_PAGE_TYPE)) {
+		case FIL_PAGE_TYPE_ALLOCATED:
+		case FIL_PAGE_TYPE_FSP_HDR:
+		case FIL_PAGE_TYPE_XDES:
+			/* never page_compressed */
+			continue;
+		case FIL_PAGE_PAGE_COMPRESSED_ENCRYPTED:
+			n_skipped++;
+			continue;
+		case FIL_PAGE_PAGE_COMPRESSED:
+			if (!decompress_page(
+				    ulint(mach_read_from_8(
+					 buf + FIL_PAGE_FILE_FLUSH_LSN_OR_KEY_VERSION)),
+				    buf + PAYLOAD,
+				    mach_read_from_2(buf + FIL_PAGE_DATA),
+				    page, size)) {
+				n_skipped++;
+				continue;
+			}
+			break;
+		default:
+			if (mach_read_from_4(
+				    buf + FIL_PAGE_FILE_FLUSH_LSN_OR_KEY_VERSION)) {
+				/* encrypted */
+				n_skipped++;
+				continue;
+			}
+			memcpy(page, buf, size);
+		}
+
+		n++;
+	}
+
+	if (n_skipped) {
+		printf("Skipped " ULINTPF " encrypted pages or pages that"
+		       " could not be decompressed\n", n_skipped);
+	}
+
+	free(buf);
+	*n_read = n;
+	return(true);
+}
+
+/** Benchmark an algorithm.
+@param[in]	alg		algorithm
+@param[in]	pages		pages
+@param[in]	n_pages		number of pages
+@param[in]	size		page size
+@return whether every page was restored by the decompression */
+static
+bool
+benchmark(
+	const algorithm_t&	alg,
+	const byte*		pages,
+	ulint			n_pages,
+	ulint			size)
+{
+	/* The payload must fit in the page, after the header. */
+	const ulint	max_len = size - PAYLOAD;
+	byte*		out = static_cast<byte*>(malloc(n_pages * max_len));
+	ulint*		out_len = static_cast<ulint*>(
+		malloc(n_pages * sizeof *out_len));
+	byte*		page = static_cast<byte*>(malloc(size));
+	ulonglong	compress_time = 0;
+	ulonglong	decompress_time = 0;
+	ulonglong	total = 0;
+	ulonglong	total_blocks = 0;
+	bool		ok = true;
+
+	for (uint r = 0; r < repeat; r++) {
+		ulonglong	start = my_interval_timer();
+
+		for (ulint i = 0; i < n_pages; i++) {
+			out_len[i] = compress_page(alg, pages + i * size, size,
+						   out + i * max_len, max_len);
+		}
+
+		compress_time += my_interval_timer() - start;
+		start = my_interval_timer();
+
+		for (ulint i = 0; i < n_pages; i++) {
+			if (out_len[i]
+			    && !decompress_page(alg.id, out + i * max_len,
+						out_len[i], page, size)) {
+				ok = false;
+			}
+		}
+
+		decompress_time += my_interval_timer() - start;
+	}
+
+	for (ulint i = 0; i < n_pages; i++) {
+		/* Pages that do not compress are written as they are. */
+		ulint	len = out_len[i] ? out_len[i] + PAYLOAD : size;
+
+		total += len;
+		total_blocks += (len + block_size - 1) / block_size
+			* block_size;
+	}
+
+	/* Check every page once more, outside the timed loop. */
+	for (ulint i = 0; ok && i < n_pages; i++) {
+		ok = !out_len[i]
+			|| (decompress_page(alg.id, out + i * max_len,
+					    out_len[i], page, size)
+			    && !memcmp(pages + i * size, page, size));
+	}
+
+	const double	mb = double(n_pages) * size * repeat / (1 << 20);
+
+	printf("%-10s %6.2f %8.2f %13.1f %15.1f%s\n",
+	       alg.name,
+	       double(n_pages) * size / double(total),
+	       double(n_pages) * size / double(total_blocks),
+	       compress_time ? mb * 1e9 / double(compress_time) : 0.0,
+	       decompress_time ? mb * 1e9 / double(decompress_time) : 0.0,
+	       ok ? "" : "  (MISMATCH)");
+
+	free(page);
+	free(out_len);
+	free(out);
+	return(ok);
+}
+
+static struct my_option innocompress_options[] = {
+  {"help", '?', "Displays this help and exits.",
+    0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"version", 'V', "Displays version information and exits.",
+    0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"algorithm", 'a', "Benchmark only this algorithm. One of: zlib, lz4, "
+   "lzo, lzma, bzip2, snappy, zstd or zstd+dict.",
+    &algorithm_name, &algorithm_name, 0,
+    GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"level", 'l', "Compression level (page_compression_level) for "
+   "zlib, lzma and zstd.",
+    &level, &level, 0, GET_UINT, REQUIRED_ARG, 6, 1, 9, 0, 1, 0},
+  {"max-pages", 'm', "Benchmark at most this many pages, sampled evenly "
+   "from the whole file.",
+    &max_pages, &max_pages, 0, GET_ULONG, REQUIRED_ARG,
+    16384, 1, ULONG_MAX, 0, 1, 0},
+  {"repeat", 'r', "Number of passes over the pages.",
+    &repeat, &repeat, 0, GET_UINT, REQUIRED_ARG, 1, 1, UINT_MAX, 0, 1, 0},
+  {"block-size", 'b', "File system block size; each compressed page "
+   "occupies a multiple of this when the rest of the page is punched.",
+    &block_size, &block_size, 0, GET_ULONG, REQUIRED_ARG,
+    4096, 512, UNIV_PAGE_SIZE_MAX, 0, 512, 0},
+
+  {0, 0, 0, 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0}
+};
+
+/* Print out the Innodb version and machine information. */
+static void print_version(void)
+{
+	printf("%s Ver %s, for %s (%s)\n",
+		my_progname, INNODB_VERSION_STR,
+		SYSTEM_TYPE, MACHINE_TYPE);
+}
+
+static void usage(void)
+{
+	print_version();
+	puts(ORACLE_WELCOME_COPYRIGHT_NOTICE("2017"));
+	printf("InnoDB page compression benchmark.\n");
+	printf("Usage: %s [-a <algorithm>] [-l <level>] [-m <max pages>] "
+	       "[-r <repeat>] [-b <block size>] <filename>\n", my_progname);
+	my_print_help(innocompress_options);
+	my_print_variables(innocompress_options);
+}
+
+extern "C" my_bool
+innocompress_get_one_option(
+	int			optid,
+	const struct my_option	*opt MY_ATTRIBUTE((unused)),
+	char			*argument MY_ATTRIBUTE((unused)))
+{
+	switch (optid) {
+	case 'V':
+		print_version();
+		my_end(0);
+		exit(EXIT_SUCCESS);
+		break;
+	case '?':
+		usage();
+		my_end(0);
+		exit(EXIT_SUCCESS);
+		break;
+	}
+
+	return(false);
+}
+
+int main(
+	int	argc,
+	char	**argv)
+{
+	int		exit_status = 1;
+	FILE*		file = NULL;
+	byte		page0[UNIV_PAGE_SIZE_MAX];
+	byte*		pages = NULL;
+	ulint		n_pages;
+	MY_STAT		st;
+
+	MY_INIT(argv[0]);
+
+	if (handle_options(&argc, &argv, innocompress_options,
+			   innocompress_get_one_option)) {
+		goto func_exit;
+	}
+
+	if (argc != 1) {
+		usage();
+		goto func_exit;
+	}
+
+	if (!my_stat(argv[0], &st, MYF(MY_WME))
+	    || !(file = my_fopen(argv[0], O_RDONLY | O_BINARY, MYF(MY_WME)))) {
+		goto func_exit;
+	}
+
+	if (my_fread(file, page0, UNIV_ZIP_SIZE_MIN, MYF(MY_NABP))) {
+		fprintf(stderr, "Error: cannot read page 0 of %s\n", argv[0]);
+		goto func_exit;
+	}
+
+	{
+		const ulint	flags = mach_read_from_4(
+			page0 + FSP_HEADER_OFFSET + FSP_SPACE_FLAGS);
+		const page_size_t	page_size(flags);
+
+		if (page_size.is_compressed()) {
+			fprintf(stderr, "Error: %s uses ROW_FORMAT=COMPRESSED,"
+				" which cannot be page_compressed\n", argv[0]);
+			goto func_exit;
+		}
+
+		srv_page_size = page_size.logical();
+		univ_page_size.copy_from(page_size);
+
+		const ulint	size = page_size.physical();
+
+		if (my_fread(file, page0 + UNIV_ZIP_SIZE_MIN,
+			     size - UNIV_ZIP_SIZE_MIN, MYF(MY_NABP))) {
+			fprintf(stderr, "Error: cannot read page 0 of %s\n",
+				argv[0]);
+			goto func_exit;
+		}
+
+		n_pages = ulint(st.st_size / size);
+		pages = static_cast<byte*>(
+			malloc(std::min(n_pages, ulint(max_pages)) * size));
+
+		if (!pages) {
+			fprintf(stderr, "Error: out of memory\n");
+			goto func_exit;
+		}
+
+#ifdef HAVE_ZSTD
+		zstd_cctx = ZSTD_createCCtx();
+		zstd_dctx = ZSTD_createDCtx();
+		/* Page-compressed pages in the file may need the
+		dictionary that is stored in page 0. */
+		zstd_dict_init(page0, NULL, 0, page_size);
+#endif /* HAVE_ZSTD */
+
+		if (!read_pages(file, page_size, n_pages, pages, &n_pages)) {
+			goto func_exit;
+		}
+
+		if (n_pages == 0) {
+			fprintf(stderr, "Error: %s contains no data pages\n",
+				argv[0]);
+			goto func_exit;
+		}
+
+#ifdef HAVE_ZSTD
+		if (!zstd_cdict) {
+			zstd_dict_init(page0, pages, n_pages, page_size);
+		}
+#endif /* HAVE_ZSTD */
+
+		printf("File %s: " ULINTPF " pages of " ULINTPF " bytes,"
+		       " level %u, block size %lu\n",
+		       argv[0], n_pages, size, level, block_size);
+		printf("%-10s %6s %8s %13s %15s\n", "algorithm", "ratio",
+		       "on disk", "compress MB/s", "decompress MB/s");
+
+		exit_status = 0;
+
+		for (ulint i = 0; i < array_elements(algorithms); i++) {
+			const algorithm_t&	alg = algorithms[i];
+
+			if (algorithm_name
+			    && strcmp(algorithm_name, alg.name)) {
+				continue;
+			}
+#ifdef HAVE_ZSTD
+			if (alg.dict && !zstd_cdict) {
+				continue;
+			}
+#endif /* HAVE_ZSTD */
+			if (!benchmark(alg, pages, n_pages, size)) {
+				exit_status = 1;
+			}
+		}
+	}
+
+func_exit:
+#ifdef HAVE_ZSTD
+	ZSTD_freeCDict(zstd_cdict);
+	ZSTD_freeDDict(zstd_ddict);
+	ZSTD_freeCCtx(zstd_cctx);
+	ZSTD_freeDCtx(zstd_dctx);
+#endif /* HAVE_ZSTD */
+	free(pages);
+
+	if (file) {
+		my_fclose(file, MYF(0));
+	}
+
+	my_end(0);
+	return(exit_status);
+}
@@ -49,6 +49,7 @@ typedef struct st_heapinfo		/* Struct from heap_info */
   ulonglong index_length;
   uint reclength;			/* Length of one record */
   int errkey;
+  uchar *dupp_key_pos;			/* Row with the duplicate key */
   ulonglong auto_increment;
   time_t create_time;
 } HEAPINFO;
@@ -109,6 +110,18 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+/*
+  A BLOB column of a heap table. The data of a BLOB is stored in a chain
+  of fixed-size chunks in HP_SHARE::blob_block; the record stores the
+  length of the BLOB followed by a pointer to the first chunk.
+*/
+
+typedef struct st_hp_blobdef
+{
+  uint offset;				/* Start of the column in record */
+  uint packlength;			/* Bytes used to store the length */
+} HP_BLOBDEF;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -133,7 +146,9 @@ typedef struct st_hp_keydef		/* Key definition with open */
 typedef struct st_heap_share
 {
   HP_BLOCK block;
+  HP_BLOCK blob_block;			/* Chunks of BLOB data */
   HP_KEYDEF  *keydef;
+  HP_BLOBDEF *blobdef;
   ulonglong data_length,index_length,max_table_size;
   ulonglong auto_increment;
   ulong min_records,max_records;	/* Params to open */
@@ -146,9 +161,11 @@ typedef struct st_heap_share
   uint reclength;			/* Length of one record */
   uint changed;
   uint keys,max_key_length;
+  uint blobs;				/* Number of BLOB columns */
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
+  uchar *blob_del_link;			/* Chain of free BLOB chunks */
   char * name;			/* Name of "memory-file" */
   time_t create_time;
   THR_LOCK lock;
@@ -173,6 +190,11 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar *dupp_key_pos;                   /* Row with the duplicate key */
+  uchar *blob_buff;                      /* BLOBs of the last read row */
+  uchar *blob_key_buff;                  /* BLOB of a row in key compare */
+  uchar **blob_chains;                   /* New BLOBs in heap_update() */
+  size_t blob_buff_length, blob_key_buff_length;
   enum ha_rkey_function last_find_flag;
   TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
   TREE_ELEMENT **last_pos;
@@ -188,9 +210,11 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_BLOBDEF *blobdef;
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
   uint auto_key_type;
   uint keys;
+  uint blobs;
   uint reclength;
   ulong max_records;
   ulong min_records;
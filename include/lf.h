@@ -136,10 +136,14 @@ typedef struct st_lf_hash LF_HASH;
 typedef void (*lf_hash_initializer)(LF_HASH *hash, void *dst, const void *src);
 
 #define LF_HASH_UNIQUE 1
+/* store the hash in cache line sized buckets instead of a list, lf_hash.c */
+#define LF_HASH_BUCKETS 2
 
 /* lf_hash overhead per element (that is, sizeof(LF_SLIST) */
 extern const int LF_HASH_OVERHEAD;
 
+struct st_lf_hash_table;
+
 struct st_lf_hash {
   LF_DYNARRAY array;                    /* hash itself */
   LF_ALLOCATOR alloc;                   /* allocator for elements */
@@ -152,6 +156,10 @@ struct st_lf_hash {
   uint flags;                           /* LF_HASH_UNIQUE, etc */
   int32 volatile size;                  /* size of array */
   int32 volatile count;                 /* number of elements in the hash */
+  /* only used with LF_HASH_BUCKETS */
+  struct st_lf_hash_table * volatile table; /* current bucket array */
+  struct st_lf_hash_table * volatile retired; /* replaced, not freed yet */
+  int32 volatile resizing;              /* set while the table is resized */
 };
 
 void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
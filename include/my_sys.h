@@ -100,6 +100,10 @@ typedef struct my_aio_result {
 #define MY_THREAD_MOVE     0x20000U /* realloc(); Memory can move */
 /* Tree that should delete things automaticly */
 #define MY_TREE_WITH_DELETE 0x40000U
+/* Tree that is stored as a B-tree, see mysys/tree.c */
+#define MY_TREE_BTREE      0x80000U
+/* init_io_cache(): read ahead or write behind, see mf_iocache_async.c */
+#define MY_ASYNC_IO        0x100000U
 
 #define MY_CHECK_ERROR	1U	/* Params to my_end; Check open-close */
 #define MY_GIVE_INFO	2U	/* Give time info about process*/
@@ -260,6 +264,7 @@ extern const char *my_collation_get_tailoring(uint id);
 
 /* statistics */
 extern ulong	my_file_opened,my_stream_opened, my_tmp_file_created;
+extern ulong	my_io_cache_async_reads, my_io_cache_async_writes;
 extern ulong    my_file_total_opened;
 extern ulong    my_sync_count;
 extern uint	mysys_usage_id;
@@ -488,6 +493,11 @@ typedef struct st_io_cache		/* Used when cacheing files */
     somewhere else
   */
   my_bool alloced_buffer;
+  /*
+    Second buffer and request of read-ahead or write-behind by the
+    io_cache_async threads, 0 if all I/O is done by the caller
+  */
+  struct st_io_cache_async *async;
 #ifdef HAVE_AIOWAIT
   /*
     As inidicated by ifdef, this is for async I/O, which is not currently
@@ -810,6 +820,8 @@ void end_slave_io_cache(IO_CACHE *cache);
 void seek_io_cache(IO_CACHE *cache, my_off_t needed_offset);
 
 extern void remove_io_thread(IO_CACHE *info);
+extern my_bool init_io_cache_async(uint threads);
+extern void end_io_cache_async(void);
 extern int _my_b_async_read(IO_CACHE *info,uchar *Buffer,size_t Count);
 extern int my_b_append(IO_CACHE *info,const uchar *Buffer,size_t Count);
 extern int my_b_safe_write(IO_CACHE *info,const uchar *Buffer,size_t Count);
@@ -899,6 +911,10 @@ extern void free_root(MEM_ROOT *root, myf MyFLAGS);
 extern void set_prealloc_root(MEM_ROOT *root, char *ptr);
 extern void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
                                 size_t prealloc_size);
+extern void mem_root_pool_trim(void);
+extern ulong my_mem_root_pool_size;
+extern int64 my_mem_root_pool_hits, my_mem_root_pool_misses;
+extern int64 my_mem_root_pool_trims;
 extern char *strdup_root(MEM_ROOT *root,const char *str);
 static inline char *safe_strdup_root(MEM_ROOT *root, const char *str)
 {
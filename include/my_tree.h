@@ -58,6 +58,8 @@ typedef struct st_tree_element {
 
 #define ELEMENT_CHILD(element, offs) (*(TREE_ELEMENT**)((char*)element + offs))
 
+struct st_tree_node;
+
 typedef struct st_tree {
   TREE_ELEMENT *root,null_element;
   TREE_ELEMENT **parents[MAX_TREE_HEIGHT];
@@ -70,6 +72,9 @@ typedef struct st_tree {
   tree_element_free free;
   myf my_flags;
   uint flag;
+  /* Only used for trees created with MY_TREE_BTREE */
+  struct st_tree_node *btree_root;
+  uint btree_max_keys, btree_slot_size;
 } TREE;
 
 	/* Functions on whole tree */
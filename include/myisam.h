@@ -326,7 +326,6 @@ typedef struct st_sort_info
   MI_INFO *info;
   HA_CHECK *param;
   uchar *buff;
-  SORT_KEY_BLOCKS *key_block, *key_block_end;
   SORT_FT_BUF *ft_buf;
   my_off_t filelength, dupp, buff_length;
   ha_rows max_records;
@@ -335,6 +334,12 @@ typedef struct st_sort_info
   uint threads_running;
   myf myf_rw;
   enum data_file_type new_data_file_type;
+  /* Rows read once for all key threads in parallel repair */
+  mysql_cond_t row_cond;
+  SORT_ROW_BATCH *row_batch;
+  ulonglong row_batches_filled;
+  uint row_readers;
+  my_bool rows_eof;
 } MI_SORT_INFO;
 
 typedef struct st_mi_sort_param
@@ -348,6 +353,7 @@ typedef struct st_mi_sort_param
   MI_SORT_INFO *sort_info;
   HA_KEYSEG *seg;
   uchar **sort_keys;
+  SORT_KEY_BLOCKS *key_block, *key_block_end; /* Index pages being built */
   uchar *rec_buff;
   void *wordlist, *wordptr;
   MEM_ROOT wordroot;
@@ -362,6 +368,8 @@ typedef struct st_mi_sort_param
   ulonglong notnull[HA_MAX_KEY_SEG+1];
 
   my_off_t pos,max_pos,filepos,start_recpos;
+  ulonglong row_batch;                  /* Next batch in parallel repair */
+  uchar *row_pos, *row_end;             /* Rows left in the current batch */
   uint key, key_length,real_key_length;
   uint maxbuffers, find_length;
   ulonglong sortbuff_size;
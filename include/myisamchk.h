@@ -140,4 +140,19 @@ typedef struct st_buffpek {
   ha_rows max_keys;                     /* Max keys in buffert */
 } BUFFPEK;
 
+/*
+  Rows passed from the reader thread to the key threads of a parallel
+  repair. The reader fills the batches of a ring in turn; a batch is
+  reused when all key threads have read it.
+*/
+
+#define SORT_ROW_BATCHES 4
+
+typedef struct st_sort_row_batch
+{
+  uchar *buff;                          /* Rows with their positions */
+  size_t length, used;                  /* Size and used part of buff */
+  uint readers;                         /* Key threads still reading it */
+} SORT_ROW_BATCH;
+
 #endif /* _myisamchk_h */
@@ -21,6 +21,9 @@
      try to get rid of dummy nodes ?
      for non-unique hash, count only _distinct_ values
      (but how to do it in lf_hash_delete ?)
+
+  With LF_HASH_BUCKETS the elements are not kept in a split-ordered list,
+  see "hash with cache line sized buckets" below.
 */
 #include <my_global.h>
 #include <m_string.h>
@@ -59,6 +62,32 @@ typedef struct {
 #define PTR(V)      (LF_SLIST *)((V) & (~(intptr)1))
 #define DELETED(V)  ((V) & 1)
 
+/*
+  A bucket of a hash with LF_HASH_BUCKETS, one cache line.
+  If the bucket is full, more elements go to a chain of overflow buckets.
+*/
+#define LF_BUCKET_SLOTS 4
+
+typedef struct st_lf_bucket {
+  int32 volatile lock;                  /* only used in the first bucket */
+  uint32 volatile hashnr[LF_BUCKET_SLOTS];
+  LF_SLIST * volatile node[LF_BUCKET_SLOTS];
+  struct st_lf_bucket * volatile next;  /* overflow bucket */
+} LF_BUCKET;
+
+/* values of LF_BUCKET::lock */
+#define LFB_LOCKED 1
+#define LFB_MOVED  2    /* the elements were moved to the new table */
+
+typedef struct st_lf_hash_table {
+  LF_BUCKET *buckets;                   /* aligned to a cache line */
+  uint32 mask;                          /* number of buckets - 1 */
+  void *alloc;                          /* memory of buckets */
+  /* the table whose elements are being moved to this one, or 0 */
+  struct st_lf_hash_table * volatile old;
+  struct st_lf_hash_table *next_retired; /* in LF_HASH::retired */
+} LF_HASH_TABLE;
+
 /** walk the list, searching for an element or invoking a callback
 
     Search for hashnr/key/keylen in the list starting from 'head' and
@@ -318,8 +347,19 @@ static inline my_hash_value_type calc_hash(CHARSET_INFO *cs,
 }
 
 #define MAX_LOAD 1.0    /* average number of elements in a bucket */
+#define LF_BUCKETS_MIN      16  /* initial size of LF_HASH_BUCKETS table */
+#define LF_BUCKETS_MAX_LOAD 2   /* average number of elements in a bucket */
 
 static int initialize_bucket(LF_HASH *, LF_SLIST * volatile*, uint, LF_PINS *);
+static LF_HASH_TABLE *lfb_new_table(uint buckets);
+static void lfb_destroy(LF_HASH *hash);
+static int lfb_insert(LF_HASH *hash, LF_SLIST *node, LF_PINS *pins);
+static int lfb_delete(LF_HASH *hash, uint32 hashnr, const uchar *key,
+                      uint keylen, LF_PINS *pins);
+static LF_SLIST *lfb_search(LF_HASH *hash, uint32 hashnr, const uchar *key,
+                            uint keylen, LF_PINS *pins);
+static int lfb_iterate(LF_HASH *hash, LF_PINS *pins,
+                       my_hash_walk_action action, void *argument);
 
 static void default_initializer(LF_HASH *hash, void *dst, const void *src)
 {
@@ -358,6 +398,15 @@ void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
   hash->get_key= get_key;
   hash->initializer= default_initializer;
   hash->hash_function= calc_hash;
+  hash->table= 0;
+  hash->retired= 0;
+  hash->resizing= 0;
+  if (flags & LF_HASH_BUCKETS)
+  {
+    /* if this fails, lf_hash_insert() will return -1 */
+    hash->table= lfb_new_table(LF_BUCKETS_MIN);
+    hash->size= LF_BUCKETS_MIN;
+  }
   DBUG_ASSERT(get_key ? !key_offset && !key_length : key_length);
 }
 
@@ -365,7 +414,9 @@ void lf_hash_destroy(LF_HASH *hash)
 {
   LF_SLIST *el, **head= (LF_SLIST **)lf_dynarray_value(&hash->array, 0);
 
-  if (head)
+  if (hash->flags & LF_HASH_BUCKETS)
+    lfb_destroy(hash);
+  else if (head)
   {
     el= *head;
     while (el)
@@ -406,6 +457,14 @@ int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
   hash->initializer(hash, node + 1, data);
   node->key= hash_key(hash, (uchar *)(node+1), &node->keylen);
   hashnr= hash->hash_function(hash->charset, node->key, node->keylen) & INT_MAX32;
+  if (hash->flags & LF_HASH_BUCKETS)
+  {
+    int res;
+    node->hashnr= hashnr;
+    if ((res= lfb_insert(hash, node, pins)))
+      lf_alloc_free(pins, node);
+    return res;
+  }
   bucket= hashnr % hash->size;
   el= lf_dynarray_lvalue(&hash->array, bucket);
   if (unlikely(!el))
@@ -441,6 +500,8 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
   uint bucket, hashnr;
 
   hashnr= hash->hash_function(hash->charset, (uchar *)key, keylen) & INT_MAX32;
+  if (hash->flags & LF_HASH_BUCKETS)
+    return lfb_delete(hash, hashnr, (uchar *)key, keylen, pins);
 
   /* hide OOM errors - if we cannot initialize a bucket, try the previous one */
   for (bucket= hashnr % hash->size; ;bucket= my_clear_highest_bit(bucket))
@@ -476,6 +537,12 @@ void *lf_hash_search_using_hash_value(LF_HASH *hash, LF_PINS *pins,
   LF_SLIST * volatile *el, *found;
   uint bucket;
 
+  if (hash->flags & LF_HASH_BUCKETS)
+  {
+    found= lfb_search(hash, hashnr & INT_MAX32, (uchar *)key, keylen, pins);
+    return found ? found+1 : 0;
+  }
+
   /* hide OOM errors - if we cannot initialize a bucket, try the previous one */
   for (bucket= hashnr % hash->size; ;bucket= my_clear_highest_bit(bucket))
   {
@@ -509,6 +576,9 @@ int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins,
   int res;
   LF_SLIST * volatile *el;
 
+  if (hash->flags & LF_HASH_BUCKETS)
+    return lfb_iterate(hash, pins, action, argument);
+
   el= lf_dynarray_lvalue(&hash->array, bucket);
   if (unlikely(!el))
     return 0; /* if there's no bucket==0, the hash is empty */
@@ -573,3 +643,631 @@ static int initialize_bucket(LF_HASH *hash, LF_SLIST * volatile *node,
   */
   return 0;
 }
+
+
+/*
+  hash with cache line sized buckets (LF_HASH_BUCKETS)
+
+  The hash is an array of LF_BUCKET, each holding up to LF_BUCKET_SLOTS
+  pointers to elements together with their hash numbers, so a search
+  usually reads one cache line of the bucket and the element it wants,
+  instead of following the split-ordered list through every element
+  with a smaller hash number.
+
+  Searches take no locks. A found element is pinned with pin 2 and then
+  it is checked that it is still in the bucket; elements are freed with
+  lf_alloc_free() after they are removed from the table, so a pinned
+  element that is still in a bucket can't be freed.
+
+  lf_hash_insert() and lf_hash_delete() lock the bucket with a spin lock
+  in its first LF_BUCKET. The table is doubled when there are more than
+  LF_BUCKETS_MAX_LOAD elements per bucket, and halved when there are
+  fewer than a quarter of that. The resizing thread makes the new table
+  current at once and then moves the elements over one old bucket at a
+  time, locking only that bucket and the new buckets that its elements
+  go to. A moved bucket is marked LFB_MOVED. Until then, inserts and
+  deletes of its elements are done in the old table. Elements are put
+  in the new table before they are removed from the old one, so a
+  search looks in the old table first.
+
+  The tables are pinned with pin 3 (current) and pin 1 (old) while they
+  are used. When all elements were moved, the old table is put in
+  LF_HASH::retired, and it is freed with its overflow buckets as soon as
+  no thread has it pinned. Overflow buckets that become empty are reused
+  by later inserts into the same chain, and are freed with their table.
+*/
+
+static LF_HASH_TABLE *lfb_new_table(uint buckets)
+{
+  LF_HASH_TABLE *table;
+  uchar *mem;
+
+  compile_time_assert(sizeof(LF_BUCKET) <= CPU_LEVEL1_DCACHE_LINESIZE);
+  if (!(table= (LF_HASH_TABLE*) my_malloc(sizeof(*table), MYF(MY_WME))))
+    return 0;
+  if (!(mem= (uchar*) my_malloc(buckets * sizeof(LF_BUCKET) +
+                                CPU_LEVEL1_DCACHE_LINESIZE,
+                                MYF(MY_WME | MY_ZEROFILL))))
+  {
+    my_free(table);
+    return 0;
+  }
+  table->alloc= mem;
+  table->buckets= (LF_BUCKET*) MY_ALIGN((intptr) mem,
+                                        CPU_LEVEL1_DCACHE_LINESIZE);
+  table->mask= buckets - 1;
+  table->old= 0;
+  table->next_retired= 0;
+  return table;
+}
+
+
+static void lfb_free_table(LF_HASH_TABLE *table)
+{
+  uint i;
+  for (i= 0; i <= table->mask; i++)
+  {
+    LF_BUCKET *bucket, *next;
+    for (bucket= table->buckets[i].next; bucket; bucket= next)
+    {
+      next= bucket->next;
+      my_free(bucket);
+    }
+  }
+  my_free(table->alloc);
+  my_free(table);
+}
+
+
+static void lfb_free_nodes(LF_HASH *hash, LF_HASH_TABLE *table)
+{
+  uint i, j;
+  for (i= 0; i <= table->mask; i++)
+  {
+    LF_BUCKET *bucket;
+    for (bucket= table->buckets + i; bucket; bucket= bucket->next)
+      for (j= 0; j < LF_BUCKET_SLOTS; j++)
+        if (bucket->node[j])
+          lf_alloc_direct_free(&hash->alloc, bucket->node[j]);
+  }
+}
+
+
+static void lfb_destroy(LF_HASH *hash)
+{
+  LF_HASH_TABLE *table= hash->table, *next;
+
+  if (!table)
+    return;
+  lfb_free_nodes(hash, table);
+  if (table->old)
+  {
+    /* a resize ran out of memory, some elements were not moved */
+    lfb_free_nodes(hash, table->old);
+    lfb_free_table(table->old);
+  }
+  lfb_free_table(table);
+  for (table= hash->retired; table; table= next)
+  {
+    next= table->next_retired;
+    lfb_free_table(table);
+  }
+  hash->table= hash->retired= 0;
+}
+
+
+/*
+  lock the first bucket of a chain
+
+  RETURN
+    0 - locked
+    1 - not locked, the elements were moved to the new table
+*/
+
+static int lfb_lock(LF_BUCKET *bucket)
+{
+  uint spins;
+  for (spins= 1; ; spins++)
+  {
+    int32 lock= my_atomic_load32(&bucket->lock);
+    if (lock & LFB_MOVED)
+      return 1;
+    if (!lock && my_atomic_cas32(&bucket->lock, &lock, LFB_LOCKED))
+      return 0;
+#ifdef HAVE_SCHED_YIELD
+    if (!(spins % 100))
+      sched_yield();
+    else
+#endif
+      (void) LF_BACKOFF;
+  }
+}
+
+
+static inline void lfb_unlock(LF_BUCKET *bucket)
+{
+  my_atomic_store32(&bucket->lock, 0);
+}
+
+
+/*
+  pin the current table with pin 3, and the table that it replaces with
+  pin 1 if the elements of that are still being moved
+*/
+
+static LF_HASH_TABLE *lfb_pin_tables(LF_HASH *hash, LF_PINS *pins,
+                                     LF_HASH_TABLE **old)
+{
+  LF_HASH_TABLE *table, *prev;
+  do
+  {
+    table= my_atomic_loadptr((void **) &hash->table);
+    lf_pin(pins, 3, table);
+  } while (table != my_atomic_loadptr((void **) &hash->table));
+  do
+  {
+    prev= my_atomic_loadptr((void **) &table->old);
+    lf_pin(pins, 1, prev);
+  } while (prev != my_atomic_loadptr((void **) &table->old));
+  *old= prev;
+  return table;
+}
+
+
+static inline void lfb_unpin_tables(LF_PINS *pins)
+{
+  lf_unpin(pins, 1);
+  lf_unpin(pins, 3);
+}
+
+
+/* see match_pins() in lf_alloc-pin.c */
+
+static int lfb_match_pins(LF_PINS *el, void *addr)
+{
+  int i;
+  LF_PINS *el_end= el + LF_DYNARRAY_LEVEL_LENGTH;
+  for (; el < el_end; el++)
+    for (i= 0; i < LF_PINBOX_PINS; i++)
+      if (el->pin[i] == addr)
+        return 1;
+  return 0;
+}
+
+
+/* free the replaced tables that are not pinned, 'resizing' must be set */
+
+static void lfb_free_retired_locked(LF_HASH *hash)
+{
+  LF_HASH_TABLE *table, *next, *keep= 0;
+
+  for (table= hash->retired; table; table= next)
+  {
+    next= table->next_retired;
+    if (lf_dynarray_iterate(&hash->alloc.pinbox.pinarray,
+                            (lf_dynarray_func) lfb_match_pins, table))
+    {
+      table->next_retired= keep;
+      keep= table;
+    }
+    else
+      lfb_free_table(table);
+  }
+  my_atomic_storeptr((void **) &hash->retired, keep);
+}
+
+
+static void lfb_free_retired(LF_HASH *hash)
+{
+  int32 not_resizing= 0;
+  if (my_atomic_cas32(&hash->resizing, &not_resizing, 1))
+  {
+    lfb_free_retired_locked(hash);
+    my_atomic_store32(&hash->resizing, 0);
+  }
+}
+
+
+/*
+  lock the first bucket of the chain of hashnr: in the old table if its
+  elements were not moved yet, in the current table otherwise
+
+  NOTE
+    the tables stay pinned, *moving is set if there is an old table
+*/
+
+static LF_BUCKET *lfb_lock_bucket(LF_HASH *hash, uint32 hashnr,
+                                  LF_PINS *pins, my_bool *moving)
+{
+  for (;;)
+  {
+    LF_HASH_TABLE *old, *table= lfb_pin_tables(hash, pins, &old);
+    LF_BUCKET *bucket;
+    *moving= old != 0;
+    if (old && !lfb_lock(bucket= old->buckets + (hashnr & old->mask)))
+      return bucket;
+    if (!lfb_lock(bucket= table->buckets + (hashnr & table->mask)))
+      return bucket;
+    /* the table was replaced meanwhile and the bucket was moved */
+  }
+}
+
+
+/*
+  make sure that a chain has n free slots, the chain must be locked
+  or not yet visible to other threads
+
+  RETURN
+    0 - ok
+    1 - out of memory
+*/
+
+static int lfb_reserve(LF_BUCKET *bucket, uint n)
+{
+  LF_BUCKET *last= bucket;
+  uint i;
+
+  for (; bucket; last= bucket, bucket= bucket->next)
+    for (i= 0; i < LF_BUCKET_SLOTS && n; i++)
+      if (!bucket->node[i])
+        n--;
+  for (; n; n-= MY_MIN(n, LF_BUCKET_SLOTS))
+  {
+    if (!(bucket= (LF_BUCKET*) my_malloc(sizeof(LF_BUCKET),
+                                         MYF(MY_WME | MY_ZEROFILL))))
+      return 1;
+    my_atomic_storeptr((void **) &last->next, bucket);
+    last= bucket;
+  }
+  return 0;
+}
+
+
+/* put a node in a free slot of a locked chain, see lfb_reserve() */
+
+static void lfb_put(LF_BUCKET *bucket, LF_SLIST *node)
+{
+  uint i;
+  for (;; bucket= bucket->next)
+  {
+    DBUG_ASSERT(bucket);
+    for (i= 0; i < LF_BUCKET_SLOTS; i++)
+    {
+      if (!bucket->node[i])
+      {
+        bucket->hashnr[i]= node->hashnr;
+        my_atomic_storeptr((void **) &bucket->node[i], node);
+        return;
+      }
+    }
+  }
+}
+
+
+/*
+  move the elements of a chain of the old table to the current table
+
+  RETURN
+    0 - moved, the chain is marked LFB_MOVED
+    1 - out of memory, nothing was moved
+*/
+
+static int lfb_move_bucket(LF_HASH_TABLE *table, LF_BUCKET *first)
+{
+  /* a chain goes to one new chain when the table is halved, two at most */
+  LF_BUCKET *bucket, *target[2]= {0, 0};
+  uint count[2]= {0, 0}, i, t;
+  int res= 1;
+
+  if (lfb_lock(first))
+    return 0;
+  for (bucket= first; bucket; bucket= bucket->next)
+  {
+    for (i= 0; i < LF_BUCKET_SLOTS; i++)
+    {
+      LF_SLIST *node= bucket->node[i];
+      LF_BUCKET *to;
+      if (!node)
+        continue;
+      to= table->buckets + (node->hashnr & table->mask);
+      t= target[0] && target[0] != to;
+      DBUG_ASSERT(!target[t] || target[t] == to);
+      target[t]= to;
+      count[t]++;
+    }
+  }
+  /* only one table is moved at a time: the new chains are never moved */
+  for (t= 0; t < 2 && target[t]; t++)
+    (void) lfb_lock(target[t]);
+  for (t= 0; t < 2 && target[t]; t++)
+    if (lfb_reserve(target[t], count[t]))
+      goto end;
+  for (bucket= first; bucket; bucket= bucket->next)
+  {
+    for (i= 0; i < LF_BUCKET_SLOTS; i++)
+    {
+      LF_SLIST *node= bucket->node[i];
+      if (!node)
+        continue;
+      lfb_put(table->buckets + (node->hashnr & table->mask), node);
+      my_atomic_storeptr((void **) &bucket->node[i], NULL);
+    }
+  }
+  res= 0;
+end:
+  for (t= 0; t < 2 && target[t]; t++)
+    lfb_unlock(target[t]);
+  my_atomic_store32(&first->lock, res ? 0 : LFB_MOVED);
+  return res;
+}
+
+
+/*
+  double or halve the number of buckets if the hash is too full or too
+  empty, or finish moving the elements after an out of memory error
+
+  NOTE
+    only one thread resizes at a time, the others continue with the
+    tables they see
+*/
+
+static void lfb_resize(LF_HASH *hash)
+{
+  LF_HASH_TABLE *old, *table;
+  int32 not_resizing= 0;
+  uint32 i, size, count;
+
+  if (my_atomic_load32(&hash->resizing) ||
+      !my_atomic_cas32(&hash->resizing, &not_resizing, 1))
+    return;
+  table= my_atomic_loadptr((void **) &hash->table);
+  if (!(old= table->old))
+  {
+    size= table->mask + 1;
+    count= (uint32) my_atomic_load32(&hash->count);
+    if (count > size * LF_BUCKETS_MAX_LOAD)
+      size*= 2;
+    else if (size > LF_BUCKETS_MIN && count < size * LF_BUCKETS_MAX_LOAD / 4)
+      size/= 2;
+    else
+      goto end;
+    old= table;
+    if (!(table= lfb_new_table(size)))
+      goto end;
+    table->old= old;
+    my_atomic_storeptr((void **) &hash->table, table);
+    my_atomic_store32(&hash->size, (int32) size);
+  }
+  for (i= 0; i <= old->mask; i++)
+    if (lfb_move_bucket(table, old->buckets + i))
+      goto end;                         /* the next resize continues */
+  my_atomic_storeptr((void **) &table->old, NULL);
+  old->next_retired= hash->retired;
+  hash->retired= old;
+  lfb_free_retired_locked(hash);
+end:
+  my_atomic_store32(&hash->resizing, 0);
+}
+
+
+static inline my_bool lfb_match(LF_HASH *hash, const LF_SLIST *node,
+                                const uchar *key, uint keylen)
+{
+  return !my_strnncoll(hash->charset, node->key, node->keylen, key, keylen);
+}
+
+
+/*
+  RETURN
+    0 - inserted
+    1 - didn't (unique key conflict)
+   -1 - out of memory
+*/
+
+static int lfb_insert(LF_HASH *hash, LF_SLIST *node, LF_PINS *pins)
+{
+  LF_BUCKET *first, *bucket;
+  my_bool moving;
+  uint i;
+  int32 count;
+  int res= 0;
+
+  if (unlikely(!hash->table))
+    return -1;
+  first= lfb_lock_bucket(hash, node->hashnr, pins, &moving);
+  if (hash->flags & LF_HASH_UNIQUE)
+  {
+    for (bucket= first; bucket; bucket= bucket->next)
+    {
+      for (i= 0; i < LF_BUCKET_SLOTS; i++)
+      {
+        if (bucket->node[i] && bucket->hashnr[i] == node->hashnr &&
+            lfb_match(hash, bucket->node[i], node->key, (uint) node->keylen))
+        {
+          res= 1;
+          goto end;
+        }
+      }
+    }
+  }
+  if (lfb_reserve(first, 1))
+    res= -1;
+  else
+    lfb_put(first, node);
+end:
+  lfb_unlock(first);
+  lfb_unpin_tables(pins);
+  if (res)
+    return res;
+
+  count= my_atomic_add32(&hash->count, 1) + 1;
+  if (moving || count > my_atomic_load32(&hash->size) * LF_BUCKETS_MAX_LOAD)
+    lfb_resize(hash);
+  else if (unlikely(my_atomic_loadptr((void **) &hash->retired) != 0))
+    lfb_free_retired(hash);
+  return 0;
+}
+
+
+/*
+  RETURN
+    0 - deleted
+    1 - didn't (not found)
+*/
+
+static int lfb_delete(LF_HASH *hash, uint32 hashnr, const uchar *key,
+                      uint keylen, LF_PINS *pins)
+{
+  LF_BUCKET *first, *bucket;
+  my_bool moving;
+  uint i;
+  int32 count, size;
+
+  if (unlikely(!hash->table))
+    return 1;
+  first= lfb_lock_bucket(hash, hashnr, pins, &moving);
+  for (bucket= first; bucket; bucket= bucket->next)
+  {
+    for (i= 0; i < LF_BUCKET_SLOTS; i++)
+    {
+      LF_SLIST *node= bucket->node[i];
+      if (node && bucket->hashnr[i] == hashnr &&
+          lfb_match(hash, node, key, keylen))
+      {
+        my_atomic_storeptr((void **) &bucket->node[i], NULL);
+        lfb_unlock(first);
+        lfb_unpin_tables(pins);
+        lf_alloc_free(pins, node);
+
+        count= my_atomic_add32(&hash->count, -1) - 1;
+        size= my_atomic_load32(&hash->size);
+        if (moving || (size > LF_BUCKETS_MIN &&
+                       count < size * LF_BUCKETS_MAX_LOAD / 4))
+          lfb_resize(hash);
+        else if (unlikely(my_atomic_loadptr((void **) &hash->retired) != 0))
+          lfb_free_retired(hash);
+        return 0;
+      }
+    }
+  }
+  lfb_unlock(first);
+  lfb_unpin_tables(pins);
+  return 1;
+}
+
+
+/* search a chain, see lfb_search() */
+
+static LF_SLIST *lfb_search_chain(LF_HASH *hash, LF_BUCKET *bucket,
+                                  uint32 hashnr, const uchar *key,
+                                  uint keylen, LF_PINS *pins)
+{
+  uint i;
+
+  for (; bucket; bucket= my_atomic_loadptr((void **) &bucket->next))
+  {
+    for (i= 0; i < LF_BUCKET_SLOTS; i++)
+    {
+      LF_SLIST *node;
+      if (bucket->hashnr[i] != hashnr ||
+          !(node= my_atomic_loadptr((void **) &bucket->node[i])))
+        continue;
+      lf_pin(pins, 2, node);
+      /* if it was moved meanwhile, it is found in the new table */
+      if (my_atomic_loadptr((void **) &bucket->node[i]) == node &&
+          lfb_match(hash, node, key, keylen))
+        return node;
+    }
+  }
+  return 0;
+}
+
+
+/*
+  RETURN
+    0    - not found
+    node - found, it is kept pinned by pin 2
+*/
+
+static LF_SLIST *lfb_search(LF_HASH *hash, uint32 hashnr, const uchar *key,
+                            uint keylen, LF_PINS *pins)
+{
+  LF_HASH_TABLE *table, *old;
+  LF_SLIST *node;
+
+  if (unlikely(!hash->table))
+    return 0;
+  do
+  {
+    table= lfb_pin_tables(hash, pins, &old);
+    if ((old && (node= lfb_search_chain(hash,
+                                         old->buckets + (hashnr & old->mask),
+                                         hashnr, key, keylen, pins))) ||
+        (node= lfb_search_chain(hash, table->buckets + (hashnr & table->mask),
+                                hashnr, key, keylen, pins)))
+    {
+      lfb_unpin_tables(pins);
+      return node;
+    }
+    /* if the table was replaced meanwhile, the node may have moved */
+  } while (my_atomic_loadptr((void **) &hash->table) != table);
+  lfb_unpin_tables(pins);
+  lf_unpin(pins, 2);
+  return 0;
+}
+
+
+static int lfb_iterate_chain(LF_BUCKET *bucket, LF_PINS *pins,
+                             my_hash_walk_action action, void *argument)
+{
+  uint i;
+
+  for (; bucket; bucket= my_atomic_loadptr((void **) &bucket->next))
+  {
+    for (i= 0; i < LF_BUCKET_SLOTS; i++)
+    {
+      LF_SLIST *node= my_atomic_loadptr((void **) &bucket->node[i]);
+      if (!node)
+        continue;
+      lf_pin(pins, 2, node);
+      if (my_atomic_loadptr((void **) &bucket->node[i]) != node)
+        continue;                       /* deleted or moved meanwhile */
+      if (action(node + 1, argument))
+        return 1;
+    }
+  }
+  return 0;
+}
+
+
+/*
+  NOTE
+    if the table is replaced during the iteration, it is restarted,
+    and elements that are moved to the new table meanwhile can be seen
+    twice, so 'action' might see some elements twice
+*/
+
+static int lfb_iterate(LF_HASH *hash, LF_PINS *pins,
+                       my_hash_walk_action action, void *argument)
+{
+  LF_HASH_TABLE *table, *old;
+  uint i;
+  int res= 0;
+
+  if (unlikely(!hash->table))
+    return 0;
+retry:
+  table= lfb_pin_tables(hash, pins, &old);
+  for (i= 0; old && i <= old->mask; i++)
+    if ((res= lfb_iterate_chain(old->buckets + i, pins, action, argument)))
+      goto end;
+  for (i= 0; i <= table->mask; i++)
+    if ((res= lfb_iterate_chain(table->buckets + i, pins, action, argument)))
+      goto end;
+  if (my_atomic_loadptr((void **) &hash->table) != table)
+    goto retry;
+end:
+  lfb_unpin_tables(pins);
+  lf_unpin(pins, 2);
+  return res;
+}
@@ -49,9 +49,9 @@
 */
 
 #include "mysys_priv.h"
+#include "mysys_err.h"
 #include <m_string.h>
 #ifdef HAVE_AIOWAIT
-#include "mysys_err.h"
 static void my_aiowait(my_aio_result *result);
 #endif
 #include <errno.h>
@@ -69,6 +69,9 @@ static int _my_b_cache_read_r(IO_CACHE *info, uchar *Buffer, size_t Count);
 static int _my_b_seq_read(IO_CACHE *info, uchar *Buffer, size_t Count);
 static int _my_b_cache_write(IO_CACHE *info, const uchar *Buffer, size_t Count);
 static int _my_b_cache_write_r(IO_CACHE *info, const uchar *Buffer, size_t Count);
+static int _my_b_cache_read_ahead(IO_CACHE *info, uchar *Buffer, size_t Count);
+static int my_b_write_behind(IO_CACHE *info);
+static int io_cache_async_flush(IO_CACHE *info);
 
 int (*_my_b_encr_read)(IO_CACHE *info,uchar *Buffer,size_t Count)= 0;
 int (*_my_b_encr_write)(IO_CACHE *info,const uchar *Buffer,size_t Count)= 0;
@@ -113,7 +116,9 @@ init_functions(IO_CACHE* info)
     /* fall through */
   case READ_FIFO:
     DBUG_ASSERT(!(info->myflags & MY_ENCRYPT));
-    info->read_function = info->share ? _my_b_cache_read_r : _my_b_cache_read;
+    info->read_function = (info->share ? _my_b_cache_read_r :
+                           info->async ? _my_b_cache_read_ahead :
+                           _my_b_cache_read);
     info->write_function = info->share ? _my_b_cache_write_r : _my_b_cache_write;
     break;
   case TYPE_NOT_SET:
@@ -141,6 +146,13 @@ init_functions(IO_CACHE* info)
 			MY_WME | MY_FAE | MY_NABP | MY_FNABP |
 			MY_DONT_CHECK_FILESIZE
 
+  NOTES
+    With MY_ASYNC_IO in cache_myflags, a READ_CACHE or WRITE_CACHE reads
+    ahead or writes behind in the io_cache_async threads, if
+    init_io_cache_async() has started them. The file must not grow or be
+    written by others while it is read this way, and the cache must not
+    be copied by value (see mf_iocache_async.c).
+
   RETURN
     0  ok
     #  error
@@ -164,6 +176,7 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
   info->buffer=0;
   info->seek_not_done= 0;
   info->next_file_user= NULL;
+  info->async= 0;
 
   if (file >= 0)
   {
@@ -285,6 +298,12 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
   info->end_of_file= end_of_file;
   info->error=0;
   info->type= type;
+#ifndef HAVE_AIOWAIT
+  if ((cache_myflags & MY_ASYNC_IO) && ! my_disable_async_io &&
+      (type == READ_CACHE || type == WRITE_CACHE) &&
+      !(cache_myflags & MY_ENCRYPT) && !io_cache_async_init(info))
+    DBUG_PRINT("info",("Using async io"));
+#endif
   init_functions(info);
 #ifdef HAVE_AIOWAIT
   if (use_async_io && ! my_disable_async_io)
@@ -325,6 +344,7 @@ int init_slave_io_cache(IO_CACHE *master, IO_CACHE *slave)
     return 1;
   }
   memcpy(slave, master, sizeof(IO_CACHE));
+  slave->async= 0;
   slave->buffer= slave_buf;
 
   memcpy(slave->buffer, master->buffer, master->buffer_length);
@@ -429,11 +449,13 @@ static void my_aiowait(my_aio_result *result)
   between READ_CACHE <-> WRITE_CACHE
   If we are doing a reinit of a cache where we have the start of the file
   in the cache, we are reusing this memory without flushing it to disk.
+  use_async_io turns read-ahead or write-behind on for the new type, if
+  the cache was opened with MY_ASYNC_IO.
 */
 
 my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
 			my_off_t seek_offset,
-			my_bool use_async_io __attribute__((unused)),
+			my_bool use_async_io,
 			my_bool clear_cache)
 {
   DBUG_ENTER("reinit_io_cache");
@@ -444,6 +466,10 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   DBUG_ASSERT(type == READ_CACHE || type == WRITE_CACHE);
   DBUG_ASSERT(info->type == READ_CACHE || info->type == WRITE_CACHE);
 
+  /* Finish the read-ahead or write-behind of the old type */
+  if (info->async && io_cache_async_flush(info))
+    DBUG_RETURN(1);
+
   /* If the whole file is in memory, avoid flushing to disk */
   if (! clear_cache &&
       seek_offset >= info->pos_in_file &&
@@ -521,6 +547,17 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   }
   info->type=type;
   info->error=0;
+#ifndef HAVE_AIOWAIT
+  if (use_async_io && (info->myflags & MY_ASYNC_IO) &&
+      ! my_disable_async_io &&
+      !(info->myflags & MY_ENCRYPT) && !info->share &&
+      (type == WRITE_CACHE ||
+       (ulong) info->buffer_length <
+       (ulong) (info->end_of_file - seek_offset)))
+    (void) io_cache_async_init(info);
+  else
+    io_cache_async_end(info);
+#endif
   init_functions(info);
 
 #ifdef HAVE_AIOWAIT
@@ -578,7 +615,7 @@ int _my_b_write(IO_CACHE *info, const uchar *Buffer, size_t Count)
   Count-=rest_length;
   info->write_pos+=rest_length;
 
-  if (my_b_flush_io_cache(info, 1))
+  if (info->async ? my_b_write_behind(info) : my_b_flush_io_cache(info, 1))
     return 1;
 
   if (Count)
@@ -793,6 +830,164 @@ int _my_b_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count)
 }
 
 
+/*
+  Start reading the block after the buffer in the io_cache_async threads
+*/
+
+static void io_cache_read_ahead(IO_CACHE *info)
+{
+  my_off_t pos_in_file;
+  size_t length;
+
+  if (info->read_end == info->buffer)
+    return;                                     /* EOF or nothing read */
+  pos_in_file= info->pos_in_file + (size_t) (info->read_end - info->buffer);
+  if (pos_in_file >= info->end_of_file)
+    return;
+  length= info->read_length - (size_t) (pos_in_file & (IO_SIZE-1));
+  if (length > info->end_of_file - pos_in_file)
+    length= (size_t) (info->end_of_file - pos_in_file);
+  io_cache_async_start(info->async, 0, info->file, pos_in_file, length,
+                       info->myflags);
+}
+
+
+/*
+  Read buffered, with read-ahead
+
+  SYNOPSIS
+    _my_b_cache_read_ahead()
+      info                      IO_CACHE pointer
+      Buffer                    Buffer to retrieve count bytes from file
+      Count                     Number of bytes to read into Buffer
+
+  NOTES
+    If the block that was read ahead starts where the buffer ends, the
+    buffers are swapped and the read of the next block is started.
+    Otherwise, for example after a seek or a failed read-ahead,
+    _my_b_cache_read() reads the block and the read-ahead starts after it.
+
+  RETURN
+    As for _my_b_cache_read()
+*/
+
+static int _my_b_cache_read_ahead(IO_CACHE *info, uchar *Buffer, size_t Count)
+{
+  IO_CACHE_ASYNC *req= info->async;
+  size_t left_length= 0;
+  int res;
+  DBUG_ENTER("_my_b_cache_read_ahead");
+
+  while (req->pending &&
+         req->pos == info->pos_in_file + (size_t) (info->read_end -
+                                                  info->buffer))
+  {
+    size_t length, copy;
+    uchar *buffer;
+
+    if ((length= io_cache_async_wait(req)) == (size_t) -1 || !length)
+      break;                              /* Let _my_b_cache_read() retry */
+    buffer= req->buffer;
+    req->buffer= info->buffer;
+    info->pos_in_file= req->pos;
+    info->buffer= info->write_buffer= info->request_pos= buffer;
+    info->read_end= buffer + length;
+    copy= MY_MIN(length, Count);
+    if (copy)
+      memcpy(Buffer, buffer, copy);
+    info->read_pos= buffer + copy;
+    /* The file position is not after the buffer any more */
+    info->seek_not_done= 1;
+    io_cache_read_ahead(info);
+    Buffer+= copy;
+    Count-= copy;
+    left_length+= copy;
+    if (!Count)
+      DBUG_RETURN(0);
+  }
+
+  io_cache_async_wait(req);
+  if ((res= _my_b_cache_read(info, Buffer, Count)))
+  {
+    if (info->error >= 0)
+      info->error+= (int) left_length;
+  }
+  else
+    io_cache_read_ahead(info);
+  DBUG_RETURN(res);
+}
+
+
+/*
+  Write a full buffer in the io_cache_async threads
+
+  SYNOPSIS
+    my_b_write_behind()
+      info                      IO_CACHE pointer, a WRITE_CACHE
+
+  NOTES
+    This is done instead of my_b_flush_io_cache() when my_b_write()
+    fills the buffer. The cache continues in the second buffer; the
+    write that was started before is waited for first.
+
+  RETURN
+    0  ok
+    1  the previous write failed, or the file could not be created
+*/
+
+static int my_b_write_behind(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *req= info->async;
+  size_t length= (size_t) (info->write_pos - info->write_buffer);
+  uchar *buffer;
+
+  DBUG_ASSERT(info->type == WRITE_CACHE && info->buffer == info->write_buffer);
+  if (info->file == -1 && real_open_cached_file(info))
+    return info->error= -1;
+  if (io_cache_async_flush(info))
+    return 1;
+
+  buffer= req->buffer;
+  req->buffer= info->write_buffer;
+  io_cache_async_start(req, 1, info->file, info->pos_in_file, length,
+                       info->myflags);
+  info->buffer= info->write_buffer= info->request_pos= info->read_pos= buffer;
+  info->pos_in_file+= length;
+  set_if_bigger(info->end_of_file, info->pos_in_file);
+  /* Writes of the caller must seek past the data of the request */
+  info->seek_not_done= 1;
+  info->write_end= (info->write_buffer + info->buffer_length -
+                    (info->pos_in_file & (IO_SIZE - 1)));
+  info->write_pos= info->write_buffer;
+  ++info->disk_writes;
+  return 0;
+}
+
+
+/*
+  Wait for the read-ahead or write-behind of a cache
+
+  RETURN
+    0  ok
+    1  the write failed, info->error is set to -1
+*/
+
+static int io_cache_async_flush(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *req= info->async;
+  my_bool write= req->write && req->pending;
+
+  if (io_cache_async_wait(req) == (size_t) -1 && write)
+  {
+    if (info->myflags & MY_WME)
+      my_error(EE_WRITE, MYF(ME_BELL), my_filename(info->file), my_errno);
+    info->error= -1;
+    return 1;
+  }
+  return 0;
+}
+
+
 /*
   Prepare IO_CACHE for shared use.
 
@@ -1848,6 +2043,10 @@ int my_block_write(IO_CACHE *info, const uchar *Buffer, size_t Count,
   DBUG_ASSERT(!info->share);
   DBUG_ASSERT(!(info->myflags & MY_ENCRYPT));
 
+  /* The write-behind may be writing the part before the buffer */
+  if (info->async && io_cache_async_flush(info))
+    return info->error;
+
   if (pos < info->pos_in_file)
   {
     /* Of no overlap, write everything without buffering */
@@ -1904,6 +2103,9 @@ int my_b_flush_io_cache(IO_CACHE *info, int need_append_buffer_lock)
   if (!append_cache)
     need_append_buffer_lock= 0;
 
+  if (info->async && io_cache_async_flush(info))
+    DBUG_RETURN(info->error);
+
   if (info->type == WRITE_CACHE || append_cache)
   {
     if (info->file == -1)
@@ -1990,6 +2192,7 @@ int end_io_cache(IO_CACHE *info)
     info->alloced_buffer=0;
     if (info->file != -1)			/* File doesn't exist */
       error= my_b_flush_io_cache(info,1);
+    io_cache_async_end(info);
     my_free(info->buffer);
     info->buffer=info->read_pos=(uchar*) 0;
   }
@@ -0,0 +1,281 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Background I/O for IO_CACHE
+
+  An IO_CACHE that is opened with MY_ASYNC_IO gets a second buffer of
+  the same size. A READ_CACHE reads the block after the current one
+  into it, and a WRITE_CACHE hands its full buffer over to be written
+  while it continues in the other one (see mf_iocache.c). The reads and
+  writes are done with my_pread() and my_pwrite() by a pool of threads
+  that is started with init_io_cache_async(). If the pool is not started,
+  MY_ASYNC_IO is ignored.
+
+  As the buffers are swapped, such a cache must not be copied by value
+  unless the original is not used any more: the copy and the original
+  would share the second buffer, and end_io_cache() of both would free
+  it. The MyISAM and Aria repair code makes such copies of its caches,
+  which is why the use_async_io argument of init_io_cache(), that most
+  callers give, is not enough.
+
+  my_io_cache_async_reads and my_io_cache_async_writes count the
+  requests that the threads have done.
+
+  A cache has at most one request at a time, so the requests of all
+  caches are kept in one FIFO queue protected by LOCK_io_cache_async.
+*/
+
+#include "mysys_priv.h"
+
+static my_bool io_cache_async_inited= 0;
+static mysql_mutex_t LOCK_io_cache_async;
+static mysql_cond_t COND_io_cache_async_queue, COND_io_cache_async_done;
+static IO_CACHE_ASYNC *queue_first, **queue_last;
+static pthread_t *io_threads;
+static uint io_thread_count;
+
+static void *io_cache_async_handler(void *arg __attribute__((unused)));
+
+
+/**
+  Start the I/O threads
+
+  @param threads	Number of threads, 0 to not use background I/O
+
+  @return 0 ok
+  @return 1 error; Can't create thread
+*/
+
+my_bool init_io_cache_async(uint threads)
+{
+  pthread_attr_t thr_attr;
+  my_bool res= 0;
+  DBUG_ENTER("init_io_cache_async");
+
+  if (!threads || io_cache_async_inited)
+    DBUG_RETURN(0);
+  if (!(io_threads= (pthread_t*) my_malloc(threads * sizeof(pthread_t),
+                                           MYF(MY_WME))))
+    DBUG_RETURN(1);
+  mysql_mutex_init(key_LOCK_io_cache_async, &LOCK_io_cache_async,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_io_cache_async_queue, &COND_io_cache_async_queue,
+                  NULL);
+  mysql_cond_init(key_COND_io_cache_async_done, &COND_io_cache_async_done,
+                  NULL);
+  queue_first= 0;
+  queue_last= &queue_first;
+
+  pthread_attr_init(&thr_attr);
+  pthread_attr_setscope(&thr_attr, PTHREAD_SCOPE_SYSTEM);
+  io_cache_async_inited= 1;
+  for (io_thread_count= 0; io_thread_count < threads; io_thread_count++)
+  {
+    if (mysql_thread_create(key_thread_io_cache_async,
+                            io_threads + io_thread_count, &thr_attr,
+                            io_cache_async_handler, NULL))
+    {
+      res= 1;
+      break;
+    }
+  }
+  pthread_attr_destroy(&thr_attr);
+  if (res)
+    end_io_cache_async();
+  DBUG_RETURN(res);
+}
+
+
+/*
+  Stop the I/O threads
+
+  NOTES
+    All IO_CACHE that use background I/O must be ended before this
+*/
+
+void end_io_cache_async(void)
+{
+  uint i;
+  DBUG_ENTER("end_io_cache_async");
+
+  if (!io_cache_async_inited)
+    DBUG_VOID_RETURN;
+
+  mysql_mutex_lock(&LOCK_io_cache_async);
+  io_cache_async_inited= 0;                     /* Signal abort */
+  mysql_cond_broadcast(&COND_io_cache_async_queue);
+  mysql_mutex_unlock(&LOCK_io_cache_async);
+  for (i= 0; i < io_thread_count; i++)
+    pthread_join(io_threads[i], NULL);
+
+  mysql_mutex_destroy(&LOCK_io_cache_async);
+  mysql_cond_destroy(&COND_io_cache_async_queue);
+  mysql_cond_destroy(&COND_io_cache_async_done);
+  my_free(io_threads);
+  io_threads= 0;
+  io_thread_count= 0;
+  DBUG_VOID_RETURN;
+}
+
+
+static void *io_cache_async_handler(void *arg __attribute__((unused)))
+{
+  my_thread_init();
+  mysql_mutex_lock(&LOCK_io_cache_async);
+  for (;;)
+  {
+    IO_CACHE_ASYNC *req;
+    size_t result;
+    int error= 0;
+
+    while (!queue_first && io_cache_async_inited)
+      mysql_cond_wait(&COND_io_cache_async_queue, &LOCK_io_cache_async);
+    if (!(req= queue_first))
+      break;                                    /* Shutdown */
+    if (!(queue_first= req->next))
+      queue_last= &queue_first;
+    mysql_mutex_unlock(&LOCK_io_cache_async);
+
+    if (req->write)
+      result= mysql_file_pwrite(req->file, req->buffer, req->length, req->pos,
+                                req->flags | MY_NABP) ? (size_t) -1 :
+              req->length;
+    else
+      result= mysql_file_pread(req->file, req->buffer, req->length, req->pos,
+                               req->flags);
+    if (result == (size_t) -1)
+      error= my_errno;
+
+    mysql_mutex_lock(&LOCK_io_cache_async);
+    if (req->write)
+      my_io_cache_async_writes++;
+    else
+      my_io_cache_async_reads++;
+    req->result= result;
+    req->error= error;
+    req->done= 1;
+    mysql_cond_broadcast(&COND_io_cache_async_done);
+  }
+  mysql_mutex_unlock(&LOCK_io_cache_async);
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+
+/*
+  Allocate the second buffer of an IO_CACHE
+
+  RETURN
+    0  ok, info->async is set
+    1  background I/O is not used
+*/
+
+my_bool io_cache_async_init(IO_CACHE *info)
+{
+  IO_CACHE_ASYNC *req;
+
+  if (!io_cache_async_inited)
+    return 1;
+  if (info->async)
+    return 0;
+  if (!(req= (IO_CACHE_ASYNC*) my_malloc(sizeof(*req),
+                                         MYF(MY_ZEROFILL |
+                                             (info->myflags &
+                                              MY_THREAD_SPECIFIC)))))
+    return 1;
+  /* A separate block, as the buffers are swapped with info->buffer */
+  if (!(req->buffer= (uchar*) my_malloc(info->buffer_length,
+                                        MYF(info->myflags &
+                                            MY_THREAD_SPECIFIC))))
+  {
+    my_free(req);
+    return 1;
+  }
+  info->async= req;
+  return 0;
+}
+
+
+/*
+  Free the second buffer of an IO_CACHE
+
+  NOTES
+    A pending request is waited for and its result is ignored
+*/
+
+void io_cache_async_end(IO_CACHE *info)
+{
+  if (!info->async)
+    return;
+  io_cache_async_wait(info->async);
+  my_free(info->async->buffer);
+  my_free(info->async);
+  info->async= 0;
+}
+
+
+/*
+  Queue a read into or a write from req->buffer
+
+  NOTES
+    The caller must wait for the request before starting another one.
+    MY_WME is not given to the I/O thread, errors are reported by the
+    caller after io_cache_async_wait().
+*/
+
+void io_cache_async_start(IO_CACHE_ASYNC *req, my_bool write, File file,
+                          my_off_t pos, size_t length, myf flags)
+{
+  DBUG_ASSERT(!req->pending);
+  req->write= write;
+  req->file= file;
+  req->pos= pos;
+  req->length= length;
+  req->flags= flags & ~(MY_WME | MY_NABP | MY_FNABP);
+  req->pending= 1;
+  req->done= 0;
+  req->next= 0;
+
+  mysql_mutex_lock(&LOCK_io_cache_async);
+  *queue_last= req;
+  queue_last= &req->next;
+  mysql_cond_signal(&COND_io_cache_async_queue);
+  mysql_mutex_unlock(&LOCK_io_cache_async);
+}
+
+
+/*
+  Wait until a request is done
+
+  RETURN
+    Number of bytes read or written by the request, 0 if there was no
+    request, or (size_t) -1 on error, with my_errno set
+*/
+
+size_t io_cache_async_wait(IO_CACHE_ASYNC *req)
+{
+  if (!req->pending)
+    return 0;
+  mysql_mutex_lock(&LOCK_io_cache_async);
+  while (!req->done)
+    mysql_cond_wait(&COND_io_cache_async_done, &LOCK_io_cache_async);
+  mysql_mutex_unlock(&LOCK_io_cache_async);
+  req->pending= 0;
+  if (req->result == (size_t) -1)
+    my_errno= req->error;
+  return req->result;
+}
@@ -19,6 +19,8 @@
 #include <my_global.h>
 #include <my_sys.h>
 #include <m_string.h>
+#include <my_atomic.h>
+#include "mysys_priv.h"
 #undef EXTRA_DEBUG
 #define EXTRA_DEBUG
 
@@ -28,6 +30,248 @@
 
 #define TRASH_MEM(X) TRASH_FREE(((char*)(X) + ((X)->size-(X)->left)), (X)->left)
 
+/*
+  Per thread pool of free MEM_ROOT blocks
+
+  Blocks of alloc_root() that are at most MEM_ROOT_POOL_MAX_BLOCK bytes
+  are rounded up to a power of two (a size class). When such a block is
+  freed it is put in the pool of the thread instead of being given back
+  to malloc, and the next alloc_root() of the same class takes it from
+  there. This avoids most malloc() and free() calls for roots that are
+  created and freed for every statement.
+
+  The pool lives in st_my_thread_var, so with the thread pool it follows
+  the connection. Blocks in the pool are always accounted as system
+  memory, so that the memory usage of a connection is not changed by
+  the pool.
+
+  The pool is limited to my_mem_root_pool_size bytes (0 disables it).
+  mem_root_pool_trim() is called between statements; it keeps only as
+  many bytes as the roots of the thread have used at most since the
+  previous call (the high water mark), so a single big statement does
+  not leave memory behind.
+*/
+
+#define MEM_ROOT_POOL_MIN_SHIFT 10
+#define MEM_ROOT_POOL_CLASSES   8
+#define MEM_ROOT_POOL_CLASS_SIZE(A) ((size_t) 1 << (MEM_ROOT_POOL_MIN_SHIFT+(A)))
+#define MEM_ROOT_POOL_MAX_BLOCK MEM_ROOT_POOL_CLASS_SIZE(MEM_ROOT_POOL_CLASSES-1)
+
+typedef struct st_mem_root_pool
+{
+  USED_MEM *blocks[MEM_ROOT_POOL_CLASSES];      /* Free blocks per class */
+  size_t size;                                  /* Bytes in blocks[] */
+  size_t in_use;                /* Bytes of class blocks used by roots */
+  size_t high_water;            /* Max in_use since last trim */
+  ulonglong hits, misses, trims;
+} MEM_ROOT_POOL;
+
+ulong my_mem_root_pool_size= 0;
+int64 my_mem_root_pool_hits= 0, my_mem_root_pool_misses= 0;
+int64 my_mem_root_pool_trims= 0;
+
+#if !(defined(HAVE_valgrind) && defined(EXTRA_DEBUG))
+
+/* Return size class for a block of 'size' bytes, or -1 if none */
+
+static inline int mem_root_pool_class(size_t size)
+{
+  int cls= 0;
+  if (size > MEM_ROOT_POOL_MAX_BLOCK)
+    return -1;
+  while (MEM_ROOT_POOL_CLASS_SIZE(cls) < size)
+    cls++;
+  return cls;
+}
+
+
+static MEM_ROOT_POOL *get_mem_root_pool(my_bool create)
+{
+  struct st_my_thread_var *thread_var= my_thread_var;
+  if (!thread_var)
+    return 0;
+  if (!thread_var->mem_root_pool && create)
+    thread_var->mem_root_pool= my_malloc(sizeof(MEM_ROOT_POOL),
+                                         MYF(MY_ZEROFILL));
+  return (MEM_ROOT_POOL*) thread_var->mem_root_pool;
+}
+
+
+/*
+  Allocate a new block for a memory root
+
+  SYNOPSIS
+    get_root_block()
+    size                Wanted size of block. Is rounded up to the size
+                        class of the block if the pool is used
+    flags               MY_THREAD_SPECIFIC or 0
+
+  RETURN
+    Block or 0 if out of memory
+*/
+
+static USED_MEM *get_root_block(size_t *size, myf flags)
+{
+  MEM_ROOT_POOL *pool;
+  USED_MEM *block;
+  int cls;
+
+  if (!my_mem_root_pool_size || (cls= mem_root_pool_class(*size)) < 0 ||
+      !(pool= get_mem_root_pool(1)))
+    return (USED_MEM*) my_malloc(*size, MYF(MY_WME | ME_FATALERROR | flags));
+
+  *size= MEM_ROOT_POOL_CLASS_SIZE(cls);
+  if ((block= pool->blocks[cls]))
+  {
+    pool->blocks[cls]= block->next;
+    pool->size-= *size;
+    pool->hits++;
+    /* Move block from system memory to the memory of the thread */
+    if ((flags & MY_THREAD_SPECIFIC) &&
+        !(block= (USED_MEM*) my_realloc(block, *size,
+                                        MYF(MY_WME | ME_FATALERROR |
+                                            MY_THREAD_SPECIFIC |
+                                            MY_THREAD_MOVE |
+                                            MY_FREE_ON_ERROR))))
+      return 0;
+  }
+  else
+  {
+    pool->misses++;
+    if (!(block= (USED_MEM*) my_malloc(*size, MYF(MY_WME | ME_FATALERROR |
+                                                   flags))))
+      return 0;
+  }
+  pool->in_use+= *size;
+  set_if_bigger(pool->high_water, pool->in_use);
+  return block;
+}
+
+
+/*
+  Free a block of a memory root
+
+  NOTES
+    The block is put in the pool of the thread if it has the size of
+    a size class and the pool is not full.
+*/
+
+static void free_root_block(USED_MEM *block)
+{
+  MEM_ROOT_POOL *pool;
+  size_t size= block->size;
+  int cls;
+
+  if ((cls= mem_root_pool_class(size)) < 0 ||
+      MEM_ROOT_POOL_CLASS_SIZE(cls) != size ||
+      !(pool= get_mem_root_pool(0)))
+  {
+    my_free(block);
+    return;
+  }
+  pool->in_use-= MY_MIN(pool->in_use, size);
+  if (pool->size + size > my_mem_root_pool_size)
+  {
+    my_free(block);
+    return;
+  }
+  /* Move block to system memory; realloc to same size does not copy */
+  if (!(block= (USED_MEM*) my_realloc(block, size,
+                                      MYF(MY_THREAD_MOVE | MY_FREE_ON_ERROR))))
+    return;
+  block->next= pool->blocks[cls];
+  pool->blocks[cls]= block;
+  pool->size+= size;
+}
+
+
+/*
+  Give back memory from the pool of the thread
+
+  SYNOPSIS
+    mem_root_pool_trim()
+
+  NOTES
+    Called between statements. Keeps as many bytes as the roots of the
+    thread used at most since the last call, but not more than
+    my_mem_root_pool_size. The biggest blocks are freed first.
+    The counters of the thread are also added to the global counters.
+*/
+
+void mem_root_pool_trim()
+{
+  MEM_ROOT_POOL *pool;
+  size_t keep;
+  int cls;
+
+  if (!(pool= get_mem_root_pool(0)))
+    return;
+
+  keep= MY_MIN(pool->high_water - MY_MIN(pool->high_water, pool->in_use),
+               my_mem_root_pool_size);
+  for (cls= MEM_ROOT_POOL_CLASSES-1; cls >= 0 && pool->size > keep; cls--)
+  {
+    USED_MEM *block;
+    while ((block= pool->blocks[cls]) && pool->size > keep)
+    {
+      pool->blocks[cls]= block->next;
+      pool->size-= MEM_ROOT_POOL_CLASS_SIZE(cls);
+      pool->trims++;
+      my_free(block);
+    }
+  }
+  pool->high_water= pool->in_use;
+
+  if (pool->hits)
+    my_atomic_add64_explicit(&my_mem_root_pool_hits, pool->hits,
+                             MY_MEMORY_ORDER_RELAXED);
+  if (pool->misses)
+    my_atomic_add64_explicit(&my_mem_root_pool_misses, pool->misses,
+                             MY_MEMORY_ORDER_RELAXED);
+  if (pool->trims)
+    my_atomic_add64_explicit(&my_mem_root_pool_trims, pool->trims,
+                             MY_MEMORY_ORDER_RELAXED);
+  pool->hits= pool->misses= pool->trims= 0;
+}
+
+#else /* HAVE_valgrind && EXTRA_DEBUG */
+
+static void free_root_block(USED_MEM *block)
+{
+  my_free(block);
+}
+
+void mem_root_pool_trim()
+{
+}
+
+#endif
+
+
+/*
+  Free the pool of a thread. Called by my_thread_end()
+*/
+
+void mem_root_pool_end(struct st_my_thread_var *thread_var)
+{
+  MEM_ROOT_POOL *pool= (MEM_ROOT_POOL*) thread_var->mem_root_pool;
+  uint cls;
+
+  if (!pool)
+    return;
+  for (cls= 0; cls < MEM_ROOT_POOL_CLASSES; cls++)
+  {
+    USED_MEM *block, *next;
+    for (block= pool->blocks[cls]; block; block= next)
+    {
+      next= block->next;
+      my_free(block);
+    }
+  }
+  my_free(pool);
+  thread_var->mem_root_pool= 0;
+}
+
 /*
   Initialize memory root
 
@@ -137,7 +381,7 @@ void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
         {
           /* remove block from the list and free it */
           *prev= mem->next;
-          my_free(mem);
+          free_root_block(mem);
         }
         else
           prev= &mem->next;
@@ -238,10 +482,8 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
     get_size= length+ALIGN_SIZE(sizeof(USED_MEM));
     get_size= MY_MAX(get_size, block_size);
 
-    if (!(next = (USED_MEM*) my_malloc(get_size,
-                                       MYF(MY_WME | ME_FATALERROR |
-                                           MALLOC_FLAG(mem_root->
-                                                       block_size)))))
+    if (!(next= get_root_block(&get_size,
+                               MALLOC_FLAG(mem_root->block_size))))
     {
       if (mem_root->error_handler)
 	(*mem_root->error_handler)();
@@ -389,13 +631,13 @@ void free_root(MEM_ROOT *root, myf MyFlags)
   {
     old=next; next= next->next ;
     if (old != root->pre_alloc)
-      my_free(old);
+      free_root_block(old);
   }
   for (next=root->free ; next ;)
   {
     old=next; next= next->next;
     if (old != root->pre_alloc)
-      my_free(old);
+      free_root_block(old);
   }
   root->used=root->free=0;
   if (root->pre_alloc)
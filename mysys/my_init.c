@@ -457,7 +457,8 @@ PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
   key_THR_LOCK_open, key_THR_LOCK_threads,
-  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_uuid_generator;
+  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_uuid_generator,
+  key_LOCK_io_cache_async;
 
 static PSI_mutex_info all_mysys_mutexes[]=
 {
@@ -485,12 +486,14 @@ static PSI_mutex_info all_mysys_mutexes[]=
   { &key_THR_LOCK_threads, "THR_LOCK_threads", PSI_FLAG_GLOBAL},
   { &key_TMPDIR_mutex, "TMPDIR_mutex", PSI_FLAG_GLOBAL},
   { &key_THR_LOCK_myisam_mmap, "THR_LOCK_myisam_mmap", PSI_FLAG_GLOBAL},
-  { &key_LOCK_uuid_generator, "LOCK_uuid_generator", PSI_FLAG_GLOBAL }
+  { &key_LOCK_uuid_generator, "LOCK_uuid_generator", PSI_FLAG_GLOBAL },
+  { &key_LOCK_io_cache_async, "LOCK_io_cache_async", PSI_FLAG_GLOBAL}
 };
 
 PSI_cond_key key_COND_alarm, key_COND_timer, key_IO_CACHE_SHARE_cond,
   key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
-  key_THR_COND_threads, key_WT_RESOURCE_cond;
+  key_THR_COND_threads, key_WT_RESOURCE_cond, key_COND_io_cache_async_queue,
+  key_COND_io_cache_async_done;
 
 static PSI_cond_info all_mysys_conds[]=
 {
@@ -500,7 +503,11 @@ static PSI_cond_info all_mysys_conds[]=
   { &key_IO_CACHE_SHARE_cond_writer, "IO_CACHE_SHARE::cond_writer", 0},
   { &key_my_thread_var_suspend, "my_thread_var::suspend", 0},
   { &key_THR_COND_threads, "THR_COND_threads", PSI_FLAG_GLOBAL},
-  { &key_WT_RESOURCE_cond, "WT_RESOURCE::cond", 0}
+  { &key_WT_RESOURCE_cond, "WT_RESOURCE::cond", 0},
+  { &key_COND_io_cache_async_queue, "COND_io_cache_async_queue",
+    PSI_FLAG_GLOBAL},
+  { &key_COND_io_cache_async_done, "COND_io_cache_async_done",
+    PSI_FLAG_GLOBAL}
 };
 
 PSI_rwlock_key key_SAFEHASH_mutex;
@@ -513,14 +520,15 @@ static PSI_rwlock_info all_mysys_rwlocks[]=
 #ifdef USE_ALARM_THREAD
 PSI_thread_key key_thread_alarm;
 #endif
-PSI_thread_key key_thread_timer;
+PSI_thread_key key_thread_timer, key_thread_io_cache_async;
 
 static PSI_thread_info all_mysys_threads[]=
 {
 #ifdef USE_ALARM_THREAD
   { &key_thread_alarm, "alarm", PSI_FLAG_GLOBAL},
 #endif
-  { &key_thread_timer, "statement_timer", PSI_FLAG_GLOBAL}
+  { &key_thread_timer, "statement_timer", PSI_FLAG_GLOBAL},
+  { &key_thread_io_cache_async, "io_cache_async", PSI_FLAG_GLOBAL}
 };
 
 
@@ -33,6 +33,7 @@ char		curr_dir[FN_REFLEN]= {0},
 		home_dir_buff[FN_REFLEN]= {0};
 ulong		my_stream_opened=0,my_file_opened=0, my_tmp_file_created=0;
 ulong           my_file_total_opened= 0;
+ulong           my_io_cache_async_reads= 0, my_io_cache_async_writes= 0;
 int		my_umask=0664, my_umask_dir=0777;
 
 myf             my_global_flags= 0;
@@ -369,6 +369,7 @@ void my_thread_end(void)
       tmp->dbug=0;
     }
 #endif
+    mem_root_pool_end(tmp);
     my_thread_destory_thr_mutex(tmp);
 
     /*
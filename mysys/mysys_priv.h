@@ -48,16 +48,18 @@ extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
   key_THR_LOCK_open, key_THR_LOCK_threads, key_LOCK_uuid_generator,
-  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_timer;
+  key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_timer,
+  key_LOCK_io_cache_async;
 
 extern PSI_cond_key key_COND_alarm, key_COND_timer, key_IO_CACHE_SHARE_cond,
   key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
-  key_THR_COND_threads;
+  key_THR_COND_threads, key_COND_io_cache_async_queue,
+  key_COND_io_cache_async_done;
 
 #ifdef USE_ALARM_THREAD
 extern PSI_thread_key key_thread_alarm;
 #endif /* USE_ALARM_THREAD */
-extern PSI_thread_key key_thread_timer;
+extern PSI_thread_key key_thread_timer, key_thread_io_cache_async;
 extern PSI_rwlock_key key_SAFEHASH_mutex;
 
 #endif /* HAVE_PSI_INTERFACE */
@@ -87,6 +89,29 @@ typedef struct {
 extern int (*_my_b_encr_read)(IO_CACHE *info,uchar *Buffer,size_t Count);
 extern int (*_my_b_encr_write)(IO_CACHE *info,const uchar *Buffer,size_t Count);
 
+/*
+  A read-ahead or write-behind request of an IO_CACHE, done by
+  the threads of mf_iocache_async.c into or from the second buffer
+*/
+typedef struct st_io_cache_async {
+  struct st_io_cache_async *next;       /* in the queue of requests */
+  uchar *buffer;                        /* buffer_length bytes */
+  my_off_t pos;                         /* file position of the request */
+  size_t length, result;                /* result is (size_t) -1 on error */
+  File file;
+  myf flags;
+  int error;                            /* my_errno of a failed request */
+  my_bool write;
+  my_bool pending;                      /* started and not yet waited for */
+  my_bool done;                         /* set by the I/O thread */
+} IO_CACHE_ASYNC;
+
+my_bool io_cache_async_init(IO_CACHE *info);
+void io_cache_async_end(IO_CACHE *info);
+void io_cache_async_start(IO_CACHE_ASYNC *req, my_bool write, File file,
+                          my_off_t pos, size_t length, myf flags);
+size_t io_cache_async_wait(IO_CACHE_ASYNC *req);
+
 #ifdef SAFEMALLOC
 void *sf_malloc(size_t size, myf my_flags);
 void *sf_realloc(void *ptr, size_t size, myf my_flags);
@@ -107,6 +132,7 @@ size_t sf_malloc_usable_size(void *ptr, my_bool *is_thread_specific);
 #endif
 
 void my_error_unregister_all(void);
+void mem_root_pool_end(struct st_my_thread_var *thread_var);
 
 #ifndef O_PATH        /* not Linux */
 #if defined(O_SEARCH) /* Illumos */
@@ -44,6 +44,18 @@
   change address of data.
 
   Implemented by monty.
+
+  If MY_TREE_BTREE is given to init_tree(), the elements are instead
+  stored in the nodes of a B-tree. Each node is an array of up to
+  tree->btree_max_keys elements (TREE_ELEMENT followed by the key or the
+  key pointer, tree->btree_slot_size bytes each), so that a search
+  touches a few consecutive memory areas instead of one node per level
+  of a binary tree. Keys that are not stored in the element are
+  allocated separately from tree->mem_root.
+  Only init_tree(), tree_insert(), tree_search(), tree_walk(),
+  reset_tree() and delete_tree() can be used with such a tree. The
+  element returned by tree_insert() is only valid until the next insert.
+  MY_TREE_BTREE is ignored together with MY_TREE_WITH_DELETE.
 */
 
 /*
@@ -65,6 +77,17 @@
 #define RED		0
 #define DEFAULT_ALLOC_SIZE 8192
 #define DEFAULT_ALIGN_SIZE 8192
+#define BTREE_NODE_SIZE  1024               /* Wanted size of B-tree node */
+
+typedef struct st_tree_node
+{
+  uint keys;                                    /* Elements in node */
+  struct st_tree_node **child;                  /* 0 for leaf nodes */
+} TREE_NODE;
+
+#define BTREE_SLOT(tree,node,pos) \
+  ((TREE_ELEMENT*) ((uchar*) (node) + ALIGN_SIZE(sizeof(TREE_NODE)) + \
+                    (size_t) (pos) * (tree)->btree_slot_size))
 
 static void delete_tree_element(TREE *,TREE_ELEMENT *);
 static int tree_walk_left_root_right(TREE *,TREE_ELEMENT *,
@@ -76,6 +99,12 @@ static void right_rotate(TREE_ELEMENT **parent, TREE_ELEMENT *leaf);
 static void rb_insert(TREE *tree,TREE_ELEMENT ***parent,
 		      TREE_ELEMENT *leaf);
 static void rb_delete_fixup(TREE *tree,TREE_ELEMENT ***parent);
+static TREE_ELEMENT *btree_insert(TREE *tree, void *key, uint key_size,
+                                  void *custom_arg);
+static void *btree_search(TREE *tree, void *key, void *custom_arg);
+static int btree_walk(TREE *tree, TREE_NODE *node, tree_walk_action action,
+                      void *argument, TREE_WALK visit);
+static void btree_free_elements(TREE *tree, TREE_NODE *node);
 
 
 /* The actual code for handling binary trees */
@@ -108,8 +137,27 @@ void init_tree(TREE *tree, size_t default_alloc_size, size_t memory_limit,
   tree->null_element.left=tree->null_element.right=0;
   tree->my_flags= my_flags;
   tree->flag= 0;
-  if (!free_element && size >= 0 &&
-      ((uint) size <= sizeof(void*) || ((uint) size & (sizeof(void*)-1))))
+  tree->btree_root= 0;
+  tree->btree_max_keys= 0;
+  if ((my_flags & (MY_TREE_BTREE | MY_TREE_WITH_DELETE)) != MY_TREE_BTREE)
+    my_flags&= ~MY_TREE_BTREE;
+  if (my_flags & MY_TREE_BTREE)
+  {
+    /*
+      A B-tree node has room for elements of one size, so keys of variable
+      length (size == 0) are stored through a pointer. Other keys are
+      stored aligned in the element.
+    */
+    if (!free_element && size > 0)
+      tree->offset_to_key= ALIGN_SIZE(sizeof(TREE_ELEMENT));
+    else
+    {
+      tree->offset_to_key=0;		/* use key through pointer */
+      tree->size_of_element+=sizeof(void*);
+    }
+  }
+  else if (!free_element && size >= 0 &&
+           ((uint) size <= sizeof(void*) || ((uint) size & (sizeof(void*)-1))))
   {
     /*
       We know that the data doesn't have to be aligned (like if the key
@@ -133,6 +181,21 @@ void init_tree(TREE *tree, size_t default_alloc_size, size_t memory_limit,
     init_alloc_root(&tree->mem_root, default_alloc_size, 0, MYF(my_flags));
     tree->mem_root.min_malloc= sizeof(TREE_ELEMENT)+tree->size_of_element;
   }
+  if (my_flags & MY_TREE_BTREE)
+  {
+    /* Without offset_to_key only the key pointer is stored in the node */
+    tree->btree_slot_size= (tree->offset_to_key ?
+                            ALIGN_SIZE(tree->offset_to_key +
+                                       tree->size_of_element) :
+                            ALIGN_SIZE(sizeof(TREE_ELEMENT) + sizeof(void*)));
+    tree->btree_max_keys= ((BTREE_NODE_SIZE - ALIGN_SIZE(sizeof(TREE_NODE))) /
+                           tree->btree_slot_size);
+    /* Node splitting needs an odd number of elements, at least 3 */
+    if (tree->btree_max_keys < 3)
+      tree->btree_max_keys= 3;
+    else if (!(tree->btree_max_keys & 1))
+      tree->btree_max_keys--;
+  }
   DBUG_VOID_RETURN;
 }
 
@@ -151,7 +214,10 @@ static void free_tree(TREE *tree, myf free_flags)
       {
         if (tree->memory_limit)
           (*tree->free)(NULL, free_init, tree->custom_arg);
-	delete_tree_element(tree,tree->root);
+        if (tree->btree_max_keys)
+          btree_free_elements(tree, tree->btree_root);
+        else
+          delete_tree_element(tree,tree->root);
         if (tree->memory_limit)
           (*tree->free)(NULL, free_end, tree->custom_arg);
       }
@@ -159,6 +225,7 @@ static void free_tree(TREE *tree, myf free_flags)
     }
   }
   tree->root= &tree->null_element;
+  tree->btree_root= 0;
   tree->elements_in_tree=0;
   tree->allocated=0;
 
@@ -205,6 +272,9 @@ TREE_ELEMENT *tree_insert(TREE *tree, void *key, uint key_size,
   int cmp;
   TREE_ELEMENT *element,***parent;
 
+  if (tree->btree_max_keys)
+    return btree_insert(tree, key, key_size, custom_arg);
+
   parent= tree->parents;
   *parent = &tree->root; element= tree->root;
   for (;;)
@@ -344,6 +414,9 @@ void *tree_search(TREE *tree, void *key, void *custom_arg)
   int cmp;
   TREE_ELEMENT *element=tree->root;
 
+  if (tree->btree_max_keys)
+    return btree_search(tree, key, custom_arg);
+
   for (;;)
   {
     if (element == &tree->null_element)
@@ -367,6 +440,8 @@ void *tree_search_key(TREE *tree, const void *key,
   TREE_ELEMENT **last_left_step_parent= NULL, **last_right_step_parent= NULL;
   TREE_ELEMENT **last_equal_element= NULL;
 
+  DBUG_ASSERT(!tree->btree_max_keys);
+
 /* 
   TODO: support for HA_READ_KEY_OR_PREV, HA_READ_PREFIX flags if needed.
 */
@@ -443,6 +518,7 @@ void *tree_search_edge(TREE *tree, TREE_ELEMENT **parents,
 {
   TREE_ELEMENT *element= tree->root;
   
+  DBUG_ASSERT(!tree->btree_max_keys);
   *parents= &tree->null_element;
   while (element != &tree->null_element)
   {
@@ -459,6 +535,8 @@ void *tree_search_next(TREE *tree, TREE_ELEMENT ***last_pos, int l_offs,
 {
   TREE_ELEMENT *x= **last_pos;
   
+  DBUG_ASSERT(!tree->btree_max_keys);
+
   if (ELEMENT_CHILD(x, r_offs) != &tree->null_element)
   {
     x= ELEMENT_CHILD(x, r_offs);
@@ -494,6 +572,8 @@ ha_rows tree_record_pos(TREE *tree, const void *key,
   double left= 1;
   double right= tree->elements_in_tree;
 
+  DBUG_ASSERT(!tree->btree_max_keys);
+
   while (element != &tree->null_element)
   {
     if ((cmp= (*tree->compare)(custom_arg, ELEMENT_KEY(tree, element), 
@@ -535,6 +615,8 @@ ha_rows tree_record_pos(TREE *tree, const void *key,
 
 int tree_walk(TREE *tree, tree_walk_action action, void *argument, TREE_WALK visit)
 {
+  if (tree->btree_max_keys)
+    return btree_walk(tree, tree->btree_root, action, argument, visit);
   switch (visit) {
   case left_root_right:
     return tree_walk_left_root_right(tree,tree->root,action,argument);
@@ -577,6 +659,264 @@ static int tree_walk_right_root_left(TREE *tree, TREE_ELEMENT *element, tree_wal
 }
 
 
+	/* Functions for trees stored as a B-tree */
+
+static TREE_NODE *btree_new_node(TREE *tree, my_bool leaf)
+{
+  size_t length= (ALIGN_SIZE(sizeof(TREE_NODE)) +
+                  (size_t) tree->btree_max_keys * tree->btree_slot_size);
+  size_t alloc_size= length + (leaf ? 0 : (tree->btree_max_keys + 1) *
+                               sizeof(TREE_NODE*));
+  TREE_NODE *node;
+
+  if (!(node= (TREE_NODE*) alloc_root(&tree->mem_root, alloc_size)))
+    return 0;
+  node->keys= 0;
+  node->child= leaf ? 0 : (TREE_NODE**) ((uchar*) node + length);
+  tree->allocated+= alloc_size;
+  return node;
+}
+
+
+/*
+  Find position of key in a B-tree node
+
+  RETURN
+    1  key found at *pos
+    0  key not found, *pos is the first element bigger than key
+*/
+
+static my_bool btree_search_node(TREE *tree, TREE_NODE *node, const void *key,
+                                 void *custom_arg, uint *pos)
+{
+  uint low= 0, high= node->keys;
+
+  while (low < high)
+  {
+    uint mid= (low + high) / 2;
+    int cmp= (*tree->compare)(custom_arg,
+                              ELEMENT_KEY(tree, BTREE_SLOT(tree, node, mid)),
+                              key);
+    if (cmp == 0)
+    {
+      *pos= mid;
+      return 1;
+    }
+    if (cmp < 0)
+      low= mid + 1;
+    else
+      high= mid;
+  }
+  *pos= low;
+  return 0;
+}
+
+
+/*
+  Split the full child 'pos' of 'node' in two and move the middle element
+  of the child to node, which must not be full
+*/
+
+static my_bool btree_split_child(TREE *tree, TREE_NODE *node, uint pos)
+{
+  TREE_NODE *left= node->child[pos], *right;
+  uint half= tree->btree_max_keys / 2;          /* Elements in each half */
+  size_t slot_size= tree->btree_slot_size;
+
+  if (!(right= btree_new_node(tree, left->child == 0)))
+    return 1;
+  memcpy(BTREE_SLOT(tree, right, 0), BTREE_SLOT(tree, left, half + 1),
+         half * slot_size);
+  if (left->child)
+    memcpy(right->child, left->child + half + 1,
+           (half + 1) * sizeof(TREE_NODE*));
+  right->keys= left->keys= half;
+
+  memmove(BTREE_SLOT(tree, node, pos + 1), BTREE_SLOT(tree, node, pos),
+          (node->keys - pos) * slot_size);
+  memmove(node->child + pos + 2, node->child + pos + 1,
+          (node->keys - pos) * sizeof(TREE_NODE*));
+  memcpy(BTREE_SLOT(tree, node, pos), BTREE_SLOT(tree, left, half),
+         slot_size);
+  node->child[pos + 1]= right;
+  node->keys++;
+  return 0;
+}
+
+
+static TREE_ELEMENT *btree_found_element(TREE *tree, TREE_ELEMENT *element)
+{
+  if (tree->flag & TREE_NO_DUPS)
+    return(NULL);
+  element->count++;
+  /* Avoid a wrap over of the count. */
+  if (! element->count)
+    element->count--;
+  return element;
+}
+
+
+/*
+  Insert into a B-tree
+
+  NOTES
+    Full nodes are split on the way down, so that there is always room
+    for the new element in the leaf and in the parent of a split node.
+*/
+
+static TREE_ELEMENT *btree_insert(TREE *tree, void *key, uint key_size,
+                                  void *custom_arg)
+{
+  TREE_NODE *node;
+  TREE_ELEMENT *element;
+  uint pos;
+
+  /* Keys stored in the element can't be longer than the element */
+  DBUG_ASSERT(!tree->offset_to_key || !key_size);
+
+  if (!(node= tree->btree_root))
+  {
+    if (!(node= tree->btree_root= btree_new_node(tree, 1)))
+      return(NULL);
+  }
+  else if (node->keys == tree->btree_max_keys)
+  {
+    if (!(node= btree_new_node(tree, 0)))
+      return(NULL);
+    node->child[0]= tree->btree_root;
+    if (btree_split_child(tree, node, 0))
+      return(NULL);
+    tree->btree_root= node;
+  }
+
+  for (;;)
+  {
+    TREE_NODE *child;
+    if (btree_search_node(tree, node, key, custom_arg, &pos))
+      return btree_found_element(tree, BTREE_SLOT(tree, node, pos));
+    if (!node->child)
+      break;
+    child= node->child[pos];
+    if (child->keys == tree->btree_max_keys)
+    {
+      int cmp;
+      if (btree_split_child(tree, node, pos))
+        return(NULL);
+      element= BTREE_SLOT(tree, node, pos);
+      if ((cmp= (*tree->compare)(custom_arg, ELEMENT_KEY(tree, element),
+                                 key)) == 0)
+        return btree_found_element(tree, element);
+      if (cmp < 0)
+        pos++;
+    }
+    node= node->child[pos];
+  }
+
+  if (tree->flag & TREE_ONLY_DUPS)
+    return((TREE_ELEMENT *) 1);
+  if (tree->memory_limit && tree->elements_in_tree &&
+      tree->allocated > tree->memory_limit)
+  {
+    reset_tree(tree);
+    return tree_insert(tree, key, key_size, custom_arg);
+  }
+
+  memmove(BTREE_SLOT(tree, node, pos + 1), BTREE_SLOT(tree, node, pos),
+          (node->keys - pos) * tree->btree_slot_size);
+  element= BTREE_SLOT(tree, node, pos);
+  element->left= element->right= 0;
+  element->colour= 0;
+  key_size+= tree->size_of_element;
+  if (!tree->offset_to_key)
+  {
+    if (key_size == sizeof(void*))		 /* no length, save pointer */
+      *((void**) (element+1))=key;
+    else
+    {
+      void *copy;
+      if (!(copy= alloc_root(&tree->mem_root, key_size - sizeof(void*))))
+      {
+        memmove(element, BTREE_SLOT(tree, node, pos + 1),
+                (node->keys - pos) * tree->btree_slot_size);
+        return(NULL);
+      }
+      tree->allocated+= key_size - sizeof(void*);
+      memcpy(copy, key, (size_t) (key_size - sizeof(void*)));
+      *((void**) (element+1))= copy;
+    }
+  }
+  else
+    memcpy((uchar*) element+tree->offset_to_key,key,(size_t) key_size);
+  element->count=1;
+  node->keys++;
+  tree->elements_in_tree++;
+  return element;
+}
+
+
+static void *btree_search(TREE *tree, void *key, void *custom_arg)
+{
+  TREE_NODE *node;
+  uint pos;
+
+  for (node= tree->btree_root; node; node= node->child ? node->child[pos] : 0)
+  {
+    if (btree_search_node(tree, node, key, custom_arg, &pos))
+      return ELEMENT_KEY(tree, BTREE_SLOT(tree, node, pos));
+  }
+  return (void*) 0;
+}
+
+
+static int btree_walk(TREE *tree, TREE_NODE *node, tree_walk_action action,
+                      void *argument, TREE_WALK visit)
+{
+  uint i;
+  int error;
+
+  if (!node)
+    return 0;
+  for (i= 0; i < node->keys; i++)
+  {
+    uint pos= visit == left_root_right ? i : node->keys - 1 - i;
+    TREE_ELEMENT *element= BTREE_SLOT(tree, node, pos);
+    if (node->child &&
+        (error= btree_walk(tree, node->child[visit == left_root_right ?
+                                             pos : pos + 1],
+                           action, argument, visit)))
+      return error;
+    if ((error= (*action)(ELEMENT_KEY(tree, element),
+                          (element_count) element->count, argument)))
+      return error;
+  }
+  if (node->child)
+    return btree_walk(tree, node->child[visit == left_root_right ?
+                                        node->keys : 0],
+                      action, argument, visit);
+  return 0;
+}
+
+
+	/* Call tree->free for all elements, in key order */
+
+static void btree_free_elements(TREE *tree, TREE_NODE *node)
+{
+  uint i;
+
+  if (!node)
+    return;
+  for (i= 0; i < node->keys; i++)
+  {
+    if (node->child)
+      btree_free_elements(tree, node->child[i]);
+    (*tree->free)(ELEMENT_KEY(tree, BTREE_SLOT(tree, node, i)), free_free,
+                  tree->custom_arg);
+  }
+  if (node->child)
+    btree_free_elements(tree, node->child[node->keys]);
+}
+
+
 	/* Functions to fix up the tree after insert and delete */
 
 static void left_rotate(TREE_ELEMENT **parent, TREE_ELEMENT *leaf)
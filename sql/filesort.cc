@@ -309,9 +309,9 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
 	/* Open cached file if it isn't open */
     if (! my_b_inited(outfile) &&
 	open_cached_file(outfile,mysql_tmpdir,TEMP_PREFIX,READ_RECORD_BUFFER,
-			  MYF(MY_WME)))
+			  MYF(MY_WME | MY_ASYNC_IO)))
       goto err;
-    if (reinit_io_cache(outfile,WRITE_CACHE,0L,0,0))
+    if (reinit_io_cache(outfile,WRITE_CACHE,0L,1,0))
       goto err;
 
     /*
@@ -946,7 +946,7 @@ write_keys(Sort_param *param,  SORT_INFO *fs_info, uint count,
 
   if (!my_b_inited(tempfile) &&
       open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
-                       MYF(MY_WME)))
+                       MYF(MY_WME | MY_ASYNC_IO)))
     goto err;                                   /* purecov: inspected */
   /* check we won't have more buffpeks than we can possibly keep in memory */
   if (my_b_tell(buffpek_pointers) + sizeof(BUFFPEK) > (ulonglong)UINT_MAX)
@@ -1467,7 +1467,7 @@ int merge_many_buff(Sort_param *param, uchar *sort_buffer,
     DBUG_RETURN(0);				/* purecov: inspected */
   if (flush_io_cache(t_file) ||
       open_cached_file(&t_file2,mysql_tmpdir,TEMP_PREFIX,DISK_BUFFER_SIZE,
-			MYF(MY_WME)))
+			MYF(MY_WME | MY_ASYNC_IO)))
     DBUG_RETURN(1);				/* purecov: inspected */
 
   from_file= t_file ; to_file= &t_file2;
@@ -1475,7 +1475,7 @@ int merge_many_buff(Sort_param *param, uchar *sort_buffer,
   {
     if (reinit_io_cache(from_file,READ_CACHE,0L,0,0))
       goto cleanup;
-    if (reinit_io_cache(to_file,WRITE_CACHE,0L,0,0))
+    if (reinit_io_cache(to_file,WRITE_CACHE,0L,1,0))
       goto cleanup;
     lastbuff=buffpek;
     for (i=0 ; i <= *maxbuffer-MERGEBUFF*3/2 ; i+=MERGEBUFF)
@@ -3219,6 +3219,14 @@ class handler :public Sql_alloc
   void ft_end() { ft_handler=NULL; }
   virtual FT_INFO *ft_init_ext(uint flags, uint inx,String *key)
     { return NULL; }
+  /*
+    Same as ft_init_ext(), but the caller will read at most 'limit' rows
+    of the result, in relevance order (FT_SORTED is set). An engine may
+    use this to rank only the top 'limit' documents.
+  */
+  virtual FT_INFO *ft_init_ext_with_limit(uint flags, uint inx, String *key,
+                                         ha_rows limit)
+    { return ft_init_ext(flags, inx, key); }
 private:
   virtual int ft_read(uchar *buf) { return HA_ERR_WRONG_COMMAND; }
   virtual int rnd_next(uchar *buf)=0;
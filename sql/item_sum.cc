@@ -795,11 +795,11 @@ bool Aggregator_distinct::setup(THD *thd)
     table->file->extra(HA_EXTRA_NO_ROWS);		// Don't update rows
     table->no_rows=1;
 
-    if (table->s->db_type() == heap_hton)
+    if (table->s->db_type() == heap_hton && !table->s->blob_fields)
     {
       /*
-        No blobs, otherwise it would have been MyISAM: set up a compare
-        function and its arguments to use with Unique.
+        No blobs: set up a compare function and its arguments to use
+        with Unique.
       */
       qsort_cmp2 compare_key;
       void* cmp_arg;
@@ -993,7 +993,11 @@ bool Aggregator_distinct::add()
       return tree->unique_add(table->record[0] + table->s->null_bytes);
     }
     if ((error= table->file->ha_write_tmp_row(table->record[0])) &&
-        table->file->is_fatal_error(error, HA_CHECK_DUP))
+        table->file->is_fatal_error(error, HA_CHECK_DUP) &&
+        create_internal_tmp_table_from_heap(table->in_use, table,
+                                            tmp_table_param->start_recinfo,
+                                            &tmp_table_param->recinfo,
+                                            error, 1, NULL))
       return TRUE;
     return FALSE;
   }
@@ -3684,7 +3688,7 @@ bool Item_func_group_concat::setup(THD *thd)
                                thd->variables.sortbuff_size/16), 0,
               tree_key_length, 
               group_concat_key_cmp_with_order, NULL, (void*) this,
-              MYF(MY_THREAD_SPECIFIC));
+              MYF(MY_THREAD_SPECIFIC | MY_TREE_BTREE));
   }
 
   if (distinct)
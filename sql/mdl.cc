@@ -693,8 +693,8 @@ void MDL_map::init()
   m_global_lock= new (std::nothrow) MDL_lock(&global_lock_key);
   m_commit_lock= new (std::nothrow) MDL_lock(&commit_lock_key);
 
-  lf_hash_init(&m_locks, sizeof(MDL_lock), LF_HASH_UNIQUE, 0, 0,
-               mdl_locks_key, &my_charset_bin);
+  lf_hash_init(&m_locks, sizeof(MDL_lock), LF_HASH_UNIQUE | LF_HASH_BUCKETS,
+               0, 0, mdl_locks_key, &my_charset_bin);
   m_locks.alloc.constructor= MDL_lock::lf_alloc_constructor;
   m_locks.alloc.destructor= MDL_lock::lf_alloc_destructor;
   m_locks.initializer= (lf_hash_initializer) MDL_lock::lf_hash_initializer;
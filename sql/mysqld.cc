@@ -530,6 +530,7 @@ ulong binlog_stmt_cache_use= 0, binlog_stmt_cache_disk_use= 0;
 ulong max_connections, max_connect_errors;
 ulong extra_max_connections;
 uint max_digest_length= 0;
+uint opt_io_cache_async_threads= 0;
 ulong slave_retried_transactions;
 ulonglong slave_skipped_errors;
 ulong feature_files_opened_with_delayed_keys= 0, feature_check_constraint= 0;
@@ -2234,6 +2235,7 @@ void clean_up(bool print_message)
 #ifndef EMBEDDED_LIBRARY
   end_thr_timer();
 #endif
+  end_io_cache_async();
   my_free_open_file_info();
   if (defaults_argv)
     free_defaults(defaults_argv);
@@ -4974,6 +4976,12 @@ static int init_server_components()
   }
 #endif
 
+  if (init_io_cache_async(opt_io_cache_async_threads))
+  {
+    fprintf(stderr, "Can't create I/O threads for io_cache_async_threads\n");
+    unireg_abort(1);
+  }
+
   my_uuid_init((ulong) (my_rnd(&sql_rand))*12345,12345);
 #ifdef HAVE_REPLICATION
   init_slave_list();
@@ -8439,6 +8447,8 @@ SHOW_VAR status_vars[]= {
   {"Handler_tmp_write",        (char*) offsetof(STATUS_VAR, ha_tmp_write_count), SHOW_LONG_STATUS},
   {"Handler_update",           (char*) offsetof(STATUS_VAR, ha_update_count), SHOW_LONG_STATUS},
   {"Handler_write",            (char*) offsetof(STATUS_VAR, ha_write_count), SHOW_LONG_STATUS},
+  {"Io_cache_async_reads",     (char*) &my_io_cache_async_reads, SHOW_LONG_NOFLUSH},
+  {"Io_cache_async_writes",    (char*) &my_io_cache_async_writes, SHOW_LONG_NOFLUSH},
   {"Key",                      (char*) &show_default_keycache, SHOW_FUNC},
   {"Last_query_cost",          (char*) offsetof(STATUS_VAR, last_query_cost), SHOW_DOUBLE_STATUS},
   {"Max_statement_time_exceeded", (char*) offsetof(STATUS_VAR, max_statement_time_exceeded), SHOW_LONG_STATUS},
@@ -8446,6 +8456,9 @@ SHOW_VAR status_vars[]= {
   {"Master_gtid_wait_timeouts", (char*) offsetof(STATUS_VAR, master_gtid_wait_timeouts), SHOW_LONGLONG_STATUS},
   {"Master_gtid_wait_time",    (char*) offsetof(STATUS_VAR, master_gtid_wait_time), SHOW_LONGLONG_STATUS},
   {"Max_used_connections",     (char*) &max_used_connections,  SHOW_LONG},
+  {"Mem_root_pool_hits",       (char*) &my_mem_root_pool_hits,  SHOW_LONGLONG},
+  {"Mem_root_pool_misses",     (char*) &my_mem_root_pool_misses, SHOW_LONGLONG},
+  {"Mem_root_pool_trims",      (char*) &my_mem_root_pool_trims, SHOW_LONGLONG},
   {"Memory_used",              (char*) &show_memory_used, SHOW_SIMPLE_FUNC},
   {"Not_flushed_delayed_rows", (char*) &delayed_rows_in_use,    SHOW_LONG_NOFLUSH},
   {"Open_files",               (char*) &my_file_opened,         SHOW_LONG_NOFLUSH},
@@ -4909,6 +4909,17 @@ extern "C" bool thd_sqlcom_can_generate_row_events(const MYSQL_THD thd)
 }
 
 
+/*
+  Whether the statement invokes stored functions (or procedures), which
+  could read the tables that it is modifying.
+*/
+
+extern "C" bool thd_uses_stored_routines(const MYSQL_THD thd)
+{
+  return thd->lex->uses_stored_routines();
+}
+
+
 extern "C" enum durability_properties thd_get_durability_property(const MYSQL_THD thd)
 {
   enum durability_properties ret= HA_REGULAR_DURABILITY;
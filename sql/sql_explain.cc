@@ -758,6 +758,7 @@ int Explain_select::print_explain(Explain_query *query,
   {
     bool using_tmp= false;
     bool using_fs= false;
+    bool using_hash= false;
 
     for (Explain_aggr_node *node= aggr_tree; node; node= node->child)
     {
@@ -765,6 +766,8 @@ int Explain_select::print_explain(Explain_query *query,
       {
         case AGGR_OP_TEMP_TABLE:
           using_tmp= true;
+          if (((Explain_aggr_tmp_table*) node)->hash_group_by)
+            using_hash= true;
           break;
         case AGGR_OP_FILESORT:
           using_fs= true;
@@ -777,7 +780,8 @@ int Explain_select::print_explain(Explain_query *query,
     for (uint i=0; i< n_join_tabs; i++)
     {
       join_tabs[i]->print_explain(output, explain_flags, is_analyze, select_id,
-                                  select_type, using_tmp, using_fs);
+                                  select_type, using_tmp, using_fs,
+                                  using_hash);
       if (i == 0)
       {
         /* 
@@ -786,6 +790,7 @@ int Explain_select::print_explain(Explain_query *query,
         */
         using_tmp= false;
         using_fs= false;
+        using_hash= false;
       }
     }
     for (uint i=0; i< n_join_tabs; i++)
@@ -882,6 +887,8 @@ void Explain_select::print_explain_json(Explain_query *query,
       {
         case AGGR_OP_TEMP_TABLE:
           writer->add_member("temporary_table").start_object();
+          if (((Explain_aggr_tmp_table*) node)->hash_group_by)
+            writer->add_member("hash_group_by").add_bool(true);
           break;
         case AGGR_OP_FILESORT:
         {
@@ -1149,7 +1156,8 @@ double Explain_table_access::get_r_filtered()
 int Explain_table_access::print_explain(select_result_sink *output, uint8 explain_flags, 
                                         bool is_analyze,
                                         uint select_id, const char *select_type,
-                                        bool using_temporary, bool using_filesort)
+                                        bool using_temporary, bool using_filesort,
+                                        bool using_hash_group_by)
 {
   THD *thd= output->thd;
   MEM_ROOT *mem_root= thd->mem_root;
@@ -1298,6 +1306,9 @@ int Explain_table_access::print_explain(select_result_sink *output, uint8 explai
     extra_buf.append(STRING_WITH_LEN("Using temporary"));
   }
 
+  if (using_hash_group_by)
+    extra_buf.append(STRING_WITH_LEN("; Using hash group by"));
+
   if (using_filesort || this->pre_join_sort)
   {
     if (first)
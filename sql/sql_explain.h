@@ -302,7 +302,10 @@ class Explain_aggr_filesort : public Explain_aggr_node
 class Explain_aggr_tmp_table : public Explain_aggr_node
 {
 public:
+  Explain_aggr_tmp_table() : hash_group_by(false) {}
   enum_explain_aggr_node_type get_type() { return AGGR_OP_TEMP_TABLE; }
+  /* The groups are computed in memory before they are written */
+  bool hash_group_by;
 };
 
 class Explain_aggr_remove_dups : public Explain_aggr_node
@@ -792,7 +795,8 @@ class Explain_table_access : public Sql_alloc
   int print_explain(select_result_sink *output, uint8 explain_flags, 
                     bool is_analyze,
                     uint select_id, const char *select_type,
-                    bool using_temporary, bool using_filesort);
+                    bool using_temporary, bool using_filesort,
+                    bool using_hash_group_by= false);
   void print_explain_json(Explain_query *query, Json_writer *writer,
                           bool is_analyze);
 
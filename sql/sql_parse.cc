@@ -2438,6 +2438,7 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   }
   thd->reset_kill_query();  /* Ensure that killed_errmsg is released */
   free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
+  mem_root_pool_trim();
 
 #if defined(ENABLED_PROFILING)
   thd->profiling.finish_current_query();
@@ -177,6 +177,8 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 
 static int join_read_const_table(THD *thd, JOIN_TAB *tab, POSITION *pos);
 static int join_read_system(JOIN_TAB *tab);
@@ -2026,7 +2028,10 @@ JOIN::optimize_inner()
 
   /* Perform FULLTEXT search before all regular searches */
   if (!(select_options & SELECT_DESCRIBE))
+  {
+    set_ft_limit();
     init_ftfuncs(thd, select_lex, MY_TEST(order));
+  }
 
   /*
     It's necessary to check const part of HAVING cond as
@@ -3037,6 +3042,54 @@ JOIN::optimize_distinct()
 }
 
 
+/**
+  @brief Tell a full-text search how many rows of its result will be read
+
+  @details
+  For "SELECT ... FROM t WHERE MATCH(..) AGAINST(..) LIMIT n" the rows
+  are returned in relevance order straight from the full-text index, so
+  only the n most relevant documents can reach the client. Anything else
+  that could reject or reorder rows (other conditions, sorting, grouping,
+  a temporary table, SQL_CALC_FOUND_ROWS) disables the hint.
+
+  The same MATCH may also be in the select list, as in
+  "SELECT MATCH(..) AS score ... WHERE MATCH(..)". setup_ftfuncs() makes
+  one of the equal MATCH items the master that does the search; there
+  must be only one search, and the WHERE clause must be one of its items.
+*/
+
+void
+JOIN::set_ft_limit()
+{
+  if (table_count != 1 || const_tables ||
+      order || group_list || implicit_grouping || select_distinct ||
+      having || need_tmp || (select_options & OPTION_FOUND_ROWS) ||
+      unit->is_union() || unit->select_limit_cnt == HA_POS_ERROR ||
+      join_tab->type != JT_FT || !conds ||
+      conds->type() != Item::FUNC_ITEM ||
+      ((Item_func*) conds)->functype() != Item_func::FT_FUNC)
+    return;
+
+  List_iterator<Item_func_match> li(*select_lex->ftfunc_list);
+  Item_func_match *ifm, *search= NULL;
+
+  while ((ifm= li++))
+  {
+    if (ifm->master)
+      continue;
+    if (search)
+      return;                                   // Several searches
+    search= ifm;
+  }
+
+  for (ifm= (Item_func_match*) conds; ifm->master; ifm= ifm->master) ;
+  if (ifm != search)
+    return;
+
+  search->ft_limit= unit->select_limit_cnt;
+}
+
+
 /**
   @brief Add Filesort object to the given table to sort if with filesort
 
@@ -3242,6 +3295,9 @@ JOIN::reinit()
     for ( ; curr_tab < end_tab; curr_tab++)
     {
       TABLE *tmp_table= curr_tab->table;
+      /* Forget the groups and spilled partitions of end_hash_update() */
+      if (curr_tab->aggr && curr_tab->aggr->group_hash)
+        curr_tab->aggr->group_hash->free();
       if (!tmp_table->is_created())
         continue;
       tmp_table->file->extra(HA_EXTRA_RESET_STATE);
@@ -12079,6 +12135,8 @@ void JOIN_TAB::cleanup()
     cache->free();
     cache= 0;
   }
+  if (aggr && aggr->group_hash)
+    aggr->group_hash->free();
   limit= 0;
   // Free select that was created for filesort outside of create_sort_index
   if (filesort && filesort->select && !filesort->own_select)
@@ -17204,20 +17262,19 @@ create_tmp_table(THD *thd, TMP_TABLE_PARAM *param, List<Item> &fields,
   share->fields= field_count;
   share->column_bitmap_size= bitmap_buffer_size(share->fields);
 
-  /* If result table is small; use a heap */
+  /*
+    If result table is small; use a heap. HEAP stores BLOBs and implements
+    unique constraints as hash keys over the whole columns, so they don't
+    force the table to disk.
+  */
   /* future: storage engine selection can be made dynamic? */
-  if (blob_count || using_unique_constraint
-      || (thd->variables.big_tables && !(select_options & SELECT_SMALL_RESULT))
+  if ((thd->variables.big_tables && !(select_options & SELECT_SMALL_RESULT))
       || (select_options & TMP_TABLE_FORCE_MYISAM)
       || thd->variables.tmp_memory_table_size == 0)
   {
     share->db_plugin= ha_lock_engine(0, TMP_ENGINE_HTON);
     table->file= get_new_handler(share, &table->mem_root,
                                  share->db_type());
-    if (group &&
-	(param->group_parts > table->file->max_key_parts() ||
-	 param->group_length > table->file->max_key_length()))
-      using_unique_constraint= true;
   }
   else
   {
@@ -17227,6 +17284,10 @@ create_tmp_table(THD *thd, TMP_TABLE_PARAM *param, List<Item> &fields,
   }
   if (!table->file)
     goto err;
+  if (group &&
+      (param->group_parts > table->file->max_key_parts() ||
+       param->group_length > table->file->max_key_length()))
+    using_unique_constraint= true;
 
   if (table->file->set_ha_share_ref(&share->ha_share))
   {
@@ -17403,6 +17464,9 @@ create_tmp_table(THD *thd, TMP_TABLE_PARAM *param, List<Item> &fields,
     share->keys_in_use.set_bit(0);
     keyinfo->key_part=key_part_info;
     keyinfo->flags=HA_NOSAME | HA_BINARY_PACK_KEY | HA_PACK_KEY;
+    /* A unique constraint groups NULLs together, as the key does */
+    if (using_unique_constraint)
+      keyinfo->flags|= HA_NULL_ARE_EQUAL;
     keyinfo->ext_key_flags= keyinfo->flags;
     keyinfo->usable_key_parts=keyinfo->user_defined_key_parts= param->group_parts;
     keyinfo->ext_key_parts= keyinfo->user_defined_key_parts;
@@ -18342,6 +18406,15 @@ void set_postjoin_aggr_write_func(JOIN_TAB *tab)
 
   DBUG_ASSERT(table && aggr);
 
+  /*
+    The groups of a previous execution are forgotten, and EXPLAIN shows
+    hash_group_by only if group_hash is used by this plan.
+  */
+  Group_hash_table *group_hash= aggr->group_hash;
+  aggr->group_hash= NULL;
+  if (group_hash)
+    group_hash->free();
+
   if (table->group && tmp_tbl->sum_func_count && 
       !tmp_tbl->precomputed_group_by)
   {
@@ -18349,7 +18422,20 @@ void set_postjoin_aggr_write_func(JOIN_TAB *tab)
       Note for MyISAM tmp tables: if uniques is true keys won't be
       created.
     */
-    if (table->s->keys && !table->s->uniques)
+    if (table->s->keys && !table->s->uniques &&
+        !table->s->blob_fields &&
+        optimizer_flag(join->thd, OPTIMIZER_SWITCH_HASH_GROUP_BY))
+    {
+      /*
+        The rows of the groups are copied with memcpy(), which does not
+        work for blobs.
+      */
+      DBUG_PRINT("info",("Using end_hash_update"));
+      aggr->group_hash= group_hash ? group_hash :
+        new (join->thd->mem_root) Group_hash_table;
+      aggr->set_write_func(aggr->group_hash ? end_hash_update : end_update);
+    }
+    else if (table->s->keys && !table->s->uniques)
     {
       DBUG_PRINT("info",("Using end_update"));
       aggr->set_write_func(end_update);
@@ -20428,33 +20514,15 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
-/*
-  @brief
-    Perform a GROUP BY operation over rows coming in arbitrary order. 
-    
-    This is done by looking up the group in a temp.table and updating group
-    values.
+/**
+  Make the key of the group index of a temporary table from the current row
 
-  @detail
-    Also applies HAVING, etc.
+  @param table  temporary table with a group key
 */
 
-static enum_nested_loop_state
-end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
-	   bool end_of_records)
+static void make_group_key(TABLE *table)
 {
-  TABLE *const table= join_tab->table;
-  ORDER   *group;
-  int	  error;
-  DBUG_ENTER("end_update");
-
-  if (end_of_records)
-    DBUG_RETURN(NESTED_LOOP_OK);
-
-  join->found_records++;
-  copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
-  /* Make a key of group index */
-  for (group=table->group ; group ; group=group->next)
+  for (ORDER *group= table->group; group; group= group->next)
   {
     Item *item= *group->item;
     if (group->fast_field_copier_setup != group->field)
@@ -20471,6 +20539,30 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     if (item->maybe_null)
       group->buff[-1]= (char) group->field->is_null();
   }
+}
+
+
+/**
+  Update the group of the current row in the index of the temporary table
+
+  @param join       current join
+  @param join_tab   JOIN_TAB of the temporary table
+  @param converted  set to true if the table was converted to disk
+
+  @details
+    The group key must have been made by make_group_key().
+
+  @return one of enum_nested_loop_state
+*/
+
+static enum_nested_loop_state
+update_tmp_table_group(JOIN *join, JOIN_TAB *join_tab, bool *converted)
+{
+  TABLE *const table= join_tab->table;
+  int	  error;
+  DBUG_ENTER("update_tmp_table_group");
+
+  *converted= false;
   if (!table->file->ha_index_read_map(table->record[1],
                                       join_tab->tmp_table_param->group_buff,
                                       HA_WHOLE_KEY,
@@ -20484,7 +20576,7 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
       table->file->print_error(error,MYF(0));	/* purecov: inspected */
       DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
     }
-    goto end;
+    DBUG_RETURN(NESTED_LOOP_OK);
   }
 
   init_tmptable_sum_functions(join->sum_funcs);
@@ -20503,11 +20595,44 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
       table->file->print_error(error, MYF(0));
       DBUG_RETURN(NESTED_LOOP_ERROR);
     }
-
-    join_tab->aggr->set_write_func(end_unique_update);
+    *converted= true;
   }
   join_tab->send_records++;
-end:
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
+/*
+  @brief
+    Perform a GROUP BY operation over rows coming in arbitrary order. 
+    
+    This is done by looking up the group in a temp.table and updating group
+    values.
+
+  @detail
+    Also applies HAVING, etc.
+*/
+
+static enum_nested_loop_state
+end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
+	   bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  enum_nested_loop_state rc;
+  bool converted;
+  DBUG_ENTER("end_update");
+
+  if (end_of_records)
+    DBUG_RETURN(NESTED_LOOP_OK);
+
+  join->found_records++;
+  copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
+  make_group_key(table);
+  if ((rc= update_tmp_table_group(join, join_tab, &converted)) <
+      NESTED_LOOP_OK)
+    DBUG_RETURN(rc);
+  if (converted)
+    join_tab->aggr->set_write_func(end_unique_update);
   if (join->thd->check_killed())
   {
     join->thd->send_kill_message();
@@ -20517,18 +20642,26 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
-/** Like end_update, but this is done with unique constraints instead of keys.  */
+/**
+  Update the group of the current row with the unique constraint of the
+  temporary table
+
+  @param join       current join
+  @param join_tab   JOIN_TAB of the temporary table
+
+  @details
+    The row is written, and the group it duplicates is updated if the
+    write fails.
+
+  @return one of enum_nested_loop_state
+*/
 
 static enum_nested_loop_state
-end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
-		  bool end_of_records)
+update_tmp_table_unique_group(JOIN *join, JOIN_TAB *join_tab)
 {
   TABLE *table= join_tab->table;
   int	  error;
-  DBUG_ENTER("end_unique_update");
-
-  if (end_of_records)
-    DBUG_RETURN(NESTED_LOOP_OK);
+  DBUG_ENTER("update_tmp_table_unique_group");
 
   init_tmptable_sum_functions(join->sum_funcs);
   copy_fields(join_tab->tmp_table_param);		// Groups are copied twice.
@@ -20539,6 +20672,22 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     join_tab->send_records++;			// New group
   else
   {
+    if (table->file->is_fatal_error(error, HA_CHECK_DUP))
+    {
+      /* A HEAP table got full; the group may exist in it */
+      bool is_duplicate;
+      if (create_internal_tmp_table_from_heap(join->thd, table,
+                                       join_tab->tmp_table_param->start_recinfo,
+                                              &join_tab->tmp_table_param->recinfo,
+                                              error, 1, &is_duplicate))
+        DBUG_RETURN(NESTED_LOOP_ERROR);          // Not a table_is_full error
+      if (!is_duplicate)
+      {
+        join_tab->send_records++;
+        DBUG_RETURN(NESTED_LOOP_OK);
+      }
+      error= HA_ERR_FOUND_DUPP_KEY;
+    }
     if ((int) table->file->get_dup_key(error) < 0)
     {
       table->file->print_error(error,MYF(0));	/* purecov: inspected */
@@ -20558,6 +20707,24 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
       DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
     }
   }
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
+/** Like end_update, but this is done with unique constraints instead of keys.  */
+
+static enum_nested_loop_state
+end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
+		  bool end_of_records)
+{
+  enum_nested_loop_state rc;
+  DBUG_ENTER("end_unique_update");
+
+  if (end_of_records)
+    DBUG_RETURN(NESTED_LOOP_OK);
+
+  if ((rc= update_tmp_table_unique_group(join, join_tab)) < NESTED_LOOP_OK)
+    DBUG_RETURN(rc);
   if (join->thd->check_killed())
   {
     join->thd->send_kill_message();
@@ -20567,6 +20734,410 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
+/**
+  Prepare a Group_hash_table for the groups of a temporary table
+
+  @param tmp_table  temporary table with a group key
+  @param param      parameters of the temporary table
+
+  @details
+    The buckets of a partition are allocated when its first group is
+    added.
+
+  @retval false  ok
+  @retval true   out of memory
+*/
+
+bool Group_hash_table::init(TABLE *tmp_table, TMP_TABLE_PARAM *param)
+{
+  DBUG_ASSERT(!is_inited());
+  table= tmp_table;
+  group_buff= param->group_buff;
+  key_length= param->group_length;
+  rec_length= table->s->reclength;
+  spilled= 0;
+  first_added= NULL;
+  last_added= &first_added;
+  used_memory= 0;
+  for (uint i= 0; i < n_partitions; i++)
+  {
+    Partition *part= partitions + i;
+    part->buckets= NULL;
+    part->n_buckets= 0;
+    part->n_groups= 0;
+    part->used_memory= 0;
+    init_sql_alloc(&part->mem_root, 16 * 1024, 0, MYF(MY_THREAD_SPECIFIC));
+  }
+  inited= true;
+  return false;
+}
+
+
+/** Free the groups of a partition */
+
+void Group_hash_table::free_partition(Partition *part)
+{
+  my_free(part->buckets);
+  part->buckets= NULL;
+  part->n_buckets= 0;
+  part->n_groups= 0;
+  used_memory-= part->used_memory;
+  part->used_memory= 0;
+  free_root(&part->mem_root, MYF(0));
+}
+
+
+/** Free all groups */
+
+void Group_hash_table::free()
+{
+  if (!is_inited())
+    return;
+  for (uint i= 0; i < n_partitions; i++)
+    free_partition(partitions + i);
+  inited= false;
+}
+
+
+/**
+  Double the number of buckets of a partition
+
+  @retval false  ok
+  @retval true   out of memory
+*/
+
+bool Group_hash_table::grow(Partition *part)
+{
+  ulong new_n_buckets= part->n_buckets ? part->n_buckets * 2 : 256;
+  Group **new_buckets;
+
+  if (!(new_buckets= (Group**) my_malloc(new_n_buckets * sizeof(Group*),
+                                         MYF(MY_WME | MY_ZEROFILL |
+                                             MY_THREAD_SPECIFIC))))
+    return true;
+  for (ulong i= 0; i < part->n_buckets; i++)
+  {
+    Group *next;
+    for (Group *group= part->buckets[i]; group; group= next)
+    {
+      Group **bucket= new_buckets + (group->hash_value & (new_n_buckets - 1));
+      next= group->next;
+      group->next= *bucket;
+      *bucket= group;
+    }
+  }
+  my_free(part->buckets);
+  part->buckets= new_buckets;
+  size_t added= (new_n_buckets - part->n_buckets) * sizeof(Group*);
+  part->used_memory+= added;
+  used_memory+= added;
+  part->n_buckets= new_n_buckets;
+  return false;
+}
+
+
+/**
+  Hash the group key of the current row
+
+  @details
+    The key must have been made by make_group_key(). Values that compare
+    equal in the group index get the same hash value.
+*/
+
+ulong Group_hash_table::hash_key() const
+{
+  ulong nr= 1, nr2= 4;
+
+  for (ORDER *group= table->group; group; group= group->next)
+  {
+    if ((*group->item)->maybe_null && group->buff[-1])
+      nr^= (nr << 1) | 1;
+    else
+      group->field->hash(&nr, &nr2);
+  }
+  return nr;
+}
+
+
+/**
+  Compare the key of a group with the group key of the current row
+
+  @retval false  the keys are equal, as in the group index
+  @retval true   the keys differ
+*/
+
+bool Group_hash_table::key_differs(const Group *group) const
+{
+  const uchar *key= group_key(group);
+
+  for (ORDER *order= table->group; order; order= order->next)
+  {
+    const uchar *pos= key + ((uchar*) order->buff - group_buff);
+
+    if ((*order->item)->maybe_null)
+    {
+      if (pos[-1] != (uchar) order->buff[-1])
+        return true;
+      if (pos[-1])
+        continue;                               // Both are NULL
+    }
+    if (order->field->cmp(pos, (uchar*) order->buff))
+      return true;
+  }
+  return false;
+}
+
+
+/**
+  Look up the group of the current row
+
+  @param hash_value  hash_key() of the row
+
+  @return the row of the group, or NULL if there is no such group in
+  memory
+*/
+
+uchar *Group_hash_table::find(ulong hash_value) const
+{
+  const Partition *part= partitions + partition_of(hash_value);
+
+  if (!part->n_buckets)
+    return NULL;
+  for (Group *group= part->buckets[hash_value & (part->n_buckets - 1)];
+       group; group= group->next)
+  {
+    if (group->hash_value == hash_value && !key_differs(group))
+      return (uchar*) (group + 1);
+  }
+  return NULL;
+}
+
+
+/**
+  Add the group of the current row
+
+  @param hash_value  hash_key() of the row, which must not be spilled
+  @param row         initial row of the group
+
+  @return the copy of the row, or NULL if out of memory
+*/
+
+uchar *Group_hash_table::add(ulong hash_value, const uchar *row)
+{
+  Partition *part= partitions + partition_of(hash_value);
+  size_t size= sizeof(Group) + rec_length + key_length;
+  Group *group;
+
+  DBUG_ASSERT(!is_spilled(hash_value));
+  if (part->n_groups >= part->n_buckets && grow(part))
+    return NULL;
+  if (!(group= (Group*) alloc_root(&part->mem_root, size)))
+    return NULL;
+  memcpy(group + 1, row, rec_length);
+  memcpy(group_key(group), group_buff, key_length);
+  group->hash_value= hash_value;
+  Group **bucket= part->buckets + (hash_value & (part->n_buckets - 1));
+  group->next= *bucket;
+  *bucket= group;
+  group->next_added= NULL;
+  *last_added= group;
+  last_added= &group->next_added;
+  part->n_groups++;
+  part->used_memory+= size;
+  used_memory+= size;
+  return (uchar*) (group + 1);
+}
+
+
+/** @return the partition that uses the most memory */
+
+uint Group_hash_table::largest_partition() const
+{
+  uint largest= 0;
+
+  for (uint i= 1; i < n_partitions; i++)
+  {
+    if (partitions[i].used_memory > partitions[largest].used_memory)
+      largest= i;
+  }
+  return largest;
+}
+
+
+/**
+  Forget the groups of a partition that were written to the table
+
+  @param part  partition of the groups
+
+  @details
+    The rows of the partition must be looked up in the temporary table
+    from now on, until free() is called.
+*/
+
+void Group_hash_table::spill(uint part)
+{
+  Group **prev= &first_added;
+
+  for (Group *group= first_added; group; group= group->next_added)
+  {
+    if (partition_of(group->hash_value) != part)
+    {
+      *prev= group;
+      prev= &group->next_added;
+    }
+  }
+  *prev= NULL;
+  last_added= prev;
+  free_partition(partitions + part);
+  spilled|= 1U << part;
+}
+
+
+/**
+  Write the groups of end_hash_update() to the temporary table
+
+  @param join      current join
+  @param join_tab  JOIN_TAB of the temporary table
+  @param part      partition to write, or Group_hash_table::n_partitions
+                   for all groups
+
+  @details
+    The groups are written in the order they were found, which is the
+    order end_update() would have written them in. The table is converted
+    to disk if it gets full. The written groups are freed.
+
+  @return one of enum_nested_loop_state
+*/
+
+static enum_nested_loop_state
+write_group_hash(JOIN *join, JOIN_TAB *join_tab, uint part)
+{
+  TABLE *const table= join_tab->table;
+  Group_hash_table *const groups= join_tab->aggr->group_hash;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  int error;
+  DBUG_ENTER("write_group_hash");
+
+  if (!groups->is_inited())
+    DBUG_RETURN(NESTED_LOOP_OK);
+  for (uchar *row= groups->first_row(); row; row= groups->next_row(row))
+  {
+    if (part != Group_hash_table::n_partitions &&
+        groups->row_partition(row) != part)
+      continue;
+    memcpy(table->record[0], row, table->s->reclength);
+    if ((error= table->file->ha_write_tmp_row(table->record[0])))
+    {
+      if (create_internal_tmp_table_from_heap(join->thd, table,
+                                       join_tab->tmp_table_param->start_recinfo,
+                                              &join_tab->tmp_table_param->recinfo,
+                                              error, 0, NULL))
+      {
+        rc= NESTED_LOOP_ERROR;                  // Not a table_is_full error
+        break;
+      }
+      if ((error= table->file->ha_index_init(0, 0)))
+      {
+        table->file->print_error(error, MYF(0));
+        rc= NESTED_LOOP_ERROR;
+        break;
+      }
+    }
+  }
+  if (part == Group_hash_table::n_partitions || rc < NESTED_LOOP_OK)
+    groups->free();
+  else
+    groups->spill(part);
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  @brief
+    Perform a GROUP BY operation over rows coming in arbitrary order,
+    keeping the groups in memory.
+
+  @detail
+    Like end_update(), but the groups are looked up in
+    AGGR_OP::group_hash instead of the index of the temporary table, and
+    are written to the table after the last row. If the groups use more
+    than tmp_memory_table_size, the largest partition of the groups is
+    written to the table, and the rows of that partition are grouped as
+    end_update() or end_unique_update() would do it. The other
+    partitions stay in memory.
+*/
+
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const tmp_table_param= join_tab->tmp_table_param;
+  Group_hash_table *const groups= join_tab->aggr->group_hash;
+  enum_nested_loop_state rc;
+  ulong hash_value;
+  uchar *row;
+  DBUG_ENTER("end_hash_update");
+
+  if (end_of_records)
+    DBUG_RETURN(write_group_hash(join, join_tab,
+                                 Group_hash_table::n_partitions));
+
+  if (!groups->is_inited())
+  {
+    if (groups->init(table, tmp_table_param))
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+  }
+  else if (groups->memory_used() >
+           join->thd->variables.tmp_memory_table_size)
+  {
+    /* Continue with the largest partition in the temporary table */
+    if ((rc= write_group_hash(join, join_tab,
+                              groups->largest_partition())) < NESTED_LOOP_OK)
+      DBUG_RETURN(rc);
+  }
+
+  join->found_records++;
+  copy_fields(tmp_table_param);                 // Groups are copied twice.
+  make_group_key(table);
+  hash_value= groups->hash_key();
+  if (groups->is_spilled(hash_value))
+  {
+    /* The group is in the temporary table */
+    if (table->s->db_type() == heap_hton)
+    {
+      bool converted;
+      rc= update_tmp_table_group(join, join_tab, &converted);
+    }
+    else
+      rc= update_tmp_table_unique_group(join, join_tab);
+    if (rc < NESTED_LOOP_OK)
+      DBUG_RETURN(rc);
+  }
+  else if ((row= groups->find(hash_value)))
+  {
+    /* Update the group in memory */
+    memcpy(table->record[0], row, table->s->reclength);
+    update_tmptable_sum_func(join->sum_funcs, table);
+    memcpy(row, table->record[0], table->s->reclength);
+  }
+  else
+  {
+    init_tmptable_sum_functions(join->sum_funcs);
+    if (copy_funcs(tmp_table_param->items_to_copy, join->thd))
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+    if (!groups->add(hash_value, table->record[0]))
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+    join_tab->send_records++;
+  }
+  if (join->thd->check_killed())
+  {
+    join->thd->send_kill_message();
+    DBUG_RETURN(NESTED_LOOP_KILLED);            /* purecov: inspected */
+  }
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
 /*
   @brief
     Perform a GROUP BY operation over a stream of rows ordered by their group.
@@ -22251,8 +22822,8 @@ JOIN_TAB::remove_duplicates()
     thd->reset_killed();
 
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
@@ -25050,7 +25621,9 @@ void save_agg_explain_data(JOIN *join, Explain_select *xpl_sel)
   {
     // Each aggregate means a temp.table
     prev_node= node;
-    node= new Explain_aggr_tmp_table;
+    Explain_aggr_tmp_table *tmp_node= new Explain_aggr_tmp_table;
+    tmp_node->hash_group_by= join_tab->aggr && join_tab->aggr->group_hash;
+    node= tmp_node;
     node->child= prev_node;
 
     if (join_tab->window_funcs_step)
@@ -942,6 +942,106 @@ class JOIN_TAB_RANGE: public Sql_alloc
 
 class Pushdown_query;
 
+/**
+  @brief
+    Groups of a GROUP BY that are kept in memory
+
+  @details
+    A group is found by the group key that make_group_key() makes in
+    TMP_TABLE_PARAM::group_buff, and it holds a copy of its row of the
+    temporary table, in which the aggregate functions are updated. The
+    rows are written to the temporary table only after all groups are
+    known, so no handler calls are made for each input row.
+
+    The groups are divided into partitions by their hash value. If the
+    groups use too much memory, the groups of one partition are written
+    to the temporary table by spill(), and the rows of that partition
+    are then grouped in the table, while the other partitions stay in
+    memory.
+
+    The memory is allocated on the first use and freed by free().
+*/
+
+class Group_hash_table :public Sql_alloc
+{
+  struct Group
+  {
+    Group *next;                       /**< Next group in the bucket */
+    Group *next_added;                 /**< Next group in adding order */
+    ulong hash_value;
+  };
+
+  /** Groups with the same partition_of() their hash value */
+  struct Partition
+  {
+    Group **buckets;
+    ulong n_buckets;
+    ulong n_groups;
+    size_t used_memory;
+    MEM_ROOT mem_root;
+  };
+
+public:
+  static const uint n_partitions= 16;
+
+private:
+  TABLE *table;
+  const uchar *group_buff;
+  uint key_length;
+  uint rec_length;
+  bool inited;
+  /** Bit i is set if partition i was written to the temporary table */
+  uint32 spilled;
+  Partition partitions[n_partitions];
+  /** Groups of all partitions in the order they were added */
+  Group *first_added;
+  Group **last_added;
+  size_t used_memory;
+
+  /** @return the partition of a hash value, from its well mixed high bits */
+  static uint partition_of(ulong hash_value)
+  { return ((uint32) hash_value * 0x9E3779B1U) >> 28; }
+  bool grow(Partition *part);
+  void free_partition(Partition *part);
+  bool key_differs(const Group *group) const;
+  /** @return the key of a group, stored after the row */
+  uchar *group_key(const Group *group) const
+  { return (uchar*) (group + 1) + rec_length; }
+
+public:
+  Group_hash_table() : inited(false) {}
+  ~Group_hash_table() { free(); }
+
+  bool init(TABLE *tmp_table, TMP_TABLE_PARAM *param);
+  void free();
+  bool is_inited() const { return inited; }
+  /** @return bytes used for the groups */
+  size_t memory_used() const { return used_memory; }
+
+  ulong hash_key() const;
+  uchar *find(ulong hash_value) const;
+  uchar *add(ulong hash_value, const uchar *row);
+
+  /** @return whether the groups of a hash value are in the table */
+  bool is_spilled(ulong hash_value) const
+  { return spilled & (1U << partition_of(hash_value)); }
+  uint largest_partition() const;
+  void spill(uint part);
+  /** @return the partition of the group of a row */
+  uint row_partition(const uchar *row) const
+  { return partition_of(((Group*) row - 1)->hash_value); }
+
+  /** @return the row of the group that was added first, or NULL */
+  uchar *first_row() const
+  { return first_added ? (uchar*) (first_added + 1) : NULL; }
+  /** @return the row of the group that was added after row, or NULL */
+  uchar *next_row(const uchar *row) const
+  {
+    Group *next= ((Group*) row - 1)->next_added;
+    return next ? (uchar*) (next + 1) : NULL;
+  }
+};
+
 /**
   @brief
     Class to perform postjoin aggregation operations
@@ -956,6 +1056,9 @@ class Pushdown_query;
                          table. Input records aren't expected to be sorted.
                          Tmp table uses the heap engine
       end_update_unique  Same as above, but the engine is myisam.
+      end_hash_update    Like end_update, but the groups are kept in
+                         group_hash until all records are read, except
+                         for the partitions that did not fit in memory.
 
     Lazy table initialization is used - the table will be instantiated and
     rnd/index scan started on the first put_record() call.
@@ -967,7 +1070,10 @@ class AGGR_OP :public Sql_alloc
 public:
   JOIN_TAB *join_tab;
 
-  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), write_func(NULL)
+  /** Groups of end_hash_update(), or NULL if it is not used */
+  Group_hash_table *group_hash;
+
+  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), group_hash(NULL), write_func(NULL)
   {};
 
   enum_nested_loop_state put_record() { return put_record(false); };
@@ -1685,6 +1791,7 @@ class JOIN :public Sql_alloc
     In this case we can stop scanning t2 when we have found one t1.a
   */
   void optimize_distinct();
+  void set_ft_limit();
 
   /**
     TRUE if the query contains an aggregate function but has no GROUP
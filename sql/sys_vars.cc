@@ -1601,6 +1601,24 @@ static Sys_var_ulonglong Sys_max_heap_table_size(
        VALID_RANGE(16384, SIZE_T_MAX), DEFAULT(16*1024*1024),
        BLOCK_SIZE(1024));
 
+static Sys_var_uint Sys_io_cache_async_threads(
+       "io_cache_async_threads",
+       "Number of background threads that read ahead and write behind for "
+       "sequentially accessed temporary files, like the ones of filesort "
+       "and LOAD DATA. 0 means that all such I/O is done by the connection",
+       READ_ONLY GLOBAL_VAR(opt_io_cache_async_threads),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 64), DEFAULT(0),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_mem_root_pool_size(
+       "mem_root_pool_size",
+       "Max number of bytes of freed memory root blocks that a connection "
+       "keeps for reuse by the following statements. Between statements "
+       "the pool is trimmed to what the connection has recently used. "
+       "0 disables the pool",
+       GLOBAL_VAR(my_mem_root_pool_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024*1024), DEFAULT(0), BLOCK_SIZE(1024));
+
 static ulong mdl_locks_cache_size;
 static Sys_var_ulong Sys_metadata_locks_cache_size(
        "metadata_locks_cache_size", "Unused",
@@ -2523,6 +2541,7 @@ export const char *optimizer_switch_names[]=
   "exists_to_in",
   "orderby_uses_equalities",
   "condition_pushdown_for_derived",
+  "hash_group_by",
   "default", 
   NullS
 };
@@ -92,7 +92,7 @@ Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
     full_size+= sizeof(element_count);
   with_counters= MY_TEST(min_dupl_count_arg);
   init_tree(&tree, (max_in_memory_size / 16), 0, size, comp_func,
-            NULL, comp_func_fixed_arg, MYF(MY_THREAD_SPECIFIC));
+            NULL, comp_func_fixed_arg, MYF(MY_THREAD_SPECIFIC | MY_TREE_BTREE));
   /* If the following fail's the next add will also fail */
   my_init_dynamic_array(&file_ptrs, sizeof(BUFFPEK), 16, 16,
                         MYF(MY_THREAD_SPECIFIC));
@@ -105,7 +105,7 @@ Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
     max_elements= 1;
 
   (void) open_cached_file(&file, mysql_tmpdir,TEMP_PREFIX, DISK_BUFFER_SIZE,
-                          MYF(MY_WME));
+                          MYF(MY_WME | MY_ASYNC_IO));
 }
 
 
@@ -410,7 +410,7 @@ Unique::reset()
   if (elements)
   {
     reset_dynamic(&file_ptrs);
-    reinit_io_cache(&file, WRITE_CACHE, 0L, 0, 1);
+    reinit_io_cache(&file, WRITE_CACHE, 0L, 1, 1);
   }
   my_free(sort.record_pointers);
   elements= 0;
@@ -54,8 +54,10 @@ class Unique :public Sql_alloc
   {
     DBUG_ENTER("unique_add");
     DBUG_PRINT("info", ("tree %u - %lu", tree.elements_in_tree, max_elements));
+    /* A B-tree may use more memory than max_elements elements */
     if (!(tree.flag & TREE_ONLY_DUPS) && 
-        tree.elements_in_tree >= max_elements && flush())
+        (tree.elements_in_tree >= max_elements ||
+         tree.allocated > max_in_memory_size) && flush())
       DBUG_RETURN(1);
     DBUG_RETURN(!tree_insert(&tree, ptr, 0, tree.custom_arg));
   }
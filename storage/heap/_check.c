@@ -18,8 +18,8 @@
 
 #include "heapdef.h"
 
-static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
-			 ulong blength, my_bool print_status);
+static int check_one_key(HP_INFO *info, uint keynr, ulong records,
+			 ulong blength, my_bool print_status, uchar *record);
 static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
 			    my_bool print_status);
 
@@ -33,7 +33,8 @@ static int check_one_rb_key(HP_INFO *info, uint keynr, ulong records,
     print_status	Prints some extra status
 
   NOTES
-    Doesn't change the state of the table handler
+    Doesn't change the state of the table handler, except for the buffer
+    that the BLOBs of the last read row are copied to
 
   RETURN VALUES
     0	ok
@@ -47,16 +48,25 @@ int heap_check_heap(HP_INFO *info, my_bool print_status)
   ulong records=0, deleted=0, pos, next_block;
   HP_SHARE *share=info->s;
   HP_INFO save_info= *info;			/* Needed because scan_init */
+  uchar *record= 0;
   DBUG_ENTER("heap_check_heap");
 
+  /* The hash of a key over BLOBs is of the row with the BLOBs in place */
+  if (share->blobs &&
+      !(record= (uchar*) my_malloc(share->reclength,
+                                   MYF(MY_WME | (share->internal ?
+                                                 MY_THREAD_SPECIFIC : 0)))))
+    DBUG_RETURN(1);
+
   for (error=key= 0 ; key < share->keys ; key++)
   {
     if (share->keydef[key].algorithm == HA_KEY_ALG_BTREE)
       error|= check_one_rb_key(info, key, share->records, print_status);
     else
-      error|= check_one_key(share->keydef + key, key, share->records,
-			    share->blength, print_status);
+      error|= check_one_key(info, key, share->records,
+			    share->blength, print_status, record);
   }
+  my_free(record);
   /*
     This is basicly the same code as in hp_scan, but we repeat it here to
     get shorter DBUG log file.
@@ -92,26 +102,42 @@ int heap_check_heap(HP_INFO *info, my_bool print_status)
                         deleted, (ulong) share->deleted));
     error= 1;
   }
+  /* hp_extract_record() may have replaced the BLOB buffer */
+  save_info.blob_buff= info->blob_buff;
+  save_info.blob_buff_length= info->blob_buff_length;
   *info= save_info;
   DBUG_RETURN(error);
 }
 
 
-static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
-			 ulong blength, my_bool print_status)
+static int check_one_key(HP_INFO *info, uint keynr, ulong records,
+			 ulong blength, my_bool print_status, uchar *record)
 {
   int error;
   ulong i,found,max_links,seek,links;
   ulong rec_link;				/* Only used with debugging */
   ulong hash_buckets_found;
   HASH_INFO *hash_info;
+  HP_KEYDEF *keydef= info->s->keydef + keynr;
+  const uchar *rec;
 
   error=0;
   hash_buckets_found= 0;
   for (i=found=max_links=seek=0 ; i < records ; i++)
   {
     hash_info=hp_find_hash(&keydef->block,i);
-    if (hash_info->hash_of_key != hp_rec_hashnr(keydef, hash_info->ptr_to_rec))
+    rec= hash_info->ptr_to_rec;
+    /* A stored row has the chunk chains instead of the BLOBs */
+    if (record)
+    {
+      if (hp_extract_record(info, record, rec))
+      {
+        error= 1;
+        continue;
+      }
+      rec= record;
+    }
+    if (hash_info->hash_of_key != hp_rec_hashnr(keydef, rec))
     {
       DBUG_PRINT("error",
                  ("Found row with wrong hash_of_key at position %lu", i));
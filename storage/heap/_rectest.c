@@ -21,9 +21,21 @@
 
 int hp_rectest(register HP_INFO *info, register const uchar *old)
 {
+  HP_SHARE *share= info->s;
+  HP_BLOBDEF *blob, *end;
+  uint start= 0;
   DBUG_ENTER("hp_rectest");
 
-  if (memcmp(info->current_ptr,old,(size_t) info->s->reclength))
+  /* The pointers of BLOB columns differ; compare only the lengths */
+  for (blob= share->blobdef, end= blob + share->blobs; blob < end; blob++)
+  {
+    uint ptr_start= blob->offset + blob->packlength;
+    if (memcmp(info->current_ptr + start, old + start, ptr_start - start))
+      DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED));
+    start= ptr_start + sizeof(uchar*);
+  }
+  if (memcmp(info->current_ptr + start, old + start,
+             (size_t) share->reclength - start))
   {
     DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED)); /* Record have changed */
   }
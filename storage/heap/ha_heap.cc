@@ -383,6 +383,8 @@ int ha_heap::info(uint flag)
   (void) heap_info(file,&hp_info,flag);
 
   errkey=                     hp_info.errkey;
+  if (flag & HA_STATUS_ERRKEY)
+    *(HEAP_PTR*) dup_ref= hp_info.dupp_key_pos;  // Ref is aligned
   stats.records=              hp_info.records;
   stats.deleted=              hp_info.deleted;
   stats.mean_rec_length=      hp_info.reclength;
@@ -618,8 +620,10 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOBDEF *blobdef;
   TABLE_SHARE *share= table_arg->s;
   bool found_real_auto_increment= 0;
+  THD *thd= current_thd;
 
   bzero(hp_create_info, sizeof(*hp_create_info));
 
@@ -627,10 +631,12 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
     parts+= table_arg->key_info[key].user_defined_key_parts;
 
   if (!(keydef= (HP_KEYDEF*) my_malloc(keys * sizeof(HP_KEYDEF) +
-				       parts * sizeof(HA_KEYSEG),
+				       parts * sizeof(HA_KEYSEG) +
+                                       share->blob_fields * sizeof(HP_BLOBDEF),
 				       MYF(MY_WME | MY_THREAD_SPECIFIC))))
     return my_errno;
   seg= reinterpret_cast<HA_KEYSEG*>(keydef + keys);
+  blobdef= reinterpret_cast<HP_BLOBDEF*>(seg + parts);
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -712,8 +718,26 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
         seg->bit_length= seg->bit_start= 0;
         seg->bit_pos= 0;
       }
+      if (field->flags & BLOB_FLAG)
+      {
+        /*
+          Only internal temporary tables have BLOBs. Their keys are unique
+          constraints over the whole BLOB, never used for lookups.
+        */
+        DBUG_ASSERT(internal_table && pos->algorithm != HA_KEY_ALG_BTREE);
+        seg->flag|= HA_BLOB_PART;
+        seg->length= 0;
+        seg->bit_start= (uint8) (field->pack_length() -
+                                 portable_sizeof_char_ptr);
+      }
     }
   }
+  for (uint i= 0; i < share->blob_fields; i++)
+  {
+    Field *field= table_arg->field[share->blob_field[i]];
+    blobdef[i].offset= (uint) (field->ptr - table_arg->record[0]);
+    blobdef[i].packlength= field->pack_length() - portable_sizeof_char_ptr;
+  }
   mem_per_row+= MY_ALIGN(share->reclength + 1, sizeof(char*));
   if (table_arg->found_next_number_field)
   {
@@ -722,7 +746,14 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   }
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
-  hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  hp_create_info->max_table_size= thd->variables.max_heap_table_size;
+  /*
+    max_rows doesn't bound the size of the BLOBs; limit the total size of
+    an internal table with BLOBs to tmp_memory_table_size as well.
+  */
+  if (internal_table && share->blob_fields)
+    set_if_smaller(hp_create_info->max_table_size,
+                   thd->variables.tmp_memory_table_size);
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
@@ -735,6 +766,8 @@ heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->keys= share->keys;
   hp_create_info->reclength= share->reclength;
   hp_create_info->keydef= keydef;
+  hp_create_info->blobs= share->blob_fields;
+  hp_create_info->blobdef= blobdef;
   return 0;
 }
 
@@ -32,6 +32,14 @@ C_MODE_START
 #define HP_MIN_RECORDS_IN_BLOCK 16
 #define HP_MAX_RECORDS_IN_BLOCK 8192
 
+/*
+  Size of a chunk of BLOB data, including the pointer to the next chunk
+  of the same BLOB at the start of the chunk.
+*/
+
+#define HP_BLOB_CHUNK_SIZE 256
+#define HP_BLOB_CHUNK_DATA (HP_BLOB_CHUNK_SIZE - sizeof(uchar*))
+
 	/* Some extern variables */
 
 extern LIST *heap_open_list,*heap_share_list;
@@ -86,7 +94,7 @@ extern ulong hp_mask(ulong hashnr,ulong buffmax,ulong maxlength);
 extern void hp_movelink(HASH_INFO *pos,HASH_INFO *next_link,
 			 HASH_INFO *newlink);
 extern int hp_rec_key_cmp(HP_KEYDEF *keydef,const uchar *rec1,
-			  const uchar *rec2);
+			  const uchar *rec2, HP_INFO *info);
 extern int hp_key_cmp(HP_KEYDEF *keydef,const uchar *rec,
 		      const uchar *key);
 extern void hp_make_key(HP_KEYDEF *keydef,uchar *key,const uchar *rec);
@@ -101,6 +109,15 @@ extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
 extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
                            key_part_map keypart_map);
+extern ulong hp_calc_blob_length(uint packlength, const uchar *pos);
+extern int hp_write_blobs(HP_INFO *info, const uchar *record, uchar *pos);
+extern int hp_update_blobs(HP_INFO *info, const uchar *old,
+                           const uchar *heap_new);
+extern void hp_free_new_blobs(HP_INFO *info);
+extern void hp_store_blobs(HP_INFO *info, uchar *pos, const uchar *heap_new);
+extern void hp_free_blobs(HP_SHARE *share, uchar *pos);
+extern int hp_extract_record(HP_INFO *info, uchar *record, const uchar *pos);
+extern uchar *hp_read_blob(HP_INFO *info, const uchar *chain, ulong length);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
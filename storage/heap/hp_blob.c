@@ -0,0 +1,421 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Storage of BLOB columns in heap tables
+
+  The data of a BLOB is stored in a chain of HP_BLOB_CHUNK_SIZE chunks
+  allocated from HP_SHARE::blob_block. Each chunk starts with a pointer
+  to the next chunk of the chain. In a stored row the pointer part of a
+  BLOB column points to the first chunk instead of to the data, and an
+  empty BLOB has no chunks. Free chunks are linked through
+  HP_SHARE::blob_del_link.
+
+  When a row is read, the BLOBs are copied to HP_INFO::blob_buff and the
+  BLOB columns of the returned record point there, so they are valid
+  until the next row is read from the handle.
+*/
+
+#include "heapdef.h"
+
+	/* Get the length of a BLOB stored in a record */
+
+ulong hp_calc_blob_length(uint packlength, const uchar *pos)
+{
+  switch (packlength) {
+  case 1:
+    return (ulong) *pos;
+  case 2:
+    return (ulong) uint2korr(pos);
+  case 3:
+    return (ulong) uint3korr(pos);
+  case 4:
+    return (ulong) uint4korr(pos);
+  default:
+    break;
+  }
+  DBUG_ASSERT(0);
+  return 0;
+}
+
+
+static uchar *hp_get_blob_ptr(const HP_BLOBDEF *blob, const uchar *record)
+{
+  uchar *ptr;
+  memcpy(&ptr, record + blob->offset + blob->packlength, sizeof(ptr));
+  return ptr;
+}
+
+
+static void hp_set_blob_ptr(const HP_BLOBDEF *blob, uchar *record, uchar *ptr)
+{
+  memcpy(record + blob->offset + blob->packlength, &ptr, sizeof(ptr));
+}
+
+
+/*
+  Allocate one chunk of BLOB data
+
+  SYNOPSIS
+    hp_alloc_blob_chunk()
+    share               Heap table
+    check_size          Whether to refuse to grow the table beyond
+                        max_table_size
+
+  RETURN
+    Pointer to the chunk, or 0 and my_errno set
+*/
+
+static uchar *hp_alloc_blob_chunk(HP_SHARE *share, my_bool check_size)
+{
+  HP_BLOCK *block= &share->blob_block;
+  ulong block_pos;
+  size_t length;
+  uchar *chunk;
+
+  if ((chunk= share->blob_del_link))
+  {
+    share->blob_del_link= *((uchar**) chunk);
+    return chunk;
+  }
+  if (!(block_pos= (block->last_allocated % block->records_in_block)))
+  {
+    if (check_size &&
+        share->data_length + share->index_length >= share->max_table_size)
+    {
+      my_errno= HA_ERR_RECORD_FILE_FULL;
+      return 0;
+    }
+    if (hp_get_new_block(share, block, &length))
+      return 0;
+    share->data_length+= length;
+  }
+  block->last_allocated++;
+  return ((uchar*) block->level_info[0].last_blocks +
+          block_pos * block->recbuffer);
+}
+
+
+	/* Give a chain of chunks back to the free list */
+
+static void hp_free_blob_chain(HP_SHARE *share, uchar *chain)
+{
+  uchar *last;
+
+  if (!chain)
+    return;
+  for (last= chain; *((uchar**) last); last= *((uchar**) last))
+    ;
+  *((uchar**) last)= share->blob_del_link;
+  share->blob_del_link= chain;
+}
+
+
+/*
+  Store BLOB data in a new chain of chunks
+
+  RETURN
+    0  ok, *chain is set (0 for an empty BLOB)
+    #  error number
+*/
+
+static int hp_write_blob_chain(HP_SHARE *share, const uchar *data,
+                               ulong length, my_bool check_size,
+                               uchar **chain)
+{
+  uchar **link= chain;
+
+  *chain= 0;
+  while (length)
+  {
+    ulong part= MY_MIN(length, HP_BLOB_CHUNK_DATA);
+    uchar *chunk;
+
+    if (!(chunk= hp_alloc_blob_chunk(share, check_size)))
+    {
+      hp_free_blob_chain(share, *chain);
+      *chain= 0;
+      return my_errno;
+    }
+    *link= chunk;
+    link= (uchar**) chunk;
+    memcpy(chunk + sizeof(uchar*), data, (size_t) part);
+    data+= part;
+    length-= part;
+  }
+  *link= 0;
+  return 0;
+}
+
+
+	/* Copy the data of a chain of chunks to a buffer */
+
+static void hp_copy_blob_chain(uchar *to, const uchar *chain, ulong length)
+{
+  while (length)
+  {
+    ulong part= MY_MIN(length, HP_BLOB_CHUNK_DATA);
+    memcpy(to, chain + sizeof(uchar*), (size_t) part);
+    to+= part;
+    length-= part;
+    chain= *((uchar**) chain);
+  }
+}
+
+
+/*
+  Store the BLOBs of a new row
+
+  SYNOPSIS
+    hp_write_blobs()
+    info                Heap table handle
+    record              Row to be written
+    pos                 Copy of record in the table
+
+  NOTES
+    The BLOB columns of pos are changed to point to the stored chains.
+    On error, nothing is left allocated.
+
+  RETURN
+    0  ok
+    #  error number
+*/
+
+int hp_write_blobs(HP_INFO *info, const uchar *record, uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOBDEF *blob, *end;
+
+  for (blob= share->blobdef, end= blob + share->blobs; blob < end; blob++)
+  {
+    ulong length= hp_calc_blob_length(blob->packlength,
+                                      record + blob->offset);
+    uchar *chain;
+
+    if (hp_write_blob_chain(share, hp_get_blob_ptr(blob, record), length,
+                            TRUE, &chain))
+    {
+      while (blob-- > share->blobdef)
+        hp_free_blob_chain(share, hp_get_blob_ptr(blob, pos));
+      return my_errno;
+    }
+    hp_set_blob_ptr(blob, pos, chain);
+  }
+  return 0;
+}
+
+
+/*
+  Store the BLOBs of an updated row
+
+  SYNOPSIS
+    hp_update_blobs()
+    info                Heap table handle, positioned on the row
+    old                 The row as read by the caller
+    heap_new            The new row
+
+  NOTES
+    The chains of the new row are saved in info->blob_chains until
+    hp_store_blobs() or hp_free_new_blobs() is called. A BLOB that did not
+    change keeps its old chain. The size of the table is not checked, as
+    for the other parts of the row.
+
+  RETURN
+    0  ok
+    #  error number
+*/
+
+int hp_update_blobs(HP_INFO *info, const uchar *old, const uchar *heap_new)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    ulong length= hp_calc_blob_length(blob->packlength,
+                                      heap_new + blob->offset);
+    uchar *data= hp_get_blob_ptr(blob, heap_new);
+    uchar *old_data= hp_get_blob_ptr(blob, old);
+
+    if (length == hp_calc_blob_length(blob->packlength, old + blob->offset) &&
+        (data == old_data || !memcmp(data, old_data, (size_t) length)))
+    {
+      info->blob_chains[i]= hp_get_blob_ptr(blob, info->current_ptr);
+      continue;
+    }
+    if (hp_write_blob_chain(share, data, length, FALSE,
+                            info->blob_chains + i))
+    {
+      while (i--)
+      {
+        blob= share->blobdef + i;
+        if (info->blob_chains[i] != hp_get_blob_ptr(blob, info->current_ptr))
+          hp_free_blob_chain(share, info->blob_chains[i]);
+      }
+      return my_errno;
+    }
+  }
+  return 0;
+}
+
+
+	/* Free the chains allocated by hp_update_blobs() */
+
+void hp_free_new_blobs(HP_INFO *info)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    if (info->blob_chains[i] != hp_get_blob_ptr(blob, info->current_ptr))
+      hp_free_blob_chain(share, info->blob_chains[i]);
+  }
+}
+
+
+/*
+  Replace a stored row with the new row of hp_update_blobs()
+
+  SYNOPSIS
+    hp_store_blobs()
+    info                Heap table handle
+    pos                 Stored row
+    heap_new            The new row
+*/
+
+void hp_store_blobs(HP_INFO *info, uchar *pos, const uchar *heap_new)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    HP_BLOBDEF *blob= share->blobdef + i;
+    uchar *chain= hp_get_blob_ptr(blob, pos);
+    if (chain != info->blob_chains[i])
+      hp_free_blob_chain(share, chain);
+  }
+  memcpy(pos, heap_new, (size_t) share->reclength);
+  for (i= 0; i < share->blobs; i++)
+    hp_set_blob_ptr(share->blobdef + i, pos, info->blob_chains[i]);
+}
+
+
+	/* Free the BLOBs of a stored row */
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  HP_BLOBDEF *blob, *end;
+
+  for (blob= share->blobdef, end= blob + share->blobs; blob < end; blob++)
+    hp_free_blob_chain(share, hp_get_blob_ptr(blob, pos));
+}
+
+
+/*
+  Copy a stored row to a record
+
+  SYNOPSIS
+    hp_extract_record()
+    info                Heap table handle
+    record              Store row here
+    pos                 Stored row
+
+  RETURN
+    0  ok
+    #  error number
+*/
+
+int hp_extract_record(HP_INFO *info, uchar *record, const uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOBDEF *blob, *end;
+  size_t total_length= 0;
+  uchar *to;
+
+  memcpy(record, pos, (size_t) share->reclength);
+  if (!share->blobs)
+    return 0;
+
+  end= share->blobdef + share->blobs;
+  for (blob= share->blobdef; blob < end; blob++)
+    total_length+= hp_calc_blob_length(blob->packlength, pos + blob->offset);
+
+  if (total_length > info->blob_buff_length)
+  {
+    my_free(info->blob_buff);
+    if (!(info->blob_buff= (uchar*) my_malloc(total_length,
+                                              MYF(MY_WME |
+                                                  (share->internal ?
+                                                   MY_THREAD_SPECIFIC : 0)))))
+    {
+      info->blob_buff_length= 0;
+      return my_errno= HA_ERR_OUT_OF_MEM;
+    }
+    info->blob_buff_length= total_length;
+  }
+
+  for (blob= share->blobdef, to= info->blob_buff; blob < end; blob++)
+  {
+    ulong length= hp_calc_blob_length(blob->packlength, pos + blob->offset);
+    if (length)
+    {
+      hp_copy_blob_chain(to, hp_get_blob_ptr(blob, pos), length);
+      hp_set_blob_ptr(blob, record, to);
+      to+= length;
+    }
+  }
+  return 0;
+}
+
+
+/*
+  Read a BLOB of a stored row for a key comparison
+
+  SYNOPSIS
+    hp_read_blob()
+    info                Heap table handle
+    chain               First chunk of the BLOB
+    length              Length of the BLOB
+
+  NOTES
+    The data is copied to info->blob_key_buff, which is only used for
+    comparing keys, so that the row last read with the handle stays valid.
+
+  RETURN
+    Pointer to the data, or 0 if out of memory
+*/
+
+uchar *hp_read_blob(HP_INFO *info, const uchar *chain, ulong length)
+{
+  if (length > info->blob_key_buff_length)
+  {
+    my_free(info->blob_key_buff);
+    if (!(info->blob_key_buff=
+          (uchar*) my_malloc((size_t) length,
+                             MYF(MY_WME | (info->s->internal ?
+                                           MY_THREAD_SPECIFIC : 0)))))
+    {
+      info->blob_key_buff_length= 0;
+      return 0;
+    }
+    info->blob_key_buff_length= (size_t) length;
+  }
+  hp_copy_blob_chain(info->blob_key_buff, chain, length);
+  return info->blob_key_buff;
+}
@@ -77,6 +77,16 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
 	  if (keyinfo->algorithm == HA_KEY_ALG_BTREE)
 	    keyinfo->rb_tree.size_of_element++;
 	}
+        if (keyinfo->seg[j].flag & HA_BLOB_PART)
+        {
+          /*
+            A hash of the whole BLOB: the key can only be used to check
+            for duplicates, not for lookups.
+          */
+          DBUG_ASSERT(keyinfo->algorithm == HA_KEY_ALG_HASH);
+          keyinfo->flag|= HA_UNIQUE_CHECK;
+          continue;
+        }
 	switch (keyinfo->seg[j].type) {
 	case HA_KEYTYPE_SHORT_INT:
 	case HA_KEYTYPE_LONG_INT:
@@ -146,7 +156,8 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     }
     if (!(share= (HP_SHARE*) my_malloc((uint) sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+                                       create_info->blobs*sizeof(HP_BLOBDEF),
 				       MYF(MY_ZEROFILL |
                                            (create_info->internal_table ?
                                             MY_THREAD_SPECIFIC : 0)))))
@@ -191,6 +202,15 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
       if ((keyinfo->flag & HA_AUTO_KEY) && create_info->with_auto_increment)
         share->auto_key= i + 1;
     }
+    share->blobdef= (HP_BLOBDEF*) keyseg;
+    share->blobs= create_info->blobs;
+    if (share->blobs)
+    {
+      memcpy(share->blobdef, create_info->blobdef,
+             (size_t) (sizeof(HP_BLOBDEF) * share->blobs));
+      init_block(&share->blob_block, HP_BLOB_CHUNK_SIZE, min_records,
+                 max_records);
+    }
     share->min_records= min_records;
     share->max_records= max_records;
     share->max_table_size= create_info->max_table_size;
@@ -321,7 +321,13 @@ ulong hp_rec_hashnr(register HP_KEYDEF *keydef, register const uchar *rec)
 	continue;
       }
     }
-    if (seg->type == HA_KEYTYPE_TEXT)
+    if (seg->flag & HA_BLOB_PART)
+    {
+      ulong length= hp_calc_blob_length(seg->bit_start, pos);
+      memcpy(&pos, pos + seg->bit_start, sizeof(char*));
+      seg->charset->coll->hash_sort(seg->charset, pos, length, &nr, &nr2);
+    }
+    else if (seg->type == HA_KEYTYPE_TEXT)
     {
       CHARSET_INFO *cs= seg->charset;
       uint char_length= seg->length;
@@ -465,7 +471,13 @@ ulong hp_rec_hashnr(register HP_KEYDEF *keydef, register const uchar *rec)
 	continue;
       }
     }
-    if (seg->type == HA_KEYTYPE_TEXT)
+    if (seg->flag & HA_BLOB_PART)
+    {
+      ulong length= hp_calc_blob_length(seg->bit_start, pos);
+      memcpy(&pos, pos + seg->bit_start, sizeof(char*));
+      seg->charset->coll->hash_sort(seg->charset, pos, length, &nr, &nr2);
+    }
+    else if (seg->type == HA_KEYTYPE_TEXT)
     {
       uint char_length= seg->length; /* TODO: fix to use my_charpos() */
       seg->charset->coll->hash_sort(seg->charset, pos, char_length,
@@ -513,6 +525,8 @@ ulong hp_rec_hashnr(register HP_KEYDEF *keydef, register const uchar *rec)
     keydef		Key definition
     rec1		Record to compare
     rec2		Other record to compare
+    info		If not 0, rec2 is a row stored in the table and
+                        its BLOBs are read with this handle
 
   NOTES
     diff_if_only_endspace_difference is used to allow us to insert
@@ -523,7 +537,8 @@ ulong hp_rec_hashnr(register HP_KEYDEF *keydef, register const uchar *rec)
     <> 0 	Key differes
 */
 
-int hp_rec_key_cmp(HP_KEYDEF *keydef, const uchar *rec1, const uchar *rec2)
+int hp_rec_key_cmp(HP_KEYDEF *keydef, const uchar *rec1, const uchar *rec2,
+                   HP_INFO *info)
 {
   HA_KEYSEG *seg,*endseg;
 
@@ -537,7 +552,20 @@ int hp_rec_key_cmp(HP_KEYDEF *keydef, const uchar *rec1, const uchar *rec2)
       if (rec1[seg->null_pos] & seg->null_bit)
 	continue;
     }
-    if (seg->type == HA_KEYTYPE_TEXT)
+    if (seg->flag & HA_BLOB_PART)
+    {
+      ulong length1= hp_calc_blob_length(seg->bit_start, rec1 + seg->start);
+      ulong length2= hp_calc_blob_length(seg->bit_start, rec2 + seg->start);
+      uchar *pos1, *pos2;
+      memcpy(&pos1, rec1 + seg->start + seg->bit_start, sizeof(char*));
+      memcpy(&pos2, rec2 + seg->start + seg->bit_start, sizeof(char*));
+      if (info && length2 && !(pos2= hp_read_blob(info, pos2, length2)))
+        return 1;
+      if (seg->charset->coll->strnncollsp(seg->charset,
+                                          pos1, length1, pos2, length2))
+        return 1;
+    }
+    else if (seg->type == HA_KEYTYPE_TEXT)
     {
       CHARSET_INFO *cs= seg->charset;
       uint char_length1;
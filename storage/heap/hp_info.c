@@ -38,6 +38,7 @@ int heap_info(reg1 HP_INFO *info,reg2 HEAPINFO *x, int flag )
   x->index_length    = info->s->index_length;
   x->max_records     = info->s->max_records;
   x->errkey          = info->errkey;
+  x->dupp_key_pos    = info->dupp_key_pos;
   x->create_time     = info->s->create_time;
   if (flag & HA_STATUS_AUTO)
     x->auto_increment= info->s->auto_increment + 1;
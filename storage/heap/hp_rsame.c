@@ -48,8 +48,7 @@ int heap_rsame(register HP_INFO *info, uchar *record, int inx)
 	DBUG_RETURN(my_errno);
       }
     }
-    memcpy(record,info->current_ptr,(size_t) share->reclength);
-    DBUG_RETURN(0);
+    DBUG_RETURN(hp_extract_record(info, record, info->current_ptr));
   }
   info->update=0;
 
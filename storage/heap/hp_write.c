@@ -46,6 +46,10 @@ int heap_write(HP_INFO *info, const uchar *record)
     DBUG_RETURN(my_errno);
   share->changed=1;
 
+  memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs && hp_write_blobs(info, record, pos))
+    goto err_blobs;
+
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
        keydef++)
   {
@@ -53,7 +57,6 @@ int heap_write(HP_INFO *info, const uchar *record)
       goto err;
   }
 
-  memcpy(pos,record,(size_t) share->reclength);
   pos[share->reclength]=1;		/* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -88,7 +91,10 @@ int heap_write(HP_INFO *info, const uchar *record)
       break;
     keydef--;
   } 
+  if (share->blobs)
+    hp_free_blobs(share, pos);
 
+err_blobs:
   share->deleted++;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
@@ -123,6 +129,7 @@ int hp_rb_write_key(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *record,
   if (!tree_insert(&keyinfo->rb_tree, (void*)info->recbuf,
 		   custom_arg.key_length, &custom_arg))
   {
+    info->dupp_key_pos= 0;
     my_errno= HA_ERR_FOUND_DUPP_KEY;
     return 1;
   }
@@ -386,8 +393,9 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
       do
       {
 	if (pos->hash_of_key == hash_of_key &&
-            ! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec))
+            ! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, info))
 	{
+          info->dupp_key_pos= pos->ptr_to_rec;
 	  DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
 	}
       } while ((pos=pos->next_key));
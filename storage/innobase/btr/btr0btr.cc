@@ -1926,6 +1926,68 @@ btr_page_empty(
 	}
 }
 
+/** Empty an index tree, freeing all pages except the root page.
+The caller must hold an exclusive lock on the table.
+@param[in,out]	index	index tree */
+void
+btr_empty_tree(dict_index_t* index)
+{
+	mtr_t	mtr;
+	mtr.start();
+	mtr.set_named_space(index->space);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	buf_block_t*	root = btr_root_block_get(index, RW_X_LATCH, &mtr);
+
+	if (root == NULL) {
+		mtr.commit();
+		return;
+	}
+
+	/* Free the pages of the leaf segment, but keep its inode,
+	so that the root page can keep pointing to it. */
+	for (;;) {
+		mtr_t	fmtr;
+		ulint	used;
+
+		fmtr.start();
+		fmtr.set_named_space(index->space);
+
+		fseg_header_t*	header = root->frame + PAGE_HEADER
+			+ PAGE_BTR_SEG_LEAF;
+
+		if (!fseg_n_reserved_pages(header, &used, &fmtr)) {
+			fmtr.commit();
+			break;
+		}
+
+		ibool	finished = fseg_free_step_not_header(
+			header, true, &fmtr);
+		fmtr.commit();
+		ut_a(!finished);
+	}
+
+	/* Free the non-leaf pages, except the root page. */
+	for (;;) {
+		mtr_t	fmtr;
+
+		fmtr.start();
+		fmtr.set_named_space(index->space);
+
+		ibool	finished = fseg_free_step_not_header(
+			root->frame + PAGE_HEADER + PAGE_BTR_SEG_TOP,
+			true, &fmtr);
+		fmtr.commit();
+
+		if (finished) {
+			break;
+		}
+	}
+
+	btr_page_empty(root, buf_block_get_page_zip(root), index, 0, &mtr);
+	mtr.commit();
+}
+
 /*************************************************************//**
 Makes tree one level higher by splitting the root, and inserts
 the tuple. It is assumed that mtr contains an x-latch on the tree.
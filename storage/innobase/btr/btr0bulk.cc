@@ -28,11 +28,44 @@ Created 03/11/2014 Shaohua Wang
 #include "btr0btr.h"
 #include "btr0cur.h"
 #include "btr0pcur.h"
+#include "gis0rtree.h"
 #include "ibuf0ibuf.h"
+#include "rem0cmp.h"
+
+#include <algorithm>
+#include <math.h>
 
 /** Innodb B-tree index fill factor for bulk load. */
 long	innobase_fill_factor;
 
+/** A record on an R-tree page and its offsets, for PageBulk::sortRecs() */
+struct rtr_bulk_rec_t {
+	/** the record */
+	rec_t*		rec;
+	/** rec_get_offsets(rec) */
+	ulint*		offsets;
+};
+
+/** Orders the records of an R-tree page like page_cur_search() */
+class rtr_bulk_rec_less {
+public:
+	/** Constructor
+	@param[in]	index	spatial index */
+	explicit rtr_bulk_rec_less(const dict_index_t* index)
+		: m_index(index) {}
+
+	/** @return whether a sorts before b */
+	bool operator()(const rtr_bulk_rec_t& a, const rtr_bulk_rec_t& b) const
+	{
+		return(cmp_rec_rec(a.rec, b.rec, a.offsets, b.offsets,
+				   m_index) < 0);
+	}
+
+private:
+	/** spatial index */
+	const dict_index_t*	m_index;
+};
+
 /** Initialize members, allocate page if needed and start mtr.
 Note: we commit all mtrs on failure.
 @return error code. */
@@ -94,10 +127,9 @@ PageBulk::init()
 			page_create_zip(new_block, m_index, m_level, 0,
 					NULL, mtr);
 		} else {
-			ut_ad(!dict_index_is_spatial(m_index));
 			page_create(new_block, mtr,
 				    dict_table_is_comp(m_index->table),
-				    false);
+				    dict_index_is_spatial(m_index));
 			btr_page_set_level(new_page, NULL, m_level, mtr);
 		}
 
@@ -172,8 +204,10 @@ PageBulk::insert(
 	rec_size = rec_offs_size(offsets);
 
 #ifdef UNIV_DEBUG
-	/* Check whether records are in order. */
-	if (!page_rec_is_infimum(m_cur_rec)) {
+	/* Check whether records are in order. R-tree pages are sorted
+	in finish(). */
+	if (!page_rec_is_infimum(m_cur_rec)
+	    && !dict_index_is_spatial(m_index)) {
 		rec_t*	old_rec = m_cur_rec;
 		ulint*	old_offsets = rec_get_offsets(
 			old_rec, m_index, NULL,	page_rec_is_leaf(old_rec),
@@ -222,6 +256,60 @@ PageBulk::insert(
 	m_cur_rec = insert_rec;
 }
 
+/** Sort the records of an R-tree page. RtrBulk inserts the records
+in STR order, but the records of a page must be in the order of
+cmp_rec_rec(), like in a B-tree. */
+void
+PageBulk::sortRecs()
+{
+	ut_ad(dict_index_is_spatial(m_index));
+
+	const bool	is_leaf = page_is_leaf(m_page);
+	rtr_bulk_rec_t*	recs = static_cast<rtr_bulk_rec_t*>(
+		mem_heap_alloc(m_heap, m_rec_no * sizeof *recs));
+	rec_t*		rec = page_get_infimum_rec(m_page);
+
+	for (ulint i = 0; i < m_rec_no; i++) {
+		rec = page_rec_get_next(rec);
+		recs[i].rec = rec;
+		recs[i].offsets = rec_get_offsets(
+			rec, m_index, NULL, is_leaf, ULINT_UNDEFINED,
+			&m_heap);
+	}
+
+	ut_ad(page_rec_is_supremum(page_rec_get_next(rec)));
+
+	std::sort(recs, recs + m_rec_no, rtr_bulk_rec_less(m_index));
+
+	/* Relink the records in the sorted order. The heap numbers
+	stay in the order of insertion. */
+	rec = page_get_infimum_rec(m_page);
+
+	for (ulint i = 0; i < m_rec_no; i++) {
+		page_rec_set_next(rec, recs[i].rec);
+		rec = recs[i].rec;
+	}
+
+	page_rec_set_next(rec, page_get_supremum_rec(m_page));
+	m_cur_rec = rec;
+
+	/* The first node pointer on the leftmost page of a non-leaf
+	level must be marked as the predefined minimum record. */
+	if (!is_leaf && btr_page_get_prev(m_page, m_mtr) == FIL_NULL) {
+		rec = recs[0].rec;
+
+		if (m_is_comp) {
+			rec_set_info_bits_new(
+				rec, rec_get_info_bits(rec, TRUE)
+				| REC_INFO_MIN_REC_FLAG);
+		} else {
+			rec_set_info_bits_old(
+				rec, rec_get_info_bits(rec, FALSE)
+				| REC_INFO_MIN_REC_FLAG);
+		}
+	}
+}
+
 /** Mark end of insertion to the page. Scan all records to set page dirs,
 and set page header members.
 Note: we refer to page_copy_rec_list_end_to_created_page. */
@@ -230,6 +318,10 @@ PageBulk::finish()
 {
 	ut_ad(m_rec_no > 0);
 
+	if (dict_index_is_spatial(m_index)) {
+		sortRecs();
+	}
+
 #ifdef UNIV_DEBUG
 	ut_ad(m_total_data + page_dir_calc_reserved_space(m_rec_no)
 	      <= page_get_free_space_of_empty(m_is_comp));
@@ -287,7 +379,6 @@ PageBulk::finish()
 	page_dir_slot_set_rec(slot, page_get_supremum_rec(m_page));
 	page_dir_slot_set_n_owned(slot, NULL, count + 1);
 
-	ut_ad(!dict_index_is_spatial(m_index));
 	page_dir_set_n_slots(m_page, NULL, 2 + slot_index);
 	page_header_set_ptr(m_page, NULL, PAGE_HEAP_TOP, m_heap_top);
 	page_dir_set_n_heap(m_page, NULL, PAGE_HEAP_NO_USER_LOW + m_rec_no);
@@ -344,8 +435,19 @@ PageBulk::getNodePtr()
 	/* Create node pointer */
 	first_rec = page_rec_get_next(page_get_infimum_rec(m_page));
 	ut_a(page_rec_is_user_rec(first_rec));
-	node_ptr = dict_index_build_node_ptr(m_index, first_rec, m_page_no,
-					     m_heap, m_level);
+
+	if (dict_index_is_spatial(m_index)) {
+		rtr_mbr_t	mbr;
+
+		rtr_page_cal_mbr(m_index, m_block, &mbr, m_heap);
+		node_ptr = rtr_index_build_node_ptr(m_index, &mbr, first_rec,
+						    m_page_no, m_heap,
+						    m_level);
+	} else {
+		node_ptr = dict_index_build_node_ptr(m_index, first_rec,
+						     m_page_no, m_heap,
+						     m_level);
+	}
 
 	return(node_ptr);
 }
@@ -582,8 +684,6 @@ Note: log_free_check requires holding no lock/latch in current thread. */
 void
 PageBulk::release()
 {
-	ut_ad(!dict_index_is_spatial(m_index));
-
 	/* We fix the block because we will re-pin it soon. */
 	buf_block_buf_fix_inc(m_block, __FILE__, __LINE__);
 
@@ -998,3 +1098,399 @@ BtrBulk::finish(dberr_t	err)
 	ut_ad(err != DB_SUCCESS || btr_validate_index(m_index, NULL, false));
 	return(err);
 }
+
+/** Convert an entry to a record and append it to a vector.
+@param[in,out]	entries	vector of entries
+@param[in,out]	heap	memory heap for the record
+@param[in]	tuple	entry; the first field is the MBR
+@return size of the record in bytes */
+ulint
+RtrBulk::add(
+	entry_vector&	entries,
+	mem_heap_t*	heap,
+	const dtuple_t*	tuple)
+{
+	ulint		rec_size = rec_get_converted_size(m_index, tuple, 0);
+	entry_t		entry;
+	rtr_mbr_t	mbr;
+
+	entry.rec = rec_convert_dtuple_to_rec(
+		static_cast<byte*>(mem_heap_alloc(heap, rec_size)),
+		m_index, tuple, 0);
+
+	rtr_read_mbr(static_cast<const byte*>(
+			     dfield_get_data(dtuple_get_nth_field(tuple, 0))),
+		     &mbr);
+
+	entry.x = (mbr.xmin + mbr.xmax) / 2;
+	entry.y = (mbr.ymin + mbr.ymax) / 2;
+
+	entries.push_back(entry);
+
+	return(rec_size);
+}
+
+/** Release the page being filled if the redo log needs a
+checkpoint, and check for it */
+void
+RtrBulk::logFreeCheck()
+{
+	if (log_sys->check_flush_or_checkpoint) {
+		m_page_bulk->release();
+
+		log_free_check();
+
+		m_page_bulk->latch();
+	}
+}
+
+/** Write entries to the pages of a level in STR order.
+@param[in,out]	entries	entries, emptied on return
+@param[in]	size	total size of the records in bytes
+@param[in]	level	page level
+@return error code */
+dberr_t
+RtrBulk::pack(
+	entry_vector&	entries,
+	ulint		size,
+	ulint		level)
+{
+	const ulint	n_entries = entries.size();
+	dberr_t		err = DB_SUCCESS;
+
+	if (n_entries == 0) {
+		return(err);
+	}
+
+	/* Estimate how many records fit on a page, and the number of
+	pages P that the entries fill. Sort the entries into slices of
+	ceil(sqrt(P)) pages by x, and each slice by y. */
+	ulint	n_per_page = page_get_free_space_of_empty(
+		dict_table_is_comp(m_index->table))
+		* ulint(innobase_fill_factor) / 100
+		/ (size / n_entries + PAGE_DIR_SLOT_SIZE);
+
+	if (n_per_page < 2) {
+		n_per_page = 2;
+	}
+
+	ulint	n_pages = (n_entries + n_per_page - 1) / n_per_page;
+	ulint	slice = n_per_page * ulint(ceil(sqrt(double(n_pages))));
+
+	std::sort(entries.begin(), entries.end(), lessX);
+
+	for (ulint i = 0; i < n_entries; i += slice) {
+		std::sort(entries.begin() + i,
+			  entries.begin() + std::min(i + slice, n_entries),
+			  lessY);
+	}
+
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	rec_offs_init(offsets_);
+
+	for (ulint i = 0; i < n_entries; i++) {
+		const rec_t*	rec = entries[i].rec;
+
+		offsets = rec_get_offsets(rec, m_index, offsets, level == 0,
+					  ULINT_UNDEFINED, &heap);
+
+		if (m_page_bulk == NULL) {
+			m_page_bulk = UT_NEW_NOKEY(
+				PageBulk(m_index, m_trx_id, FIL_NULL, level,
+					 m_flush_observer));
+			err = m_page_bulk->init();
+
+			if (err != DB_SUCCESS) {
+				UT_DELETE(m_page_bulk);
+				m_page_bulk = NULL;
+				break;
+			}
+		} else if ((i % slice == 0 && m_page_bulk->getRecNo() > 0)
+			   || !m_page_bulk->isSpaceAvailable(
+				   rec_offs_size(offsets))) {
+			/* Start a new page for a new slice, or when
+			the page is full. */
+			PageBulk*	sibling_page_bulk = UT_NEW_NOKEY(
+				PageBulk(m_index, m_trx_id, FIL_NULL, level,
+					 m_flush_observer));
+			err = sibling_page_bulk->init();
+
+			if (err != DB_SUCCESS) {
+				UT_DELETE(sibling_page_bulk);
+				break;
+			}
+
+			err = pageCommit(m_page_bulk, sibling_page_bulk);
+
+			if (err != DB_SUCCESS) {
+				sibling_page_bulk->commit(false);
+				UT_DELETE(sibling_page_bulk);
+				break;
+			}
+
+			UT_DELETE(m_page_bulk);
+			m_page_bulk = sibling_page_bulk;
+
+			/* Important: log_free_check whether we need
+			a checkpoint. */
+			if (level == 0) {
+				if (m_flush_observer->check_interrupted()) {
+					err = DB_INTERRUPTED;
+					break;
+				}
+
+				/* Wake up page cleaner to flush dirty
+				pages. */
+				srv_inc_activity_count();
+				os_event_set(buf_flush_event);
+
+				logFreeCheck();
+			}
+		}
+
+		m_page_bulk->insert(rec, offsets);
+	}
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+
+	entries.clear();
+
+	return(err);
+}
+
+/** Split a page of a compressed table that failed to compress.
+@param[in]	page_bulk	page to split
+@param[in]	next_page_bulk	next page, or NULL
+@return error code */
+dberr_t
+RtrBulk::pageSplit(
+	PageBulk*	page_bulk,
+	PageBulk*	next_page_bulk)
+{
+	ut_ad(page_bulk->getPageZip() != NULL);
+
+	if (page_bulk->getRecNo() <= 1) {
+		return(DB_TOO_BIG_RECORD);
+	}
+
+	PageBulk	new_page_bulk(m_index, m_trx_id, FIL_NULL,
+				      page_bulk->getLevel(), m_flush_observer);
+	dberr_t		err = new_page_bulk.init();
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	/* Move the upper half of the records to the new page. The
+	node pointers to both pages carry their own MBRs. */
+	rec_t*	split_rec = page_bulk->getSplitRec();
+	new_page_bulk.copyIn(split_rec);
+	page_bulk->copyOut(split_rec);
+
+	err = pageCommit(page_bulk, &new_page_bulk);
+
+	if (err == DB_SUCCESS) {
+		err = pageCommit(&new_page_bulk, next_page_bulk);
+	}
+
+	if (err != DB_SUCCESS) {
+		new_page_bulk.commit(false);
+	}
+
+	return(err);
+}
+
+/** Commit(finish) a page, and buffer the node pointer to it
+for the level above.
+@param[in]	page_bulk	page to commit
+@param[in]	next_page_bulk	next page, or NULL
+@return error code */
+dberr_t
+RtrBulk::pageCommit(
+	PageBulk*	page_bulk,
+	PageBulk*	next_page_bulk)
+{
+	page_bulk->finish();
+
+	if (next_page_bulk != NULL) {
+		ut_ad(page_bulk->getLevel() == next_page_bulk->getLevel());
+
+		page_bulk->setNext(next_page_bulk->getPageNo());
+		next_page_bulk->setPrev(page_bulk->getPageNo());
+	} else {
+		page_bulk->setNext(FIL_NULL);
+	}
+
+	if (page_bulk->getPageZip() != NULL && !page_bulk->compress()) {
+		return(pageSplit(page_bulk, next_page_bulk));
+	}
+
+	/* Only sortRecs() may mark a node pointer as the minimum
+	record, so that it is the first one of its page. */
+	dtuple_t*	node_ptr = page_bulk->getNodePtr();
+
+	dtuple_set_info_bits(node_ptr, dtuple_get_info_bits(node_ptr)
+			     & ~REC_INFO_MIN_REC_FLAG);
+
+	m_node_size += add(m_nodes, m_node_heap, node_ptr);
+	m_last_page_no = page_bulk->getPageNo();
+
+	page_bulk->commit(true);
+
+	return(DB_SUCCESS);
+}
+
+/** Write the buffered entries to leaf pages in STR order.
+Note: the caller must not hold any latches, because we may
+call log_free_check().
+@return error code */
+dberr_t
+RtrBulk::flush()
+{
+	if (m_entries.empty()) {
+		return(DB_SUCCESS);
+	}
+
+	if (m_page_bulk != NULL) {
+		m_page_bulk->latch();
+	}
+
+	dberr_t	err = pack(m_entries, m_size, 0);
+
+	m_size = 0;
+	mem_heap_empty(m_heap);
+
+	if (m_page_bulk != NULL) {
+		if (err == DB_SUCCESS) {
+			/* Keep the last leaf page open for the next
+			batch. */
+			m_page_bulk->release();
+		} else {
+			m_page_bulk->commit(false);
+			UT_DELETE(m_page_bulk);
+			m_page_bulk = NULL;
+		}
+	}
+
+	return(err);
+}
+
+/** Copy the last written page to the root page.
+@param[in]	level	level of the last written page
+@return error code */
+dberr_t
+RtrBulk::copyToRoot(
+	ulint	level)
+{
+	mtr_t		mtr;
+	page_id_t	page_id(dict_index_get_space(m_index), m_last_page_no);
+	page_size_t	page_size(dict_table_page_size(m_index->table));
+	PageBulk	root_page_bulk(m_index, m_trx_id,
+				       dict_index_get_page(m_index), level,
+				       m_flush_observer);
+
+	mtr_start(&mtr);
+	mtr.set_named_space(dict_index_get_space(m_index));
+	mtr_x_lock(dict_index_get_lock(m_index), &mtr);
+
+	ut_ad(m_last_page_no != FIL_NULL);
+	buf_block_t*	last_block = btr_block_get(
+		page_id, page_size, RW_X_LATCH, m_index, &mtr);
+	rec_t*		first_rec = page_rec_get_next(
+		page_get_infimum_rec(buf_block_get_frame(last_block)));
+	ut_ad(page_rec_is_user_rec(first_rec));
+
+	/* Copy last page to root page. */
+	dberr_t	err = root_page_bulk.init();
+
+	if (err != DB_SUCCESS) {
+		mtr_commit(&mtr);
+		return(err);
+	}
+
+	root_page_bulk.copyIn(first_rec);
+
+	/* Remove last page. */
+	btr_page_free_low(m_index, last_block, level, false, &mtr);
+
+	/* Do not flush the last page. */
+	last_block->page.flush_observer = NULL;
+
+	mtr_commit(&mtr);
+
+	err = pageCommit(&root_page_bulk, NULL);
+	ut_ad(err == DB_SUCCESS);
+
+	return(err);
+}
+
+/** R-tree bulk load finish. We write the buffered entries, build
+the non-leaf levels and copy the top page to the root page of the
+index if no error occurs.
+@param[in]	err	whether bulk load was successful until now
+@return error code */
+dberr_t
+RtrBulk::finish(
+	dberr_t	err)
+{
+	ut_ad(!dict_table_is_temporary(m_index->table));
+
+	if (err == DB_SUCCESS) {
+		err = flush();
+	}
+
+	ulint	level = 0;
+
+	/* Build the levels bottom up until a level fits on one page. */
+	for (;;) {
+		if (m_page_bulk != NULL) {
+			if (level == 0) {
+				m_page_bulk->latch();
+			}
+
+			if (err == DB_SUCCESS) {
+				err = pageCommit(m_page_bulk, NULL);
+			}
+
+			if (err != DB_SUCCESS) {
+				m_page_bulk->commit(false);
+			}
+
+			UT_DELETE(m_page_bulk);
+			m_page_bulk = NULL;
+		}
+
+		if (err != DB_SUCCESS || m_nodes.size() <= 1) {
+			break;
+		}
+
+		/* The node pointers of this level become the entries
+		of the level above. */
+		entry_vector	entries;
+		ulint		size = m_node_size;
+
+		entries.swap(m_nodes);
+		m_node_size = 0;
+		std::swap(m_heap, m_node_heap);
+
+		err = pack(entries, size, ++level);
+
+		mem_heap_empty(m_heap);
+	}
+
+	if (err == DB_SUCCESS && !m_nodes.empty()) {
+		ut_ad(m_nodes.size() == 1);
+		err = copyToRoot(level);
+	}
+
+	m_nodes.clear();
+
+	ut_ad(!sync_check_iterate(dict_sync_check()));
+
+	ut_ad(err != DB_SUCCESS || btr_validate_index(m_index, NULL, false));
+	return(err);
+}
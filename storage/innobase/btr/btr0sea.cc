@@ -77,6 +77,9 @@ UNIV_INTERN byte		btr_sea_pad2[CACHE_LINE_SIZE];
 /** The adaptive hash index */
 btr_search_sys_t*	btr_search_sys;
 
+/** Maximum number of hashed pages per index, or 0 for no limit */
+ulong		btr_search_index_max_pages	= 0;
+
 /** If the number of records on the page divided by this parameter
 would have been successfully accessed using a hash index, the index
 is then built on the page, assuming the global limit has been reached */
@@ -110,6 +113,20 @@ btr_search_get_n_fields(
 	return(btr_search_get_n_fields(cursor->n_fields, cursor->n_bytes));
 }
 
+/** Determine if an index has used up its share of the adaptive hash index.
+NOTE that info->ref_count is read without holding the search latch,
+unless the caller holds it.
+@param[in]	info	search info of the index
+@return	whether no further pages of the index should be hashed */
+inline MY_ATTRIBUTE((warn_unused_result))
+bool
+btr_search_index_is_full(
+	const btr_search_t*	info)
+{
+	return(btr_search_index_max_pages
+	       && info->ref_count >= btr_search_index_max_pages);
+}
+
 /********************************************************************//**
 Builds a hash index on a page with the given parameters. If the page already
 has a hash index with different parameters, the old hash index is removed.
@@ -568,6 +585,12 @@ btr_search_update_block_hash_info(
 	     / BTR_SEARCH_PAGE_BUILD_LIMIT)
 	    && (info->n_hash_potential >= BTR_SEARCH_BUILD_LIMIT)) {
 
+		if (!block->index && btr_search_index_is_full(info)) {
+			/* The index already has as many hashed pages
+			as it is allowed to have. */
+			return(FALSE);
+		}
+
 		if ((!block->index)
 		    || (block->n_hash_helps
 			> 2 * page_get_n_recs(block->frame))
@@ -861,6 +884,8 @@ btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	info->n_hash_misses++;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
 
@@ -1079,6 +1104,7 @@ btr_search_guess_on_hash(
 	meanwhile! Thus it might not be a bug. */
 #endif
 	info->last_hash_succ = TRUE;
+	info->n_hash_hits++;
 
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
@@ -1524,6 +1550,11 @@ btr_search_build_page_hash_index(
 	case. */
 	if (!block->index) {
 		assert_block_ahi_empty(block);
+
+		if (btr_search_index_is_full(index->search_info)) {
+			goto exit_func;
+		}
+
 		index->search_info->ref_count++;
 	}
 
@@ -112,6 +112,148 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
 }
 
+/** Initialize a doublewrite batch area.
+@param[out]	batch		batch area
+@param[in]	write_buf	page-aligned buffer of
+				srv_doublewrite_batch_size pages
+@param[in]	buf_block_arr	array of srv_doublewrite_batch_size
+				block pointers
+@param[in]	offset		byte offset in innodb_doublewrite_file */
+static
+void
+buf_dblwr_batch_init(
+	buf_dblwr_batch_t*	batch,
+	byte*			write_buf,
+	buf_page_t**		buf_block_arr,
+	os_offset_t		offset)
+{
+	mutex_create(LATCH_ID_BUF_DBLWR, &batch->mutex);
+
+	batch->b_event = os_event_create("dblwr_batch_event");
+	batch->first_free = 0;
+	batch->b_reserved = 0;
+	batch->batch_running = false;
+	batch->write_buf = write_buf;
+	batch->buf_block_arr = buf_block_arr;
+	batch->offset = offset;
+}
+
+/** Open or create innodb_doublewrite_file and set up one batch area in
+it for each buffer pool instance and flush type.
+@return whether the file can be used */
+static
+bool
+buf_dblwr_file_open()
+{
+	char*	name = is_absolute_path(srv_doublewrite_file)
+		? mem_strdup(srv_doublewrite_file)
+		: fil_make_filepath(NULL, srv_doublewrite_file,
+				    NO_EXT, false);
+	bool	success;
+
+	buf_dblwr->file = os_file_create(
+		innodb_data_file_key, name,
+		OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT
+		| OS_FILE_ON_ERROR_SILENT,
+		OS_FILE_NORMAL, OS_DATA_FILE, false, &success);
+
+	if (!success) {
+		buf_dblwr->file = os_file_create(
+			innodb_data_file_key, name,
+			OS_FILE_CREATE | OS_FILE_ON_ERROR_NO_EXIT,
+			OS_FILE_NORMAL, OS_DATA_FILE, false, &success);
+	}
+
+	if (!success) {
+		ib::error() << "Cannot open or create " << name
+			<< "; using the doublewrite buffer in the"
+			" system tablespace";
+		ut_free(name);
+		return(false);
+	}
+
+	const ulint		n_batches = 2 * srv_buf_pool_instances;
+	const os_offset_t	batch_bytes = os_offset_t(
+		srv_doublewrite_batch_size) << UNIV_PAGE_SIZE_SHIFT;
+	const os_offset_t	size = os_file_get_size(buf_dblwr->file);
+
+	/* Never shrink the file: it may contain pages that are needed
+	for crash recovery. They are read in buf_dblwr_file_load(). */
+	if (size == os_offset_t(-1)
+	    || (size < n_batches * batch_bytes
+		&& !os_file_set_size(name, buf_dblwr->file,
+				     n_batches * batch_bytes))) {
+		ib::error() << "Cannot extend " << name << " to "
+			<< n_batches * batch_bytes << " bytes; using"
+			" the doublewrite buffer in the system tablespace";
+		os_file_close(buf_dblwr->file);
+		buf_dblwr->file = OS_FILE_CLOSED;
+		ut_free(name);
+		return(false);
+	}
+
+	buf_dblwr->file_name = name;
+	buf_dblwr->n_batches = n_batches;
+
+	buf_dblwr->batches = static_cast<buf_dblwr_batch_t*>(
+		ut_zalloc_nokey(n_batches * sizeof(buf_dblwr_batch_t)));
+
+	buf_dblwr->batch_buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey(n_batches * batch_bytes + UNIV_PAGE_SIZE));
+
+	byte*		write_buf = static_cast<byte*>(
+		ut_align(buf_dblwr->batch_buf_unaligned, UNIV_PAGE_SIZE));
+	buf_page_t**	buf_block_arr = static_cast<buf_page_t**>(
+		ut_zalloc_nokey(n_batches * srv_doublewrite_batch_size
+				* sizeof(void*)));
+
+	for (ulint i = 0; i < n_batches; i++) {
+		buf_dblwr_batch_init(
+			&buf_dblwr->batches[i],
+			write_buf + i * batch_bytes,
+			buf_block_arr + i * srv_doublewrite_batch_size,
+			i * batch_bytes);
+	}
+
+	ib::info() << "Using " << name << " for " << n_batches
+		<< " doublewrite batches of " << srv_doublewrite_batch_size
+		<< " pages";
+
+	return(true);
+}
+
+/** Get the batch area that a buffer pool instance posts to.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST
+@return batch area */
+static
+buf_dblwr_batch_t*
+buf_dblwr_get_batch(
+	const buf_pool_t*	buf_pool,
+	buf_flush_t		flush_type)
+{
+	if (buf_dblwr->n_batches == 1) {
+		return(buf_dblwr->batches);
+	}
+
+	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
+	ut_ad(buf_pool->instance_no < srv_buf_pool_instances);
+
+	return(&buf_dblwr->batches[buf_pool->instance_no * 2
+				   + (flush_type == BUF_FLUSH_LRU)]);
+}
+
+/** @return the first slot of the doublewrite buffer in the system
+tablespace that is used for single page flushes */
+static
+ulint
+buf_dblwr_single_page_first_slot()
+{
+	/* With innodb_doublewrite_file the batches are not written to
+	the system tablespace, and all its slots are available. */
+	return(buf_dblwr->n_batches == 1 ? srv_doublewrite_batch_size : 0);
+}
+
 /****************************************************************//**
 Creates or initialializes the doublewrite buffer at a database start. */
 static
@@ -137,11 +279,8 @@ buf_dblwr_init(
 
 	mutex_create(LATCH_ID_BUF_DBLWR, &buf_dblwr->mutex);
 
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
 	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
 	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
 
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
@@ -160,6 +299,63 @@ buf_dblwr_init(
 
 	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		ut_zalloc_nokey(buf_size * sizeof(void*)));
+
+	buf_dblwr->file = OS_FILE_CLOSED;
+
+	if (srv_doublewrite_file == NULL || *srv_doublewrite_file == '\0'
+	    || srv_read_only_mode || !buf_dblwr_file_open()) {
+		/* Batches use the first srv_doublewrite_batch_size slots
+		of the doublewrite buffer in the system tablespace. */
+		buf_dblwr->n_batches = 1;
+		buf_dblwr->batches = static_cast<buf_dblwr_batch_t*>(
+			ut_zalloc_nokey(sizeof(buf_dblwr_batch_t)));
+
+		buf_dblwr_batch_init(buf_dblwr->batches,
+				     buf_dblwr->write_buf,
+				     buf_dblwr->buf_block_arr, 0);
+	}
+}
+
+/** Read the pages of innodb_doublewrite_file for crash recovery.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+buf_dblwr_file_load()
+{
+	if (buf_dblwr->file_name == NULL) {
+		return(DB_SUCCESS);
+	}
+
+	const ulint	n_pages = ulint(os_file_get_size(buf_dblwr->file)
+					>> UNIV_PAGE_SIZE_SHIFT);
+
+	if (n_pages == 0) {
+		return(DB_SUCCESS);
+	}
+
+	buf_dblwr->recover_buf_unaligned = static_cast<byte*>(
+		ut_malloc_nokey((n_pages + 1) * UNIV_PAGE_SIZE));
+
+	byte*		page = static_cast<byte*>(
+		ut_align(buf_dblwr->recover_buf_unaligned, UNIV_PAGE_SIZE));
+	IORequest	read_request(IORequest::READ);
+	dberr_t		err = os_file_read(read_request, buf_dblwr->file,
+					   page, 0, n_pages * UNIV_PAGE_SIZE);
+
+	if (err != DB_SUCCESS) {
+		ib::error() << "Failed to read " << buf_dblwr->file_name;
+		return(err);
+	}
+
+	for (ulint i = 0; i < n_pages; i++, page += UNIV_PAGE_SIZE) {
+		if (memcmp(field_ref_zero, page + FIL_PAGE_LSN, 8)) {
+			/* Each valid page header must contain
+			a nonzero FIL_PAGE_LSN field. */
+			recv_sys->dblwr.add(page);
+		}
+	}
+
+	return(DB_SUCCESS);
 }
 
 /** Create the doublewrite buffer if the doublewrite buffer header
@@ -519,7 +715,7 @@ buf_dblwr_init_or_load_pages(
 
 	ut_free(unaligned_read_buf);
 
-	return(DB_SUCCESS);
+	return(buf_dblwr_file_load());
 }
 
 /** Process and remove the double write buffer pages for all tablespaces. */
@@ -688,6 +884,9 @@ buf_dblwr_process()
 
 	fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
 	ut_free(unaligned_read_buf);
+
+	ut_free(buf_dblwr->recover_buf_unaligned);
+	buf_dblwr->recover_buf_unaligned = NULL;
 }
 
 /****************************************************************//**
@@ -698,9 +897,25 @@ buf_dblwr_free()
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
 	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_destroy(buf_dblwr->b_event);
+	for (ulint i = 0; i < buf_dblwr->n_batches; i++) {
+		buf_dblwr_batch_t*	batch = &buf_dblwr->batches[i];
+
+		ut_ad(batch->b_reserved == 0);
+		os_event_destroy(batch->b_event);
+		mutex_free(&batch->mutex);
+	}
+
+	if (buf_dblwr->file_name != NULL) {
+		ut_free(buf_dblwr->batches[0].buf_block_arr);
+		ut_free(buf_dblwr->batch_buf_unaligned);
+		os_file_close(buf_dblwr->file);
+		ut_free(buf_dblwr->file_name);
+	}
+
+	ut_free(buf_dblwr->batches);
+	ut_free(buf_dblwr->recover_buf_unaligned);
+
 	os_event_destroy(buf_dblwr->s_event);
 	ut_free(buf_dblwr->write_buf_unaligned);
 	buf_dblwr->write_buf_unaligned = NULL;
@@ -735,35 +950,42 @@ buf_dblwr_update(
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		{
+			buf_dblwr_batch_t*	batch = buf_dblwr_get_batch(
+				buf_pool_from_bpage(bpage), flush_type);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+			mutex_enter(&batch->mutex);
 
-		buf_dblwr->b_reserved--;
+			ut_ad(batch->batch_running);
+			ut_ad(batch->b_reserved > 0);
+			ut_ad(batch->b_reserved <= batch->first_free);
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
-			/* This will finish the batch. Sync data files
-			to the disk. */
-			fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			batch->b_reserved--;
 
-			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
-		}
+			if (batch->b_reserved == 0) {
+				mutex_exit(&batch->mutex);
+				/* This will finish the batch. Sync data
+				files to the disk. */
+				fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
+				mutex_enter(&batch->mutex);
 
-		mutex_exit(&buf_dblwr->mutex);
+				/* We can now reuse the doublewrite memory
+				buffer: */
+				batch->first_free = 0;
+				batch->batch_running = false;
+				os_event_set(batch->b_event);
+			}
+
+			mutex_exit(&batch->mutex);
+		}
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
 			const ulint size = TRX_SYS_DOUBLEWRITE_BLOCKS * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
 			ulint i;
 			mutex_enter(&buf_dblwr->mutex);
-			for (i = srv_doublewrite_batch_size; i < size; ++i) {
+			for (i = buf_dblwr_single_page_first_slot();
+			     i < size; ++i) {
 				if (buf_dblwr->buf_block_arr[i] == bpage) {
 					buf_dblwr->s_reserved--;
 					buf_dblwr->buf_block_arr[i] = NULL;
@@ -941,37 +1163,87 @@ buf_dblwr_write_block_to_datafile(
 	}
 }
 
-/********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+/** Write the pages of a doublewrite batch to the doublewrite storage
+and make them durable.
+@param[in]	batch		batch area
+@param[in]	first_free	number of pages in the batch */
+static
 void
-buf_dblwr_flush_buffered_writes()
+buf_dblwr_batch_write(
+	const buf_dblwr_batch_t*	batch,
+	ulint				first_free)
 {
-	byte*		write_buf;
-	ulint		first_free;
-	ulint		len;
+	if (buf_dblwr->file_name != NULL) {
+		/* The whole batch is one sequential write to the batch
+		area of innodb_doublewrite_file. */
+		IORequest	request(IORequest::WRITE);
+		dberr_t		err = os_file_write(
+			request, buf_dblwr->file_name, buf_dblwr->file,
+			batch->write_buf, batch->offset,
+			first_free * UNIV_PAGE_SIZE);
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
+		if (err != DB_SUCCESS) {
+			ib::fatal() << "Failed to write to "
+				<< buf_dblwr->file_name << ": "
+				<< ut_strerr(err);
+		}
+
+		os_file_flush(buf_dblwr->file);
 		return;
 	}
 
-	ut_ad(!srv_read_only_mode);
+	ut_ad(batch == buf_dblwr->batches);
+
+	/* Write out the first block of the doublewrite buffer */
+	ulint	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
+			     first_free) * UNIV_PAGE_SIZE;
+
+	fil_io(IORequestWrite, true,
+	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
+	       0, len, (void*) batch->write_buf, NULL);
+
+	if (first_free > TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+		/* Write out the second block of the doublewrite buffer. */
+		len = (first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+		       * UNIV_PAGE_SIZE;
+
+		fil_io(IORequestWrite, true,
+		       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2),
+		       univ_page_size, 0, len,
+		       (void*) (batch->write_buf
+				+ TRX_SYS_DOUBLEWRITE_BLOCK_SIZE
+				* UNIV_PAGE_SIZE),
+		       NULL);
+	}
+
+	/* Now flush the doublewrite buffer data to disk */
+	fil_flush(TRX_SYS_SPACE);
+}
+
+/** Flush the buffered writes of a doublewrite batch area: write the
+pages to the doublewrite storage, sync it, and then post the writes to
+the data files.
+@param[in,out]	batch	batch area
+@param[in]	wait	whether to wait for a batch that another thread
+			is writing; if false, such a batch is skipped */
+static
+void
+buf_dblwr_batch_flush(
+	buf_dblwr_batch_t*	batch,
+	bool			wait)
+{
+	ulint		first_free;
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&batch->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (batch->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&batch->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -982,39 +1254,44 @@ buf_dblwr_flush_buffered_writes()
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (batch->batch_running) {
+		if (!wait) {
+			/* The pages of the running batch are being
+			posted by the thread that started it. */
+			mutex_exit(&batch->mutex);
+			return;
+		}
+
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(batch->b_event);
+		mutex_exit(&batch->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(batch->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!batch->batch_running);
+	ut_ad(batch->first_free == batch->b_reserved);
 
 	/* Disallow anyone else to post to doublewrite buffer or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	batch->batch_running = true;
+	first_free = batch->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
-
-	write_buf = buf_dblwr->write_buf;
+	mutex_exit(&batch->mutex);
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) batch->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -1029,60 +1306,37 @@ buf_dblwr_flush_buffered_writes()
 
 		/* Check that the page as written to the doublewrite
 		buffer has sane LSN values. */
-		buf_dblwr_check_page_lsn(write_buf + len2);
-	}
-
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
+		buf_dblwr_check_page_lsn(batch->write_buf + len2);
 	}
 
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
-
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
+	buf_dblwr_batch_write(batch, first_free);
 
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the writes have been flushed to disk now
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	DBUG_EXECUTE_IF("ib_dblwr_crash_after_batch_write",
+			DBUG_SUICIDE(););
+
+	/* Up to this point first_free and batch->first_free are
+	same because we have set the batch->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access batch->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting batch->first_free to a higher value.
+	If this happens and we are using batch->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == batch->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			batch->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -1092,6 +1346,52 @@ buf_dblwr_flush_buffered_writes()
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+void
+buf_dblwr_flush_buffered_writes()
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	ut_ad(!srv_read_only_mode);
+
+	for (ulint i = 0; i < buf_dblwr->n_batches; i++) {
+		buf_dblwr_batch_flush(&buf_dblwr->batches[i],
+				      buf_dblwr->n_batches == 1);
+	}
+}
+
+/** Flush the doublewrite batch that the given buffer pool instance
+posts to for the given flush type, like buf_dblwr_flush_buffered_writes().
+With the doublewrite buffer in the system tablespace, all instances
+share one batch.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST */
+void
+buf_dblwr_flush_batch(
+	const buf_pool_t*	buf_pool,
+	buf_flush_t		flush_type)
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	ut_ad(!srv_read_only_mode);
+
+	buf_dblwr_batch_flush(buf_dblwr_get_batch(buf_pool, flush_type),
+			      true);
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -1103,12 +1403,15 @@ buf_dblwr_add_to_batch(
 {
 	ut_a(buf_page_in_file(bpage));
 
+	buf_dblwr_batch_t*	batch = buf_dblwr_get_batch(
+		buf_pool_from_bpage(bpage), buf_page_get_flush_type(bpage));
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&batch->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(batch->first_free <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->batch_running) {
+	if (batch->batch_running) {
 
 		/* This not nearly as bad as it looks. There is only
 		page_cleaner thread which does background flushing
@@ -1116,23 +1419,23 @@ buf_dblwr_add_to_batch(
 		point. The only exception is when a user thread is
 		forced to do a flush batch because of a sync
 		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(batch->b_event);
+		mutex_exit(&batch->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(batch->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (batch->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&batch->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_batch_flush(batch, true);
 
 		goto try_again;
 	}
 
-	byte*	p = buf_dblwr->write_buf
-		+ univ_page_size.physical() * buf_dblwr->first_free;
+	byte*	p = batch->write_buf
+		+ univ_page_size.physical() * batch->first_free;
 
 	/* We request frame here to get correct buffer in case of
 	encryption and/or page compression */
@@ -1155,24 +1458,24 @@ buf_dblwr_add_to_batch(
 		memcpy(p, frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	batch->buf_block_arr[batch->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	batch->first_free++;
+	batch->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!batch->batch_running);
+	ut_ad(batch->first_free == batch->b_reserved);
+	ut_ad(batch->b_reserved <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (batch->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&batch->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_batch_flush(batch, true);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&batch->mutex);
 }
 
 /********************************************************************//**
@@ -1199,11 +1502,11 @@ buf_dblwr_write_single_page(
 	ut_a(buf_dblwr != NULL);
 
 	/* total number of slots available for single page flushes
-	starts from srv_doublewrite_batch_size to the end of the
-	buffer. */
+	starts from buf_dblwr_single_page_first_slot() to the end of
+	the buffer. */
 	size = TRX_SYS_DOUBLEWRITE_BLOCKS * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	ut_a(size > srv_doublewrite_batch_size);
-	n_slots = size - srv_doublewrite_batch_size;
+	ut_a(size > buf_dblwr_single_page_first_slot());
+	n_slots = size - buf_dblwr_single_page_first_slot();
 
 	if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE) {
 
@@ -1231,7 +1534,7 @@ buf_dblwr_write_single_page(
 		goto retry;
 	}
 
-	for (i = srv_doublewrite_batch_size; i < size; ++i) {
+	for (i = buf_dblwr_single_page_first_slot(); i < size; ++i) {
 
 		if (!buf_dblwr->in_use[i]) {
 			break;
@@ -47,6 +47,7 @@ Created April 08, 2011 Vasil Dimov
 #include "mysql/service_wsrep.h" /* wsrep_recovery */
 
 enum status_severity {
+	STATUS_VERBOSE,
 	STATUS_INFO,
 	STATUS_ERR
 };
@@ -132,6 +133,9 @@ buf_dump_status(
 	case STATUS_ERR:
 		ib::error() << export_vars.innodb_buffer_pool_dump_status;
 		break;
+
+	case STATUS_VERBOSE:
+		break;
 	}
 
 	va_end(ap);
@@ -171,6 +175,9 @@ buf_load_status(
 	case STATUS_ERR:
 		ib::error() << export_vars.innodb_buffer_pool_load_status;
 		break;
+
+	case STATUS_VERBOSE:
+		break;
 	}
 
 	va_end(ap);
@@ -428,10 +435,12 @@ buf_load_throttle_if_needed(
 					throttling is needed, we do the check
 					every srv_io_capacity IO ops. */
 	ulint*	last_activity_count,
-	ulint	n_io)			/*!< in: number of IO ops done since
+	ulint	n_io,			/*!< in: number of IO ops done since
 					buffer pool load has started */
+	ulint	io_capacity)		/*!< in: share of srv_io_capacity
+					granted to the caller */
 {
-	if (n_io % srv_io_capacity < srv_io_capacity - 1) {
+	if (n_io % io_capacity < io_capacity - 1) {
 		return;
 	}
 
@@ -441,7 +450,7 @@ buf_load_throttle_if_needed(
 		return;
 	}
 
-	/* srv_io_capacity IO operations have been performed by buffer pool
+	/* io_capacity IO operations have been performed by buffer pool
 	load since the last time we were here. */
 
 	/* If no other activity, then keep going without any delay. */
@@ -467,7 +476,7 @@ buf_load_throttle_if_needed(
 	   again.
 	5. There has been more other activity and thus we enter here.
 	6. Now last_check_time is recent and we sleep if necessary to prevent
-	   more than srv_io_capacity IO operations per second.
+	   more than io_capacity IO operations per second.
 	The deficiency is that we could have slept at 3., but for this we
 	would have to update last_check_time before the
 	"cur_activity_count == *last_activity_count" check and calling
@@ -481,6 +490,198 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Number of pages of one tablespace that a buffer pool load worker
+claims at a time. Large tablespaces are split into chunks of this size
+so that several workers can read from the same tablespace. */
+static const ulint	BUF_LOAD_CHUNK_SIZE = 4096;
+
+/** Maximum number of in-progress tablespaces listed in
+innodb_buffer_pool_load_status. */
+static const ulint	BUF_LOAD_STATUS_MAX_SPACES = 8;
+
+/** Progress of the buffer pool load for one tablespace. */
+struct buf_load_space_t {
+	/** tablespace identifier */
+	ulint		space_id;
+	/** number of pages of this tablespace in the dump */
+	ulint		n_pages;
+	/** number of pages processed so far, updated atomically */
+	ulint		n_done;
+};
+
+/** A contiguous slice of the sorted dump, belonging to one tablespace,
+that is read by one buffer pool load worker. */
+struct buf_load_chunk_t {
+	/** the tablespace the pages belong to */
+	buf_load_space_t*	space;
+	/** index of the first page in the dump */
+	ulint			first;
+	/** number of pages */
+	ulint			n_pages;
+};
+
+/** State shared between buf_load() and its worker threads. */
+struct buf_load_ctx_t {
+	/** the sorted dump */
+	const buf_dump_t*	dump;
+	/** work units, in dump order */
+	buf_load_chunk_t*	chunks;
+	/** number of elements in chunks[] */
+	ulint			n_chunks;
+	/** index of the next chunk to claim, updated atomically */
+	ulint			next_chunk;
+	/** number of running workers, updated atomically */
+	ulint			n_active;
+	/** number of worker threads */
+	ulint			n_threads;
+};
+
+/** Read the pages of one chunk of the buffer pool dump.
+Consecutive page numbers are submitted back to back and the simulated
+AIO handlers are woken up at the end of every contiguous run, so that
+the reads can be merged into larger requests.
+@param[in,out]	ctx			buffer pool load state
+@param[in]	chunk			work unit
+@param[in,out]	last_check_time		see buf_load_throttle_if_needed()
+@param[in,out]	last_activity_cnt	see buf_load_throttle_if_needed()
+@param[in,out]	n_io			number of pages read by this worker */
+static
+void
+buf_load_chunk(
+	buf_load_ctx_t*		ctx,
+	buf_load_chunk_t*	chunk,
+	ulint*			last_check_time,
+	ulint*			last_activity_cnt,
+	ulint*			n_io)
+{
+	const ulint	space_id = chunk->space->space_id;
+	fil_space_t*	space = fil_space_acquire_silent(space_id);
+
+	/* JAN: TODO: As we use background page read below,
+	if tablespace is encrypted we cant use it. */
+	if (space == NULL
+	    || (space->crypt_data
+		&& space->crypt_data->encryption != FIL_ENCRYPTION_OFF
+		&& space->crypt_data->type != CRYPT_SCHEME_UNENCRYPTED)) {
+
+		if (space != NULL) {
+			fil_space_release(space);
+		}
+
+		my_atomic_addlint(&chunk->space->n_done, chunk->n_pages);
+		return;
+	}
+
+	const page_size_t	page_size(space->flags);
+	const ulint		io_capacity = std::max<ulint>(
+		srv_io_capacity / ctx->n_threads, 1);
+	const ulint		end = chunk->first + chunk->n_pages;
+
+	for (ulint i = chunk->first; i < end; i++) {
+
+		if (SHUTTING_DOWN() || buf_load_abort_flag) {
+			break;
+		}
+
+		const ulint	page_no = BUF_DUMP_PAGE(ctx->dump[i]);
+
+		buf_read_page_background(
+			page_id_t(space_id, page_no), page_size, true);
+
+		my_atomic_addlint(&chunk->space->n_done, 1);
+
+		if (i + 1 == end
+		    || BUF_DUMP_PAGE(ctx->dump[i + 1]) != page_no + 1
+		    || i % 64 == 63) {
+			os_aio_simulated_wake_handler_threads();
+		}
+
+		buf_load_throttle_if_needed(
+			last_check_time, last_activity_cnt, (*n_io)++,
+			io_capacity);
+	}
+
+	fil_space_release(space);
+}
+
+/** Buffer pool load worker thread. Claims chunks of the sorted dump
+until none are left or the load is aborted.
+@param[in,out]	arg	buffer pool load state, buf_load_ctx_t
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_load_worker)(void* arg)
+{
+	my_thread_init();
+
+	buf_load_ctx_t*	ctx = static_cast<buf_load_ctx_t*>(arg);
+	ulint		last_check_time = 0;
+	ulint		last_activity_cnt = 0;
+	ulint		n_io = 0;
+
+	for (;;) {
+		ulint	i = my_atomic_addlint(&ctx->next_chunk, 1);
+
+		if (i >= ctx->n_chunks
+		    || SHUTTING_DOWN() || buf_load_abort_flag) {
+			break;
+		}
+
+		buf_load_chunk(ctx, &ctx->chunks[i],
+			       &last_check_time, &last_activity_cnt, &n_io);
+	}
+
+	my_atomic_addlint(&ctx->n_active, -1);
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Report the progress of a running buffer pool load in
+innodb_buffer_pool_load_status.
+@param[in]	spaces		per-tablespace progress
+@param[in]	n_spaces	number of elements in spaces[]
+@param[in]	dump_n		total number of pages to load */
+static
+void
+buf_load_report_progress(
+	buf_load_space_t*	spaces,
+	ulint			n_spaces,
+	ulint			dump_n)
+{
+	char	in_progress[BUF_LOAD_STATUS_MAX_SPACES * 48];
+	char*	p = in_progress;
+	ulint	n_listed = 0;
+	ulint	n_done = 0;
+	ulint	n_spaces_done = 0;
+
+	in_progress[0] = '\0';
+
+	for (ulint i = 0; i < n_spaces; i++) {
+		const ulint	done = my_atomic_loadlint(&spaces[i].n_done);
+
+		n_done += done;
+
+		if (done == spaces[i].n_pages) {
+			n_spaces_done++;
+		} else if (done > 0 && n_listed < BUF_LOAD_STATUS_MAX_SPACES) {
+			p += snprintf(p, in_progress + sizeof in_progress - p,
+				      "%s" ULINTPF ": " ULINTPF "/" ULINTPF,
+				      n_listed ? ", " : "; tablespace ",
+				      spaces[i].space_id, done,
+				      spaces[i].n_pages);
+			n_listed++;
+		}
+	}
+
+	buf_load_status(STATUS_VERBOSE,
+			"Loaded " ULINTPF "/" ULINTPF " pages, "
+			ULINTPF "/" ULINTPF " tablespaces completed%s",
+			n_done, dump_n, n_spaces_done, n_spaces, in_progress);
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -632,15 +833,63 @@ buf_load()
 		std::sort(dump, dump + dump_n);
 	}
 
-	ulint		last_check_time = 0;
-	ulint		last_activity_cnt = 0;
+	/* Split the sorted dump into per-tablespace runs, and the runs
+	into chunks of at most BUF_LOAD_CHUNK_SIZE pages, so that several
+	workers can read from one tablespace at the same time. dump[] is
+	sorted by (space, page), so all pages from a given tablespace are
+	consecutive. */
+	ulint	n_spaces = 0;
+	ulint	n_chunks = 0;
+
+	for (i = 0; i < dump_n; i++) {
+		if (i == 0 || BUF_DUMP_SPACE(dump[i])
+		    != BUF_DUMP_SPACE(dump[i - 1])) {
+			n_spaces++;
+			n_chunks++;
+		} else if (i % BUF_LOAD_CHUNK_SIZE == 0) {
+			n_chunks++;
+		}
+	}
+
+	buf_load_space_t*	spaces = static_cast<buf_load_space_t*>(
+		ut_zalloc_nokey(n_spaces * sizeof *spaces));
+	buf_load_chunk_t*	chunks = static_cast<buf_load_chunk_t*>(
+		ut_zalloc_nokey(n_chunks * sizeof *chunks));
+
+	if (spaces == NULL || chunks == NULL) {
+		ut_free(spaces);
+		ut_free(chunks);
+		ut_free(dump);
+		buf_load_status(STATUS_ERR,
+				"Cannot allocate memory for"
+				" buffer pool load: %s", strerror(errno));
+		return;
+	}
+
+	buf_load_space_t*	cur_space = NULL;
+	buf_load_chunk_t*	cur_chunk = NULL;
+
+	for (i = 0; i < dump_n; i++) {
+		const ulint	this_space_id = BUF_DUMP_SPACE(dump[i]);
+
+		if (cur_space == NULL || cur_space->space_id != this_space_id) {
+			cur_space = cur_space ? cur_space + 1 : spaces;
+			cur_space->space_id = this_space_id;
+		} else if (i % BUF_LOAD_CHUNK_SIZE != 0) {
+			cur_space->n_pages++;
+			cur_chunk->n_pages++;
+			continue;
+		}
 
-	/* Avoid calling the expensive fil_space_acquire_silent() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
-	ulint		cur_space_id = BUF_DUMP_SPACE(dump[0]);
-	fil_space_t*	space = fil_space_acquire_silent(cur_space_id);
-	page_size_t	page_size(space ? space->flags : 0);
+		cur_space->n_pages++;
+		cur_chunk = cur_chunk ? cur_chunk + 1 : chunks;
+		cur_chunk->space = cur_space;
+		cur_chunk->first = i;
+		cur_chunk->n_pages = 1;
+	}
+
+	ut_ad(cur_space == spaces + n_spaces - 1);
+	ut_ad(cur_chunk == chunks + n_chunks - 1);
 
 	/* JAN: TODO: MySQL 5.7 PSI
 #ifdef HAVE_PSI_STAGE_INTERFACE
@@ -652,75 +901,46 @@ buf_load()
 	mysql_stage_set_work_completed(pfs_stage_progress, 0);
 	*/
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	buf_load_ctx_t	ctx;
 
-		/* space_id for this iteration of the loop */
-		const ulint	this_space_id = BUF_DUMP_SPACE(dump[i]);
+	ctx.dump = dump;
+	ctx.chunks = chunks;
+	ctx.n_chunks = n_chunks;
+	ctx.next_chunk = 0;
+	ctx.n_threads = std::min<ulint>(std::max<ulint>(
+		srv_buf_load_threads, 1), n_chunks);
+	ctx.n_active = ctx.n_threads;
 
-		if (this_space_id != cur_space_id) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
-
-			cur_space_id = this_space_id;
-			space = fil_space_acquire_silent(cur_space_id);
+	for (i = 0; i < ctx.n_threads; i++) {
+		os_thread_create(buf_load_worker, &ctx, NULL);
+	}
 
-			if (space != NULL) {
-				const page_size_t	cur_page_size(
-					space->flags);
-				page_size.copy_from(cur_page_size);
-			}
-		}
+	for (ulint n_polls = 1; my_atomic_loadlint(&ctx.n_active) > 0;
+	     n_polls++) {
+		os_thread_sleep(100000);
 
-		/* JAN: TODO: As we use background page read below,
-		if tablespace is encrypted we cant use it. */
-		if (space == NULL ||
-		   (space && space->crypt_data &&
-		    space->crypt_data->encryption != FIL_ENCRYPTION_OFF &&
-		    space->crypt_data->type != CRYPT_SCHEME_UNENCRYPTED)) {
-			continue;
+		/* Refresh the status about once a second. */
+		if (n_polls % 10 == 0) {
+			buf_load_report_progress(spaces, n_spaces, dump_n);
 		}
+	}
 
-		buf_read_page_background(
-			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
-
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
+	ut_free(chunks);
+	ut_free(spaces);
+	ut_free(dump);
 
-		if (buf_load_abort_flag) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_INFO,
-				"Buffer pool(s) load aborted on request");
-			/* Premature end, set estimated = completed = i and
-			end the current stage event. */
-			/*
-			mysql_stage_set_work_estimated(pfs_stage_progress, i);
-			mysql_stage_set_work_completed(pfs_stage_progress,
-			i);
-			*/
+	if (buf_load_abort_flag) {
+		buf_load_abort_flag = FALSE;
+		buf_load_status(
+			STATUS_INFO,
+			"Buffer pool(s) load aborted on request");
+		/* Premature end, end the current stage event. */
 #ifdef HAVE_PSI_STAGE_INTERFACE
-			/* mysql_end_stage(); */
+		/* mysql_end_stage(); */
 #endif /* HAVE_PSI_STAGE_INTERFACE */
-			return;
-		}
-
-		buf_load_throttle_if_needed(
-			&last_check_time, &last_activity_cnt, i);
-	}
-
-	if (space != NULL) {
-		fil_space_release(space);
+		return;
 	}
 
-	ut_free(dump);
-
 	ut_sprintf_timestamp(now);
 
 	buf_load_status(STATUS_INFO,
@@ -1993,7 +1993,7 @@ buf_flush_end(
 	buf_pool_mutex_exit(buf_pool);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_batch(buf_pool, flush_type);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -127,9 +127,9 @@ where n=1..n_uniq.
 		: srv_stats_persistent_sample_pages)
 
 /* number of distinct records on a given level that are required to stop
-descending to lower levels and fetch N_SAMPLE_PAGES(index) records
+descending to lower levels and fetch n_sample_pages records
 from that level */
-#define N_DIFF_REQUIRED(index)	(N_SAMPLE_PAGES(index) * 10)
+#define N_DIFF_REQUIRED(n_sample_pages)	((n_sample_pages) * 10)
 
 /* A dynamic array where we store the boundaries of each distinct group
 of keys. For example if a btree level is:
@@ -490,6 +490,7 @@ dict_stats_table_clone_create(
 
 		idx->stat_defrag_n_page_split = 0;
 		idx->stat_defrag_n_pages_freed = 0;
+		idx->stat_recalc_skipped = false;
 	}
 
 	ut_d(t->magic_n = DICT_TABLE_MAGIC_N);
@@ -756,6 +757,8 @@ dict_stats_copy(
 
 		dst_idx->stat_n_leaf_pages = src_idx->stat_n_leaf_pages;
 
+		dst_idx->stat_recalc_skipped = src_idx->stat_recalc_skipped;
+
 		dst_idx->stat_defrag_modified_counter =
 			src_idx->stat_defrag_modified_counter;
 		dst_idx->stat_defrag_n_pages_freed =
@@ -784,6 +787,7 @@ dict_index_t::stat_n_sample_sizes[]
 dict_index_t::stat_n_non_null_key_vals[]
 dict_index_t::stat_index_size
 dict_index_t::stat_n_leaf_pages
+dict_index_t::stat_recalc_skipped
 dict_index_t::stat_defrag_modified_counter
 dict_index_t::stat_defrag_n_pages_freed
 dict_index_t::stat_defrag_n_page_split
@@ -1901,15 +1905,20 @@ dict_stats_index_set_n_diff(
 	}
 }
 
-/*********************************************************************//**
-Calculates new statistics for a given index and saves them to the index
+/** Calculate new statistics for a given index and save them to the index
 members stat_n_diff_key_vals[], stat_n_sample_sizes[], stat_index_size and
-stat_n_leaf_pages. This function could be slow. */
+stat_n_leaf_pages. This function could be slow.
+@param[in,out]	index		index to analyze
+@param[in]	n_sample_pages	number of leaf pages to sample for each
+n-column prefix; indexes that are smaller than N_SAMPLE_PAGES(index) pages
+for each n-column prefix are scanned completely
+@return whether stat_n_diff_key_vals[] were estimated from a sample of
+leaf pages */
 static
-void
+bool
 dict_stats_analyze_index(
-/*=====================*/
-	dict_index_t*	index)	/*!< in/out: index to analyze */
+	dict_index_t*	index,
+	ib_uint64_t	n_sample_pages)
 {
 	ulint		root_level;
 	ulint		level;
@@ -1927,13 +1936,15 @@ dict_stats_analyze_index(
 
 	/* Disable update statistic for Rtree */
 	if (dict_index_is_spatial(index)) {
-		DBUG_VOID_RETURN;
+		DBUG_RETURN(false);
 	}
 
 	DEBUG_PRINTF("  %s(index=%s)\n", __func__, index->name());
 
 	dict_stats_empty_index(index, false);
 
+	index->stat_recalc_skipped = false;
+
 	mtr_start(&mtr);
 
 	mtr_s_lock(dict_index_get_lock(index), &mtr);
@@ -1951,7 +1962,7 @@ dict_stats_analyze_index(
 	switch (size) {
 	case ULINT_UNDEFINED:
 		dict_stats_assert_initialized_index(index);
-		DBUG_VOID_RETURN;
+		DBUG_RETURN(false);
 	case 0:
 		/* The root node of the tree is a leaf */
 		size = 1;
@@ -2005,7 +2016,7 @@ dict_stats_analyze_index(
 		mtr_commit(&mtr);
 
 		dict_stats_assert_initialized_index(index);
-		DBUG_VOID_RETURN;
+		DBUG_RETURN(false);
 	}
 
 	/* For each level that is being scanned in the btree, this contains the
@@ -2044,7 +2055,8 @@ dict_stats_analyze_index(
 
 		DEBUG_PRINTF("  %s(): searching level with >=%llu "
 			     "distinct records, n_prefix=" ULINTPF "\n",
-			     __func__, N_DIFF_REQUIRED(index), n_prefix);
+			     __func__, N_DIFF_REQUIRED(n_sample_pages),
+			     n_prefix);
 
 		/* Commit the mtr to release the tree S lock to allow
 		other threads to do some work too. */
@@ -2068,7 +2080,8 @@ dict_stats_analyze_index(
 		distinct records because we do not want to scan the
 		leaf level because it may contain too many records */
 		if (level_is_analyzed
-		    && (n_diff_on_level[n_prefix - 1] >= N_DIFF_REQUIRED(index)
+		    && (n_diff_on_level[n_prefix - 1]
+			>= N_DIFF_REQUIRED(n_sample_pages)
 			|| level == 1)) {
 
 			goto found_level;
@@ -2081,7 +2094,7 @@ dict_stats_analyze_index(
 			/* if this does not hold we should be on
 			"found_level" instead of here */
 			ut_ad(n_diff_on_level[n_prefix - 1]
-			      < N_DIFF_REQUIRED(index));
+			      < N_DIFF_REQUIRED(n_sample_pages));
 
 			level--;
 			level_is_analyzed = false;
@@ -2106,13 +2119,13 @@ dict_stats_analyze_index(
 			total_recs is left from the previous iteration when
 			we scanned one level upper or we have not scanned any
 			levels yet in which case total_recs is 1. */
-			if (total_recs > N_SAMPLE_PAGES(index)) {
+			if (total_recs > n_sample_pages) {
 
 				/* if the above cond is true then we are
 				not at the root level since on the root
 				level total_recs == 1 (set before we
 				enter the n-prefix loop) and cannot
-				be > N_SAMPLE_PAGES(index) */
+				be > n_sample_pages */
 				ut_a(level != root_level);
 
 				/* step one level back and be satisfied with
@@ -2135,7 +2148,7 @@ dict_stats_analyze_index(
 
 			if (level == 1
 			    || n_diff_on_level[n_prefix - 1]
-			    >= N_DIFF_REQUIRED(index)) {
+			    >= N_DIFF_REQUIRED(n_sample_pages)) {
 				/* we have reached the last level we could scan
 				or we found a good level with many distinct
 				records */
@@ -2166,7 +2179,7 @@ dict_stats_analyze_index(
 		ut_ad(total_recs > 0);
 		ut_ad(n_diff_on_level[n_prefix - 1] > 0);
 
-		ut_ad(N_SAMPLE_PAGES(index) > 0);
+		ut_ad(n_sample_pages > 0);
 
 		n_diff_data_t*	data = &n_diff_data[n_prefix - 1];
 
@@ -2177,7 +2190,7 @@ dict_stats_analyze_index(
 		data->n_diff_on_level = n_diff_on_level[n_prefix - 1];
 
 		data->n_leaf_pages_to_analyze = std::min(
-			N_SAMPLE_PAGES(index),
+			n_sample_pages,
 			n_diff_on_level[n_prefix - 1]);
 
 		/* pick some records from this level and dive below them for
@@ -2196,26 +2209,101 @@ dict_stats_analyze_index(
 
 	/* n_prefix == 0 means that the above loop did not end up prematurely
 	due to tree being changed and so n_diff_data[] is set up. */
-	if (n_prefix == 0) {
+	const bool	sampled = n_prefix == 0;
+
+	if (sampled) {
 		dict_stats_index_set_n_diff(n_diff_data, index);
 	}
 
 	UT_DELETE_ARRAY(n_diff_data);
 
 	dict_stats_assert_initialized_index(index);
-	DBUG_VOID_RETURN;
+	DBUG_RETURN(sampled);
 }
 
-/*********************************************************************//**
-Calculates new estimates for table and index statistics. This function
+/** Recalculate the statistics of an index, re-sampling it only as much as
+it was modified since the statistics were last calculated. An index that
+was not modified keeps its statistics. Otherwise, fewer leaf pages are
+sampled, and the new estimates are merged with the previous ones, which
+are weighted by their sample size and by the fraction of the index that
+was not modified.
+@param[in,out]	index	index to analyze */
+static
+void
+dict_stats_analyze_index_incremental(
+	dict_index_t*	index)
+{
+	const ulint		n_uniq = dict_index_get_n_unique(index);
+	/* The last n-column prefix makes the records unique. */
+	const ib_uint64_t	n_recs = index->stat_n_diff_key_vals[n_uniq - 1];
+	/* Modifications made while the index is sampled are counted
+	for the next recalculation. */
+	const ib_uint64_t	n_modified = index->stat_modified_reset();
+
+	if (n_modified == 0 && n_recs > 0) {
+		index->stat_recalc_skipped = true;
+		return;
+	}
+
+	const ib_uint64_t	n_sample_pages = N_SAMPLE_PAGES(index);
+
+	if (n_modified >= n_recs / 2) {
+		/* Too much has changed; recalculate from scratch. */
+		dict_stats_analyze_index(index, n_sample_pages);
+		return;
+	}
+
+	/* Sample the more pages the larger the modified fraction is. */
+	const double	modified = double(n_modified) / double(n_recs);
+	const ulint	old_n_leaf_pages = index->stat_n_leaf_pages;
+	std::vector<ib_uint64_t, ut_allocator<ib_uint64_t> >	old(
+		index->stat_n_diff_key_vals,
+		index->stat_n_diff_key_vals + n_uniq);
+	std::vector<ib_uint64_t, ut_allocator<ib_uint64_t> >	old_sample(
+		index->stat_n_sample_sizes,
+		index->stat_n_sample_sizes + n_uniq);
+
+	if (!dict_stats_analyze_index(
+		    index, 1 + ib_uint64_t(double(n_sample_pages)
+					   * 2 * modified))) {
+		/* The index was scanned completely, or the estimates
+		could not be computed. */
+		return;
+	}
+
+	/* The previous estimates were for an index of
+	old_n_leaf_pages pages. */
+	const double	scale = double(index->stat_n_leaf_pages)
+		/ double(std::max<ulint>(old_n_leaf_pages, 1));
+
+	for (ulint i = 0; i < n_uniq; i++) {
+		const double	old_weight = double(old_sample[i])
+			* (1 - modified);
+		const double	new_weight = double(
+			index->stat_n_sample_sizes[i]);
+
+		index->stat_n_diff_key_vals[i] = ib_uint64_t(
+			(double(old[i]) * scale * old_weight
+			 + double(index->stat_n_diff_key_vals[i])
+			 * new_weight)
+			/ (old_weight + new_weight));
+		index->stat_n_sample_sizes[i] = ib_uint64_t(
+			old_weight + new_weight);
+	}
+}
+
+/** Calculate new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
 will be saved on disk.
+@param[in,out]	table		table
+@param[in]	incremental	whether to only re-sample the indexes
+as much as they were modified (dict_stats_analyze_index_incremental())
 @return DB_SUCCESS or error code */
 static
 dberr_t
 dict_stats_update_persistent(
-/*=========================*/
-	dict_table_t*	table)		/*!< in/out: table */
+	dict_table_t*	table,
+	bool		incremental)
 {
 	dict_index_t*	index;
 
@@ -2240,7 +2328,12 @@ dict_stats_update_persistent(
 
 	ut_ad(!dict_index_is_ibuf(index));
 
-	dict_stats_analyze_index(index);
+	if (incremental) {
+		dict_stats_analyze_index_incremental(index);
+	} else {
+		index->stat_modified_reset();
+		dict_stats_analyze_index(index, N_SAMPLE_PAGES(index));
+	}
 
 	ulint	n_unique = dict_index_get_n_unique(index);
 
@@ -2262,14 +2355,18 @@ dict_stats_update_persistent(
 			continue;
 		}
 
-		dict_stats_empty_index(index, false);
-
 		if (dict_stats_should_ignore_index(index)) {
+			dict_stats_empty_index(index, false);
 			continue;
 		}
 
-		if (!(table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
-			dict_stats_analyze_index(index);
+		if (table->stats_bg_flag & BG_STAT_SHOULD_QUIT) {
+			dict_stats_empty_index(index, false);
+		} else if (incremental) {
+			dict_stats_analyze_index_incremental(index);
+		} else {
+			index->stat_modified_reset();
+			dict_stats_analyze_index(index, N_SAMPLE_PAGES(index));
 		}
 
 		table->stat_sum_of_other_index_sizes
@@ -2539,7 +2636,8 @@ dict_stats_save(
 			continue;
 		}
 
-		if (dict_stats_should_ignore_index(index)) {
+		if (dict_stats_should_ignore_index(index)
+		    || index->stat_recalc_skipped) {
 			continue;
 		}
 
@@ -3115,7 +3213,8 @@ dict_stats_update_for_index(
 
 		if (dict_stats_persistent_storage_check(false)) {
 			dict_table_stats_lock(index->table, RW_X_LATCH);
-			dict_stats_analyze_index(index);
+			index->stat_modified_reset();
+			dict_stats_analyze_index(index, N_SAMPLE_PAGES(index));
 			dict_table_stats_unlock(index->table, RW_X_LATCH);
 			dict_stats_save(index->table, &index->id);
 			DBUG_VOID_RETURN;
@@ -3171,6 +3270,7 @@ dict_stats_update(
 	}
 
 	switch (stats_upd_option) {
+	case DICT_STATS_RECALC_INCREMENTAL:
 	case DICT_STATS_RECALC_PERSISTENT:
 
 		if (srv_read_only_mode) {
@@ -3195,7 +3295,10 @@ dict_stats_update(
 
 			dberr_t	err;
 
-			err = dict_stats_update_persistent(table);
+			err = dict_stats_update_persistent(
+				table,
+				stats_upd_option
+				== DICT_STATS_RECALC_INCREMENTAL);
 
 			if (err != DB_SUCCESS) {
 				return(err);
@@ -368,8 +368,13 @@ dict_stats_process_entry_from_recalc_pool()
 	be replaced with something else, though a time interval is the natural
 	approach. */
 
-	if (ut_difftime(ut_time(), table->stats_last_recalc)
-	    < MIN_RECALC_INTERVAL) {
+	double	since_last_recalc = ut_difftime(
+		ut_time(), table->stats_last_recalc);
+
+	DBUG_EXECUTE_IF("dict_stats_recalc_now",
+			since_last_recalc = MIN_RECALC_INTERVAL;);
+
+	if (since_last_recalc < MIN_RECALC_INTERVAL) {
 
 		/* Stats were (re)calculated not long ago. To avoid
 		too frequent stats updates we put back the table on
@@ -379,7 +384,9 @@ dict_stats_process_entry_from_recalc_pool()
 
 	} else {
 
-		dict_stats_update(table, DICT_STATS_RECALC_PERSISTENT);
+		dict_stats_update(table, srv_stats_incremental_recalc
+				  ? DICT_STATS_RECALC_INCREMENTAL
+				  : DICT_STATS_RECALC_PERSISTENT);
 	}
 
 	mutex_enter(&dict_sys->mutex);
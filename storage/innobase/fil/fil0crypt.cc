@@ -39,6 +39,7 @@ Modified           Jan Lindström jan.lindstrom@mariadb.com
 #include "btr0scrub.h"
 #include "fsp0fsp.h"
 #include "fil0pagecompress.h"
+#include "buf0rea.h"
 #include "ha_prototypes.h" // IB_LOG_
 #include <my_crypt.h>
 
@@ -1532,6 +1533,7 @@ fil_crypt_start_rotate_space(
 		space->size consulted.*/
 		crypt_data->rotate_state.max_offset = state->space->size;
 		crypt_data->rotate_state.end_lsn = 0;
+		crypt_data->rotate_state.pages_done = 0;
 		crypt_data->rotate_state.min_key_version_found =
 			key_state->key_version;
 
@@ -1578,6 +1580,8 @@ fil_crypt_find_page_to_rotate(
 	}
 
 	fil_space_crypt_t *crypt_data = space->crypt_data;
+	const ulint extent_size = fsp_get_extent_size_in_pages(
+		page_size_t(space->flags));
 
 	mutex_enter(&crypt_data->mutex);
 	ut_ad(key_state->key_id == crypt_data->key_id);
@@ -1585,6 +1589,19 @@ fil_crypt_find_page_to_rotate(
 	bool found = crypt_data->rotate_state.max_offset >=
 		crypt_data->rotate_state.next_offset;
 
+	/* Let a batch end at an extent boundary when it reaches one,
+	so that the threads seldom share extents and each batch can be
+	read with a few large requests by fil_crypt_read_ahead().
+	The batch is shortened, never extended beyond the iops budget. */
+	const ulint next = crypt_data->rotate_state.next_offset;
+
+	if (batch >= extent_size) {
+		batch = ut_calc_align_down(next + batch, extent_size) - next;
+	} else {
+		batch = std::min(batch,
+				 ut_calc_align(next + 1, extent_size) - next);
+	}
+
 	if (found) {
 		state->offset = crypt_data->rotate_state.next_offset;
 		ulint remaining = crypt_data->rotate_state.max_offset -
@@ -1926,6 +1943,50 @@ fil_crypt_rotate_page(
 	}
 }
 
+/***********************************************************************
+Issue asynchronous reads for the pages of a batch that are not
+in the buffer pool, so that fil_crypt_rotate_page() does not have
+to wait for one synchronous read per page.
+@param[in]		state		Rotation state
+@param[in]		end		End of the batch
+@return number of pages that were read */
+static
+ulint
+fil_crypt_read_ahead(
+	const rotate_thread_t*	state,
+	ulint			end)
+{
+	fil_space_t* space = state->space;
+	const page_size_t page_size(space->flags);
+	ulint n_reads = 0;
+
+	DBUG_EXECUTE_IF("fil_crypt_disable_read_ahead", return(0););
+
+	for (ulint offset = state->offset; offset < end; offset++) {
+		if (space->is_stopping()) {
+			break;
+		}
+
+		if (space->id == TRX_SYS_SPACE
+		    && buf_dblwr_page_inside(offset)) {
+			continue;
+		}
+
+		const page_id_t page_id(space->id, offset);
+
+		if (!buf_page_peek(page_id)) {
+			buf_read_page_background(page_id, page_size, false);
+			n_reads++;
+		}
+	}
+
+	if (n_reads) {
+		os_aio_simulated_wake_handler_threads();
+	}
+
+	return(n_reads);
+}
+
 /***********************************************************************
 Rotate a batch of pages
 @param[in,out]		key_state		Key state
@@ -1942,6 +2003,10 @@ fil_crypt_rotate_pages(
 
 	ut_ad(state->space->n_pending_ops > 0);
 
+	const ulint begin = state->offset;
+	const uintmax_t start = ut_time_us(NULL);
+	const ulint n_reads = fil_crypt_read_ahead(state, end);
+
 	for (; state->offset < end; state->offset++) {
 
 		/* we can't rotate pages in dblwr buffer as
@@ -1959,6 +2024,29 @@ fil_crypt_rotate_pages(
 
 		fil_crypt_rotate_page(key_state, state);
 	}
+
+	if (end > begin) {
+		fil_space_crypt_t* crypt_data = state->space->crypt_data;
+		mutex_enter(&crypt_data->mutex);
+		crypt_data->rotate_state.pages_done += end - begin;
+		mutex_exit(&crypt_data->mutex);
+	}
+
+	/* The pages that were read ahead were found in the buffer pool
+	by fil_crypt_get_page_throttle(), which only sleeps after a
+	synchronous read. Let those reads use up the allocated iops. */
+	if (n_reads) {
+		uintmax_t budget_us = uintmax_t(n_reads) * 1000000
+			/ state->allocated_iops;
+		uintmax_t now = ut_time_us(NULL);
+		uintmax_t elapsed_us = now > start ? now - start : 0;
+
+		if (elapsed_us < budget_us && !state->space->is_stopping()) {
+			os_event_reset(fil_crypt_throttle_sleep_event);
+			os_event_wait_time(fil_crypt_throttle_sleep_event,
+					   ulint(budget_us - elapsed_us));
+		}
+	}
 }
 
 /***********************************************************************
@@ -2451,6 +2539,14 @@ fil_space_crypt_get_status(
 				crypt_data->rotate_state.next_offset;
 			status->rotate_max_page_number =
 				crypt_data->rotate_state.max_offset;
+			status->rotate_pages_done =
+				crypt_data->rotate_state.pages_done;
+
+			time_t elapsed = time(0)
+				- crypt_data->rotate_state.start_time;
+			status->rotate_pages_per_second =
+				status->rotate_pages_done
+				/ ulint(elapsed > 0 ? elapsed : 1);
 		}
 
 		mutex_exit(&crypt_data->mutex);
@@ -660,6 +660,13 @@ fil_node_open_file(
 				page_size_t(space->flags), page);
 		}
 
+		/* Page reads must not wait for the first page while
+		decompressing, so the zstd dictionary is loaded here. */
+		if (first_time_open
+		    && node == UT_LIST_GET_FIRST(space->chain)) {
+			fil_space_read_zstd_dict(space, page);
+		}
+
 		ut_free(buf2);
 		os_file_close(node->handle);
 		node->handle = OS_FILE_CLOSED;
@@ -1355,6 +1362,12 @@ fil_space_detach(
 		UT_LIST_REMOVE(fil_system->rotation_list, space);
 	}
 
+	if (space->is_in_zstd_list) {
+		space->is_in_zstd_list = false;
+
+		UT_LIST_REMOVE(fil_system->zstd_list, space);
+	}
+
 	UT_LIST_REMOVE(fil_system->space_list, space);
 
 	ut_a(space->magic_n == FIL_SPACE_MAGIC_N);
@@ -1401,6 +1414,7 @@ fil_space_free_low(
 
 	rw_lock_free(&space->latch);
 	fil_space_destroy_crypt_data(&space->crypt_data);
+	fil_space_free_zstd_dict(space);
 
 	ut_free(space->name);
 	ut_free(space);
@@ -1920,6 +1934,7 @@ fil_init(
 	UT_LIST_INIT(fil_system->LRU, &fil_node_t::LRU);
 	UT_LIST_INIT(fil_system->space_list, &fil_space_t::space_list);
 	UT_LIST_INIT(fil_system->rotation_list, &fil_space_t::rotation_list);
+	UT_LIST_INIT(fil_system->zstd_list, &fil_space_t::zstd_list);
 	UT_LIST_INIT(fil_system->unflushed_spaces,
 		     &fil_space_t::unflushed_spaces);
 	UT_LIST_INIT(fil_system->named_spaces, &fil_space_t::named_spaces);
@@ -1927,6 +1942,7 @@ fil_init(
 	fil_system->max_n_open = max_n_open;
 
 	fil_space_crypt_init();
+	fil_zstd_init();
 }
 
 /*******************************************************************//**
@@ -5657,6 +5673,7 @@ fil_close(void)
 		fil_system = NULL;
 
 		fil_space_crypt_cleanup();
+		fil_zstd_close();
 	}
 }
 
@@ -5692,6 +5709,7 @@ struct fil_iterator_t {
 						for IO */
 	byte*		io_buffer;		/*!< Buffer to use for IO */
 	fil_space_crypt_t *crypt_data;		/*!< MariaDB Crypt data (if encrypted) */
+	fil_zstd_dict_t* zstd_dict;		/*!< zstd dictionary, or NULL */
 	byte*           crypt_io_buffer;        /*!< MariaDB IO buffer when
 						encrypted */
 	dict_table_t*	table;			/*!< Imported table */
@@ -5830,7 +5848,8 @@ fil_iterate(
 			to decompress page before we can update it. */
 			if (page_compressed) {
 				fil_decompress_page(NULL, dst, ulong(size),
-						    NULL);
+						    NULL, false,
+						    iter.zstd_dict);
 				updated = true;
 			}
 
@@ -6084,6 +6103,10 @@ fil_tablespace_iterate(
 		iter.crypt_data = fil_space_read_crypt_data(
 			callback.get_page_size(), page);
 
+		/* pages may be compressed with a zstd dictionary */
+		iter.zstd_dict = fil_zstd_dict_read(
+			dict_tf_to_fsp_flags(table->flags), page);
+
 		if (err == DB_SUCCESS) {
 
 			/* Compressed pages can't be optimised for block IO
@@ -6121,6 +6144,8 @@ fil_tablespace_iterate(
 				fil_space_destroy_crypt_data(&iter.crypt_data);
 			}
 
+			fil_zstd_dict_free(iter.zstd_dict);
+
 			ut_free(io_buffer);
 			ut_free(crypt_io_buffer);
 		}
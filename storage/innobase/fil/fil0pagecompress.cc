@@ -73,10 +73,656 @@ Updated 14/02/2015
 #ifdef HAVE_SNAPPY
 #include "snappy-c.h"
 #endif
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#include "zdict.h"
+#endif
 
 /* Used for debugging */
 //#define UNIV_PAGECOMPRESS_DEBUG 1
 
+#ifdef HAVE_ZSTD
+/** Minimum size of a tablespace in pages for training a zstd dictionary */
+static const ulint	FIL_ZSTD_TRAIN_MIN_PAGES = 64;
+/** Number of pages that are sampled for training a zstd dictionary */
+static const ulint	FIL_ZSTD_TRAIN_SAMPLES = 128;
+/** Minimum number of index pages for training a zstd dictionary */
+static const ulint	FIL_ZSTD_TRAIN_MIN_SAMPLES = 16;
+/** Maximum size of a zstd dictionary in bytes */
+static const ulint	FIL_ZSTD_DICT_MAX = 16384;
+
+/** zstd dictionary of a page_compressed tablespace. Pages that are
+compressed with the dictionary carry its ID in the zstd frame header.
+Pages that are written before the dictionary exists are compressed
+without a dictionary, and remain readable. */
+struct fil_zstd_dict_t {
+	/** dictionary ID */
+	unsigned		id;
+	/** digested dictionary for compression */
+	ZSTD_CDict*		cdict;
+	/** digested dictionary for decompression */
+	ZSTD_DDict*		ddict;
+	/** the dictionary of an earlier incarnation of the tablespace,
+	or NULL */
+	fil_zstd_dict_t*	retired;
+};
+
+/** Get the location of the zstd dictionary in the first page.
+@param[in]	page_size	page size of the tablespace
+@return byte offset */
+static
+ulint
+fil_zstd_dict_offset(const page_size_t& page_size)
+{
+	return(FSP_HEADER_OFFSET + fsp_header_get_encryption_offset(page_size)
+	       + FSP_ZSTD_DICT);
+}
+
+/** Get the maximum size of the zstd dictionary.
+@param[in]	page_size	page size of the tablespace
+@return maximum size of the dictionary in bytes */
+static
+ulint
+fil_zstd_dict_capacity(const page_size_t& page_size)
+{
+	return(std::min(page_size.physical() - FIL_PAGE_DATA_END
+			- fil_zstd_dict_offset(page_size)
+			- FSP_ZSTD_DICT_DATA,
+			FIL_ZSTD_DICT_MAX));
+}
+
+/** zstd contexts of a thread. Creating a context allocates its
+working memory, so every thread that compresses or decompresses pages
+keeps its own. */
+struct fil_zstd_ctx_t {
+	/** compression context, or NULL */
+	ZSTD_CCtx*	cctx;
+	/** decompression context, or NULL */
+	ZSTD_DCtx*	dctx;
+};
+
+/** Key of the fil_zstd_ctx_t of the current thread */
+static pthread_key(fil_zstd_ctx_t*, fil_zstd_ctx_key);
+
+/** Free the zstd contexts of a thread that is exiting.
+@param[in,out]	arg	fil_zstd_ctx_t of the thread */
+static
+void
+fil_zstd_ctx_free(void* arg)
+{
+	fil_zstd_ctx_t*	ctx = static_cast<fil_zstd_ctx_t*>(arg);
+
+	ZSTD_freeCCtx(ctx->cctx);
+	ZSTD_freeDCtx(ctx->dctx);
+	free(ctx);
+}
+
+/** @return the zstd contexts of the current thread, or NULL */
+static
+fil_zstd_ctx_t*
+fil_zstd_ctx_get()
+{
+	fil_zstd_ctx_t*	ctx = static_cast<fil_zstd_ctx_t*>(
+		pthread_getspecific(fil_zstd_ctx_key));
+
+	/* Allocated with calloc(), because the destructor is invoked
+	after the thread has been detached from performance_schema. */
+	if (ctx == NULL
+	    && (ctx = static_cast<fil_zstd_ctx_t*>(
+			calloc(1, sizeof *ctx))) != NULL
+	    && pthread_setspecific(fil_zstd_ctx_key, ctx)) {
+		free(ctx);
+		ctx = NULL;
+	}
+
+	return(ctx);
+}
+
+/** @return the compression context of the current thread, or NULL */
+static
+ZSTD_CCtx*
+fil_zstd_cctx_get()
+{
+	fil_zstd_ctx_t*	ctx = fil_zstd_ctx_get();
+
+	if (ctx != NULL && ctx->cctx == NULL) {
+		ctx->cctx = ZSTD_createCCtx();
+	}
+
+	return(ctx != NULL ? ctx->cctx : NULL);
+}
+
+/** @return the decompression context of the current thread, or NULL */
+static
+ZSTD_DCtx*
+fil_zstd_dctx_get()
+{
+	fil_zstd_ctx_t*	ctx = fil_zstd_ctx_get();
+
+	if (ctx != NULL && ctx->dctx == NULL) {
+		ctx->dctx = ZSTD_createDCtx();
+	}
+
+	return(ctx != NULL ? ctx->dctx : NULL);
+}
+
+/** Digest a zstd dictionary.
+@param[in]	flags	tablespace flags
+@param[in]	data	the dictionary
+@param[in]	len	length of the dictionary in bytes
+@return the dictionary, or NULL if it is not valid */
+static
+fil_zstd_dict_t*
+fil_zstd_dict_create(ulint flags, const byte* data, ulint len)
+{
+	ulint	level = fsp_flags_get_page_compression_level(flags);
+
+	if (level == 0) {
+		level = page_zip_level;
+	}
+
+	fil_zstd_dict_t*	dict = static_cast<fil_zstd_dict_t*>(
+		ut_zalloc_nokey(sizeof *dict));
+
+	dict->id = ZSTD_getDictID_fromDict(data, len);
+	dict->cdict = ZSTD_createCDict(data, len, int(level));
+	dict->ddict = ZSTD_createDDict(data, len);
+
+	if (dict->id == 0 || dict->cdict == NULL || dict->ddict == NULL) {
+		fil_zstd_dict_free(dict);
+		return(NULL);
+	}
+
+	return(dict);
+}
+
+/** Read the zstd dictionary from the first page of a tablespace.
+@param[in]	flags	tablespace flags
+@param[in]	name	tablespace name, for error messages
+@param[in]	page	first page of the tablespace
+@return the dictionary, or NULL if there is none */
+static
+fil_zstd_dict_t*
+fil_zstd_dict_read(ulint flags, const char* name, const page_t* page)
+{
+	const page_size_t	page_size(flags);
+	const byte*		d = page + fil_zstd_dict_offset(page_size);
+
+	if (!FSP_FLAGS_HAS_PAGE_COMPRESSION(flags)
+	    || mach_read_from_4(d + FSP_ZSTD_DICT_MAGIC)
+	    != FSP_ZSTD_DICT_MAGIC_N) {
+		return(NULL);
+	}
+
+	ulint			len = mach_read_from_2(d + FSP_ZSTD_DICT_LEN);
+	fil_zstd_dict_t*	dict = len <= fil_zstd_dict_capacity(page_size)
+		? fil_zstd_dict_create(flags, d + FSP_ZSTD_DICT_DATA, len)
+		: NULL;
+
+	if (dict == NULL) {
+		ib::error() << "Corrupted zstd dictionary of length " << len
+			    << " in file '" << name << "'";
+	}
+
+	return(dict);
+}
+
+/** @return the current zstd dictionary of a tablespace, or NULL
+@param[in]	space	tablespace */
+static
+const fil_zstd_dict_t*
+fil_space_get_zstd_dict(fil_space_t* space)
+{
+	return(static_cast<const fil_zstd_dict_t*>(my_atomic_loadptr(
+		reinterpret_cast<void**>(&space->zstd_dict))));
+}
+
+/** Make a zstd dictionary the current one of a tablespace.
+@param[in,out]	space	tablespace
+@param[in]	dict	dictionary to install
+@return the current dictionary (dict, or one installed concurrently) */
+static
+const fil_zstd_dict_t*
+fil_space_zstd_dict_publish(fil_space_t* space, fil_zstd_dict_t* dict)
+{
+	void*	expected = NULL;
+
+	if (my_atomic_casptr(reinterpret_cast<void**>(&space->zstd_dict),
+			     &expected, dict)) {
+		return(dict);
+	}
+
+	fil_zstd_dict_free(dict);
+	return(static_cast<const fil_zstd_dict_t*>(expected));
+}
+
+/** Check whether a tablespace may be compressed with a zstd dictionary.
+The dictionary is stored unencrypted in the first page, and it contains
+fragments of the data.
+@param[in]	space	tablespace
+@return whether a dictionary may be trained and used */
+static
+bool
+fil_space_zstd_dict_allowed(const fil_space_t* space)
+{
+	const fil_space_crypt_t*	crypt_data = space->crypt_data;
+
+	return(srv_zstd_dictionary
+	       && !(crypt_data != NULL
+		    ? crypt_data->should_encrypt() : srv_encrypt_tables));
+}
+
+/** Request a zstd dictionary to be loaded or trained for a tablespace
+that does not have one.
+@param[in,out]	space	tablespace */
+static
+void
+fil_space_request_zstd_dict(fil_space_t* space)
+{
+	if (space->zstd_requested
+	    || space->purpose != FIL_TYPE_TABLESPACE
+	    || space->size < FIL_ZSTD_TRAIN_MIN_PAGES) {
+		return;
+	}
+
+	mutex_enter(&fil_system->mutex);
+
+	if (!space->zstd_requested && !space->is_stopping()) {
+		space->zstd_requested = true;
+		space->is_in_zstd_list = true;
+		UT_LIST_ADD_LAST(fil_system->zstd_list, space);
+	}
+
+	mutex_exit(&fil_system->mutex);
+}
+
+/** Compress a page with zstd.
+@param[in,out]	space	tablespace, or NULL during IMPORT
+@param[in]	encrypted	whether the page will be encrypted
+@param[out]	out	compressed page
+@param[in]	out_len	size of out in bytes
+@param[in]	buf	page to compress
+@param[in]	len	size of the page in bytes
+@param[in]	level	compression level, if there is no dictionary
+@return length of the compressed page, or an error code
+(see ZSTD_isError()) */
+static
+size_t
+fil_zstd_compress(
+	fil_space_t*	space,
+	bool		encrypted,
+	byte*		out,
+	ulint		out_len,
+	const byte*	buf,
+	ulint		len,
+	int		level)
+{
+	const fil_zstd_dict_t*	dict = NULL;
+
+	if (space != NULL && !encrypted
+	    && fil_space_zstd_dict_allowed(space)) {
+		dict = fil_space_get_zstd_dict(space);
+
+		if (dict == NULL) {
+			fil_space_request_zstd_dict(space);
+		}
+	}
+
+	ZSTD_CCtx*	cctx = fil_zstd_cctx_get();
+
+	if (cctx == NULL) {
+		return(size_t(-1));
+	}
+
+	if (dict == NULL) {
+		return(ZSTD_compressCCtx(cctx, out, out_len, buf, len, level));
+	}
+
+	srv_stats.pages_zstd_dict_compressed.inc();
+	return(ZSTD_compress_usingCDict(cctx, out, out_len, buf, len,
+					dict->cdict));
+}
+
+/** Decompress a page with zstd. This may be invoked from an i/o
+completion thread, so the dictionary must have been loaded already, by
+fil_space_read_zstd_dict() or fil_zstd_dict_train().
+@param[in]	import_dict	dictionary of a tablespace that is being
+imported, or NULL
+@param[in]	space_id	tablespace id
+@param[out]	out		decompressed page
+@param[in]	out_len		size of out in bytes
+@param[in]	buf		compressed page payload
+@param[in]	len		size of the payload in bytes
+@return length of the decompressed page, or an error code
+(see ZSTD_isError()) */
+static
+size_t
+fil_zstd_decompress(
+	const fil_zstd_dict_t*	import_dict,
+	ulint			space_id,
+	byte*			out,
+	ulint			out_len,
+	const byte*		buf,
+	ulint			len)
+{
+	ZSTD_DCtx*	dctx = fil_zstd_dctx_get();
+
+	if (dctx == NULL) {
+		return(size_t(-1));
+	}
+
+	const unsigned	id = ZSTD_getDictID_fromFrame(buf, len);
+
+	if (id == 0) {
+		return(ZSTD_decompressDCtx(dctx, out, out_len, buf, len));
+	}
+
+	size_t	size = size_t(-1);
+
+	srv_stats.pages_zstd_dict_decompressed.inc();
+
+	if (import_dict != NULL) {
+		if (import_dict->id == id) {
+			size = ZSTD_decompress_usingDDict(
+				dctx, out, out_len, buf, len,
+				import_dict->ddict);
+		}
+	} else if (fil_space_t* space = fil_space_acquire_for_io(space_id)) {
+		const fil_zstd_dict_t*	dict = fil_space_get_zstd_dict(space);
+
+		if (dict != NULL && dict->id == id) {
+			size = ZSTD_decompress_usingDDict(
+				dctx, out, out_len, buf, len, dict->ddict);
+		}
+
+		fil_space_release_for_io(space);
+	}
+
+	return(size);
+}
+
+/** Load the zstd dictionary of a tablespace from the first page, or
+train one on the index pages of the tablespace and store it in the
+first page.
+@param[in,out]	space	tablespace */
+static
+void
+fil_zstd_dict_train(fil_space_t* space)
+{
+	const page_size_t	page_size(space->flags);
+	const ulint		size = page_size.physical();
+	mtr_t			mtr;
+
+	mtr.start();
+
+	buf_block_t*	block = buf_page_get(page_id_t(space->id, 0),
+					     page_size, RW_S_LATCH, &mtr);
+
+	if (fil_zstd_dict_t* dict = fil_zstd_dict_read(
+		    space->flags, space->name, buf_block_get_frame(block))) {
+		fil_space_zstd_dict_publish(space, dict);
+		mtr.commit();
+		return;
+	}
+
+	/* Pages at or above FSP_FREE_LIMIT have never been used. */
+	const ulint	limit = fsp_header_get_field(
+		buf_block_get_frame(block), FSP_FREE_LIMIT);
+
+	mtr.commit();
+
+	/* Sample pages evenly from the whole tablespace. */
+	byte*	samples = static_cast<byte*>(
+		ut_malloc_nokey(FIL_ZSTD_TRAIN_SAMPLES * size));
+	size_t	sizes[FIL_ZSTD_TRAIN_SAMPLES];
+	ulint	n = 0;
+	ulint	step = std::max(limit / FIL_ZSTD_TRAIN_SAMPLES, ulint(1));
+
+	for (ulint page_no = FSP_FIRST_INODE_PAGE_NO + 1;
+	     page_no < limit && n < FIL_ZSTD_TRAIN_SAMPLES
+	     && !space->is_stopping();
+	     page_no += step) {
+		dberr_t	err;
+
+		mtr.start();
+
+		block = buf_page_get_gen(
+			page_id_t(space->id, page_no), page_size,
+			RW_S_LATCH, NULL, BUF_GET_POSSIBLY_FREED,
+			__FILE__, __LINE__, &mtr, &err);
+
+		if (block != NULL
+		    && fil_page_index_page_check(buf_block_get_frame(block))) {
+			memcpy(samples + n * size,
+			       buf_block_get_frame(block), size);
+			sizes[n++] = size;
+		}
+
+		mtr.commit();
+	}
+
+	if (n < FIL_ZSTD_TRAIN_MIN_SAMPLES) {
+		ut_free(samples);
+		return;
+	}
+
+	const ulint	capacity = fil_zstd_dict_capacity(page_size);
+	byte*		data = static_cast<byte*>(ut_malloc_nokey(capacity));
+	size_t		len = ZDICT_trainFromBuffer(data, capacity, samples,
+						    sizes, unsigned(n));
+	ut_free(samples);
+
+	fil_zstd_dict_t*	dict = ZDICT_isError(len)
+		? NULL : fil_zstd_dict_create(space->flags, data, len);
+
+	if (dict == NULL) {
+		ib::warn() << "Training a zstd dictionary for file '"
+			   << space->name << "' failed: "
+			   << (ZDICT_isError(len)
+			       ? ZDICT_getErrorName(len) : "invalid");
+		ut_free(data);
+		return;
+	}
+
+	const ulint	offset = fil_zstd_dict_offset(page_size);
+
+	mtr.start();
+	mtr.set_named_space(space);
+
+	block = buf_page_get(page_id_t(space->id, 0), page_size,
+			     RW_SX_LATCH, &mtr);
+	byte*	d = buf_block_get_frame(block) + offset;
+
+	mlog_write_string(d + FSP_ZSTD_DICT_DATA, data, len, &mtr);
+	mlog_write_ulint(d + FSP_ZSTD_DICT_LEN, len, MLOG_2BYTES, &mtr);
+	mlog_write_ulint(d + FSP_ZSTD_DICT_MAGIC, FSP_ZSTD_DICT_MAGIC_N,
+			 MLOG_4BYTES, &mtr);
+
+	mtr.commit();
+
+	/* A page that is compressed with the dictionary could be
+	written before the page that contains the dictionary. Make sure
+	that redo log recovery will restore the dictionary, and that
+	the dictionary is in the file when the tablespace is opened
+	and fil_space_read_zstd_dict() reads it. */
+	const lsn_t	lsn = mtr.commit_lsn();
+
+	log_write_up_to(lsn, true);
+	buf_flush_request_force(lsn);
+	buf_flush_wait_flushed(lsn);
+
+	/* The first page could have been reinitialized by TRUNCATE. */
+	mtr.start();
+
+	block = buf_page_get(page_id_t(space->id, 0), page_size,
+			     RW_S_LATCH, &mtr);
+	d = buf_block_get_frame(block) + offset;
+
+	if (mach_read_from_4(d + FSP_ZSTD_DICT_MAGIC) != FSP_ZSTD_DICT_MAGIC_N
+	    || memcmp(d + FSP_ZSTD_DICT_DATA, data, len)) {
+		fil_zstd_dict_free(dict);
+		dict = NULL;
+	}
+
+	ut_free(data);
+
+	if (dict != NULL) {
+		ib::info() << "Trained a zstd dictionary of " << len
+			   << " bytes on " << n << " pages of file '"
+			   << space->name << "'";
+		fil_space_zstd_dict_publish(space, dict);
+	}
+
+	mtr.commit();
+}
+#endif /* HAVE_ZSTD */
+
+/** Create the per-thread zstd contexts. Invoked by fil_init(). */
+void
+fil_zstd_init()
+{
+#ifdef HAVE_ZSTD
+	ut_a(!pthread_key_create(&fil_zstd_ctx_key, fil_zstd_ctx_free));
+#endif /* HAVE_ZSTD */
+}
+
+/** Free the key of the per-thread zstd contexts. Invoked by fil_close(). */
+void
+fil_zstd_close()
+{
+#ifdef HAVE_ZSTD
+	/* The i/o threads have exited, and freed their contexts. */
+	pthread_key_delete(fil_zstd_ctx_key);
+#endif /* HAVE_ZSTD */
+}
+
+/** Read the zstd dictionary of a tablespace that is not in fil_system.
+@param[in]	flags	tablespace flags
+@param[in]	page	first page of the tablespace
+@return the dictionary (to be freed by fil_zstd_dict_free()), or NULL */
+fil_zstd_dict_t*
+fil_zstd_dict_read(ulint flags, const byte* page)
+{
+#ifdef HAVE_ZSTD
+	return(fil_zstd_dict_read(flags, "(import)", page));
+#else
+	return(NULL);
+#endif /* HAVE_ZSTD */
+}
+
+/** Free a zstd dictionary.
+@param[in,out]	dict	dictionary, or NULL */
+void
+fil_zstd_dict_free(fil_zstd_dict_t* dict)
+{
+#ifdef HAVE_ZSTD
+	if (dict != NULL) {
+		ZSTD_freeCDict(dict->cdict);
+		ZSTD_freeDDict(dict->ddict);
+		ut_free(dict);
+	}
+#else
+	ut_a(dict == NULL);
+#endif /* HAVE_ZSTD */
+}
+
+/** Load the zstd dictionary of a tablespace from the first page,
+when the first file of the tablespace is being opened.
+@param[in,out]	space	tablespace
+@param[in]	page	first page of the tablespace */
+void
+fil_space_read_zstd_dict(fil_space_t* space, const byte* page)
+{
+#ifdef HAVE_ZSTD
+	if (fil_space_get_zstd_dict(space) == NULL) {
+		if (fil_zstd_dict_t* dict = fil_zstd_dict_read(
+			    space->flags, space->name, page)) {
+			fil_space_zstd_dict_publish(space, dict);
+		}
+	}
+#endif /* HAVE_ZSTD */
+}
+
+/** Load or train the zstd dictionary of the next tablespace in
+fil_system->zstd_list. Invoked by the master thread. */
+void
+fil_zstd_dict_process()
+{
+#ifdef HAVE_ZSTD
+	mutex_enter(&fil_system->mutex);
+
+	fil_space_t*	space = UT_LIST_GET_FIRST(fil_system->zstd_list);
+
+	if (space != NULL) {
+		ut_ad(space->is_in_zstd_list);
+		space->is_in_zstd_list = false;
+		UT_LIST_REMOVE(fil_system->zstd_list, space);
+
+		if (UT_LIST_GET_LEN(space->chain) == 0
+		    || space->is_stopping()) {
+			space = NULL;
+		} else {
+			space->n_pending_ops++;
+		}
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	if (space == NULL) {
+		return;
+	}
+
+	if (fil_space_get_zstd_dict(space) == NULL
+	    && fil_space_zstd_dict_allowed(space)) {
+		fil_zstd_dict_train(space);
+	}
+
+	fil_space_release(space);
+#endif /* HAVE_ZSTD */
+}
+
+/** Forget the zstd dictionary of a tablespace whose first page is
+being initialized by fsp_header_init().
+@param[in,out]	space	tablespace */
+void
+fil_space_reset_zstd_dict(fil_space_t* space)
+{
+#ifdef HAVE_ZSTD
+	/* Pages that are being written concurrently may still use
+	the dictionary, so it will only be freed together with
+	the tablespace. */
+	if (fil_zstd_dict_t* dict = static_cast<fil_zstd_dict_t*>(
+		    my_atomic_fasptr(reinterpret_cast<void**>(
+					     &space->zstd_dict), NULL))) {
+		dict->retired = space->zstd_retired;
+		space->zstd_retired = dict;
+	}
+
+	mutex_enter(&fil_system->mutex);
+	space->zstd_requested = space->is_in_zstd_list;
+	mutex_exit(&fil_system->mutex);
+#endif /* HAVE_ZSTD */
+}
+
+/** Free the zstd dictionaries of a tablespace.
+@param[in,out]	space	tablespace that is being freed */
+void
+fil_space_free_zstd_dict(fil_space_t* space)
+{
+#ifdef HAVE_ZSTD
+	if (space->zstd_dict != NULL) {
+		space->zstd_dict->retired = space->zstd_retired;
+		space->zstd_retired = space->zstd_dict;
+		space->zstd_dict = NULL;
+	}
+
+	while (fil_zstd_dict_t* dict = space->zstd_retired) {
+		space->zstd_retired = dict->retired;
+		fil_zstd_dict_free(dict);
+	}
+#endif /* HAVE_ZSTD */
+}
+
 /****************************************************************//**
 For page compressed pages compress the page before actual write
 operation.
@@ -259,6 +905,23 @@ fil_compress_page(
 	}
 #endif /* HAVE_SNAPPY */
 
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+	{
+		size_t	cstatus = fil_zstd_compress(
+			space, encrypted, out_buf + header_len, write_size,
+			buf, len, comp_level);
+
+		if (ZSTD_isError(cstatus)) {
+			err = int(cstatus);
+			goto err_exit;
+		}
+
+		write_size = cstatus;
+		break;
+	}
+#endif /* HAVE_ZSTD */
+
 	case PAGE_ZLIB_ALGORITHM:
 		err = compress2(out_buf+header_len, (ulong*)&write_size, buf,
 				uLong(len), comp_level);
@@ -415,9 +1078,13 @@ fil_decompress_page(
 	ulong	len,		/*!< in: length of output buffer.*/
 	ulint*	write_size,	/*!< in/out: Actual payload size of
 				the compressed data. */
-	bool	return_error)	/*!< in: true if only an error should
+	bool	return_error,	/*!< in: true if only an error should
 				be produced when decompression fails.
 				By default this parameter is false. */
+	const fil_zstd_dict_t*	zstd_dict)
+				/*!< in: zstd dictionary of a tablespace
+				that is not in fil_system (IMPORT), or
+				NULL to use the one of the tablespace */
 {
 	int err = 0;
 	ulint actual_size = 0;
@@ -621,6 +1288,25 @@ fil_decompress_page(
 		break;
 	}
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+	{
+		size_t	olen = fil_zstd_decompress(
+			zstd_dict,
+			mach_read_from_4(buf + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID),
+			in_buf, len, buf + header_len, actual_size);
+
+		if (ZSTD_isError(olen) || olen != len) {
+			err = int(olen);
+			goto err_exit;
+			if (return_error) {
+				goto error_return;
+			}
+		}
+
+		break;
+	}
+#endif /* HAVE_ZSTD */
 	default:
 		goto err_exit;
 		if (return_error) {
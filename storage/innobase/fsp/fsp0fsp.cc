@@ -30,6 +30,7 @@ Created 11/29/1995 Heikki Tuuri
 #include "buf0buf.h"
 #include "fil0fil.h"
 #include "fil0crypt.h"
+#include "fil0pagecompress.h"
 #include "mtr0log.h"
 #include "ut0byte.h"
 #include "page0page.h"
@@ -768,6 +769,10 @@ fsp_header_init(ulint space_id, ulint size, mtr_t* mtr)
 	space->free_len = 0;
 	space->free_limit = 0;
 
+	/* Pages must not be compressed with the zstd dictionary that was
+	stored in the prior contents of the file page. */
+	fil_space_reset_zstd_dict(space);
+
 	/* The prior contents of the file page should be ignored */
 
 	fsp_init_file_page(space, block, mtr);
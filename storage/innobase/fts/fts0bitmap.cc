@@ -0,0 +1,437 @@
+/*****************************************************************************
+
+Copyright (c) 2017, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/******************************************************************//**
+@file fts/fts0bitmap.cc
+Compressed doc id sets for full text search
+*******************************************************/
+
+#include "fts0bitmap.h"
+
+#include <algorithm>
+
+/** Count the bits that are set in a word.
+@param[in]	word	64-bit word
+@return number of bits set */
+static inline
+ulint
+fts_bitmap_popcount(
+	ib_uint64_t	word)
+{
+#if defined(__GNUC__)
+	return(ulint(__builtin_popcountll(word)));
+#else
+	ulint	n = 0;
+
+	for (; word != 0; word &= word - 1) {
+		++n;
+	}
+
+	return(n);
+#endif
+}
+
+/** @return whether the container has the low bits */
+bool
+fts_doc_bitmap_t::container_t::contains(
+	uint16_t	low) const
+{
+	if (!bits.empty()) {
+		return((bits[low >> 6] >> (low & 63)) & 1);
+	}
+
+	return(std::binary_search(array.begin(), array.end(), low));
+}
+
+/** Add low bits to the container. */
+void
+fts_doc_bitmap_t::container_t::add(
+	uint16_t	low)
+{
+	if (!bits.empty()) {
+		ib_uint64_t&	word = bits[low >> 6];
+		ib_uint64_t	bit = ib_uint64_t(1) << (low & 63);
+
+		if (!(word & bit)) {
+			word |= bit;
+			++card;
+		}
+
+		return;
+	}
+
+	if (array.empty() || array.back() < low) {
+		array.push_back(low);
+	} else {
+		array_t::iterator	it = std::lower_bound(
+			array.begin(), array.end(), low);
+
+		if (*it == low) {
+			return;
+		}
+
+		array.insert(it, low);
+	}
+
+	if (++card > FTS_BITMAP_ARRAY_MAX) {
+		to_bits();
+	}
+}
+
+/** Convert an array container to a bitmap. */
+void
+fts_doc_bitmap_t::container_t::to_bits()
+{
+	ut_ad(bits.empty());
+
+	bits.assign(FTS_BITMAP_WORDS, 0);
+
+	for (array_t::const_iterator it = array.begin();
+	     it != array.end(); ++it) {
+		bits[*it >> 6] |= ib_uint64_t(1) << (*it & 63);
+	}
+
+	array_t().swap(array);
+}
+
+/** Convert a bitmap container to an array if it is small. */
+void
+fts_doc_bitmap_t::container_t::shrink()
+{
+	if (bits.empty() || card > FTS_BITMAP_ARRAY_MAX) {
+		return;
+	}
+
+	array.reserve(card);
+
+	for (ulint i = 0; i < FTS_BITMAP_WORDS; ++i) {
+		for (ib_uint64_t word = bits[i]; word != 0;
+		     word &= word - 1) {
+			ulint	bit = fts_bitmap_popcount((word & -word) - 1);
+
+			array.push_back(uint16_t(i << 6 | bit));
+		}
+	}
+
+	bits_t().swap(bits);
+}
+
+/** Find the container of a key.
+@param[in]	key	high 48 bits of a doc id
+@return the container, or NULL */
+const fts_doc_bitmap_t::container_t*
+fts_doc_bitmap_t::find(
+	ib_uint64_t	key) const
+{
+	ulint	low = 0;
+	ulint	high = m_containers.size();
+
+	while (low < high) {
+		ulint	mid = (low + high) / 2;
+
+		if (m_containers[mid].key < key) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return(low < m_containers.size() && m_containers[low].key == key
+	       ? &m_containers[low] : NULL);
+}
+
+/** Add a doc id. Ids are best added in ascending order.
+@param[in]	doc_id	doc id to add */
+void
+fts_doc_bitmap_t::add(
+	doc_id_t	doc_id)
+{
+	ib_uint64_t	key = doc_id >> 16;
+	uint16_t	low = uint16_t(doc_id & 0xFFFF);
+
+	if (m_containers.empty() || m_containers.back().key < key) {
+		m_containers.push_back(container_t());
+		m_containers.back().key = key;
+		m_containers.back().card = 0;
+	} else if (m_containers.back().key != key) {
+		containers_t::iterator	it = m_containers.begin();
+
+		while (it->key < key) {
+			++it;
+		}
+
+		if (it->key != key) {
+			it = m_containers.insert(it, container_t());
+			it->key = key;
+			it->card = 0;
+		}
+
+		it->add(low);
+		return;
+	}
+
+	m_containers.back().add(low);
+}
+
+/** @return whether the set contains doc_id
+@param[in]	doc_id	doc id to look up */
+bool
+fts_doc_bitmap_t::contains(
+	doc_id_t	doc_id) const
+{
+	const container_t*	container = find(doc_id >> 16);
+
+	return(container != NULL
+	       && container->contains(uint16_t(doc_id & 0xFFFF)));
+}
+
+/** Keep only the doc ids that are also in another set.
+@param[in]	other	set to intersect with */
+void
+fts_doc_bitmap_t::intersect(
+	const fts_doc_bitmap_t&	other)
+{
+	containers_t::iterator		it = m_containers.begin();
+	containers_t::iterator		out = m_containers.begin();
+	containers_t::const_iterator	o = other.m_containers.begin();
+
+	for (; it != m_containers.end(); ++it) {
+		while (o != other.m_containers.end() && o->key < it->key) {
+			++o;
+		}
+
+		if (o == other.m_containers.end()) {
+			break;
+		}
+
+		if (o->key != it->key) {
+			continue;
+		}
+
+		if (!it->bits.empty() && !o->bits.empty()) {
+			it->card = 0;
+
+			for (ulint i = 0; i < FTS_BITMAP_WORDS; ++i) {
+				it->bits[i] &= o->bits[i];
+				it->card += fts_bitmap_popcount(it->bits[i]);
+			}
+
+			it->shrink();
+		} else if (!it->bits.empty()) {
+			array_t	array;
+
+			for (array_t::const_iterator a = o->array.begin();
+			     a != o->array.end(); ++a) {
+				if (it->contains(*a)) {
+					array.push_back(*a);
+				}
+			}
+
+			bits_t().swap(it->bits);
+			it->array.swap(array);
+			it->card = it->array.size();
+		} else {
+			array_t::iterator	end = it->array.begin();
+
+			for (array_t::const_iterator a = it->array.begin();
+			     a != it->array.end(); ++a) {
+				if (o->contains(*a)) {
+					*end++ = *a;
+				}
+			}
+
+			it->array.erase(end, it->array.end());
+			it->card = it->array.size();
+		}
+
+		if (it->card > 0) {
+			if (out != it) {
+				out->key = it->key;
+				out->card = it->card;
+				out->array.swap(it->array);
+				out->bits.swap(it->bits);
+			}
+
+			++out;
+		}
+	}
+
+	m_containers.erase(out, m_containers.end());
+}
+
+/** Add all doc ids of another set.
+@param[in]	other	set to merge */
+void
+fts_doc_bitmap_t::merge(
+	const fts_doc_bitmap_t&	other)
+{
+	containers_t	merged;
+
+	merged.reserve(m_containers.size() + other.m_containers.size());
+
+	containers_t::iterator		it = m_containers.begin();
+	containers_t::const_iterator	o = other.m_containers.begin();
+
+	while (it != m_containers.end() || o != other.m_containers.end()) {
+		if (o == other.m_containers.end()
+		    || (it != m_containers.end() && it->key < o->key)) {
+			merged.push_back(container_t());
+			merged.back().key = it->key;
+			merged.back().card = it->card;
+			merged.back().array.swap(it->array);
+			merged.back().bits.swap(it->bits);
+			++it;
+			continue;
+		}
+
+		merged.push_back(*o);
+
+		if (it != m_containers.end() && it->key == o->key) {
+			container_t&	c = merged.back();
+
+			if (!it->bits.empty()) {
+				if (c.bits.empty()) {
+					c.to_bits();
+				}
+
+				c.card = 0;
+
+				for (ulint i = 0; i < FTS_BITMAP_WORDS; ++i) {
+					c.bits[i] |= it->bits[i];
+					c.card += fts_bitmap_popcount(
+						c.bits[i]);
+				}
+			} else {
+				for (array_t::const_iterator a
+				     = it->array.begin();
+				     a != it->array.end(); ++a) {
+					c.add(*a);
+				}
+			}
+
+			++it;
+		}
+
+		++o;
+	}
+
+	m_containers.swap(merged);
+}
+
+/** @return number of doc ids in the set */
+ulint
+fts_doc_bitmap_t::size() const
+{
+	ulint	n = 0;
+
+	for (containers_t::const_iterator it = m_containers.begin();
+	     it != m_containers.end(); ++it) {
+		n += it->card;
+	}
+
+	return(n);
+}
+
+/** @return number of bytes used by the set */
+ulint
+fts_doc_bitmap_t::mem_size() const
+{
+	ulint	n = sizeof(*this)
+		+ m_containers.capacity() * sizeof(container_t);
+
+	for (containers_t::const_iterator it = m_containers.begin();
+	     it != m_containers.end(); ++it) {
+		n += it->array.capacity() * sizeof(uint16_t)
+			+ it->bits.capacity() * sizeof(ib_uint64_t);
+	}
+
+	return(n);
+}
+
+/** Look up the doc id set of a word.
+@param[in]	index_id	FTS index
+@param[in]	word		word
+@return the doc id set, or NULL */
+const fts_doc_bitmap_t*
+fts_bitmap_cache_t::find(
+	index_id_t		index_id,
+	const fts_string_t*	word) const
+{
+	map_t::const_iterator	it = m_map.find(key_t(
+		index_id, std::string(reinterpret_cast<const char*>(
+			word->f_str), word->f_len)));
+
+	return(it == m_map.end() ? NULL : it->second);
+}
+
+/** Remember the doc id set of a word, if it is worth caching.
+@param[in]	index_id	FTS index
+@param[in]	word		word
+@param[in]	version		version() before the set was read
+@param[in]	docs		doc id set of the word */
+void
+fts_bitmap_cache_t::insert(
+	index_id_t		index_id,
+	const fts_string_t*	word,
+	ulint			version,
+	const fts_doc_bitmap_t&	docs)
+{
+	if (version != m_version
+	    || docs.size() < FTS_BITMAP_CACHE_MIN_DOCS
+	    || docs.mem_size() > FTS_BITMAP_CACHE_MAX_SIZE / 4) {
+		return;
+	}
+
+	key_t	key(index_id, std::string(
+			reinterpret_cast<const char*>(word->f_str),
+			word->f_len));
+
+	if (m_map.find(key) != m_map.end()) {
+		return;
+	}
+
+	fts_doc_bitmap_t*	copy = UT_NEW_NOKEY(fts_doc_bitmap_t(docs));
+	ulint			size = copy->mem_size() + key.second.size();
+
+	/* Evict sets in key order until the new one fits. */
+	while (m_size + size > FTS_BITMAP_CACHE_MAX_SIZE) {
+		map_t::iterator	it = m_map.begin();
+
+		ut_ad(it != m_map.end());
+
+		m_size -= it->second->mem_size() + it->first.second.size();
+		UT_DELETE(it->second);
+		m_map.erase(it);
+	}
+
+	m_map[key] = copy;
+	m_size += size;
+}
+
+/** Discard all doc id sets. */
+void
+fts_bitmap_cache_t::invalidate()
+{
+	for (map_t::iterator it = m_map.begin(); it != m_map.end(); ++it) {
+		UT_DELETE(it->second);
+	}
+
+	m_map.clear();
+	m_size = 0;
+	++m_version;
+}
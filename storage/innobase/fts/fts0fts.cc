@@ -36,6 +36,7 @@ Full Text Search interface
 #include "fts0types.ic"
 #include "fts0vlc.ic"
 #include "fts0plugin.h"
+#include "fts0bitmap.h"
 #include "dict0priv.h"
 #include "dict0stats.h"
 #include "btr0pcur.h"
@@ -310,6 +311,8 @@ fts_cache_destroy(fts_cache_t* cache)
 		mem_heap_free(static_cast<mem_heap_t*>(cache->sync_heap->arg));
 	}
 
+	UT_DELETE(cache->bitmaps);
+
 	mem_heap_free(cache->cache_heap);
 }
 
@@ -671,6 +674,8 @@ fts_cache_create(
 
 	cache->stopword_info.status = STOPWORD_NOT_INIT;
 
+	cache->bitmaps = UT_NEW_NOKEY(fts_bitmap_cache_t());
+
 	return(cache);
 }
 
@@ -1098,6 +1103,10 @@ fts_cache_clear(
 {
 	ulint		i;
 
+	/* The doc id sets only cover the FTS INDEX tables, which are
+	about to receive the contents of the cache, or be emptied. */
+	cache->bitmaps->invalidate();
+
 	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
 		ulint			j;
 		fts_index_cache_t*	index_cache;
@@ -36,8 +36,11 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "fts0pars.h"
 #include "fts0types.h"
 #include "fts0plugin.h"
+#include "fts0bitmap.h"
+#include "srv0srv.h"
 #include "ut0new.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -149,6 +152,12 @@ struct fts_query_t {
 	bool		multi_exist;	/*!< multiple FTS_EXIST oper */
 
 	st_mysql_ftparser*	parser;	/*!< fts plugin parser */
+
+	fts_doc_bitmap_t*	candidates;
+					/*!< In boolean mode, the documents
+					that contain all words required by
+					the query ('+'), or NULL; no other
+					document can be in the result */
 };
 
 /** For phrase matching, first we collect the documents and the positions
@@ -3240,6 +3249,21 @@ fts_query_filter_doc_ids(
 			word_freq->doc_count++;
 		}
 
+		if (query->candidates != NULL
+		    && !query->candidates->contains(doc_id)) {
+			/* The document cannot be in the result; only
+			count it, and keep no ranking data for it. */
+			while (*ptr) {
+				fts_decode_vlc(&ptr);
+			}
+
+			++ptr;
+
+			decoded = ptr - (byte*) data;
+
+			continue;
+		}
+
 		/* We simply collect the matching instances here. */
 		if (query->collect_positions) {
 			ib_alloc_t*	heap_alloc;
@@ -3802,6 +3826,10 @@ fts_query_free(
 		fts_query_free_doc_ids(query, query->doc_ids);
 	}
 
+	if (query->candidates) {
+		UT_DELETE(query->candidates);
+	}
+
 	if (query->word_freqs) {
 		const ib_rbt_node_t*	node;
 
@@ -3895,6 +3923,223 @@ fts_query_parse(
 	DBUG_RETURN(state.root);
 }
 
+/** Add the doc ids of an ilist to a doc id set.
+@param[in,out]	docs	doc id set
+@param[in]	ilist	encoded ilist
+@param[in]	len	length of ilist in bytes */
+static
+void
+fts_query_ilist_to_bitmap(
+	fts_doc_bitmap_t*	docs,
+	const byte*		ilist,
+	ulint			len)
+{
+	byte*		ptr = const_cast<byte*>(ilist);
+	const byte*	end = ilist + len;
+	doc_id_t	doc_id = 0;
+
+	while (ptr < end) {
+		doc_id += fts_decode_vlc(&ptr);
+
+		docs->add(doc_id);
+
+		/* Skip the positions and the end marker. */
+		while (*ptr) {
+			fts_decode_vlc(&ptr);
+		}
+
+		++ptr;
+	}
+}
+
+/** Callback function to collect the doc ids of FTS INDEX rows.
+@return always TRUE */
+static
+ibool
+fts_query_bitmap_fetch_nodes(
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: pointer to fts_fetch_t */
+{
+	sel_node_t*		sel_node = static_cast<sel_node_t*>(row);
+	fts_fetch_t*		fetch = static_cast<fts_fetch_t*>(user_arg);
+	fts_doc_bitmap_t*	docs = static_cast<fts_doc_bitmap_t*>(
+		fetch->read_arg);
+	que_node_t*		exp = que_node_get_next(sel_node->select_list);
+
+	/* Note: The column numbers below must match the SELECT
+	in fts_index_fetch_nodes(). */
+	for (int i = 1; exp; exp = que_node_get_next(exp), ++i) {
+		if (i == 4) { /* ILIST */
+			dfield_t*	dfield = que_node_get_val(exp);
+
+			ut_a(dfield_get_len(dfield) != UNIV_SQL_NULL);
+
+			fts_query_ilist_to_bitmap(
+				docs,
+				static_cast<const byte*>(
+					dfield_get_data(dfield)),
+				dfield_get_len(dfield));
+		}
+	}
+
+	return(TRUE);
+}
+
+/** Collect the doc ids of a word from the index cache and the FTS INDEX.
+The doc ids of frequent words in the FTS INDEX are cached across queries.
+@param[in,out]	query	query instance
+@param[in]	token	word
+@param[out]	docs	doc ids that contain the word
+@return DB_SUCCESS or error code */
+static
+dberr_t
+fts_query_word_bitmap(
+	fts_query_t*		query,
+	const fts_string_t*	token,
+	fts_doc_bitmap_t*	docs)
+{
+	fts_cache_t*		cache = query->index->table->fts->cache;
+	const fts_index_cache_t*index_cache;
+	const ib_vector_t*	nodes;
+	const fts_doc_bitmap_t*	cached;
+	ulint			version;
+
+	rw_lock_x_lock(&cache->lock);
+
+	index_cache = fts_find_index_cache(cache, query->index);
+
+	/* Must find the index cache. */
+	ut_a(index_cache != NULL);
+
+	nodes = fts_cache_find_word(index_cache, token);
+
+	for (ulint i = 0; nodes != NULL && i < ib_vector_size(nodes); ++i) {
+		const fts_node_t*	node = static_cast<const fts_node_t*>(
+			ib_vector_get_const(nodes, i));
+
+		fts_query_ilist_to_bitmap(docs, node->ilist, node->ilist_size);
+	}
+
+	cached = cache->bitmaps->find(query->index->id, token);
+	version = cache->bitmaps->version();
+
+	if (cached != NULL) {
+		docs->merge(*cached);
+	}
+
+	rw_lock_x_unlock(&cache->lock);
+
+	if (cached != NULL) {
+		return(DB_SUCCESS);
+	}
+
+	fts_doc_bitmap_t	disk_docs;
+	fts_fetch_t		fetch;
+	que_t*			graph = NULL;
+
+	fetch.read_arg = &disk_docs;
+	fetch.read_record = fts_query_bitmap_fetch_nodes;
+	fetch.total_memory = 0;
+
+	dberr_t	error = fts_index_fetch_nodes(
+		query->trx, &graph, &query->fts_index_table, token, &fetch);
+
+	fts_que_graph_free(graph);
+
+	if (error != DB_SUCCESS) {
+		return(error);
+	}
+
+	rw_lock_x_lock(&cache->lock);
+	cache->bitmaps->insert(query->index->id, token, version, disk_docs);
+	rw_lock_x_unlock(&cache->lock);
+
+	docs->merge(disk_docs);
+
+	return(DB_SUCCESS);
+}
+
+/** In boolean mode, find the documents that contain all the words that
+the top level of the query requires ('+word'). Only these documents can be
+in the result, so fts_query_filter_doc_ids() will keep no ranking data for
+any other document.
+@param[in,out]	query	parsed query
+@return DB_SUCCESS or error code */
+static
+dberr_t
+fts_query_find_candidates(
+	fts_query_t*	query)
+{
+	std::vector<fts_string_t, ut_allocator<fts_string_t> >	tokens;
+	ulint	n_nodes = 0;
+
+	ut_ad(query->root->type == FTS_AST_LIST);
+
+	for (const fts_ast_node_t* node = query->root->list.head;
+	     node != NULL; node = node->next, ++n_nodes) {
+
+		/* '+word' is parsed as a list of an operator and a term. */
+		if (node->type != FTS_AST_LIST) {
+			continue;
+		}
+
+		const fts_ast_node_t*	oper = node->list.head;
+		const fts_ast_node_t*	term = oper ? oper->next : NULL;
+
+		if (oper != NULL
+		    && oper->type == FTS_AST_OPER && oper->oper == FTS_EXIST
+		    && term != NULL && term->next == NULL
+		    && term->type == FTS_AST_TERM && !term->term.wildcard
+		    && term->term.ptr->len > 0) {
+			fts_string_t	token;
+
+			token.f_str = term->term.ptr->str;
+			token.f_len = term->term.ptr->len;
+			token.f_n_char = 0;
+
+			tokens.push_back(token);
+		}
+	}
+
+	/* A single '+word' is evaluated as cheaply without a filter. */
+	if (tokens.empty() || n_nodes < 2) {
+		return(DB_SUCCESS);
+	}
+
+	DBUG_EXECUTE_IF("fts_query_disable_candidates", return(DB_SUCCESS););
+
+	fts_doc_bitmap_t*	candidates = UT_NEW_NOKEY(fts_doc_bitmap_t());
+	dberr_t			error = DB_SUCCESS;
+
+	for (ulint i = 0; i < tokens.size(); ++i) {
+		if (i == 0) {
+			error = fts_query_word_bitmap(
+				query, &tokens[i], candidates);
+		} else {
+			fts_doc_bitmap_t	docs;
+
+			error = fts_query_word_bitmap(
+				query, &tokens[i], &docs);
+
+			candidates->intersect(docs);
+		}
+
+		if (error != DB_SUCCESS || candidates->empty()) {
+			break;
+		}
+	}
+
+	if (error != DB_SUCCESS) {
+		UT_DELETE(candidates);
+		return(error);
+	}
+
+	query->candidates = candidates;
+	query->total_size += candidates->mem_size();
+
+	return(DB_SUCCESS);
+}
+
 /*******************************************************************//**
 FTS Query optimization
 Set FTS_OPT_RANKING if it is a simple term query */
@@ -3919,12 +4164,888 @@ fts_query_can_optimize(
 	}
 }
 
+/** Largest LIMIT for which fts_query() ranks only the top documents.
+For larger limits a full evaluation is about as cheap. */
+static const ulint	FTS_QUERY_TOP_K_MAX = 10000;
+
+/** The postings of a query term in one FTS INDEX row or index cache
+node, for the top-k evaluation */
+struct fts_top_k_block_t {
+	doc_id_t	first_doc_id;	/*!< first doc id in the ilist */
+
+	doc_id_t	last_doc_id;	/*!< last doc id in the ilist */
+
+	ulint		doc_count;	/*!< number of doc ids in the ilist */
+
+	const byte*	ilist;		/*!< encoded ilist, on the query heap */
+
+	ulint		ilist_len;	/*!< length of ilist in bytes */
+
+	ulint		max_freq;	/*!< upper bound of the term frequency
+					of any document in the block; exact
+					once the block has been decoded */
+
+	fts_doc_freq_t*	docs;		/*!< decoded postings, or NULL */
+
+	ulint		n_docs;		/*!< number of elements in docs */
+};
+
+typedef std::vector<fts_top_k_block_t, ut_allocator<fts_top_k_block_t> >
+	fts_top_k_blocks_t;
+
+/** A distinct query term in the top-k evaluation */
+struct fts_top_k_term_t {
+	fts_word_freq_t*	word_freq;	/*!< doc_count and idf */
+
+	fts_top_k_blocks_t*	blocks;		/*!< postings in doc id
+						order; the blocks do not
+						overlap */
+
+	double			weight;		/*!< idf * idf */
+
+	double			max_score;	/*!< upper bound of the rank
+						that the term can contribute
+						to a document */
+
+	ulint			n_occur;	/*!< number of times the term
+						appears in the query */
+
+	ulint			block;		/*!< cursor: current block */
+
+	ulint			pos;		/*!< cursor: position in the
+						decoded current block */
+};
+
+typedef std::vector<fts_top_k_term_t, ut_allocator<fts_top_k_term_t> >
+	fts_top_k_terms_t;
+
+typedef std::vector<fts_ranking_t, ut_allocator<fts_ranking_t> >
+	fts_top_k_heap_t;
+
+/** Argument of fts_query_top_k_fetch_nodes() */
+struct fts_top_k_fetch_t {
+	fts_query_t*		query;	/*!< query instance */
+
+	fts_top_k_term_t*	term;	/*!< term being fetched */
+};
+
+/** Doc id of an exhausted term cursor */
+static const doc_id_t	FTS_TOP_K_END = ~doc_id_t(0);
+
+/** Check whether a query can be evaluated by fts_query_top_k().
+@param[in]	query	parsed query
+@param[in]	flags	FTS search mode
+@param[in]	limit	number of documents that will be read
+@return true if only the top "limit" documents need to be ranked */
+static
+bool
+fts_query_use_top_k(
+	const fts_query_t*	query,
+	uint			flags,
+	ulint			limit)
+{
+	if (limit == ULINT_UNDEFINED || limit == 0
+	    || limit > FTS_QUERY_TOP_K_MAX
+	    || (flags & (FTS_BOOL | FTS_EXPAND))
+	    || query->root == NULL) {
+		return(false);
+	}
+
+	DBUG_EXECUTE_IF("fts_query_disable_top_k", return(false););
+
+	ut_ad(query->root->type == FTS_AST_LIST);
+
+	const fts_ast_node_t*	node = query->root->list.head;
+
+	if (node == NULL) {
+		return(false);
+	}
+
+	/* A natural language query is a plain list of terms. */
+	for (; node != NULL; node = node->next) {
+		if (node->type != FTS_AST_TERM || node->term.wildcard) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Upper bound of the term frequency of any document in an ilist that
+has not been decoded. Every document takes at least one byte for its doc
+id delta, one for each position and one for the end marker.
+@param[in]	ilist_len	length of the ilist in bytes
+@param[in]	doc_count	number of documents in the ilist
+@return maximum possible term frequency */
+static
+ulint
+fts_top_k_block_max_freq(
+	ulint	ilist_len,
+	ulint	doc_count)
+{
+	if (doc_count == 0) {
+		return(0);
+	}
+
+	return(ilist_len + 1 > 3 * doc_count
+	       ? ilist_len + 1 - 3 * doc_count : 1);
+}
+
+/** Add a block to the postings of a term.
+@param[in,out]	query		query instance
+@param[in,out]	blocks		postings of the term
+@param[in]	first_doc_id	first doc id in the ilist
+@param[in]	last_doc_id	last doc id in the ilist
+@param[in]	doc_count	number of doc ids in the ilist
+@param[in]	ilist		encoded ilist
+@param[in]	ilist_len	length of ilist in bytes
+@return DB_SUCCESS or DB_FTS_EXCEED_RESULT_CACHE_LIMIT */
+static
+dberr_t
+fts_top_k_add_block(
+	fts_query_t*		query,
+	fts_top_k_blocks_t*	blocks,
+	doc_id_t		first_doc_id,
+	doc_id_t		last_doc_id,
+	ulint			doc_count,
+	const byte*		ilist,
+	ulint			ilist_len)
+{
+	fts_top_k_block_t	block;
+
+	if (ilist_len == 0) {
+		return(DB_SUCCESS);
+	}
+
+	block.first_doc_id = first_doc_id;
+	block.last_doc_id = last_doc_id;
+	block.doc_count = doc_count;
+	block.ilist = static_cast<byte*>(
+		mem_heap_dup(query->heap, ilist, ilist_len));
+	block.ilist_len = ilist_len;
+	block.max_freq = fts_top_k_block_max_freq(ilist_len, doc_count);
+	block.docs = NULL;
+	block.n_docs = 0;
+
+	blocks->push_back(block);
+
+	query->total_size += ilist_len + sizeof(block);
+
+	return(query->total_size > fts_result_cache_limit
+	       ? DB_FTS_EXCEED_RESULT_CACHE_LIMIT : DB_SUCCESS);
+}
+
+/** Decode the ilist of a block, unless already done. The maximum term
+frequency of the block becomes exact.
+@param[in,out]	query	query instance
+@param[in,out]	block	block to decode */
+static
+void
+fts_top_k_decode_block(
+	fts_query_t*		query,
+	fts_top_k_block_t*	block)
+{
+	if (block->docs != NULL) {
+		return;
+	}
+
+	ulint		n_alloc = ut_max(block->doc_count, ulint(1));
+	const byte*	ptr = block->ilist;
+	const byte*	end = ptr + block->ilist_len;
+	doc_id_t	doc_id = 0;
+
+	block->docs = static_cast<fts_doc_freq_t*>(mem_heap_alloc(
+		query->heap, n_alloc * sizeof(*block->docs)));
+	block->n_docs = 0;
+	block->max_freq = 0;
+
+	while (ptr < end) {
+		ulint	freq = 0;
+
+		doc_id += fts_decode_vlc(const_cast<byte**>(&ptr));
+
+		while (*ptr) {
+			fts_decode_vlc(const_cast<byte**>(&ptr));
+			++freq;
+		}
+
+		/* Skip the end of word position marker. */
+		++ptr;
+
+		if (block->n_docs == n_alloc) {
+			/* DOC_COUNT was too small; grow the array. */
+			fts_doc_freq_t*	docs = static_cast<fts_doc_freq_t*>(
+				mem_heap_alloc(query->heap, 2 * n_alloc
+					       * sizeof(*block->docs)));
+
+			memcpy(docs, block->docs,
+			       n_alloc * sizeof(*block->docs));
+
+			block->docs = docs;
+			n_alloc *= 2;
+		}
+
+		block->docs[block->n_docs].doc_id = doc_id;
+		block->docs[block->n_docs].freq = freq;
+		++block->n_docs;
+
+		block->max_freq = ut_max(block->max_freq, freq);
+	}
+
+	query->total_size += block->n_docs * sizeof(*block->docs);
+}
+
+/** Compare two blocks on their first doc id.
+@return true if b1 starts before b2 */
+static
+bool
+fts_top_k_block_less(
+	const fts_top_k_block_t&	b1,
+	const fts_top_k_block_t&	b2)
+{
+	return(b1.first_doc_id < b2.first_doc_id);
+}
+
+/** Compare two postings on their doc id.
+@return true if d1 comes before d2 */
+static
+bool
+fts_top_k_doc_less(
+	const fts_doc_freq_t&	d1,
+	const fts_doc_freq_t&	d2)
+{
+	return(d1.doc_id < d2.doc_id);
+}
+
+/** Sort the blocks of a term in doc id order. Index cache nodes and
+FTS INDEX rows normally cover disjoint doc id ranges; if they do not,
+merge all postings into a single block in which the first occurrence of
+a doc id wins, as it does in fts_query_filter_doc_ids().
+@param[in,out]	query	query instance
+@param[in,out]	blocks	postings of a term */
+static
+void
+fts_top_k_sort_blocks(
+	fts_query_t*		query,
+	fts_top_k_blocks_t*	blocks)
+{
+	fts_top_k_blocks_t	sorted(*blocks);
+
+	std::stable_sort(sorted.begin(), sorted.end(), fts_top_k_block_less);
+
+	bool	overlap = false;
+
+	for (ulint i = 1; i < sorted.size(); ++i) {
+		if (sorted[i].first_doc_id <= sorted[i - 1].last_doc_id) {
+			overlap = true;
+			break;
+		}
+	}
+
+	if (!overlap) {
+		blocks->swap(sorted);
+		return;
+	}
+
+	ulint	n_docs = 0;
+
+	for (ulint i = 0; i < blocks->size(); ++i) {
+		fts_top_k_decode_block(query, &(*blocks)[i]);
+		n_docs += (*blocks)[i].n_docs;
+	}
+
+	fts_top_k_block_t	merged;
+
+	merged.docs = static_cast<fts_doc_freq_t*>(mem_heap_alloc(
+		query->heap, ut_max(n_docs, ulint(1)) * sizeof(*merged.docs)));
+	merged.n_docs = 0;
+	merged.max_freq = 0;
+
+	for (ulint i = 0; i < blocks->size(); ++i) {
+		const fts_top_k_block_t&	block = (*blocks)[i];
+
+		memcpy(merged.docs + merged.n_docs, block.docs,
+		       block.n_docs * sizeof(*block.docs));
+		merged.n_docs += block.n_docs;
+	}
+
+	std::stable_sort(merged.docs, merged.docs + merged.n_docs,
+			 fts_top_k_doc_less);
+
+	ulint	n = 0;
+
+	for (ulint i = 0; i < merged.n_docs; ++i) {
+		if (n == 0 || merged.docs[i].doc_id != merged.docs[n - 1].doc_id) {
+			merged.docs[n++] = merged.docs[i];
+			merged.max_freq = ut_max(
+				merged.max_freq, merged.docs[i].freq);
+		}
+	}
+
+	merged.n_docs = n;
+	merged.doc_count = n;
+	merged.ilist = NULL;
+	merged.ilist_len = 0;
+	merged.first_doc_id = n > 0 ? merged.docs[0].doc_id : 0;
+	merged.last_doc_id = n > 0 ? merged.docs[n - 1].doc_id : 0;
+
+	blocks->clear();
+
+	if (n > 0) {
+		blocks->push_back(merged);
+	}
+}
+
+/** Callback function to collect the FTS INDEX rows of a term.
+@return TRUE to continue, FALSE on error */
+static
+ibool
+fts_query_top_k_fetch_nodes(
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: pointer to fts_fetch_t */
+{
+	sel_node_t*		sel_node = static_cast<sel_node_t*>(row);
+	fts_fetch_t*		fetch = static_cast<fts_fetch_t*>(user_arg);
+	fts_top_k_fetch_t*	arg = static_cast<fts_top_k_fetch_t*>(
+		fetch->read_arg);
+	fts_query_t*		query = arg->query;
+	fts_top_k_term_t*	term = arg->term;
+	que_node_t*		exp = que_node_get_next(sel_node->select_list);
+	ulint			doc_count = 0;
+	doc_id_t		first_doc_id = 0;
+	doc_id_t		last_doc_id = 0;
+	int			i;
+
+	/* Note: The column numbers below must match the SELECT
+	in fts_index_fetch_nodes(). */
+	for (i = 1; exp; exp = que_node_get_next(exp), ++i) {
+		dfield_t*	dfield = que_node_get_val(exp);
+		const byte*	data = static_cast<const byte*>(
+			dfield_get_data(dfield));
+		ulint		len = dfield_get_len(dfield);
+
+		ut_a(len != UNIV_SQL_NULL);
+
+		switch (i) {
+		case 1: /* DOC_COUNT */
+			doc_count = mach_read_from_4(data);
+			term->word_freq->doc_count += doc_count;
+			break;
+
+		case 2: /* FIRST_DOC_ID */
+			first_doc_id = fts_read_doc_id(data);
+			break;
+
+		case 3: /* LAST_DOC_ID */
+			last_doc_id = fts_read_doc_id(data);
+			break;
+
+		case 4: /* ILIST */
+			query->error = fts_top_k_add_block(
+				query, term->blocks, first_doc_id,
+				last_doc_id, doc_count, data, len);
+			break;
+
+		default:
+			ut_error;
+		}
+	}
+
+	ut_a(i == 5);
+
+	return(query->error == DB_SUCCESS);
+}
+
+/** Collect the postings of a term from the index cache and the FTS
+INDEX, without decoding them.
+@param[in,out]	query	query instance
+@param[in,out]	term	term to collect
+@return DB_SUCCESS or error code */
+static
+dberr_t
+fts_query_top_k_fetch(
+	fts_query_t*		query,
+	fts_top_k_term_t*	term)
+{
+	const fts_string_t*	token = &term->word_freq->word;
+	fts_cache_t*		cache = query->index->table->fts->cache;
+
+	rw_lock_x_lock(&cache->lock);
+
+	const fts_index_cache_t*	index_cache = fts_find_index_cache(
+		cache, query->index);
+
+	/* Must find the index cache. */
+	ut_a(index_cache != NULL);
+
+	const ib_vector_t*	nodes = fts_cache_find_word(index_cache, token);
+
+	for (ulint i = 0; nodes != NULL && i < ib_vector_size(nodes)
+	     && query->error == DB_SUCCESS; ++i) {
+		const fts_node_t*	node = static_cast<const fts_node_t*>(
+			ib_vector_get_const(nodes, i));
+
+		query->error = fts_top_k_add_block(
+			query, term->blocks, node->first_doc_id,
+			node->last_doc_id, node->doc_count,
+			node->ilist, node->ilist_size);
+
+		if (query->error == DB_SUCCESS && node->ilist_size > 0) {
+			/* Like fts_query_check_node(), count the
+			documents of index cache nodes one by one. */
+			fts_top_k_block_t*	block = &term->blocks->back();
+
+			fts_top_k_decode_block(query, block);
+
+			term->word_freq->doc_count += block->n_docs;
+		}
+	}
+
+	rw_lock_x_unlock(&cache->lock);
+
+	if (query->error != DB_SUCCESS) {
+		return(query->error);
+	}
+
+	fts_top_k_fetch_t	arg;
+	fts_fetch_t		fetch;
+	que_t*			graph = NULL;
+
+	arg.query = query;
+	arg.term = term;
+
+	fetch.read_arg = &arg;
+	fetch.read_record = fts_query_top_k_fetch_nodes;
+	fetch.total_memory = 0;
+
+	dberr_t	error = fts_index_fetch_nodes(
+		query->trx, &graph, &query->fts_index_table, token, &fetch);
+
+	fts_que_graph_free(graph);
+
+	if (error != DB_SUCCESS && query->error == DB_SUCCESS) {
+		query->error = error;
+	}
+
+	return(query->error);
+}
+
+/** Position a term cursor on the first document that is not before
+doc_id, decoding only the block that contains it.
+@param[in,out]	query	query instance
+@param[in,out]	term	term cursor
+@param[in]	doc_id	doc id to seek
+@return the doc id under the cursor, or FTS_TOP_K_END */
+static
+doc_id_t
+fts_top_k_seek(
+	fts_query_t*		query,
+	fts_top_k_term_t*	term,
+	doc_id_t		doc_id)
+{
+	fts_top_k_blocks_t&	blocks = *term->blocks;
+
+	while (term->block < blocks.size()) {
+		fts_top_k_block_t*	block = &blocks[term->block];
+
+		if (block->last_doc_id < doc_id) {
+			/* Skip the whole block without decoding it. */
+			++term->block;
+			term->pos = 0;
+			continue;
+		}
+
+		fts_top_k_decode_block(query, block);
+
+		const fts_doc_freq_t*	begin = block->docs + term->pos;
+		const fts_doc_freq_t*	end = block->docs + block->n_docs;
+		fts_doc_freq_t		key;
+
+		key.doc_id = doc_id;
+
+		term->pos = std::lower_bound(
+			begin, end, key, fts_top_k_doc_less) - block->docs;
+
+		if (term->pos < block->n_docs) {
+			return(block->docs[term->pos].doc_id);
+		}
+
+		++term->block;
+		term->pos = 0;
+	}
+
+	return(FTS_TOP_K_END);
+}
+
+/** Upper bound of the rank that a term can contribute to a document,
+from the block that covers the document; the block is not decoded.
+@param[in,out]	term	term cursor
+@param[in]	doc_id	document
+@return upper bound of the rank contribution */
+static
+double
+fts_top_k_block_bound(
+	fts_top_k_term_t*	term,
+	doc_id_t		doc_id)
+{
+	fts_top_k_blocks_t&	blocks = *term->blocks;
+
+	while (term->block < blocks.size()
+	       && blocks[term->block].last_doc_id < doc_id) {
+		++term->block;
+		term->pos = 0;
+	}
+
+	if (term->block == blocks.size()
+	    || blocks[term->block].first_doc_id > doc_id) {
+		return(0.0);
+	}
+
+	return(double(blocks[term->block].max_freq) * term->weight);
+}
+
+/** Compare two rankings in result order.
+@return true if r1 ranks higher than r2 */
+static
+bool
+fts_top_k_better(
+	const fts_ranking_t&	r1,
+	const fts_ranking_t&	r2)
+{
+	return(r1.rank > r2.rank
+	       || (r1.rank == r2.rank && r1.doc_id < r2.doc_id));
+}
+
+/** Count the deleted documents in the postings of a term, for the IDF
+of a single term query; see fts_query_prepare_result().
+@param[in,out]	query	query instance
+@param[in,out]	term	term
+@return number of deleted documents that contain the term */
+static
+ulint
+fts_top_k_count_deleted(
+	fts_query_t*		query,
+	fts_top_k_term_t*	term)
+{
+	const fts_update_t*	array = static_cast<const fts_update_t*>(
+		query->deleted->doc_ids->data);
+	ulint			size = ib_vector_size(query->deleted->doc_ids);
+	ulint			n_deleted = 0;
+
+	for (ulint i = 0; i < size; ++i) {
+		if (fts_top_k_seek(query, term, array[i].doc_id)
+		    == array[i].doc_id) {
+			++n_deleted;
+		}
+	}
+
+	term->block = 0;
+	term->pos = 0;
+
+	return(n_deleted);
+}
+
+/** Rank only the top documents of a natural language query. The terms
+are evaluated document at a time. Terms whose combined maximum score
+cannot lift a document into the current top "limit" only check the
+documents that the other terms produce (MaxScore). Their FTS INDEX rows
+are skipped without decoding unless such a document falls into them,
+and even then only if the row's maximum term frequency (block-max) can
+still make a difference.
+@param[in,out]	query	parsed query
+@param[in]	limit	number of documents that will be read
+@param[out]	result	the top documents, ranked as fts_query() would
+@return DB_SUCCESS or error code */
+static
+dberr_t
+fts_query_top_k(
+	fts_query_t*	query,
+	ulint		limit,
+	fts_result_t**	result)
+{
+	fts_top_k_terms_t	terms;
+
+	/* Collect the distinct terms in query order. The rank of a
+	document is summed in this order, as in
+	fts_query_calculate_ranking(). */
+	for (fts_ast_node_t* node = query->root->list.head;
+	     node != NULL && query->error == DB_SUCCESS;
+	     node = node->next) {
+
+		fts_string_t	token;
+
+		token.f_str = node->term.ptr->str;
+		token.f_len = node->term.ptr->len;
+		token.f_n_char = 0;
+
+		if (token.f_len == 0) {
+			continue;
+		}
+
+		ulint			n_words = rbt_size(query->word_freqs);
+		fts_word_freq_t*	word_freq = fts_query_add_word_freq(
+			query, &token);
+
+		if (rbt_size(query->word_freqs) == n_words) {
+			/* A repeated term is read again by
+			fts_query_union(), which adds to the document
+			count of the term each time. */
+			for (ulint i = 0; i < terms.size(); ++i) {
+				if (terms[i].word_freq == word_freq) {
+					++terms[i].n_occur;
+				}
+			}
+
+			continue;
+		}
+
+		fts_top_k_term_t	term;
+
+		memset(&term, 0x0, sizeof(term));
+		term.word_freq = word_freq;
+		term.blocks = UT_NEW_NOKEY(fts_top_k_blocks_t());
+		term.n_occur = 1;
+
+		terms.push_back(term);
+
+		fts_query_top_k_fetch(query, &terms.back());
+	}
+
+	const bool	single_term = query->flags == FTS_OPT_RANKING;
+	ulint		n_terms = terms.size();
+	fts_top_k_heap_t heap;
+
+	if (query->error != DB_SUCCESS) {
+		goto func_exit;
+	}
+
+	for (ulint i = 0; i < n_terms; ++i) {
+		fts_top_k_sort_blocks(query, terms[i].blocks);
+
+		terms[i].word_freq->doc_count *= terms[i].n_occur;
+
+		if (single_term) {
+			/* The IDF of a single term query only counts
+			documents that have not been deleted. */
+			terms[i].word_freq->doc_count -= fts_top_k_count_deleted(
+				query, &terms[i]);
+		}
+	}
+
+	fts_query_calculate_idf(query);
+
+	{
+		/* Terms in ascending order of max_score */
+		std::vector<ulint, ut_allocator<ulint> >	order(n_terms);
+		std::vector<double, ut_allocator<double> >	prefix(n_terms);
+		std::vector<ulint, ut_allocator<ulint> >	freqs(n_terms);
+		const fts_update_t*	deleted = static_cast<const fts_update_t*>(
+			query->deleted->doc_ids->data);
+		int			n_deleted = static_cast<int>(
+			ib_vector_size(query->deleted->doc_ids));
+		/* Allowance for rounding in the float sums of ranks */
+		const double		slack = 1.0 + 1e-6 * double(n_terms + 1);
+		ulint			n_non_essential = 0;
+
+		for (ulint i = 0; i < n_terms; ++i) {
+			fts_top_k_term_t&	term = terms[i];
+			ulint			max_freq = 0;
+
+			for (ulint j = 0; j < term.blocks->size(); ++j) {
+				max_freq = ut_max(
+					max_freq, (*term.blocks)[j].max_freq);
+			}
+
+			term.weight = term.word_freq->idf * term.word_freq->idf;
+			term.max_score = double(max_freq) * term.weight;
+			term.block = 0;
+			term.pos = 0;
+
+			order[i] = i;
+		}
+
+		for (ulint i = 1; i < n_terms; ++i) {
+			for (ulint j = i; j > 0 && terms[order[j]].max_score
+			     < terms[order[j - 1]].max_score; --j) {
+				std::swap(order[j], order[j - 1]);
+			}
+		}
+
+		for (ulint i = 0; i < n_terms; ++i) {
+			prefix[i] = (i > 0 ? prefix[i - 1] : 0.0)
+				+ terms[order[i]].max_score;
+		}
+
+		heap.reserve(limit);
+
+		for (;;) {
+			/* The next candidate is the smallest doc id of the
+			essential terms. */
+			doc_id_t	doc_id = FTS_TOP_K_END;
+
+			for (ulint i = n_non_essential; i < n_terms; ++i) {
+				fts_top_k_term_t*	term = &terms[order[i]];
+				doc_id_t		d = fts_top_k_seek(
+					query, term, 0);
+
+				doc_id = ut_min(doc_id, d);
+			}
+
+			if (doc_id == FTS_TOP_K_END) {
+				break;
+			}
+
+			double	bound = 0.0;
+
+			for (ulint i = 0; i < n_terms; ++i) {
+				freqs[i] = 0;
+			}
+
+			for (ulint i = n_non_essential; i < n_terms; ++i) {
+				fts_top_k_term_t*	term = &terms[order[i]];
+
+				if (fts_top_k_seek(query, term, 0) == doc_id) {
+					const fts_top_k_block_t& block =
+						(*term->blocks)[term->block];
+
+					freqs[order[i]] =
+						block.docs[term->pos].freq;
+
+					bound += double(freqs[order[i]])
+						* term->weight;
+
+					/* Step past the candidate. */
+					++term->pos;
+				}
+			}
+
+			if (fts_bsearch(const_cast<fts_update_t*>(deleted), 0,
+					n_deleted, doc_id) >= 0) {
+				continue;
+			}
+
+			const bool	full = heap.size() == limit;
+
+			/* Add the non-essential terms from the largest
+			down, first by their block maximum and then, if the
+			document can still make it, exactly. */
+			for (ulint i = n_non_essential; full && i > 0; --i) {
+				fts_top_k_term_t*	term = &terms[order[i - 1]];
+
+				if ((bound + prefix[i - 1]) * slack
+				    <= heap.front().rank) {
+					break;
+				}
+
+				double	block_bound = fts_top_k_block_bound(
+					term, doc_id);
+
+				if (block_bound == 0.0) {
+					continue;
+				}
+
+				if ((bound + block_bound
+				     + (i > 1 ? prefix[i - 2] : 0.0)) * slack
+				    <= heap.front().rank) {
+					continue;
+				}
+
+				if (fts_top_k_seek(query, term, doc_id)
+				    == doc_id) {
+					freqs[order[i - 1]] = (*term->blocks)[
+						term->block].docs[term->pos].freq;
+
+					bound += double(freqs[order[i - 1]])
+						* term->weight;
+				}
+			}
+
+			if (full && bound * slack <= heap.front().rank) {
+				continue;
+			}
+
+			fts_ranking_t	ranking;
+
+			ranking.doc_id = doc_id;
+			ranking.words = NULL;
+			ranking.words_len = 0;
+
+			if (single_term) {
+				ranking.rank = static_cast<fts_rank_t>(
+					freqs[0]);
+				ranking.rank = static_cast<fts_rank_t>(
+					ranking.rank * terms[0].word_freq->idf
+					* terms[0].word_freq->idf);
+			} else {
+				ranking.rank = 0;
+
+				for (ulint i = 0; i < n_terms; ++i) {
+					double	idf = terms[i].word_freq->idf;
+					double	weight;
+
+					if (freqs[i] == 0) {
+						continue;
+					}
+
+					weight = double(freqs[i]) * idf;
+					ranking.rank += static_cast<fts_rank_t>(
+						weight * idf);
+				}
+			}
+
+			if (!full) {
+				heap.push_back(ranking);
+				std::push_heap(heap.begin(), heap.end(),
+					       fts_top_k_better);
+			} else if (fts_top_k_better(ranking, heap.front())) {
+				std::pop_heap(heap.begin(), heap.end(),
+					      fts_top_k_better);
+				heap.back() = ranking;
+				std::push_heap(heap.begin(), heap.end(),
+					       fts_top_k_better);
+			} else {
+				continue;
+			}
+
+			if (heap.size() < limit) {
+				continue;
+			}
+
+			/* Terms that together cannot lift a document
+			above the current threshold become non-essential. */
+			while (n_non_essential < n_terms
+			       && prefix[n_non_essential] * slack
+			       <= heap.front().rank) {
+				++n_non_essential;
+			}
+		}
+	}
+
+	*result = static_cast<fts_result_t*>(ut_zalloc_nokey(sizeof(**result)));
+
+	(*result)->rankings_by_id = rbt_create(
+		sizeof(fts_ranking_t), fts_ranking_doc_id_cmp);
+
+	for (ulint i = 0; i < heap.size(); ++i) {
+		rbt_insert((*result)->rankings_by_id, &heap[i], &heap[i]);
+	}
+
+func_exit:
+	for (ulint i = 0; i < terms.size(); ++i) {
+		UT_DELETE(terms[i].blocks);
+	}
+
+	return(query->error);
+}
+
 /** FTS Query entry point.
 @param[in]	trx		transaction
 @param[in]	index		fts index to search
 @param[in]	flags		FTS search mode
 @param[in]	query_str	FTS query
 @param[in]	query_len	FTS query string len in bytes
+@param[in]	limit		number of documents, in descending order of
+rank, that the caller will read, or ULINT_UNDEFINED for all
 @param[in,out]	result		result doc ids
 @return DB_SUCCESS if successful otherwise error code */
 dberr_t
@@ -3934,6 +5055,7 @@ fts_query(
 	uint		flags,
 	const byte*	query_str,
 	ulint		query_len,
+	ulint		limit,
 	fts_result_t**	result)
 {
 	fts_query_t	query;
@@ -4065,28 +5187,44 @@ fts_query(
 			        fts_result_cache_limit = 2048;
 		);
 
-		/* Traverse the Abstract Syntax Tree (AST) and execute
-		the query. */
-		query.error = fts_ast_visit(
-			FTS_NONE, ast, fts_query_visitor,
-			&query, &will_be_ignored);
+		if (fts_query_use_top_k(&query, flags, limit)) {
+			/* Only the best ranked documents will be read. */
+			srv_stats.n_fts_top_k_queries.inc();
+			fts_query_top_k(&query, limit, result);
+		} else {
+			if (boolean_mode) {
+				query.error = fts_query_find_candidates(
+					&query);
+			}
 
-		/* If query expansion is requested, extend the search
-		with first search pass result */
-		if (query.error == DB_SUCCESS && (flags & FTS_EXPAND)) {
-			query.error = fts_expand_query(index, &query);
-		}
+			/* Traverse the Abstract Syntax Tree (AST) and
+			execute the query. */
+			if (query.error == DB_SUCCESS) {
+				query.error = fts_ast_visit(
+					FTS_NONE, ast, fts_query_visitor,
+					&query, &will_be_ignored);
+			}
 
-		/* Calculate the inverse document frequency of the terms. */
-		if (query.error == DB_SUCCESS
-		    && query.flags != FTS_OPT_RANKING) {
-			fts_query_calculate_idf(&query);
-		}
+			/* If query expansion is requested, extend the
+			search with first search pass result */
+			if (query.error == DB_SUCCESS
+			    && (flags & FTS_EXPAND)) {
+				query.error = fts_expand_query(index, &query);
+			}
 
-		/* Copy the result from the query state, so that we can
-		return it to the caller. */
-		if (query.error == DB_SUCCESS) {
-			*result = fts_query_get_result(&query, *result);
+			/* Calculate the inverse document frequency of
+			the terms. */
+			if (query.error == DB_SUCCESS
+			    && query.flags != FTS_OPT_RANKING) {
+				fts_query_calculate_idf(&query);
+			}
+
+			/* Copy the result from the query state, so that
+			we can return it to the caller. */
+			if (query.error == DB_SUCCESS) {
+				*result = fts_query_get_result(
+					&query, *result);
+			}
 		}
 
 		error = query.error;
@@ -909,6 +909,7 @@ static ibool innodb_have_lz4=IF_LZ4(1, 0);
 static ibool innodb_have_lzma=IF_LZMA(1, 0);
 static ibool innodb_have_bzip2=IF_BZIP2(1, 0);
 static ibool innodb_have_snappy=IF_SNAPPY(1, 0);
+static ibool innodb_have_zstd=IF_ZSTD(1, 0);
 static ibool innodb_have_punch_hole=IF_PUNCH_HOLE(1, 0);
 
 static
@@ -965,6 +966,13 @@ static MYSQL_THDVAR_BOOL(table_locks, PLUGIN_VAR_OPCMDARG,
   /* check_func */ NULL, /* update_func */ NULL,
   /* default */ TRUE);
 
+static MYSQL_THDVAR_BOOL(bulk_insert_lock_table, PLUGIN_VAR_OPCMDARG,
+  "Allow a multi-row INSERT into an empty table to lock the table"
+  " exclusively until the transaction ends, and to load the rows sorted"
+  " instead of inserting them one by one",
+  /* check_func */ NULL, /* update_func */ NULL,
+  /* default */ FALSE);
+
 static MYSQL_THDVAR_BOOL(strict_mode, PLUGIN_VAR_OPCMDARG,
   "Use strict mode when evaluating create options.",
   NULL, NULL, TRUE);
@@ -989,6 +997,12 @@ static MYSQL_THDVAR_STR(tmpdir,
   innodb_tmpdir_validate, NULL, NULL);
 
 static SHOW_VAR innodb_status_variables[]= {
+  {"aio_backend",
+  (char*) &export_vars.innodb_aio_backend,		  SHOW_CHAR_PTR},
+  {"aio_requests",
+  (char*) &export_vars.innodb_aio_requests,		  SHOW_LONG},
+  {"aio_submit_calls",
+  (char*) &export_vars.innodb_aio_submit_calls,		  SHOW_LONG},
   {"buffer_pool_dump_status",
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
   {"buffer_pool_load_status",
@@ -1029,6 +1043,10 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_wait_free,	  SHOW_LONG},
   {"buffer_pool_write_requests",
   (char*) &export_vars.innodb_buffer_pool_write_requests, SHOW_LONG},
+  {"bulk_insert_rows",
+  (char*) &export_vars.innodb_bulk_insert_rows,		  SHOW_LONG},
+  {"bulk_insert_spills",
+  (char*) &export_vars.innodb_bulk_insert_spills,	  SHOW_LONG},
   {"data_fsyncs",
   (char*) &export_vars.innodb_data_fsyncs,		  SHOW_LONG},
   {"data_pending_fsyncs",
@@ -1049,6 +1067,12 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_dblwr_pages_written,	  SHOW_LONG},
   {"dblwr_writes",
   (char*) &export_vars.innodb_dblwr_writes,		  SHOW_LONG},
+  {"fts_top_k_queries",
+  (char*) &export_vars.innodb_fts_top_k_queries,	  SHOW_LONG},
+  {"fts_top_k_requeries",
+  (char*) &export_vars.innodb_fts_top_k_requeries,	  SHOW_LONG},
+  {"icp_filter_rejected",
+  (char*) &export_vars.innodb_icp_filter_rejected,	  SHOW_LONG},
   {"log_waits",
   (char*) &export_vars.innodb_log_waits,		  SHOW_LONG},
   {"log_write_requests",
@@ -1129,6 +1153,10 @@ static SHOW_VAR innodb_status_variables[]= {
    (char*) &export_vars.innodb_pages_page_decompressed,   SHOW_LONGLONG},
   {"num_pages_page_compression_error",
    (char*) &export_vars.innodb_pages_page_compression_error,   SHOW_LONGLONG},
+  {"num_pages_zstd_dict_compressed",
+   (char*) &export_vars.innodb_pages_zstd_dict_compressed,   SHOW_LONGLONG},
+  {"num_pages_zstd_dict_decompressed",
+   (char*) &export_vars.innodb_pages_zstd_dict_decompressed, SHOW_LONGLONG},
   {"num_pages_encrypted",
    (char*) &export_vars.innodb_pages_encrypted,   SHOW_LONGLONG},
   {"num_pages_decrypted",
@@ -1143,6 +1171,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &innodb_have_bzip2,		  SHOW_BOOL},
   {"have_snappy",
   (char*) &innodb_have_snappy,		  SHOW_BOOL},
+  {"have_zstd",
+  (char*) &innodb_have_zstd,		  SHOW_BOOL},
   {"have_punch_hole",
   (char*) &innodb_have_punch_hole,	  SHOW_BOOL},
 
@@ -3912,6 +3942,15 @@ innobase_init(
 	}
 #endif
 
+#ifndef HAVE_ZSTD
+	if (innodb_compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		sql_print_error("InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				"InnoDB: libzstd is not installed. \n",
+				innodb_compression_algorithm);
+		goto error;
+	}
+#endif
+
 	if ((srv_encrypt_tables || srv_encrypt_log)
 	     && !encryption_key_id_exists(FIL_DEFAULT_ENCRYPTION_KEY)) {
 		sql_print_error("InnoDB: cannot enable encryption, "
@@ -8175,6 +8214,7 @@ ha_innobase::build_template(
 		}
 
 		m_prebuilt->idx_cond = this;
+		innobase_build_icp_filter(pushed_idx_cond, table, m_prebuilt);
 	} else {
 no_icp:
 		mysql_row_templ_t*	templ;
@@ -10304,6 +10344,23 @@ ha_innobase::ft_init_ext(
 	uint			flags,	/* in: */
 	uint			keynr,	/* in: */
 	String*			key)	/* in: */
+{
+	return(ft_init_ext_with_limit(flags, keynr, key, HA_POS_ERROR));
+}
+
+/** Initialize FT index scan of which at most limit rows will be read,
+in descending order of relevance.
+@param[in]	flags	FT search mode
+@param[in]	keynr	index number
+@param[in]	key	search string
+@param[in]	limit	number of rows that will be read, or HA_POS_ERROR
+@return FT_INFO structure if successful or NULL */
+FT_INFO*
+ha_innobase::ft_init_ext_with_limit(
+	uint			flags,
+	uint			keynr,
+	String*			key,
+	ha_rows			limit)
 {
 	NEW_FT_INFO*		fts_hdl = NULL;
 	dict_index_t*		index;
@@ -10409,10 +10466,31 @@ ha_innobase::ft_init_ext(
 	const byte*	q = reinterpret_cast<const byte*>(
 		const_cast<char*>(query));
 
-	// FIXME: support ft_init_ext_with_hints(), pass LIMIT
-	dberr_t	error = fts_query(trx, index, flags, q, query_len, &result);
+	ulint	ft_limit = limit == HA_POS_ERROR || limit >= ULINT_UNDEFINED
+		? ULINT_UNDEFINED : ulint(limit);
+	byte*	ft_query = NULL;
+
+	if (ft_limit != ULINT_UNDEFINED) {
+		/* The result may be cut to the top documents. Keep a copy
+		of the search in case ft_read() has to skip a document that
+		is not visible to this transaction and repeat the search.
+		If there is no memory for the copy, search without the
+		limit. */
+		ft_query = static_cast<byte*>(my_memdup(q, query_len, MYF(0)));
+
+		DBUG_EXECUTE_IF("ft_init_ext_query_oom",
+				my_free(ft_query); ft_query = NULL;);
+
+		if (ft_query == NULL) {
+			ft_limit = ULINT_UNDEFINED;
+		}
+	}
+
+	dberr_t	error = fts_query(
+		trx, index, flags, q, query_len, ft_limit, &result);
 
 	if (error != DB_SUCCESS) {
+		my_free(ft_query);
 		my_error(convert_error_code_to_mysql(error, 0, NULL), MYF(0));
 		return(NULL);
 	}
@@ -10425,6 +10503,19 @@ ha_innobase::ft_init_ext(
 	fts_hdl->could_you = const_cast<_ft_vft_ext*>(&ft_vft_ext_result);
 	fts_hdl->ft_prebuilt = m_prebuilt;
 	fts_hdl->ft_result = result;
+	fts_hdl->ft_index = index;
+	fts_hdl->ft_flags = flags;
+	fts_hdl->ft_query = NULL;
+	fts_hdl->ft_query_len = 0;
+
+	if (ft_limit != ULINT_UNDEFINED && result->rankings_by_id != NULL
+	    && rbt_size(result->rankings_by_id) >= ft_limit) {
+		/* The result may have been cut to the top documents. */
+		fts_hdl->ft_query = ft_query;
+		fts_hdl->ft_query_len = query_len;
+	} else {
+		my_free(ft_query);
+	}
 
 	/* FIXME: Re-evaluate the condition when Bug 14469540 is resolved */
 	m_prebuilt->in_fts_query = true;
@@ -10601,6 +10692,23 @@ ha_innobase::ft_read(
 			table->status = 0;
 			break;
 		case DB_RECORD_NOT_FOUND:
+			if (reinterpret_cast<NEW_FT_INFO*>(
+				    ft_handler)->ft_query != NULL) {
+				/* Documents beyond the top ranked ones
+				are needed after all. */
+				ret = ft_requery();
+
+				if (ret != DB_SUCCESS) {
+					error = convert_error_code_to_mysql(
+						ret, 0, m_user_thd);
+					table->status = STATUS_NOT_FOUND;
+					break;
+				}
+
+				result = reinterpret_cast<NEW_FT_INFO*>(
+					ft_handler)->ft_result;
+			}
+
 			result->current = const_cast<ib_rbt_node_t*>(
 				rbt_next(result->rankings_by_rank,
 					 result->current));
@@ -10654,6 +10762,56 @@ ha_innobase::ft_read(
 	return(HA_ERR_END_OF_FILE);
 }
 
+/** Repeat a full-text search whose result was cut to the top ranked
+documents, without a limit. The current position is kept.
+@return DB_SUCCESS or error code */
+dberr_t
+ha_innobase::ft_requery()
+{
+	NEW_FT_INFO*	fts_hdl = reinterpret_cast<NEW_FT_INFO*>(ft_handler);
+	fts_result_t*	result = fts_hdl->ft_result;
+	fts_result_t*	full_result;
+	ulint		n_read = 1;
+
+	srv_stats.n_fts_top_k_requeries.inc();
+
+	for (const ib_rbt_node_t* node = rbt_first(result->rankings_by_rank);
+	     node != result->current;
+	     node = rbt_next(result->rankings_by_rank, node)) {
+		++n_read;
+	}
+
+	dberr_t	error = fts_query(
+		m_prebuilt->trx, fts_hdl->ft_index, fts_hdl->ft_flags,
+		fts_hdl->ft_query, fts_hdl->ft_query_len, ULINT_UNDEFINED,
+		&full_result);
+
+	if (error != DB_SUCCESS) {
+		return(error);
+	}
+
+	my_free(fts_hdl->ft_query);
+	fts_hdl->ft_query = NULL;
+
+	/* The top documents rank the same and in the same order in the
+	full result, so skip as many as have been read. */
+	fts_query_sort_result_on_rank(full_result);
+
+	full_result->current = const_cast<ib_rbt_node_t*>(
+		rbt_first(full_result->rankings_by_rank));
+
+	while (--n_read > 0 && full_result->current != NULL) {
+		full_result->current = const_cast<ib_rbt_node_t*>(
+			rbt_next(full_result->rankings_by_rank,
+				 full_result->current));
+	}
+
+	fts_query_free_result(result);
+	fts_hdl->ft_result = full_result;
+
+	return(DB_SUCCESS);
+}
+
 /*************************************************************************
 */
 
@@ -15808,8 +15966,12 @@ ha_innobase::extra(
 	case HA_EXTRA_INSERT_WITH_UPDATE:
 		thd_to_trx(ha_thd())->duplicates |= TRX_DUP_IGNORE;
 		break;
+	case HA_EXTRA_IGNORE_DUP_KEY:
+		m_prebuilt->ignore_dup_key = true;
+		break;
 	case HA_EXTRA_NO_IGNORE_DUP_KEY:
 		thd_to_trx(ha_thd())->duplicates &= ~TRX_DUP_IGNORE;
+		m_prebuilt->ignore_dup_key = false;
 		break;
 	case HA_EXTRA_WRITE_CAN_REPLACE:
 		thd_to_trx(ha_thd())->duplicates |= TRX_DUP_REPLACE;
@@ -15834,6 +15996,59 @@ ha_innobase::extra(
 	return(0);
 }
 
+/** Prepare for inserting many rows. If the table is empty when the
+first row is inserted, the rows will be sorted and loaded into the
+indexes by end_bulk_insert(); see row_bulk_insert_start().
+@param[in]	rows	estimated number of rows, or 0 if not known
+@param[in]	flags	HA_CREATE_UNIQUE_INDEX_BY_SORT or 0 */
+void
+ha_innobase::start_bulk_insert(ha_rows rows, uint flags)
+{
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+
+	ut_ad(!m_prebuilt->bulk_insert);
+
+	THD*	thd = ha_thd();
+
+	/* Triggers and stored functions could read the table while
+	the inserted rows are only buffered. */
+	m_prebuilt->bulk_insert_requested = rows != 1
+		&& !high_level_read_only
+		&& !table->triggers
+		&& !thd_uses_stored_routines(thd)
+#ifdef WITH_WSREP
+		&& !wsrep_on(thd)
+#endif /* WITH_WSREP */
+		;
+	m_prebuilt->bulk_insert_lock = THDVAR(thd, bulk_insert_lock_table);
+
+	DBUG_VOID_RETURN;
+}
+
+/** Load the rows that were buffered since start_bulk_insert().
+@return 0 or error code */
+int
+ha_innobase::end_bulk_insert()
+{
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	THD*	thd = ha_thd();
+
+	/* A killed statement will be rolled back to the TRX_UNDO_EMPTY
+	record, and there is no point in loading the rows. */
+	dberr_t	err = row_bulk_insert_end(m_prebuilt, thd_kill_level(thd));
+
+	if (err == DB_SUCCESS) {
+		DBUG_RETURN(0);
+	}
+
+	int	error = convert_error_code_to_mysql(
+		err, m_prebuilt->table->flags, thd);
+
+	set_my_errno(error);
+	DBUG_RETURN(error);
+}
+
 /**
 MySQL calls this method at the end of each statement. This method
 exists for readability only. ha_innobase::reset() doesn't give any
@@ -15846,6 +16061,13 @@ ha_innobase::end_stmt()
 		row_mysql_prebuilt_free_blob_heap(m_prebuilt);
 	}
 
+	if (m_prebuilt->bulk_insert_requested || m_prebuilt->bulk_insert) {
+		/* end_bulk_insert() was not called. */
+		row_bulk_insert_end(m_prebuilt, true);
+	}
+
+	m_prebuilt->ignore_dup_key = false;
+
 	reset_template();
 
 	m_ds_mrr.dsmrr_close();
@@ -19497,6 +19719,7 @@ innobase_fts_close_ranking(
 
 	fts_query_free_result(result);
 
+	my_free(reinterpret_cast<NEW_FT_INFO*>(fts_hdl)->ft_query);
 	my_free((uchar*) fts_hdl);
 }
 
@@ -20306,6 +20529,14 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   " Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_STR(doublewrite_file, srv_doublewrite_file,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Path of a file that holds a separate doublewrite area for each buffer"
+  " pool instance and flush type, relative to the data directory unless"
+  " absolute. By default all batches share the doublewrite buffer in the"
+  " system tablespace.",
+  NULL, NULL, NULL);
+
 static MYSQL_SYSVAR_BOOL(use_atomic_writes, innobase_use_atomic_writes,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Enable atomic writes, instead of using the doublewrite buffer, for files "
@@ -20578,6 +20809,14 @@ static MYSQL_SYSVAR_BOOL(stats_auto_recalc, srv_stats_auto_recalc,
   " new statistics)",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(stats_incremental_recalc,
+  srv_stats_incremental_recalc,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether the automatic recalculation of persistent statistics skips"
+  " the indexes that were not modified and samples the others in proportion"
+  " to their modifications, merging the results with the previous statistics",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   srv_stats_persistent_sample_pages,
   PLUGIN_VAR_RQCMDARG,
@@ -20609,6 +20848,13 @@ static MYSQL_SYSVAR_ULONG(adaptive_hash_index_parts, btr_ahi_parts,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Number of InnoDB Adaptive Hash Index Partitions (default 8)",
   NULL, NULL, 8, 1, 512, 0);
+
+static MYSQL_SYSVAR_ULONG(adaptive_hash_index_max_pages,
+  btr_search_index_max_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of pages of a single index that may be hashed"
+  " in the InnoDB adaptive hash index (0 = unlimited, the default)",
+  NULL, NULL, 0, 0, ~0UL, 0);
 #endif /* BTR_CUR_HASH_ADAPT */
 
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
@@ -20748,6 +20994,12 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_st
   "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_buf_load_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read pages in parallel during a buffer pool load."
+  " Each thread reads sorted, contiguous runs of pages of one tablespace.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_BOOL(defragment, srv_defragment,
   PLUGIN_VAR_RQCMDARG,
   "Enable/disable InnoDB defragmentation (default FALSE). When set to FALSE, all existing "
@@ -21083,6 +21335,11 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO on Linux, if supported.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -21180,6 +21437,13 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   " trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(fetch_cache_max_rows, srv_fetch_cache_max_rows,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of rows that a non-locking scan fetches in one batch"
+  " while holding the page latch. The batch starts at 8 rows and doubles"
+  " while the scan continues, up to 1 MiB of rows.",
+  NULL, NULL, MYSQL_FETCH_CACHE_SIZE, MYSQL_FETCH_CACHE_SIZE, 16384, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
   PLUGIN_VAR_RQCMDARG,
   "Turn on a monitor counter",
@@ -21329,7 +21593,7 @@ static MYSQL_SYSVAR_BOOL(use_trim, srv_use_trim,
   "Deallocate (punch_hole|trim) unused portions of the page compressed page (on by default)",
   NULL, innodb_use_trim_update, TRUE);
 
-static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", 0 };
+static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", "zstd", 0 };
 static TYPELIB page_compression_algorithms_typelib=
 {
   array_elements(page_compression_algorithms) - 1, 0,
@@ -21337,7 +21601,7 @@ static TYPELIB page_compression_algorithms_typelib=
 };
 static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PLUGIN_VAR_OPCMDARG,
-  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, or bzip2",
+  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, snappy, or zstd",
   innodb_compression_algorithm_validate, NULL,
   /* We use here the largest number of supported compression method to
   enable all those methods that are available. Availability of compression
@@ -21345,6 +21609,13 @@ static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PAGE_ZLIB_ALGORITHM,
   &page_compression_algorithms_typelib);
 
+static MYSQL_SYSVAR_BOOL(compression_zstd_dictionary, srv_zstd_dictionary,
+  PLUGIN_VAR_OPCMDARG,
+  "Whether zstd page compression trains a dictionary for each tablespace"
+  " and stores it in the first page. The dictionary contains fragments"
+  " of the data; it is not used for tablespaces that are encrypted.",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_LONG(mtflush_threads, srv_mtflush_threads,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "DEPRECATED. Number of multi-threaded flush threads",
@@ -21497,6 +21768,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_load_now),
   MYSQL_SYSVAR(buffer_pool_load_abort),
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
   MYSQL_SYSVAR(defragment),
   MYSQL_SYSVAR(defragment_n_pages),
   MYSQL_SYSVAR(defragment_stats_accuracy),
@@ -21515,6 +21787,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_file),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(use_atomic_writes),
   MYSQL_SYSVAR(use_fallocate),
@@ -21575,11 +21848,13 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
   MYSQL_SYSVAR(stats_auto_recalc),
+  MYSQL_SYSVAR(stats_incremental_recalc),
   MYSQL_SYSVAR(stats_modified_counter),
   MYSQL_SYSVAR(stats_traditional),
 #ifdef BTR_CUR_HASH_ADAPT
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(adaptive_hash_index_parts),
+  MYSQL_SYSVAR(adaptive_hash_index_max_pages),
 #endif /* BTR_CUR_HASH_ADAPT */
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
@@ -21591,6 +21866,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
   MYSQL_SYSVAR(table_locks),
+  MYSQL_SYSVAR(bulk_insert_lock_table),
   MYSQL_SYSVAR(thread_concurrency),
   MYSQL_SYSVAR(adaptive_max_sleep_delay),
   MYSQL_SYSVAR(prefix_index_cluster_optimization),
@@ -21599,6 +21875,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -21613,6 +21890,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* WITH_INNODB_DISALLOW_WRITES */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(fetch_cache_max_rows),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(io_capacity),
   MYSQL_SYSVAR(io_capacity_max),
@@ -21669,6 +21947,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(use_trim),
   MYSQL_SYSVAR(compression_default),
   MYSQL_SYSVAR(compression_algorithm),
+  MYSQL_SYSVAR(compression_zstd_dictionary),
   MYSQL_SYSVAR(mtflush_threads),
   MYSQL_SYSVAR(use_mtflush),
   /* Encryption feature */
@@ -21725,6 +22004,9 @@ i_s_innodb_cmpmem,
 i_s_innodb_cmpmem_reset,
 i_s_innodb_cmp_per_index,
 i_s_innodb_cmp_per_index_reset,
+#ifdef BTR_CUR_HASH_ADAPT
+i_s_innodb_ahi_per_index,
+#endif /* BTR_CUR_HASH_ADAPT */
 i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
 i_s_innodb_buffer_stats,
@@ -21876,6 +22158,30 @@ innobase_index_cond(
 	return handler_index_cond_check(file);
 }
 
+/** Account for a record that was rejected by row_icp_filter_t
+without evaluating the pushed index condition.
+@param[in,out]	file	pointer to ha_innobase
+@return ICP_NO_MATCH, or ICP_ABORTED_BY_USER */
+ICP_RESULT
+innobase_index_cond_skip(void* file)
+{
+	return(static_cast<ha_innobase*>(file)->idx_cond_skip());
+}
+
+/** Account for a record that was rejected by row_icp_filter_t
+without evaluating the pushed index condition.
+@return ICP_NO_MATCH, or ICP_ABORTED_BY_USER */
+ICP_RESULT
+ha_innobase::idx_cond_skip()
+{
+	if (thd_kill_level(table->in_use) > THD_ABORT_SOFTLY) {
+		return(ICP_ABORTED_BY_USER);
+	}
+
+	increment_statistics(&SSV::ha_icp_attempts);
+	return(ICP_NO_MATCH);
+}
+
 
 /** Find or open a mysql table for the virtual column template
 @param[in]	thd	mysql thread handle
@@ -22658,6 +22964,17 @@ innodb_compression_algorithm_validate(
 		DBUG_RETURN(1);
 	}
 #endif
+
+#ifndef HAVE_ZSTD
+	if (compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				    "InnoDB: libzstd is not installed. \n",
+				    compression_algorithm);
+		DBUG_RETURN(1);
+	}
+#endif
 	DBUG_RETURN(0);
 }
 
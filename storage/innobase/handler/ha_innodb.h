@@ -188,6 +188,12 @@ class ha_innobase: public handler
 
 	FT_INFO* ft_init_ext(uint flags, uint inx, String* key);
 
+	FT_INFO* ft_init_ext_with_limit(
+		uint			flags,
+		uint			inx,
+		String*			key,
+		ha_rows			limit);
+
 	FT_INFO* ft_init_ext_with_hints(
 		uint			inx,
 		String*			key,
@@ -196,6 +202,8 @@ class ha_innobase: public handler
 
 	int ft_read(uchar* buf);
 
+	dberr_t ft_requery();
+
 	void position(const uchar *record);
 
 	int info(uint);
@@ -208,6 +216,10 @@ class ha_innobase: public handler
 
 	int extra(ha_extra_function operation);
 
+	void start_bulk_insert(ha_rows rows, uint flags);
+
+	int end_bulk_insert();
+
 	int reset();
 
 	int external_lock(THD *thd, int lock_type);
@@ -431,6 +443,11 @@ class ha_innobase: public handler
 	@param[in] idx_cond Index condition to be checked
 	@return idx_cond if pushed; NULL if not pushed */
 	Item* idx_cond_push(uint keyno, Item* idx_cond);
+
+	/** Account for a record that was rejected by row_icp_filter_t
+	without evaluating the pushed index condition.
+	@return ICP_NO_MATCH, or ICP_ABORTED_BY_USER */
+	ICP_RESULT idx_cond_skip();
 	/* @} */
 
 	/* An helper function for index_cond_func_innodb: */
@@ -571,6 +588,11 @@ bool thd_binlog_filter_ok(const MYSQL_THD thd);
 */
 bool thd_sqlcom_can_generate_row_events(const MYSQL_THD thd);
 
+/** Check if the statement invokes stored functions or procedures.
+@param thd Thread handle
+@retval 1 the statement uses stored routines, 0 otherwise. */
+bool thd_uses_stored_routines(const MYSQL_THD thd);
+
 /** Is strict sql_mode set.
 @param thd Thread object
 @return True if sql_mode has strict mode (all or trans), false otherwise. */
@@ -622,6 +644,12 @@ typedef struct new_ft_info
 	struct _ft_vft_ext	*could_you;
 	row_prebuilt_t*		ft_prebuilt;
 	fts_result_t*		ft_result;
+	/** If ft_result only holds the top ranked documents: the search,
+	so that it can be repeated in full when a document is not found */
+	dict_index_t*		ft_index;
+	uint			ft_flags;
+	byte*			ft_query;
+	ulint			ft_query_len;
 } NEW_FT_INFO;
 
 /**
@@ -994,6 +1022,18 @@ unsigned
 innodb_col_no(const Field* field)
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
 
+/** Compile the conjuncts of the pushed index condition that
+row_icp_filter_t can evaluate.
+@param[in]	cond		pushed index condition
+@param[in]	table		table
+@param[in,out]	prebuilt	prebuilt struct, with the templates
+for index condition pushdown */
+void
+innobase_build_icp_filter(
+	Item*		cond,
+	const TABLE*	table,
+	row_prebuilt_t*	prebuilt);
+
 /********************************************************************//**
 Helper function to push frm mismatch error to error log and
 if needed to sql-layer. */
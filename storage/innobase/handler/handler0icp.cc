@@ -0,0 +1,404 @@
+/*****************************************************************************
+
+Copyright (c) 2018, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file handler/handler0icp.cc
+Compilation of pushed index conditions for row_icp_filter_t
+*******************************************************/
+
+/* Item_func and its subclasses are only visible to the server. */
+#define MYSQL_SERVER 1
+
+#include "ha_prototypes.h"
+#include <sql_class.h>
+#include <item.h>
+#include <sql_time.h>
+
+#include "row0mysql.h"
+#include "ha_innodb.h"
+
+#include <algorithm>
+
+/** Find the index condition pushdown template of a column that
+row_icp_filter_t can evaluate.
+@param[in]	prebuilt	prebuilt struct
+@param[in]	table		table
+@param[in]	item		an argument of a condition
+@return the template, or NULL if item is not such a column */
+static
+const mysql_row_templ_t*
+innobase_icp_filter_templ(
+	const row_prebuilt_t*	prebuilt,
+	const TABLE*		table,
+	Item*			item)
+{
+	item = item->real_item();
+
+	if (item->type() != Item::FIELD_ITEM) {
+		return(NULL);
+	}
+
+	const Field*	field = static_cast<Item_field*>(item)->field;
+
+	if (field->table != table) {
+		return(NULL);
+	}
+
+	switch (field->real_type()) {
+	case MYSQL_TYPE_TINY:
+	case MYSQL_TYPE_SHORT:
+	case MYSQL_TYPE_INT24:
+	case MYSQL_TYPE_LONG:
+	case MYSQL_TYPE_LONGLONG:
+	case MYSQL_TYPE_NEWDATE:
+		break;
+	default:
+		return(NULL);
+	}
+
+	const ulint	offset = ulint(field->ptr - table->record[0]);
+
+	for (ulint i = 0; i < prebuilt->idx_cond_n_cols; i++) {
+		const mysql_row_templ_t*	templ
+			= &prebuilt->mysql_template[i];
+
+		if (templ->mysql_col_offset == offset) {
+			return(!templ->is_virtual
+			       && templ->type == DATA_INT
+			       && templ->icp_rec_field_no != ULINT_UNDEFINED
+			       ? templ : NULL);
+		}
+	}
+
+	return(NULL);
+}
+
+/** Convert a constant of an index condition to row_icp_filter_t::key().
+@param[in]	item	constant
+@param[in]	templ	column that the constant is compared with
+@param[out]	key	the key, if *pos is 0
+@param[out]	pos	-1 if the constant is below any value of the column,
+1 if it is above any value, 0 if key was assigned
+@return whether the constant can be used */
+static
+bool
+innobase_icp_filter_key(
+	Item*				item,
+	const mysql_row_templ_t*	templ,
+	ib_uint64_t*			key,
+	int*				pos)
+{
+	if (!item->basic_const_item()) {
+		return(false);
+	}
+
+	longlong	val;
+	bool		val_unsigned;
+
+	if (templ->mysql_type != MYSQL_TYPE_DATE) {
+		if (item->cmp_type() != INT_RESULT) {
+			return(false);
+		}
+
+		val = item->val_int();
+		val_unsigned = item->unsigned_flag;
+	} else {
+		MYSQL_TIME	ltime;
+
+		switch (item->cmp_type()) {
+		case TIME_RESULT:
+			if (item->get_date(&ltime, 0)) {
+				return(false);
+			}
+			break;
+		case STRING_RESULT: {
+			String			tmp;
+			const String*		str = item->val_str(&tmp);
+			MYSQL_TIME_STATUS	status;
+
+			if (!str
+			    || str_to_datetime(str->charset(), str->ptr(),
+					       str->length(), &ltime, 0,
+					       &status)
+			    || status.warnings) {
+				return(false);
+			}
+			break;
+		}
+		default:
+			return(false);
+		}
+
+		/* Only compare with valid dates. A time of day would
+		make the comparison a DATETIME comparison. */
+		if (ltime.neg || !ltime.year || !ltime.month || !ltime.day
+		    || ltime.hour || ltime.minute || ltime.second
+		    || ltime.second_part) {
+			return(false);
+		}
+
+		/* The format of Field_newdate::store_TIME() */
+		val = longlong(ltime.year * 16 * 32 + ltime.month * 32
+			       + ltime.day);
+		val_unsigned = false;
+	}
+
+	if (item->null_value) {
+		return(false);
+	}
+
+	*pos = 0;
+
+	if (templ->is_unsigned) {
+		if (!val_unsigned && val < 0) {
+			*pos = -1;
+		}
+	} else if (val_unsigned && ulonglong(val) > ulonglong(LONGLONG_MAX)) {
+		*pos = 1;
+	}
+
+	*key = row_icp_filter_t::key(ib_uint64_t(val), templ->is_unsigned);
+	return(true);
+}
+
+/** Narrow down a row_icp_term_t by a comparison with a constant.
+@param[in,out]	term	the condition
+@param[in]	func	Item_func::LT_FUNC, LE_FUNC, EQ_FUNC, GE_FUNC
+or GT_FUNC, with the column on the left
+@param[in]	key	the constant
+@param[in]	pos	position of the constant relative to the column */
+static
+void
+innobase_icp_filter_bound(
+	row_icp_term_t*		term,
+	Item_func::Functype	func,
+	ib_uint64_t		key,
+	int			pos)
+{
+	const ib_uint64_t	max = ~ib_uint64_t(0);
+
+	switch (func) {
+	case Item_func::EQ_FUNC:
+		if (pos) {
+			term->low = 1;
+			term->high = 0;
+		} else {
+			term->low = std::max(term->low, key);
+			term->high = std::min(term->high, key);
+		}
+		return;
+	case Item_func::LT_FUNC:
+	case Item_func::LE_FUNC:
+		if (pos < 0 || (!pos && func == Item_func::LT_FUNC
+				&& key == 0)) {
+			term->low = 1;
+			term->high = 0;
+		} else if (!pos) {
+			term->high = std::min(
+				term->high,
+				func == Item_func::LT_FUNC ? key - 1 : key);
+		}
+		return;
+	case Item_func::GT_FUNC:
+	case Item_func::GE_FUNC:
+		if (pos > 0 || (!pos && func == Item_func::GT_FUNC
+				&& key == max)) {
+			term->low = 1;
+			term->high = 0;
+		} else if (!pos) {
+			term->low = std::max(
+				term->low,
+				func == Item_func::GT_FUNC ? key + 1 : key);
+		}
+		return;
+	default:
+		ut_error;
+	}
+}
+
+/** Compile a conjunct of the pushed index condition into a
+row_icp_term_t, if it compares an integer or DATE column of the index
+with constants.
+@param[in]	cond		the conjunct
+@param[in]	prebuilt	prebuilt struct
+@param[in]	table		table
+@param[out]	term		the condition
+@return whether the conjunct was compiled */
+static
+bool
+innobase_icp_filter_term(
+	Item*			cond,
+	const row_prebuilt_t*	prebuilt,
+	const TABLE*		table,
+	row_icp_term_t*		term)
+{
+	if (cond->type() != Item::FUNC_ITEM) {
+		return(false);
+	}
+
+	Item_func*			func = static_cast<Item_func*>(cond);
+	Item**				args = func->arguments();
+	Item_func::Functype		functype = func->functype();
+	const mysql_row_templ_t*	templ;
+	ib_uint64_t			key;
+	int				pos;
+
+	switch (functype) {
+	case Item_func::EQ_FUNC:
+	case Item_func::LT_FUNC:
+	case Item_func::LE_FUNC:
+	case Item_func::GE_FUNC:
+	case Item_func::GT_FUNC: {
+		const Item_bool_rowready_func2*	cmp
+			= static_cast<Item_bool_rowready_func2*>(func);
+		Item*				value = args[1];
+
+		if ((templ = innobase_icp_filter_templ(
+			     prebuilt, table, args[0])) == NULL) {
+			/* Try "constant op column". */
+			if ((templ = innobase_icp_filter_templ(
+				     prebuilt, table, args[1])) == NULL) {
+				return(false);
+			}
+
+			value = args[0];
+			functype = cmp->rev_functype();
+		}
+
+		if (cmp->compare_type()
+		    != (templ->mysql_type == MYSQL_TYPE_DATE
+			? TIME_RESULT : INT_RESULT)
+		    || !innobase_icp_filter_key(value, templ, &key, &pos)) {
+			return(false);
+		}
+		break;
+	}
+	case Item_func::BETWEEN:
+	case Item_func::IN_FUNC:
+		if (static_cast<Item_func_opt_neg*>(func)->negated
+		    || (templ = innobase_icp_filter_templ(
+				prebuilt, table, args[0])) == NULL) {
+			return(false);
+		}
+		break;
+	default:
+		return(false);
+	}
+
+	term->rec_field_no = templ->icp_rec_field_no;
+	term->is_unsigned = templ->is_unsigned;
+	term->low = 0;
+	term->high = ~ib_uint64_t(0);
+	term->in.clear();
+
+	switch (functype) {
+	case Item_func::BETWEEN:
+		for (uint i = 1; i <= 2; i++) {
+			if (!innobase_icp_filter_key(args[i], templ,
+						     &key, &pos)) {
+				return(false);
+			}
+
+			innobase_icp_filter_bound(
+				term, i == 1
+				? Item_func::GE_FUNC : Item_func::LE_FUNC,
+				key, pos);
+		}
+		return(true);
+	case Item_func::IN_FUNC:
+		for (uint i = 1; i < func->argument_count(); i++) {
+			if (!innobase_icp_filter_key(args[i], templ,
+						     &key, &pos)) {
+				return(false);
+			}
+
+			if (!pos) {
+				term->in.push_back(key);
+			}
+		}
+
+		std::sort(term->in.begin(), term->in.end());
+
+		if (term->in.empty()) {
+			/* No value of the column can match. */
+			term->low = 1;
+			term->high = 0;
+		} else {
+			term->low = term->in.front();
+			term->high = term->in.back();
+		}
+		return(true);
+	default:
+		innobase_icp_filter_bound(term, functype, key, pos);
+		return(true);
+	}
+}
+
+/** Compile the conjuncts of the pushed index condition that
+row_icp_filter_t can evaluate.
+@param[in]	cond		pushed index condition
+@param[in]	table		table
+@param[in,out]	prebuilt	prebuilt struct, with the templates
+for index condition pushdown */
+void
+innobase_build_icp_filter(
+	Item*		cond,
+	const TABLE*	table,
+	row_prebuilt_t*	prebuilt)
+{
+	row_icp_filter_t*	filter = prebuilt->icp_filter;
+
+	if (filter) {
+		filter->terms.clear();
+	}
+
+	if (!cond) {
+		return;
+	}
+
+	List<Item>	single;
+	List<Item>*	conds = &single;
+
+	if (cond->type() == Item::COND_ITEM
+	    && static_cast<Item_cond*>(cond)->functype()
+	    == Item_func::COND_AND_FUNC) {
+		conds = static_cast<Item_cond*>(cond)->argument_list();
+	} else {
+		single.push_back(cond);
+	}
+
+	List_iterator_fast<Item>	it(*conds);
+	row_icp_term_t			term;
+
+	while (Item* item = it++) {
+		if (!innobase_icp_filter_term(item, prebuilt, table, &term)) {
+			continue;
+		}
+
+		if (!filter) {
+			filter = prebuilt->icp_filter
+				= UT_NEW_NOKEY(row_icp_filter_t());
+		}
+
+		filter->terms.push_back(term);
+	}
+
+	if (filter) {
+		filter->n_skipped = 0;
+	}
+}
@@ -54,6 +54,7 @@ Modified Dec 29, 2014 Jan Lindström (Added sys_semaphore_waits)
 #include "fts0opt.h"
 #include "fts0priv.h"
 #include "btr0btr.h"
+#include "btr0sea.h"
 #include "page0zip.h"
 #include "sync0arr.h"
 #include "fil0fil.h"
@@ -1959,6 +1960,243 @@ UNIV_INTERN struct st_maria_plugin	i_s_innodb_cmp_per_index_reset =
         STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE),
 };
 
+#ifdef BTR_CUR_HASH_ADAPT
+/* Fields of the dynamic table information_schema.innodb_ahi_per_index. */
+static ST_FIELD_INFO	i_s_ahi_per_index_fields_info[] =
+{
+#define AHI_DATABASE_NAME	0
+	{STRUCT_FLD(field_name,		"database_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_TABLE_NAME		1
+	{STRUCT_FLD(field_name,		"table_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_NAME		2
+	{STRUCT_FLD(field_name,		"index_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_INDEX_ID		3
+	{STRUCT_FLD(field_name,		"index_id"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_PAGES_HASHED	4
+	{STRUCT_FLD(field_name,		"pages_hashed"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_HITS		5
+	{STRUCT_FLD(field_name,		"hits"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define AHI_MISSES		6
+	{STRUCT_FLD(field_name,		"misses"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill information_schema.innodb_ahi_per_index with the adaptive hash index
+statistics of the indexes of one cached table.
+@return 0 on success, 1 on failure */
+static
+int
+i_s_ahi_per_index_fill_table(
+/*=========================*/
+	THD*			thd,	/*!< in: thread */
+	TABLE*			table,	/*!< in/out: table to fill */
+	const dict_table_t*	dict_table)/*!< in: cached table */
+{
+	Field**	fields = table->field;
+	char	db_utf8[MAX_DB_UTF8_LEN];
+	char	table_utf8[MAX_TABLE_UTF8_LEN];
+
+	dict_fs2utf8(dict_table->name.m_name,
+		     db_utf8, sizeof(db_utf8),
+		     table_utf8, sizeof(table_utf8));
+
+	for (const dict_index_t* index = dict_table_get_first_index(dict_table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		/* The counters are updated without any latch, and
+		ref_count is protected by the search latch, which we
+		do not acquire here: the values may be slightly off. */
+		const btr_search_t*	info = index->search_info;
+
+		if (info->ref_count == 0
+		    && info->n_hash_hits == 0
+		    && info->n_hash_misses == 0) {
+			continue;
+		}
+
+		field_store_string(fields[AHI_DATABASE_NAME], db_utf8);
+		field_store_string(fields[AHI_TABLE_NAME], table_utf8);
+		field_store_index_name(fields[AHI_INDEX_NAME], index->name);
+
+		fields[AHI_INDEX_ID]->store(index->id, true);
+		fields[AHI_PAGES_HASHED]->store(info->ref_count, true);
+		fields[AHI_HITS]->store(info->n_hash_hits, true);
+		fields[AHI_MISSES]->store(info->n_hash_misses, true);
+
+		if (schema_table_store_record(thd, table)) {
+			return(1);
+		}
+	}
+
+	return(0);
+}
+
+/*******************************************************************//**
+Fill the dynamic table information_schema.innodb_ahi_per_index.
+@return 0 on success, 1 on failure */
+static
+int
+i_s_ahi_per_index_fill(
+/*===================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	Item*		)	/*!< in: condition (ignored) */
+{
+	int	status = 0;
+
+	DBUG_ENTER("i_s_ahi_per_index_fill");
+
+	/* deny access to non-superusers */
+	if (check_global_access(thd, PROCESS_ACL)) {
+
+		DBUG_RETURN(0);
+	}
+
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
+
+	mutex_enter(&dict_sys->mutex);
+
+	for (const dict_table_t* table = UT_LIST_GET_FIRST(dict_sys->table_LRU);
+	     table != NULL && status == 0;
+	     table = UT_LIST_GET_NEXT(table_LRU, table)) {
+
+		status = i_s_ahi_per_index_fill_table(thd, tables->table,
+						      table);
+	}
+
+	for (const dict_table_t* table
+		     = UT_LIST_GET_FIRST(dict_sys->table_non_LRU);
+	     table != NULL && status == 0;
+	     table = UT_LIST_GET_NEXT(table_LRU, table)) {
+
+		status = i_s_ahi_per_index_fill_table(thd, tables->table,
+						      table);
+	}
+
+	mutex_exit(&dict_sys->mutex);
+
+	DBUG_RETURN(status);
+}
+
+/*******************************************************************//**
+Bind the dynamic table information_schema.innodb_ahi_per_index.
+@return 0 on success */
+static
+int
+i_s_ahi_per_index_init(
+/*===================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	DBUG_ENTER("i_s_ahi_per_index_init");
+	ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = i_s_ahi_per_index_fields_info;
+	schema->fill_table = i_s_ahi_per_index_fill;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_maria_plugin	i_s_innodb_ahi_per_index =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_AHI_PER_INDEX"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, maria_plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "Adaptive hash index statistics per index"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_ahi_per_index_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+        /* Maria extension */
+	STRUCT_FLD(version_info, INNODB_VERSION_STR),
+        STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE),
+};
+#endif /* BTR_CUR_HASH_ADAPT */
+
 /* Fields of the dynamic table information_schema.innodb_cmpmem. */
 static ST_FIELD_INFO	i_s_cmpmem_fields_info[] =
 {
@@ -8576,6 +8814,24 @@ static ST_FIELD_INFO	innodb_tablespaces_encryption_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+#define TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE 10
+	{STRUCT_FLD(field_name,		"KEY_ROTATION_PAGES_DONE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_PER_SECOND 11
+	{STRUCT_FLD(field_name,		"KEY_ROTATION_PAGES_PER_SECOND"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -8633,11 +8889,22 @@ i_s_dict_fill_tablespaces_encryption(
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]->set_notnull();
 		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]->store(
 			   status.rotate_max_page_number, true));
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE]->set_notnull();
+		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE]->store(
+			   status.rotate_pages_done, true));
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_PER_SECOND]
+			->set_notnull();
+		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_PER_SECOND]
+		   ->store(status.rotate_pages_per_second, true));
 	} else {
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGE_NUMBER]
 			->set_null();
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]
 			->set_null();
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE]
+			->set_null();
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_PER_SECOND]
+			->set_null();
 	}
 
 	OK(schema_table_store_record(thd, table_to_fill));
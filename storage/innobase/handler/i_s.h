@@ -38,6 +38,9 @@ extern struct st_maria_plugin	i_s_innodb_cmp;
 extern struct st_maria_plugin	i_s_innodb_cmp_reset;
 extern struct st_maria_plugin	i_s_innodb_cmp_per_index;
 extern struct st_maria_plugin	i_s_innodb_cmp_per_index_reset;
+#ifdef BTR_CUR_HASH_ADAPT
+extern struct st_maria_plugin	i_s_innodb_ahi_per_index;
+#endif /* BTR_CUR_HASH_ADAPT */
 extern struct st_maria_plugin	i_s_innodb_cmpmem;
 extern struct st_maria_plugin	i_s_innodb_cmpmem_reset;
 extern struct st_maria_plugin   i_s_innodb_metrics;
@@ -380,6 +380,12 @@ btr_free(
 	const page_id_t&	page_id,
 	const page_size_t&	page_size);
 
+/** Empty an index tree, freeing all pages except the root page.
+The caller must hold an exclusive lock on the table.
+@param[in,out]	index	index tree */
+void
+btr_empty_tree(dict_index_t* index);
+
 /** Read the last used AUTO_INCREMENT value from PAGE_ROOT_AUTO_INC.
 @param[in,out]	index	clustered index
 @return	the last used AUTO_INCREMENT value
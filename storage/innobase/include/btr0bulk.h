@@ -83,7 +83,6 @@ class PageBulk
 		m_flush_observer(observer),
 		m_err(DB_SUCCESS)
 	{
-		ut_ad(!dict_index_is_spatial(m_index));
 	}
 
 	/** Deconstructor */
@@ -202,6 +201,11 @@ class PageBulk
 	mem_heap_t*	m_heap;
 
 private:
+	/** Sort the records of an R-tree page. RtrBulk inserts the records
+	in STR order, but the records of a page must be in the order of
+	cmp_rec_rec(), like in a B-tree. */
+	void sortRecs();
+
 	/** The index B-tree */
 	dict_index_t*	m_index;
 
@@ -389,4 +393,198 @@ class BtrBulk
 	page_bulk_vector*	m_page_bulks;
 };
 
+/** Bulk load of an R-tree with the Sort-Tile-Recursive (STR) algorithm.
+The index entries are buffered, and when the buffer fills up they are
+sorted into ceil(sqrt(P)) vertical slices by the x coordinate of their
+MBR center, where P is the number of leaf pages that they fill, and each
+slice is sorted by the y coordinate and written to consecutive leaf
+pages. When all entries have been written, the node pointers of each
+level are packed in the same way into the level above, until the top
+level fits on the root page.
+
+The call sequence is init(), insert() and flush() when isFull(), and
+finally finish(). */
+class RtrBulk
+{
+public:
+	/** Constructor
+	@param[in]	index		spatial index
+	@param[in]	trx_id		transaction id
+	@param[in]	observer	flush observer
+	@param[in]	buf_size	size of the buffer of leaf entries,
+					in bytes */
+	RtrBulk(
+		dict_index_t*	index,
+		trx_id_t	trx_id,
+		FlushObserver*	observer,
+		ulint		buf_size)
+		:
+		m_heap(NULL),
+		m_node_heap(NULL),
+		m_index(index),
+		m_trx_id(trx_id),
+		m_flush_observer(observer),
+		m_buf_size(buf_size),
+		m_size(0),
+		m_node_size(0),
+		m_page_bulk(NULL),
+		m_last_page_no(FIL_NULL)
+	{
+		ut_ad(dict_index_is_spatial(m_index));
+		ut_ad(m_flush_observer != NULL);
+#ifdef UNIV_DEBUG
+		fil_space_inc_redo_skipped_count(m_index->space);
+#endif /* UNIV_DEBUG */
+	}
+
+	/** Destructor */
+	~RtrBulk()
+	{
+		ut_ad(m_page_bulk == NULL);
+
+		mem_heap_free(m_heap);
+		mem_heap_free(m_node_heap);
+
+#ifdef UNIV_DEBUG
+		fil_space_dec_redo_skipped_count(m_index->space);
+#endif /* UNIV_DEBUG */
+	}
+
+	/** Initialization
+	Note: must be called right after constructor. */
+	void init()
+	{
+		ut_ad(m_heap == NULL);
+		m_heap = mem_heap_create(1024);
+		m_node_heap = mem_heap_create(1024);
+	}
+
+	/** Buffer an index entry.
+	@param[in]	tuple	leaf page entry */
+	void insert(const dtuple_t* tuple)
+	{
+		m_size += add(m_entries, m_heap, tuple);
+	}
+
+	/** @return whether the buffered entries should be written by flush() */
+	bool isFull() const
+	{
+		return(m_size + m_entries.size() * sizeof(entry_t)
+		       >= m_buf_size);
+	}
+
+	/** Write the buffered entries to leaf pages in STR order.
+	Note: the caller must not hold any latches, because we may
+	call log_free_check().
+	@return error code */
+	dberr_t flush();
+
+	/** R-tree bulk load finish. We write the buffered entries, build
+	the non-leaf levels and copy the top page to the root page of the
+	index if no error occurs.
+	@param[in]	err	whether bulk load was successful until now
+	@return error code */
+	dberr_t finish(dberr_t err);
+
+private:
+	/** An entry to write to a page */
+	struct entry_t {
+		/** the record */
+		const rec_t*	rec;
+		/** x coordinate of the MBR center */
+		double		x;
+		/** y coordinate of the MBR center */
+		double		y;
+	};
+
+	typedef std::vector<entry_t, ut_allocator<entry_t> >	entry_vector;
+
+	/** Compare the x coordinates of the MBR centers of entries */
+	static bool lessX(const entry_t& a, const entry_t& b)
+	{
+		return(a.x < b.x);
+	}
+
+	/** Compare the y coordinates of the MBR centers of entries */
+	static bool lessY(const entry_t& a, const entry_t& b)
+	{
+		return(a.y < b.y);
+	}
+
+	/** Convert an entry to a record and append it to a vector.
+	@param[in,out]	entries	vector of entries
+	@param[in,out]	heap	memory heap for the record
+	@param[in]	tuple	entry; the first field is the MBR
+	@return size of the record in bytes */
+	ulint add(
+		entry_vector&	entries,
+		mem_heap_t*	heap,
+		const dtuple_t*	tuple);
+
+	/** Release the page being filled if the redo log needs a
+	checkpoint, and check for it */
+	void logFreeCheck();
+
+	/** Write entries to the pages of a level in STR order.
+	@param[in,out]	entries	entries, emptied on return
+	@param[in]	size	total size of the records in bytes
+	@param[in]	level	page level
+	@return error code */
+	dberr_t pack(entry_vector& entries, ulint size, ulint level);
+
+	/** Commit(finish) a page, and buffer the node pointer to it
+	for the level above.
+	@param[in]	page_bulk	page to commit
+	@param[in]	next_page_bulk	next page, or NULL
+	@return error code */
+	dberr_t pageCommit(PageBulk* page_bulk, PageBulk* next_page_bulk);
+
+	/** Split a page of a compressed table that failed to compress.
+	@param[in]	page_bulk	page to split
+	@param[in]	next_page_bulk	next page, or NULL
+	@return error code */
+	dberr_t pageSplit(PageBulk* page_bulk, PageBulk* next_page_bulk);
+
+	/** Copy the last written page to the root page.
+	@param[in]	level	level of the last written page
+	@return error code */
+	dberr_t copyToRoot(ulint level);
+
+	/** Memory heap for the buffered leaf entries */
+	mem_heap_t*		m_heap;
+
+	/** Memory heap for the node pointers of m_nodes */
+	mem_heap_t*		m_node_heap;
+
+	/** R-tree index */
+	dict_index_t*		m_index;
+
+	/** Transaction id */
+	trx_id_t		m_trx_id;
+
+	/** Flush observer */
+	FlushObserver*		m_flush_observer;
+
+	/** Size of the buffer of leaf entries in bytes */
+	const ulint		m_buf_size;
+
+	/** Buffered leaf entries */
+	entry_vector		m_entries;
+
+	/** Size of the records of m_entries in bytes */
+	ulint			m_size;
+
+	/** Node pointers to the pages written at the current level */
+	entry_vector		m_nodes;
+
+	/** Size of the records of m_nodes in bytes */
+	ulint			m_node_size;
+
+	/** The page being filled at the current level, or NULL */
+	PageBulk*		m_page_bulk;
+
+	/** The number of the last committed page */
+	ulint			m_last_page_no;
+};
+
 #endif
@@ -319,6 +319,16 @@ struct btr_search_t{
 				the same prefix should be indexed in the
 				hash index */
 	/*---------------------- @} */
+	/* @{ Per-index statistics, reported in
+	INFORMATION_SCHEMA.INNODB_AHI_PER_INDEX. Unlike ref_count, these
+	are not protected by the search latch: concurrent searches
+	increment them without any latch or atomic operation, so that some
+	increments may be lost and the values are approximate. */
+	ulint	n_hash_hits;	/*!< number of searches that were
+				resolved through the hash index */
+	ulint	n_hash_misses;	/*!< number of hash index lookups
+				that failed */
+	/* @} */
 #ifdef UNIV_SEARCH_PERF_STAT
 	ulint	n_hash_succ;	/*!< number of successful hash searches thus
 				far */
@@ -349,6 +359,11 @@ extern rw_lock_t**		btr_search_latches;
 /** The adaptive hash index */
 extern btr_search_sys_t*	btr_search_sys;
 
+/** Maximum number of pages of a single index that may be in the
+adaptive hash index at the same time, or 0 for no limit
+(innodb_adaptive_hash_index_max_pages) */
+extern ulong			btr_search_index_max_pages;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 extern ulint	btr_search_n_succ;
@@ -109,6 +109,17 @@ of threads can occur. */
 void
 buf_dblwr_flush_buffered_writes();
 
+/** Flush the doublewrite batch that the given buffer pool instance
+posts to for the given flush type, like buf_dblwr_flush_buffered_writes().
+With the doublewrite buffer in the system tablespace, all instances
+share one batch.
+@param[in]	buf_pool	buffer pool instance
+@param[in]	flush_type	BUF_FLUSH_LRU or BUF_FLUSH_LIST */
+void
+buf_dblwr_flush_batch(
+	const buf_pool_t*	buf_pool,
+	buf_flush_t		flush_type);
+
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -123,13 +134,16 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
+/** A doublewrite batch area. Pages posted with buf_dblwr_add_to_batch()
+are collected here, written to the doublewrite storage with one write
+and then written to their data files.
+With the doublewrite buffer in the system tablespace there is a single
+batch area. With innodb_doublewrite_file there is one for each buffer
+pool instance and flush type, so that page cleaners flushing different
+instances do not wait for each other. */
+struct buf_dblwr_batch_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
 				field and write_buf */
-	ulint		block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint		block2;	/*!< page number of the second block */
 	ulint		first_free;/*!< first free position in write_buf
 				measured in units of UNIV_PAGE_SIZE */
 	ulint		b_reserved;/*!< number of slots currently reserved
@@ -137,7 +151,28 @@ struct buf_dblwr_t{
 	os_event_t	b_event;/*!< event where threads wait for a
 				batch flush to end;
 				os_event_set() and os_event_reset()
-				are protected by buf_dblwr_t::mutex */
+				are protected by buf_dblwr_batch_t::mutex */
+	bool		batch_running;/*!< set to TRUE if currently a batch
+				is being written from the doublewrite
+				buffer. */
+	byte*		write_buf;/*!< write buffer of
+				srv_doublewrite_batch_size pages, aligned
+				to an address divisible by UNIV_PAGE_SIZE */
+	buf_page_t**	buf_block_arr;/*!< array to store pointers to
+				the buffer blocks which have been
+				cached to write_buf */
+	os_offset_t	offset;	/*!< byte offset of the batch area in
+				innodb_doublewrite_file; unused when the
+				batch is written to the system tablespace */
+};
+
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting the single page
+				flush slots */
+	ulint		block1;	/*!< the page number of the first
+				doublewrite block (64 pages) */
+	ulint		block2;	/*!< page number of the second block */
 	ulint		s_reserved;/*!< number of slots currently
 				reserved for single page flushes. */
 	os_event_t	s_event;/*!< event where threads wait for a
@@ -145,9 +180,6 @@ struct buf_dblwr_t{
 	bool*		in_use;	/*!< flag used to indicate if a slot is
 				in use. Only used for single page
 				flushes. */
-	bool		batch_running;/*!< set to TRUE if currently a batch
-				is being written from the doublewrite
-				buffer. */
 	byte*		write_buf;/*!< write buffer used in writing to the
 				doublewrite buffer, aligned to an
 				address divisible by UNIV_PAGE_SIZE
@@ -157,6 +189,20 @@ struct buf_dblwr_t{
 	buf_page_t**	buf_block_arr;/*!< array to store pointers to
 				the buffer blocks which have been
 				cached to write_buf */
+	buf_dblwr_batch_t* batches;/*!< batch areas */
+	ulint		n_batches;/*!< number of elements in batches:
+				1 if the batches are written to the
+				system tablespace, or
+				2 * srv_buf_pool_instances if they are
+				written to innodb_doublewrite_file */
+	char*		file_name;/*!< innodb_doublewrite_file path,
+				or NULL */
+	pfs_os_file_t	file;	/*!< innodb_doublewrite_file handle */
+	byte*		batch_buf_unaligned;/*!< memory for the write_buf
+				of the batches in innodb_doublewrite_file */
+	byte*		recover_buf_unaligned;/*!< pages read from
+				innodb_doublewrite_file at startup, freed
+				by buf_dblwr_process() */
 };
 
 #endif
@@ -920,6 +920,18 @@ struct dict_index_t{
 	bool		stats_error_printed;
 				/*!< has persistent statistics error printed
 				for this index ? */
+	ib_uint64_t	stat_modified_counter;
+				/*!< approximate number of records
+				inserted into or delete-marked in the
+				index since the statistics were last
+				calculated; updated by stat_modified()
+				and stat_modified_reset() only */
+	bool		stat_recalc_skipped;
+				/*!< whether the last incremental
+				recalculation of persistent statistics
+				kept the statistics of this unmodified
+				index, so that dict_stats_save() need
+				not write them again */
 	/* @} */
 	/** Statistics for defragmentation, these numbers are estimations and
 	could be very inaccurate at certain times, e.g. right after restart,
@@ -980,6 +992,27 @@ struct dict_index_t{
 	{
 		return DICT_CLUSTERED == (type & (DICT_CLUSTERED | DICT_IBUF));
 	}
+
+	/** Count records inserted into or delete-marked in the index.
+	Many threads modify an index without holding a common latch.
+	@param[in]	n	number of records */
+	void stat_modified(ib_uint64_t n = 1)
+	{
+		my_atomic_add64(reinterpret_cast<int64*>(
+					&stat_modified_counter),
+				int64(n));
+	}
+
+	/** Start counting the modifications for the next recalculation
+	of the statistics.
+	@return the number of modifications since the previous reset */
+	ib_uint64_t stat_modified_reset()
+	{
+		return ib_uint64_t(my_atomic_fas64(
+					   reinterpret_cast<int64*>(
+						   &stat_modified_counter),
+					   0));
+	}
 };
 
 /** The status of online index creation */
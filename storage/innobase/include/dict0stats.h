@@ -39,6 +39,10 @@ enum dict_stats_upd_option_t {
 				storage, if the persistent storage is
 				not present then emit a warning and
 				fall back to transient stats */
+	DICT_STATS_RECALC_INCREMENTAL,/* like DICT_STATS_RECALC_PERSISTENT,
+				but only re-sample the indexes as much as
+				they were modified since the statistics
+				were last calculated */
 	DICT_STATS_RECALC_TRANSIENT,/* (re) calculate the statistics
 				using an imprecise quick algo
 				without saving the results
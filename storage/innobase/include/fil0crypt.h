@@ -93,6 +93,7 @@ struct fil_space_rotate_state_t
 				     rotated */
 	lsn_t end_lsn;		/*!< max lsn created when rotating this
 				space */
+	ulint pages_done;	/*!< pages processed since start_time */
 	bool starting;		/*!< initial write of IV */
 	bool flushing;		/*!< space is being flushed at end of rotate */
 	struct {
@@ -214,6 +215,8 @@ struct fil_space_crypt_status_t {
 	bool flushing;           /*!< is flush at end of rotation ongoing */
 	ulint rotate_next_page_number; /*!< next page if key rotating */
 	ulint rotate_max_page_number;  /*!< max page if key rotating */
+	ulint rotate_pages_done; /*!< pages processed if key rotating */
+	ulint rotate_pages_per_second; /*!< throughput if key rotating */
 };
 
 /** Statistics about encryption key rotation */
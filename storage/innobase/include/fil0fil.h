@@ -77,6 +77,9 @@ fil_type_is_data(
 
 struct fil_node_t;
 
+/** zstd dictionary of a tablespace, see fil0pagecompress.cc */
+struct fil_zstd_dict_t;
+
 /** Tablespace or log data space */
 struct fil_space_t {
 	char*		name;	/*!< Tablespace name */
@@ -181,6 +184,28 @@ struct fil_space_t {
 	/** True if we have already printed compression failure */
 	bool		printed_compression_failure;
 
+	/** zstd dictionary for page_compressed pages, or NULL.
+	Set by fil_space_zstd_dict_publish() when the first file is
+	opened or a dictionary has been trained, and freed by
+	fil_space_free_low() */
+	fil_zstd_dict_t* zstd_dict;
+
+	/** zstd dictionaries of earlier incarnations of the tablespace
+	(before TRUNCATE TABLE); protected by the X-latch on page 0 */
+	fil_zstd_dict_t* zstd_retired;
+
+	/** other tablespaces waiting for a zstd dictionary */
+	UT_LIST_NODE_T(fil_space_t) zstd_list;
+
+	/** whether the tablespace is in fil_system->zstd_list;
+	protected by fil_system->mutex */
+	bool		is_in_zstd_list;
+
+	/** whether a zstd dictionary has been requested for the
+	tablespace since it was created or truncated; protected by
+	fil_system->mutex */
+	bool		zstd_requested;
+
 	/** True if the device this filespace is on supports atomic writes */
 	bool		atomic_write_supported;
 
@@ -516,6 +541,10 @@ struct fil_system_t {
 	UT_LIST_BASE_NODE_T(fil_space_t) rotation_list;
 					/*!< list of all file spaces needing
 					key rotation.*/
+	UT_LIST_BASE_NODE_T(fil_space_t) zstd_list;
+					/*!< list of page_compressed file
+					spaces waiting for a zstd dictionary
+					to be loaded or trained */
 
 	ibool		space_id_reuse_warned;
 					/* !< TRUE if fil_space_create()
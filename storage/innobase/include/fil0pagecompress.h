@@ -62,8 +62,55 @@ fil_decompress_page(
 	ulong	len,		/*!< in: length of output buffer.*/
 	ulint*	write_size,	/*!< in/out: Actual payload size of
 				the compressed data. */
-	bool	return_error=false);
+	bool	return_error=false,
 				/*!< in: true if only an error should
 				be produced when decompression fails.
 				By default this parameter is false. */
+	const fil_zstd_dict_t*	zstd_dict=NULL);
+				/*!< in: zstd dictionary of a tablespace
+				that is not in fil_system (IMPORT), or
+				NULL to use the one of the tablespace */
+
+/** Create the per-thread zstd contexts. Invoked by fil_init(). */
+void
+fil_zstd_init();
+
+/** Free the key of the per-thread zstd contexts. Invoked by fil_close(). */
+void
+fil_zstd_close();
+
+/** Read the zstd dictionary of a tablespace that is not in fil_system.
+@param[in]	flags	tablespace flags
+@param[in]	page	first page of the tablespace
+@return the dictionary (to be freed by fil_zstd_dict_free()), or NULL */
+fil_zstd_dict_t*
+fil_zstd_dict_read(ulint flags, const byte* page);
+
+/** Free a zstd dictionary.
+@param[in,out]	dict	dictionary, or NULL */
+void
+fil_zstd_dict_free(fil_zstd_dict_t* dict);
+
+/** Load the zstd dictionary of a tablespace from the first page,
+when the first file of the tablespace is being opened.
+@param[in,out]	space	tablespace
+@param[in]	page	first page of the tablespace */
+void
+fil_space_read_zstd_dict(fil_space_t* space, const byte* page);
+
+/** Load or train the zstd dictionary of the next tablespace in
+fil_system->zstd_list. Invoked by the master thread. */
+void
+fil_zstd_dict_process();
+
+/** Forget the zstd dictionary of a tablespace whose first page is
+being initialized by fsp_header_init().
+@param[in,out]	space	tablespace */
+void
+fil_space_reset_zstd_dict(fil_space_t* space);
+
+/** Free the zstd dictionaries of a tablespace.
+@param[in,out]	space	tablespace that is being freed */
+void
+fil_space_free_zstd_dict(fil_space_t* space);
 #endif
@@ -36,7 +36,24 @@ Created 11/12/2013 Jan Lindström jan.lindstrom@skysql.com
 #define PAGE_LZMA_ALGORITHM	4
 #define PAGE_BZIP2_ALGORITHM	5
 #define PAGE_SNAPPY_ALGORITHM	6
-#define PAGE_ALGORITHM_LAST	PAGE_SNAPPY_ALGORITHM
+#define PAGE_ZSTD_ALGORITHM	7
+#define PAGE_ALGORITHM_LAST	PAGE_ZSTD_ALGORITHM
+
+/** @name zstd dictionary of a page_compressed tablespace
+The dictionary is stored in the first page of the tablespace, between
+the encryption information and the page trailer. Its offset is
+FSP_HEADER_OFFSET + fsp_header_get_encryption_offset() + FSP_ZSTD_DICT.
+@{ */
+#define FSP_ZSTD_DICT		64	/*!< offset of the dictionary from
+					the encryption information, which
+					takes at most 33 bytes */
+#define FSP_ZSTD_DICT_MAGIC	0	/*!< FSP_ZSTD_DICT_MAGIC_N if the
+					dictionary exists (4 bytes) */
+#define FSP_ZSTD_DICT_LEN	4	/*!< length of the dictionary in
+					bytes (2 bytes) */
+#define FSP_ZSTD_DICT_DATA	6	/*!< the dictionary */
+#define FSP_ZSTD_DICT_MAGIC_N	0x5A444943	/*!< "ZDIC" */
+/* @} */
 
 /**********************************************************************//**
 Reads the page compression level from the first page of a tablespace.
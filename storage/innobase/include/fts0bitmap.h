@@ -0,0 +1,174 @@
+/*****************************************************************************
+
+Copyright (c) 2017, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/******************************************************************//**
+@file include/fts0bitmap.h
+Compressed doc id sets for full text search
+*******************************************************/
+
+#ifndef INNOBASE_FTS0BITMAP_H
+#define INNOBASE_FTS0BITMAP_H
+
+#include "univ.i"
+#include "fts0fts.h"
+#include "ut0new.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/** A set of document ids. An id is split into its high 48 bits, which
+select a container, and its low 16 bits, which are kept in the container:
+as a sorted array while the container holds at most
+FTS_BITMAP_ARRAY_MAX ids, and as a 8KiB bitmap otherwise. Dense and sparse
+ranges of doc ids both take little memory, and two sets are intersected
+container by container. */
+class fts_doc_bitmap_t {
+public:
+	/** Add a doc id. Ids are best added in ascending order.
+	@param[in]	doc_id	doc id to add */
+	void add(doc_id_t doc_id);
+
+	/** @return whether the set contains doc_id
+	@param[in]	doc_id	doc id to look up */
+	bool contains(doc_id_t doc_id) const;
+
+	/** Keep only the doc ids that are also in another set.
+	@param[in]	other	set to intersect with */
+	void intersect(const fts_doc_bitmap_t& other);
+
+	/** Add all doc ids of another set.
+	@param[in]	other	set to merge */
+	void merge(const fts_doc_bitmap_t& other);
+
+	/** @return number of doc ids in the set */
+	ulint size() const;
+
+	/** @return whether the set is empty */
+	bool empty() const { return(m_containers.empty()); }
+
+	/** @return number of bytes used by the set */
+	ulint mem_size() const;
+
+	/** Remove all doc ids. */
+	void clear() { m_containers.clear(); }
+
+	/** Largest number of doc ids in an array container */
+	static const ulint	FTS_BITMAP_ARRAY_MAX = 4096;
+
+	/** Number of 64-bit words in a bitmap container */
+	static const ulint	FTS_BITMAP_WORDS = 1024;
+
+private:
+	typedef std::vector<uint16_t, ut_allocator<uint16_t> >	array_t;
+	typedef std::vector<ib_uint64_t, ut_allocator<ib_uint64_t> > bits_t;
+
+	/** The doc ids that share their high 48 bits */
+	struct container_t {
+		/** high 48 bits of the doc ids */
+		ib_uint64_t	key;
+		/** number of doc ids in the container */
+		ulint		card;
+		/** sorted low 16 bits, if bits is empty */
+		array_t		array;
+		/** bitmap of the low 16 bits, or empty */
+		bits_t		bits;
+
+		/** @return whether the container has the low bits */
+		bool contains(uint16_t low) const;
+
+		/** Add low bits to the container. */
+		void add(uint16_t low);
+
+		/** Convert an array container to a bitmap. */
+		void to_bits();
+
+		/** Convert a bitmap container to an array if it is small. */
+		void shrink();
+	};
+
+	typedef std::vector<container_t, ut_allocator<container_t> >
+		containers_t;
+
+	/** Find the container of a key.
+	@param[in]	key	high 48 bits of a doc id
+	@return the container, or NULL */
+	const container_t* find(ib_uint64_t key) const;
+
+	/** containers in ascending order of key */
+	containers_t	m_containers;
+};
+
+/** Doc id sets of frequent words in the FTS INDEX tables, kept across
+queries. The sets only cover the FTS INDEX tables and not the index cache,
+and they are invalidated whenever a SYNC moves the index cache to the FTS
+INDEX tables. Protected by fts_cache_t::lock. */
+class fts_bitmap_cache_t {
+public:
+	fts_bitmap_cache_t() : m_version(0), m_size(0) {}
+
+	~fts_bitmap_cache_t() { invalidate(); }
+
+	/** Look up the doc id set of a word.
+	@param[in]	index_id	FTS index
+	@param[in]	word		word
+	@return the doc id set, or NULL */
+	const fts_doc_bitmap_t* find(
+		index_id_t		index_id,
+		const fts_string_t*	word) const;
+
+	/** Remember the doc id set of a word, if it is worth caching.
+	@param[in]	index_id	FTS index
+	@param[in]	word		word
+	@param[in]	version		version() before the set was read
+	@param[in]	docs		doc id set of the word */
+	void insert(
+		index_id_t		index_id,
+		const fts_string_t*	word,
+		ulint			version,
+		const fts_doc_bitmap_t&	docs);
+
+	/** @return the version, to be passed to insert() */
+	ulint version() const { return(m_version); }
+
+	/** Discard all doc id sets. */
+	void invalidate();
+
+	/** Smallest number of doc ids in a set worth caching */
+	static const ulint	FTS_BITMAP_CACHE_MIN_DOCS = 1024;
+
+	/** Largest number of bytes to cache per table */
+	static const ulint	FTS_BITMAP_CACHE_MAX_SIZE = 4 << 20;
+
+private:
+	typedef std::pair<index_id_t, std::string>	key_t;
+
+	typedef std::map<key_t, fts_doc_bitmap_t*, std::less<key_t>,
+			 ut_allocator<std::pair<const key_t,
+						fts_doc_bitmap_t*> > >
+		map_t;
+
+	/** incremented by invalidate() */
+	ulint		m_version;
+	/** bytes used by the cached sets */
+	ulint		m_size;
+	/** cached sets */
+	map_t		m_map;
+};
+
+#endif /* INNOBASE_FTS0BITMAP_H */
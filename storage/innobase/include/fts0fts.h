@@ -564,6 +564,8 @@ fts_commit(
 @param[in]	flags		FTS search mode
 @param[in]	query_str	FTS query
 @param[in]	query_len	FTS query string len in bytes
+@param[in]	limit		number of documents, in descending order of
+rank, that the caller will read, or ULINT_UNDEFINED for all
 @param[in,out]	result		result doc ids
 @return DB_SUCCESS if successful otherwise error code */
 dberr_t
@@ -573,6 +575,7 @@ fts_query(
 	uint		flags,
 	const byte*	query_str,
 	ulint		query_len,
+	ulint		limit,
 	fts_result_t**	result)
 	MY_ATTRIBUTE((warn_unused_result));
 
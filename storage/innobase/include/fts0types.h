@@ -38,6 +38,7 @@ Created 2007-03-27 Sunny Bains
 /** Types used within FTS. */
 struct fts_que_t;
 struct fts_node_t;
+class fts_bitmap_cache_t;
 
 /** Callbacks used within FTS. */
 typedef pars_user_func_cb_t fts_sql_callback;
@@ -196,6 +197,11 @@ struct fts_cache_t {
 
 	fts_stopword_t	stopword_info;	/*!< Cached stopwords for the FTS */
 	mem_heap_t*	cache_heap;	/*!< Cache Heap */
+
+	fts_bitmap_cache_t*
+			bitmaps;	/*!< Doc id sets of frequent words
+					in the FTS INDEX tables, for
+					boolean mode queries */
 };
 
 /** Columns of the FTS auxiliary INDEX table */
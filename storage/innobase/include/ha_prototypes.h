@@ -593,6 +593,14 @@ innobase_index_cond(
 	void*	file)	/*!< in/out: pointer to ha_innobase */
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Account for a record that was rejected by row_icp_filter_t
+without evaluating the pushed index condition.
+@param[in,out]	file	pointer to ha_innobase
+@return ICP_NO_MATCH, or ICP_ABORTED_BY_USER */
+ICP_RESULT
+innobase_index_cond_skip(void* file)
+	MY_ATTRIBUTE((warn_unused_result));
+
 /******************************************************************//**
 Gets information on the durability property requested by thread.
 Used when writing either a prepare or commit record to the log
@@ -468,7 +468,11 @@ struct TTASEventMutex {
 					     MUTEX_STATE_UNLOCKED,
 					     MY_MEMORY_ORDER_RELEASE)
 		    == MUTEX_STATE_WAITERS) {
+#ifdef HAVE_IB_LINUX_FUTEX
+			sync_futex_wake(&m_lock_word, 1);
+#else
 			os_event_set(m_event);
+#endif /* HAVE_IB_LINUX_FUTEX */
 			sync_array_object_signalled();
 		}
 	}
@@ -495,13 +499,13 @@ struct TTASEventMutex {
 				n_waits++;
 				os_thread_yield();
 
+#ifdef HAVE_IB_LINUX_FUTEX
+				wait(filename, line);
+				break;
+#else
 				sync_cell_t*	cell;
 				sync_array_t *sync_arr = sync_array_get_and_reserve_cell(
-					this,
-					(m_policy.get_id() == LATCH_ID_BUF_BLOCK_MUTEX
-					 || m_policy.get_id() == LATCH_ID_BUF_POOL_ZIP)
-					? SYNC_BUF_BLOCK
-					: SYNC_MUTEX,
+					this, sync_array_type(),
 					filename, line, &cell);
 
 				int32 oldval = MUTEX_STATE_LOCKED;
@@ -515,6 +519,7 @@ struct TTASEventMutex {
 				} else {
 					sync_array_wait_event(sync_arr, cell);
 				}
+#endif /* HAVE_IB_LINUX_FUTEX */
 			} else {
 				ut_delay(ut_rnd_interval(0, max_delay));
 			}
@@ -553,6 +558,36 @@ struct TTASEventMutex {
 	}
 
 private:
+	/** @return the lock request type for the sync array */
+	ulint sync_array_type() const
+		UNIV_NOTHROW
+	{
+		return(m_policy.get_id() == LATCH_ID_BUF_BLOCK_MUTEX
+		       || m_policy.get_id() == LATCH_ID_BUF_POOL_ZIP
+		       ? SYNC_BUF_BLOCK : SYNC_MUTEX);
+	}
+
+#ifdef HAVE_IB_LINUX_FUTEX
+	/** Sleep on the lock word until the mutex is acquired. The lock
+	word is left at MUTEX_STATE_WAITERS, so that exit() will wake up
+	the next waiter, if any.
+	@param[in]	filename	from where called
+	@param[in]	line		within filename */
+	void wait(const char* filename, uint32_t line)
+		UNIV_NOTHROW
+	{
+		sync_futex_waiter_t	waiter(
+			this, sync_array_type(), filename, line);
+
+		while (my_atomic_fas32_explicit(&m_lock_word,
+						MUTEX_STATE_WAITERS,
+						MY_MEMORY_ORDER_ACQUIRE)
+		       != MUTEX_STATE_UNLOCKED) {
+			waiter.wait(&m_lock_word, MUTEX_STATE_WAITERS);
+		}
+	}
+#endif /* HAVE_IB_LINUX_FUTEX */
+
 	/** Disable copying */
 	TTASEventMutex(const TTASEventMutex&);
 	TTASEventMutex& operator=(const TTASEventMutex&);
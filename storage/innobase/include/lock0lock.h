@@ -472,12 +472,23 @@ lock_table(
 	que_thr_t*	thr)	/*!< in: query thread */
 	MY_ATTRIBUTE((warn_unused_result));
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table IX or X lock object for a resurrected transaction. */
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx);	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	lock_mode	mode);	/*!< in: LOCK_IX or LOCK_X */
+
+/** Check if a transaction holds an exclusive lock on a table.
+@param[in]	trx	transaction
+@param[in]	table	table
+@return whether trx holds LOCK_X on table */
+bool
+lock_table_has_x(
+	const trx_t*		trx,
+	const dict_table_t*	table)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
 
 /** Sets a lock on a table based on the given mode.
 @param[in]	table	table to lock
@@ -1484,6 +1484,10 @@ be other, synchronous, pending writes. */
 void
 os_aio_wait_until_no_pending_writes();
 
+/** @return the name of the asynchronous I/O implementation in use */
+const char*
+os_aio_backend_name();
+
 /** Wakes up simulated aio i/o-handler threads if they have something to do. */
 void
 os_aio_simulated_wake_handler_threads();
@@ -488,4 +488,113 @@ row_merge_read_rec(
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space)	   /*!< in: space id */
 	MY_ATTRIBUTE((warn_unused_result));
+
+class RtrBulk;
+
+/** Rows of a bulk insert into an empty table. The rows are buffered
+and sorted per index, spilled to temporary files when a buffer fills up,
+and finally loaded into each index with BtrBulk, like in
+row_merge_build_indexes(). Spatial index entries are loaded with RtrBulk
+instead. The caller must hold LOCK_X on the table and must have written
+a TRX_UNDO_EMPTY undo log record, whose roll pointer is stored in every
+clustered index record. */
+class row_merge_bulk_t {
+public:
+	/** Constructor.
+	@param[in,out]	table		table to insert into
+	@param[in,out]	mysql_table	MySQL table handle, for reporting
+					duplicate keys
+	@param[in]	roll_ptr	roll pointer of the TRX_UNDO_EMPTY
+					undo log record */
+	row_merge_bulk_t(
+		dict_table_t*	table,
+		struct TABLE*	mysql_table,
+		roll_ptr_t	roll_ptr);
+
+	/** Destructor. Discards any rows that were not loaded. */
+	~row_merge_bulk_t();
+
+	/** Check if all indexes of a table are empty.
+	@param[in,out]	table	table
+	@param[in]	reset	whether to reinitialize root pages that
+				contain garbage of purged records;
+				the caller must hold LOCK_X on the table
+	@return whether the table is empty */
+	static bool is_empty(dict_table_t* table, bool reset);
+
+	/** Check if a row can be buffered. Rows that need off-page
+	columns must be inserted normally, after finish().
+	@param[in]	row	table row
+	@return whether the clustered index record fits on a page */
+	bool fits(const dtuple_t* row);
+
+	/** Buffer a row. DB_TRX_ID, DB_ROLL_PTR and DB_ROW_ID are written
+	to the row, which must point to ins_node_t::sys_buf.
+	@param[in,out]	row	table row
+	@param[in,out]	trx	transaction
+	@return error code */
+	dberr_t add(dtuple_t* row, trx_t* trx);
+
+	/** Load the buffered rows into the indexes.
+	@param[in,out]	trx	transaction
+	@return error code */
+	dberr_t finish(trx_t* trx);
+
+private:
+	/** Sort the buffer of an index and write it to the temporary file.
+	@param[in]	i	index number
+	@param[in,out]	index	index
+	@param[in,out]	trx	transaction
+	@return error code */
+	dberr_t write_buffer(ulint i, dict_index_t* index, trx_t* trx);
+
+	/** Buffer the entry of a spatial index, and write the buffered
+	entries to leaf pages when the buffer is full.
+	@param[in]	i	index number
+	@param[in,out]	index	spatial index
+	@param[in]	row	table row
+	@param[in,out]	trx	transaction
+	@return error code */
+	dberr_t add_spatial(
+		ulint		i,
+		dict_index_t*	index,
+		const dtuple_t*	row,
+		trx_t*		trx);
+
+	/** Abort the loads of spatial indexes that were not finished.
+	@param[in]	err	error code */
+	void abort_spatial(dberr_t err);
+
+	/** table being loaded */
+	dict_table_t*		m_table;
+	/** MySQL table handle */
+	struct TABLE*		m_mysql_table;
+	/** roll pointer of the TRX_UNDO_EMPTY record */
+	roll_ptr_t		m_roll_ptr;
+	/** number of indexes */
+	ulint			m_n_index;
+	/** sort buffer of each index, or NULL for spatial indexes */
+	row_merge_buf_t**	m_buf;
+	/** R-tree bulk load of each spatial index, or NULL */
+	RtrBulk**		m_rtr_bulk;
+	/** flush observer of the pages written by the bulk loads,
+	or NULL if none were written yet */
+	FlushObserver*		m_observer;
+	/** temporary file of each index */
+	merge_file_t*		m_file;
+	/** temporary file for row_merge_sort() */
+	int			m_tmpfd;
+	/** 3 buffers for temporary file I/O, or NULL if not allocated */
+	row_merge_block_t*	m_block;
+	/** buffer for encrypting the temporary files, or NULL */
+	row_merge_block_t*	m_crypt_block;
+	/** memory allocation of m_block */
+	ut_new_pfx_t		m_block_pfx;
+	/** memory allocation of m_crypt_block */
+	ut_new_pfx_t		m_crypt_pfx;
+	/** memory heap for fits() */
+	mem_heap_t*		m_heap;
+	/** largest AUTO_INCREMENT value that was buffered */
+	ib_uint64_t		m_autoinc;
+};
 #endif /* row0merge.h */
@@ -38,9 +38,13 @@ Created 9/17/2000 Heikki Tuuri
 #include "btr0pcur.h"
 #include "trx0types.h"
 #include "fil0crypt.h"
+#include "ut0new.h"
+
+#include <vector>
 
 // Forward declaration
 struct SysIndexCallback;
+class row_merge_bulk_t;
 
 extern ibool row_rollback_on_timeout;
 
@@ -235,6 +239,15 @@ row_insert_for_mysql(
 	row_prebuilt_t*		prebuilt)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Finish a bulk insert into an empty table that was started by
+row_insert_for_mysql() after ha_innobase::start_bulk_insert().
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in]	discard		whether to discard the buffered rows
+				because the statement failed
+@return error code or DB_SUCCESS */
+dberr_t
+row_bulk_insert_end(row_prebuilt_t* prebuilt, bool discard);
+
 /*********************************************************************//**
 Builds a dummy query graph used in selects. */
 void
@@ -590,7 +603,59 @@ struct mysql_row_templ_t {
 	ulint	is_virtual;		/*!< if a column is a virtual column */
 };
 
+/** A condition on an integer or DATE column of prebuilt->index that is
+compiled from the pushed index condition by ha_innobase::build_template().
+The column values and the bounds are compared as row_icp_filter_t::key(). */
+struct row_icp_term_t {
+	/** field number of the column in prebuilt->index */
+	ulint		rec_field_no;
+	/** whether the column is an unsigned integer (DATA_UNSIGNED) */
+	bool		is_unsigned;
+	/** smallest matching key; low > high if nothing matches */
+	ib_uint64_t	low;
+	/** largest matching key */
+	ib_uint64_t	high;
+	/** sorted keys of an IN list, or empty if low..high is a range */
+	std::vector<ib_uint64_t, ut_allocator<ib_uint64_t> >	in;
+};
+
+/** The compiled conjuncts of the pushed index condition. A record that
+does not satisfy them does not satisfy the whole condition, and it is
+rejected in row_search_idx_cond_check() without converting it to the
+MySQL format or calling back to the SQL layer. */
+struct row_icp_filter_t {
+	typedef std::vector<row_icp_term_t, ut_allocator<row_icp_term_t> >
+		terms_t;
+
+	/** the conditions, all of which must hold */
+	terms_t		terms;
+	/** number of records rejected since the full index condition
+	was last evaluated */
+	ulint		n_skipped;
+
+	/** Map a column value to a key whose unsigned order is the order
+	of the values.
+	@param[in]	val		value from mach_read_int_type()
+	@param[in]	is_unsigned	whether the column is unsigned
+	@return the key */
+	static ib_uint64_t key(ib_uint64_t val, bool is_unsigned)
+	{
+		return(is_unsigned ? val : val ^ (ib_uint64_t(1) << 63));
+	}
+};
+
+/** The full index condition is evaluated for every this many records that
+row_icp_filter_t rejected, so that the end of the range and KILL QUERY
+are noticed. */
+#define ROW_ICP_FILTER_CHECK_INTERVAL	256
+
+/* Number of rows cached in fetch_cache in the first batch after the
+cursor was positioned; the batch size doubles with every further batch,
+up to innodb_fetch_cache_max_rows */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* The batch does not grow beyond this many bytes of cached rows,
+whatever innodb_fetch_cache_max_rows is */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(1024 * 1024)
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -658,6 +723,14 @@ struct row_prebuilt_t {
 					not to be confused with InnoDB
 					externally stored columns
 					(VARCHAR can be off-page too) */
+	unsigned	bulk_insert_requested:1;/*!< set by
+					ha_innobase::start_bulk_insert()
+					until the first row is inserted */
+	unsigned	bulk_insert_lock:1;/*!< whether the bulk insert
+					may lock the table exclusively
+					(innodb_bulk_insert_lock_table) */
+	unsigned	ignore_dup_key:1;/*!< TRUE while
+					HA_EXTRA_IGNORE_DUP_KEY is in effect */
 	mysql_row_templ_t* mysql_template;/*!< template used to transform
 					rows fast between MySQL and Innobase
 					formats; memory for this template
@@ -689,6 +762,8 @@ struct row_prebuilt_t {
 	que_fork_t*	ins_graph;	/*!< Innobase SQL query graph used
 					in inserts. Will be rebuilt on
 					trx_id or n_indexes mismatch. */
+	row_merge_bulk_t* bulk_insert;	/*!< rows of a bulk insert into
+					an empty table, or NULL */
 	que_fork_t*	upd_graph;	/*!< Innobase SQL query graph used
 					in updates or deletes */
 	btr_pcur_t*	pcur;		/*!< persistent cursor used in selects
@@ -763,7 +838,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte**		fetch_cache;
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
@@ -772,7 +847,15 @@ struct row_prebuilt_t {
 					pointers point 4 bytes past the
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
-					start and at the end */
+					start and at the end; NULL if not
+					allocated yet */
+	ulint		fetch_cache_size;/*!< number of rows allocated
+					in fetch_cache */
+	ulint		fetch_cache_limit;/*!< number of rows to cache in
+					the current batch; starts at
+					MYSQL_FETCH_CACHE_SIZE when the cursor
+					is positioned and grows while the
+					scan continues */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -810,6 +893,8 @@ struct row_prebuilt_t {
 					not used. */
 	ulint		idx_cond_n_cols;/*!< Number of fields in idx_cond_cols.
 					0 if and only if idx_cond == NULL. */
+	row_icp_filter_t* icp_filter;	/*!< compiled part of idx_cond
+					for non-locking reads, or NULL */
 	/*----------------------*/
 
 	/*----------------------*/
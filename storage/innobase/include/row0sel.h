@@ -53,6 +53,12 @@ void
 sel_node_free_private(
 /*==================*/
 	sel_node_t*	node);	/*!< in: select node struct */
+/** Free the fetch cache of a prebuilt struct, after checking the magic
+numbers around the cached rows.
+@param[in,out]	prebuilt	prebuilt struct */
+void
+row_sel_prefetch_cache_free(
+	row_prebuilt_t*	prebuilt);
 /*********************************************************************//**
 Frees a prefetch buffer for a column, including the dynamically allocated
 memory for data stored there. */
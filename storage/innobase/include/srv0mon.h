@@ -314,6 +314,9 @@ enum monitor_id_t {
 	MONITOR_PURGE_INVOKED,
 	MONITOR_PURGE_N_PAGE_HANDLED,
 	MONITOR_DML_PURGE_DELAY,
+	MONITOR_PURGE_N_TABLES_BATCHED,
+	MONITOR_PURGE_N_NODES_USED,
+	MONITOR_PURGE_N_THREADS,
 	MONITOR_PURGE_STOP_COUNT,
 	MONITOR_PURGE_RESUME_COUNT,
 
@@ -125,6 +125,10 @@ struct srv_stats_t
         ulint_ctr_64_t          pages_page_decompressed;
 	/* Number of page compression errors */
 	ulint_ctr_64_t          pages_page_compression_error;
+	/* Number of pages compressed with a zstd dictionary */
+	ulint_ctr_64_t		pages_zstd_dict_compressed;
+	/* Number of pages decompressed with a zstd dictionary */
+	ulint_ctr_64_t		pages_zstd_dict_decompressed;
 	/* Number of pages encrypted */
 	ulint_ctr_64_t          pages_encrypted;
    	/* Number of pages decrypted */
@@ -141,6 +145,24 @@ struct srv_stats_t
 	/** Number of data read in total (in bytes) */
 	ulint_ctr_1_t		data_read;
 
+	/** Number of requests passed to native asynchronous I/O */
+	ulint_ctr_64_t		aio_requests;
+
+	/** Number of io_submit() or io_uring_enter() calls */
+	ulint_ctr_64_t		aio_submit_calls;
+
+	/** Number of full-text searches that ranked only the top
+	documents */
+	ulint_ctr_64_t		n_fts_top_k_queries;
+
+	/** Number of top-k full-text searches that had to be repeated
+	without the limit */
+	ulint_ctr_64_t		n_fts_top_k_requeries;
+
+	/** Number of records that the compiled part of a pushed index
+	condition rejected without calling back to the SQL layer */
+	ulint_ctr_64_t		n_icp_filter_rejected;
+
 	/** Wait time of database locks */
 	int64_ctr_1_t		n_lock_wait_time;
 
@@ -162,6 +184,13 @@ struct srv_stats_t
 	/** Number of rows inserted */
 	ulint_ctr_64_t		n_rows_inserted;
 
+	/** Number of rows loaded by bulk inserts into empty tables */
+	ulint_ctr_64_t		n_bulk_insert_rows;
+
+	/** Number of sort buffers of bulk inserts written to
+	temporary files */
+	ulint_ctr_64_t		n_bulk_insert_spills;
+
 	/** Number of system rows read. */
 	ulint_ctr_64_t		n_system_rows_read;
 
@@ -222,6 +251,9 @@ and/or load it during startup. */
 extern char		srv_buffer_pool_dump_at_shutdown;
 extern char		srv_buffer_pool_load_at_startup;
 
+/** Number of threads that read pages during a buffer pool load */
+extern ulong		srv_buf_load_threads;
+
 /* Whether to disable file system cache if it is defined */
 extern char		srv_disable_sort_file_cache;
 
@@ -281,6 +313,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/** innodb_use_io_uring; whether native AIO on Linux uses io_uring
+instead of libaio */
+extern my_bool	srv_use_io_uring;
 extern my_bool	srv_numa_interleave;
 
 /* Use trim operation */
@@ -292,6 +327,10 @@ extern my_bool srv_use_atomic_writes;
 /* Compression algorithm*/
 extern ulong innodb_compression_algorithm;
 
+/** innodb_compression_zstd_dictionary; whether zstd page compression
+trains a dictionary for each tablespace */
+extern my_bool srv_zstd_dictionary;
+
 /* Number of flush threads */
 #define MTFLUSH_MAX_WORKER		64
 #define MTFLUSH_DEFAULT_WORKER		8
@@ -417,6 +456,8 @@ extern ulint	srv_lock_table_size;
 extern ulint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+/** innodb_fetch_cache_max_rows */
+extern ulong	srv_fetch_cache_max_rows;
 extern ulint	srv_n_read_io_threads;
 extern ulint	srv_n_write_io_threads;
 
@@ -484,12 +525,16 @@ extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
+extern my_bool			srv_stats_incremental_recalc;
 extern my_bool			srv_stats_include_delete_marked;
 extern unsigned long long	srv_stats_modified_counter;
 extern my_bool			srv_stats_sample_traditional;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+/** Dedicated file for the doublewrite batches of each buffer pool
+instance, or NULL to use the doublewrite buffer in the system tablespace */
+extern char*	srv_doublewrite_file;
 extern ulong	srv_checksum_algorithm;
 
 extern double	srv_max_buf_pool_modified_pct;
@@ -986,6 +1031,12 @@ struct export_var_t{
 	ulint innodb_dblwr_pages_written;	/*!< srv_dblwr_pages_written */
 	ulint innodb_dblwr_writes;		/*!< srv_dblwr_writes */
 	ibool innodb_have_atomic_builtins;	/*!< HAVE_ATOMIC_BUILTINS */
+	const char* innodb_aio_backend;		/*!< os_aio_backend_name() */
+	ulint innodb_aio_requests;		/*!< srv_stats.aio_requests */
+	ulint innodb_aio_submit_calls;		/*!< srv_stats.aio_submit_calls */
+	ulint innodb_fts_top_k_queries;		/*!< srv_stats.n_fts_top_k_queries */
+	ulint innodb_fts_top_k_requeries;	/*!< srv_stats.n_fts_top_k_requeries */
+	ulint innodb_icp_filter_rejected;	/*!< srv_stats.n_icp_filter_rejected */
 	ulint innodb_log_waits;			/*!< srv_log_waits */
 	ulint innodb_log_write_requests;	/*!< srv_log_write_requests */
 	ulint innodb_log_writes;		/*!< srv_log_writes */
@@ -1009,6 +1060,8 @@ struct export_var_t{
 						/ 1000 */
 	ulint innodb_rows_read;			/*!< srv_n_rows_read */
 	ulint innodb_rows_inserted;		/*!< srv_n_rows_inserted */
+	ulint innodb_bulk_insert_rows;		/*!< srv_stats.n_bulk_insert_rows */
+	ulint innodb_bulk_insert_spills;	/*!< srv_stats.n_bulk_insert_spills */
 	ulint innodb_rows_updated;		/*!< srv_n_rows_updated */
 	ulint innodb_rows_deleted;		/*!< srv_n_rows_deleted */
 	ulint innodb_system_rows_read; /*!< srv_n_system_rows_read */
@@ -1057,6 +1110,12 @@ struct export_var_t{
 						compression */
 	int64_t innodb_pages_page_compression_error;/*!< Number of page
 						compression errors */
+	int64_t innodb_pages_zstd_dict_compressed;/*!< Number of pages
+						compressed with a zstd
+						dictionary */
+	int64_t innodb_pages_zstd_dict_decompressed;/*!< Number of pages
+						decompressed with a zstd
+						dictionary */
 	int64_t innodb_pages_encrypted;      /*!< Number of pages
 						encrypted */
 	int64_t innodb_pages_decrypted;      /*!< Number of pages
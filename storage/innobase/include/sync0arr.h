@@ -30,6 +30,12 @@ Created 9/5/1995 Heikki Tuuri
 #include "univ.i"
 #include "os0thread.h"
 
+#ifdef HAVE_IB_LINUX_FUTEX
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif /* HAVE_IB_LINUX_FUTEX */
+
 /** Synchronization wait array cell */
 struct sync_cell_t;
 
@@ -72,6 +78,15 @@ sync_array_wait_event(
 	sync_array_t*	arr,	/*!< in: wait array */
 	sync_cell_t*&	cell);	/*!< in: the reserved cell */
 
+/** Mark a reserved cell as waiting, without waiting for its event.
+In the debug version, checks if the wait will result in a deadlock.
+@param[in,out]	arr	wait array
+@param[in,out]	cell	the reserved cell */
+void
+sync_array_wait_begin(
+	sync_array_t*	arr,
+	sync_cell_t*	cell);
+
 /******************************************************************//**
 Frees the cell. NOTE! sync_array_wait_event frees the cell
 automatically! */
@@ -131,6 +146,80 @@ sync_array_get_nth_cell(
 	sync_array_t*	arr,	/*!< in: sync array */
 	ulint		n);	/*!< in: index */
 
+#ifdef HAVE_IB_LINUX_FUTEX
+/** Number of seconds that a thread sleeps on a futex before the wait
+is registered in the sync array */
+#define SYNC_FUTEX_REGISTER_WAIT	1
+
+/** A thread that sleeps directly on the word of a mutex or rw-lock.
+Unlike sync_array_wait_event(), the sync array mutex is not acquired for
+every wait. Only a wait that lasts longer than SYNC_FUTEX_REGISTER_WAIT
+seconds reserves a sync array cell, so that the long semaphore wait
+diagnostics and INFORMATION_SCHEMA.INNODB_SYS_SEMAPHORE_WAITS see it.
+In debug builds every sleep reserves a cell and is checked for a
+deadlock, as in sync_array_wait_event(). */
+class sync_futex_waiter_t {
+public:
+	/** Constructor
+	@param[in]	object	the mutex or rw-lock to wait for
+	@param[in]	type	lock request type
+	@param[in]	file	file where requested
+	@param[in]	line	line where requested */
+	sync_futex_waiter_t(
+		void*		object,
+		ulint		type,
+		const char*	file,
+		unsigned	line)
+		:
+		m_object(object),
+		m_type(type),
+		m_file(file),
+		m_line(line),
+		m_arr(NULL),
+		m_cell(NULL)
+	{}
+
+	/** Destructor. Frees the sync array cell, if one was reserved. */
+	~sync_futex_waiter_t()
+	{
+		if (m_cell != NULL) {
+			sync_array_free_cell(m_arr, m_cell);
+		}
+	}
+
+	/** Sleep until the futex word is woken up, or until it does not
+	hold the expected value. The caller must recheck the lock, as the
+	wake-up can also be spurious.
+	@param[in]	word	futex word
+	@param[in]	val	expected value of the word */
+	void wait(int32* word, int32 val);
+
+private:
+	/** the mutex or rw-lock to wait for */
+	void*		m_object;
+	/** lock request type */
+	ulint		m_type;
+	/** file where requested */
+	const char*	m_file;
+	/** line where requested */
+	unsigned	m_line;
+	/** the sync array of m_cell */
+	sync_array_t*	m_arr;
+	/** the cell that was reserved after a long wait, or NULL */
+	sync_cell_t*	m_cell;
+};
+
+/** Wake up threads that sleep on a futex word.
+@param[in]	word	futex word
+@param[in]	n	maximum number of threads to wake up */
+inline
+void
+sync_futex_wake(int32* word, int n)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+#endif /* HAVE_IB_LINUX_FUTEX */
+
 #include "sync0arr.ic"
 
 #endif /* sync0arr_h */
@@ -576,6 +576,13 @@ struct rw_lock_t
 	/** 1: there are waiters */
 	volatile uint32_t	waiters;
 
+#ifdef HAVE_IB_LINUX_FUTEX
+	/** Incremented by every unlock that resets waiters. Read and
+	write waiters sleep on the value that they read before setting
+	waiters, so that a wake-up cannot be missed. */
+	volatile int32	waiters_seq;
+#endif /* HAVE_IB_LINUX_FUTEX */
+
 	/** number of granted SX locks. */
 	volatile ulint	sx_recursive;
 
@@ -593,11 +600,13 @@ struct rw_lock_t
 	the lock_word. */
 	volatile os_thread_id_t	writer_thread;
 
-	/** Used by sync0arr.cc for thread queueing */
+	/** Used by sync0arr.cc for thread queueing; not waited for
+	with HAVE_IB_LINUX_FUTEX, where the waiters sleep on waiters_seq */
 	os_event_t	event;
 
 	/** Event for next-writer to wait on. A thread must decrement
-	lock_word before waiting. */
+	lock_word before waiting. Not waited for with HAVE_IB_LINUX_FUTEX,
+	where the next writer sleeps on lock_word. */
 	os_event_t	wait_ex_event;
 
 	/** File name where lock created */
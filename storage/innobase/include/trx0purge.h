@@ -515,6 +515,10 @@ class purge_sys_t
 					without holding the latch. */
 	que_t*		query;		/*!< The query graph which will do the
 					parallelized purge operation */
+	mem_heap_t*	heap;		/*!< Memory heap for the copies of the
+					undo log records of the current
+					batch; emptied when the next batch
+					is attached */
 	ReadView	view;		/*!< The purge will not remove undo logs
 					which are >= this view (purge view) */
 	volatile ulint	n_submitted;	/*!< Count of total tasks submitted
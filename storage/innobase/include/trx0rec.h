@@ -80,6 +80,13 @@ trx_undo_rec_get_undo_no(
 /*=====================*/
 	const trx_undo_rec_t*	undo_rec);	/*!< in: undo log record */
 
+/** Read the table id from an undo log record.
+@param[in]	undo_rec	undo log record
+@return table id */
+UNIV_INLINE
+table_id_t
+trx_undo_rec_get_table_id(const trx_undo_rec_t* undo_rec);
+
 /**********************************************************************//**
 Returns the start of the undo record data area. */
 #define trx_undo_rec_get_ptr(undo_rec, undo_no)		\
@@ -192,7 +199,9 @@ trx_undo_report_row_operation(
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: in the case of an insert,
 					index entry to insert into the
-					clustered index; in updates,
+					clustered index, or NULL for a
+					bulk insert into an empty table
+					(TRX_UNDO_EMPTY); in updates,
 					may contain a clustered index
 					record tuple that also contains
 					virtual columns of the table;
@@ -322,6 +331,8 @@ trx_undo_read_v_idx(
 compilation info multiplied by 16 is ORed to this value in an undo log
 record */
 
+#define	TRX_UNDO_EMPTY		10	/* bulk insert into an empty table;
+					rollback empties all indexes */
 #define	TRX_UNDO_INSERT_REC	11	/* fresh insert into clustered index */
 #define	TRX_UNDO_UPD_EXIST_REC	12	/* update of a non-delete-marked
 					record */
@@ -24,6 +24,7 @@ INCLUDE(lzo.cmake)
 INCLUDE(lzma.cmake)
 INCLUDE(bzip2.cmake)
 INCLUDE(snappy.cmake)
+INCLUDE(zstd.cmake)
 INCLUDE(numa)
 
 MYSQL_CHECK_LZ4()
@@ -31,6 +32,7 @@ MYSQL_CHECK_LZO()
 MYSQL_CHECK_LZMA()
 MYSQL_CHECK_BZIP2()
 MYSQL_CHECK_SNAPPY()
+MYSQL_CHECK_ZSTD()
 MYSQL_CHECK_NUMA()
 
 IF(CMAKE_CROSSCOMPILING)
@@ -65,6 +67,20 @@ IF(UNIX)
     IF(HAVE_LIBAIO_H AND HAVE_LIBAIO)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
+
+      # io_uring is driven through raw system calls, so only the
+      # kernel headers are needed (no liburing).
+      CHECK_C_SOURCE_COMPILES("
+      #include <sys/syscall.h>
+      #include <linux/io_uring.h>
+      int main() {
+        struct io_uring_params p;
+        return (int) sizeof(p) + __NR_io_uring_setup + __NR_io_uring_enter
+          + IORING_OP_READV + IORING_OP_WRITEV;
+      }" HAVE_IO_URING)
+      IF(HAVE_IO_URING)
+        ADD_DEFINITIONS(-DHAVE_IO_URING=1)
+      ENDIF()
     ENDIF()
     IF(HAVE_LIBNUMA)
       LINK_LIBRARIES(numa)
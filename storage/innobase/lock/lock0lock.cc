@@ -4706,16 +4706,18 @@ lock_table(
 }
 
 /*********************************************************************//**
-Creates a table IX lock object for a resurrected transaction. */
+Creates a table IX or X lock object for a resurrected transaction. */
 void
-lock_table_ix_resurrect(
-/*====================*/
+lock_table_resurrect(
+/*=================*/
 	dict_table_t*	table,	/*!< in/out: table */
-	trx_t*		trx)	/*!< in/out: transaction */
+	trx_t*		trx,	/*!< in/out: transaction */
+	lock_mode	mode)	/*!< in: LOCK_IX or LOCK_X */
 {
 	ut_ad(trx->is_recovered);
+	ut_ad(mode == LOCK_IX || mode == LOCK_X);
 
-	if (lock_table_has(trx, table, LOCK_IX)) {
+	if (lock_table_has(trx, table, mode)) {
 		return;
 	}
 
@@ -4725,10 +4727,10 @@ lock_table_ix_resurrect(
 	other transactions have in the table lock queue. */
 
 	ut_ad(!lock_table_other_has_incompatible(
-		      trx, LOCK_WAIT, table, LOCK_IX));
+		      trx, LOCK_WAIT, table, mode));
 
 	trx_mutex_enter(trx);
-	lock_table_create(table, LOCK_IX, trx);
+	lock_table_create(table, mode, trx);
 	lock_mutex_exit();
 	trx_mutex_exit(trx);
 }
@@ -4799,6 +4801,18 @@ lock_table_dequeue(
 	}
 }
 
+/** Check if a transaction holds an exclusive lock on a table.
+@param[in]	trx	transaction
+@param[in]	table	table
+@return whether trx holds LOCK_X on table */
+bool
+lock_table_has_x(
+	const trx_t*		trx,
+	const dict_table_t*	table)
+{
+	return(lock_table_has(trx, table, LOCK_X) != NULL);
+}
+
 /** Sets a lock on a table based on the given mode.
 @param[in]	table	table to lock
 @param[in,out]	trx	transaction
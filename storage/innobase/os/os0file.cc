@@ -62,6 +62,13 @@ Created 10/21/1995 Heikki Tuuri
 
 #ifdef LINUX_NATIVE_AIO
 #include <libaio.h>
+# ifdef HAVE_IO_URING
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <poll.h>
+# endif /* HAVE_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
@@ -188,6 +195,9 @@ mysql_pfs_key_t  innodb_temp_file_key;
 #endif /* UNIV_PFS_IO */
 
 class AIO;
+#if defined(LINUX_NATIVE_AIO) && defined(HAVE_IO_URING)
+class LinuxIoUring;
+#endif /* LINUX_NATIVE_AIO && HAVE_IO_URING */
 
 /** The asynchronous I/O context */
 struct Slot {
@@ -268,6 +278,11 @@ struct Slot {
 
 	/** length of the block to read or write */
 	ulint			len;
+
+# ifdef HAVE_IO_URING
+	/** the buffer passed to IORING_OP_READV or IORING_OP_WRITEV */
+	struct iovec		iov;
+# endif /* HAVE_IO_URING */
 #else
 	/** length of the block to read or write */
 	ulint			len;
@@ -426,6 +441,18 @@ class AIO {
 		return(m_aio_ctx[segment]);
 	}
 
+# ifdef HAVE_IO_URING
+	/** Accessor for the io_uring of a segment
+	@param[in]	segment	Segment for which to get the ring
+	@return the ring, or NULL if this array uses libaio */
+	inline LinuxIoUring* io_uring(ulint segment)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Submit the requests that were queued with
+	IORequest::DO_NOT_WAKE in all io_uring AIO arrays. */
+	static void io_uring_submit_all();
+# endif /* HAVE_IO_URING */
+
 	/** Creates an io_context for native linux AIO.
 	@param[in]	max_events	number of events
 	@param[out]	io_ctx		io_ctx to initialize.
@@ -585,6 +612,30 @@ class AIO {
 	@return DB_SUCCESS or error code */
 	dberr_t init_linux_native_aio()
 		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Create one libaio context per segment.
+	@return false if Linux native AIO was disabled because of a failure */
+	bool create_linux_io_ctxs()
+		MY_ATTRIBUTE((warn_unused_result));
+
+# ifdef HAVE_IO_URING
+	/** Create one io_uring per segment.
+	@return true on success; on failure nothing is left allocated */
+	bool init_io_uring()
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Close the io_uring of every segment */
+	void close_io_uring();
+
+	/** Switch the arrays that were created so far from io_uring to
+	libaio, after io_uring could not be set up for a later array.
+	@return false if Linux native AIO was disabled because of a failure */
+	static bool io_uring_disable_all()
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Submit the queued requests of all segments of the array */
+	void io_uring_submit();
+# endif /* HAVE_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 private:
@@ -627,6 +678,12 @@ class AIO {
 	event for each possible pending IO. The size of the array
 	is equal to m_slots.size(). */
 	IOEvents		m_events;
+
+# ifdef HAVE_IO_URING
+	/** io_uring submission and completion rings, one per segment,
+	or NULL if this array uses libaio io_context */
+	LinuxIoUring*		m_io_uring;
+# endif /* HAVE_IO_URING */
 #endif /* LINUX_NATIV_AIO */
 
 	/** The aio arrays for non-ibuf i/o and ibuf i/o, as well as
@@ -1623,6 +1680,364 @@ os_file_punch_hole_posix(
 
 #if defined(LINUX_NATIVE_AIO)
 
+# ifdef HAVE_IO_URING
+/** Number of requests queued with IORequest::DO_NOT_WAKE after which
+they are handed to the kernel even if the batch has not ended */
+static const unsigned	OS_AIO_URING_SUBMIT_BATCH = 32;
+
+/** Time in milliseconds that an i/o handler thread waits for io_uring
+completions before it checks the server state again; the same as
+OS_AIO_REAP_TIMEOUT for io_getevents() */
+static const int	OS_AIO_URING_REAP_TIMEOUT_MS = 500;
+
+/** An io_uring instance serving one segment of an AIO array.
+
+Requests are written to the submission ring that is shared with the
+kernel. A request posted with IORequest::DO_NOT_WAKE is only queued;
+it is handed to the kernel together with the rest of its batch by a
+single io_uring_enter() when the batch ends. Completions are reaped
+directly from the shared completion ring, so that an i/o handler thread
+that finds completed requests does not need a system call at all. */
+class LinuxIoUring {
+public:
+	LinuxIoUring()
+		:
+		m_fd(-1),
+		m_sq_ptr(MAP_FAILED),
+		m_sq_size(),
+		m_cq_ptr(MAP_FAILED),
+		m_cq_size(),
+		m_sqes(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+		m_sqes_size(),
+		m_n_queued()
+	{
+		// No op
+	}
+
+	/** Set up the ring.
+	@param[in]	entries	number of submission queue entries
+	@return true on success */
+	bool create(unsigned entries)
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Tear down the ring. Must be called after create(), also when
+	create() failed. */
+	void close();
+
+	/** Post a read or write request.
+	@param[in,out]	slot	reserved slot
+	@param[in]	submit	whether to hand the request and all earlier
+				queued requests to the kernel now */
+	void queue(Slot* slot, bool submit);
+
+	/** Hand all queued requests to the kernel. */
+	void submit()
+	{
+		m_mutex.enter();
+		submit_low();
+		m_mutex.exit();
+	}
+
+	/** Wait for completed requests. Only one thread may reap from a ring.
+	@param[out]	events		completed requests, in the format that
+					io_getevents() would have returned
+	@param[in]	n		size of events[]
+	@param[in]	timeout_ms	how long to wait if nothing has
+					completed
+	@return number of completed requests, or -errno */
+	int getevents(io_event* events, unsigned n, int timeout_ms);
+
+private:
+	/** Hand the queued requests to the kernel; m_mutex must be held */
+	void submit_low();
+
+	/** Move completed requests from the completion ring to events[].
+	@param[out]	events	completed requests
+	@param[in]	n	size of events[]
+	@return number of completed requests */
+	unsigned reap(io_event* events, unsigned n);
+
+	/** Ring file descriptor */
+	int			m_fd;
+
+	/** Protects the submission ring */
+	OSMutex			m_mutex;
+
+	/** Submission ring mapping */
+	void*			m_sq_ptr;
+	size_t			m_sq_size;
+
+	/** Completion ring mapping */
+	void*			m_cq_ptr;
+	size_t			m_cq_size;
+
+	/** Submission queue entries */
+	struct io_uring_sqe*	m_sqes;
+	size_t			m_sqes_size;
+
+	/** Submission ring fields shared with the kernel */
+	unsigned*		m_sq_head;
+	unsigned*		m_sq_tail;
+	unsigned		m_sq_mask;
+	unsigned		m_sq_entries;
+	unsigned*		m_sq_array;
+
+	/** Completion ring fields shared with the kernel */
+	unsigned*		m_cq_head;
+	unsigned*		m_cq_tail;
+	unsigned		m_cq_mask;
+	struct io_uring_cqe*	m_cqes;
+
+	/** Number of requests in the submission ring that have not been
+	passed to io_uring_enter() yet; protected by m_mutex */
+	unsigned		m_n_queued;
+};
+
+/** Set up the ring.
+@param[in]	entries	number of submission queue entries
+@return true on success */
+bool
+LinuxIoUring::create(unsigned entries)
+{
+	struct io_uring_params	params;
+
+	m_mutex.init();
+
+	memset(&params, 0x0, sizeof(params));
+
+	m_fd = static_cast<int>(
+		syscall(__NR_io_uring_setup, entries, &params));
+
+	if (m_fd < 0) {
+		return(false);
+	}
+
+	m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_cq_size = params.cq_off.cqes
+		+ params.cq_entries * sizeof(struct io_uring_cqe);
+	m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	m_sq_ptr = mmap(NULL, m_sq_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+	m_cq_ptr = mmap(NULL, m_cq_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+	m_sqes = static_cast<struct io_uring_sqe*>(
+		mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+
+	if (m_sq_ptr == MAP_FAILED || m_cq_ptr == MAP_FAILED
+	    || m_sqes == MAP_FAILED) {
+		return(false);
+	}
+
+	byte*	sq = static_cast<byte*>(m_sq_ptr);
+	byte*	cq = static_cast<byte*>(m_cq_ptr);
+
+	m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	m_sq_entries = params.sq_entries;
+	m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+	m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<struct io_uring_cqe*>(
+		cq + params.cq_off.cqes);
+
+	return(true);
+}
+
+/** Tear down the ring. */
+void
+LinuxIoUring::close()
+{
+	if (m_sqes != MAP_FAILED) {
+		munmap(m_sqes, m_sqes_size);
+	}
+
+	if (m_cq_ptr != MAP_FAILED) {
+		munmap(m_cq_ptr, m_cq_size);
+	}
+
+	if (m_sq_ptr != MAP_FAILED) {
+		munmap(m_sq_ptr, m_sq_size);
+	}
+
+	if (m_fd >= 0) {
+		::close(m_fd);
+	}
+
+	m_mutex.destroy();
+}
+
+/** Hand the queued requests to the kernel; m_mutex must be held */
+void
+LinuxIoUring::submit_low()
+{
+	while (m_n_queued > 0) {
+
+		int	ret = static_cast<int>(syscall(
+				__NR_io_uring_enter, m_fd, m_n_queued, 0, 0,
+				NULL, 0));
+
+		if (ret >= 0) {
+			ut_a(static_cast<unsigned>(ret) <= m_n_queued);
+
+			m_n_queued -= ret;
+
+			srv_stats.aio_submit_calls.inc();
+
+			continue;
+		}
+
+		switch (errno) {
+		case EINTR:
+			continue;
+		case EAGAIN:
+		case EBUSY:
+			/* Out of kernel resources, or the completion ring
+			is full. The i/o handler threads will make room. */
+			os_thread_sleep(100);
+			continue;
+		}
+
+		ib::fatal()
+			<< "io_uring_enter() failed: errno=" << errno
+			<< ". Set innodb_use_io_uring=0 in my.cnf to use"
+			" libaio instead.";
+	}
+}
+
+/** Post a read or write request.
+@param[in,out]	slot	reserved slot
+@param[in]	submit	whether to hand the request and all earlier queued
+			requests to the kernel now */
+void
+LinuxIoUring::queue(Slot* slot, bool submit)
+{
+	m_mutex.enter();
+
+	unsigned	tail = *m_sq_tail;
+
+	if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE)
+	    >= m_sq_entries) {
+
+		/* Without IORING_SETUP_SQPOLL the kernel consumes all
+		entries in io_uring_enter(). */
+		submit_low();
+
+		ut_a(tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE)
+		     < m_sq_entries);
+	}
+
+	unsigned		index = tail & m_sq_mask;
+	struct io_uring_sqe*	sqe = &m_sqes[index];
+
+	slot->iov.iov_base = slot->ptr;
+	slot->iov.iov_len = slot->len;
+	slot->control.data = slot;
+
+	memset(sqe, 0x0, sizeof(*sqe));
+
+	sqe->opcode = slot->type.is_read() ? IORING_OP_READV : IORING_OP_WRITEV;
+	sqe->fd = slot->file;
+	sqe->off = slot->offset;
+	sqe->addr = reinterpret_cast<uintptr_t>(&slot->iov);
+	sqe->len = 1;
+	sqe->user_data = reinterpret_cast<uintptr_t>(slot);
+
+	m_sq_array[index] = index;
+
+	__atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	++m_n_queued;
+
+	if (submit || m_n_queued >= OS_AIO_URING_SUBMIT_BATCH) {
+		submit_low();
+	}
+
+	m_mutex.exit();
+}
+
+/** Move completed requests from the completion ring to events[].
+@param[out]	events	completed requests
+@param[in]	n	size of events[]
+@return number of completed requests */
+unsigned
+LinuxIoUring::reap(io_event* events, unsigned n)
+{
+	unsigned	head = *m_cq_head;
+	unsigned	tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+	unsigned	i;
+
+	for (i = 0; i < n && head != tail; ++i, ++head) {
+
+		const struct io_uring_cqe*	cqe = &m_cqes[head & m_cq_mask];
+		Slot*				slot = reinterpret_cast<Slot*>(
+			static_cast<uintptr_t>(cqe->user_data));
+
+		events[i].data = slot;
+		events[i].obj = &slot->control;
+
+		if (cqe->res >= 0) {
+			events[i].res = cqe->res;
+			events[i].res2 = 0;
+		} else {
+			events[i].res = 0;
+			events[i].res2 = cqe->res;
+		}
+	}
+
+	__atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+
+	return(i);
+}
+
+/** Wait for completed requests.
+@param[out]	events		completed requests
+@param[in]	n		size of events[]
+@param[in]	timeout_ms	how long to wait if nothing has completed
+@return number of completed requests, or -errno */
+int
+LinuxIoUring::getevents(io_event* events, unsigned n, int timeout_ms)
+{
+	unsigned	n_reaped = reap(events, n);
+
+	if (n_reaped > 0) {
+		return(static_cast<int>(n_reaped));
+	}
+
+	/* Nothing completed. Make sure that nothing we are going to wait
+	for is still sitting in the submission ring. */
+	submit();
+
+	struct pollfd	pfd;
+
+	pfd.fd = m_fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	if (::poll(&pfd, 1, timeout_ms) < 0) {
+		return(-errno);
+	}
+
+	return(static_cast<int>(reap(events, n)));
+}
+
+/** Accessor for the io_uring of a segment
+@param[in]	segment	Segment for which to get the ring
+@return the ring, or NULL if this array uses libaio */
+inline
+LinuxIoUring*
+AIO::io_uring(ulint segment)
+{
+	ut_ad(segment < get_n_segments());
+
+	return(m_io_uring != NULL ? &m_io_uring[segment] : NULL);
+}
+# endif /* HAVE_IO_URING */
+
 /** Linux native AIO handler */
 class LinuxAIOHandler {
 public:
@@ -1735,6 +2150,14 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	slot->n_bytes = 0;
 	slot->io_already_done = false;
 
+# ifdef HAVE_IO_URING
+	if (LinuxIoUring* ring = m_array->io_uring(m_segment)) {
+		ring->queue(slot, true);
+
+		return(DB_SUCCESS);
+	}
+# endif /* HAVE_IO_URING */
+
 	struct iocb*	iocb = &slot->control;
 
 	if (slot->type.is_read()) {
@@ -1762,6 +2185,8 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	/* Resubmit an I/O request */
 	int	ret = io_submit(m_array->io_ctx(m_segment), 1, &iocb);
 
+	srv_stats.aio_submit_calls.inc();
+
 	if (ret < -1)  {
 		errno = -ret;
 	}
@@ -1865,6 +2290,9 @@ LinuxAIOHandler::collect()
 
 	/* Which io_context we are going to use. */
 	io_context*	io_ctx = m_array->io_ctx(m_segment);
+#ifdef HAVE_IO_URING
+	LinuxIoUring*	ring = m_array->io_uring(m_segment);
+#endif /* HAVE_IO_URING */
 
 	/* Starting point of the m_segment we will be working on. */
 	ulint	start_pos = m_segment * m_n_slots;
@@ -1890,6 +2318,13 @@ LinuxAIOHandler::collect()
 
 		int	ret;
 
+#ifdef HAVE_IO_URING
+		if (ring != NULL) {
+			ret = ring->getevents(
+				events, static_cast<unsigned>(m_n_slots),
+				OS_AIO_URING_REAP_TIMEOUT_MS);
+		} else
+#endif /* HAVE_IO_URING */
 		ret = io_getevents(io_ctx, 1, m_n_slots, events, &timeout);
 
 		for (int i = 0; i < ret; ++i) {
@@ -2110,8 +2545,23 @@ AIO::linux_dispatch(Slot* slot)
 
 	io_ctx_index = (slot->pos * m_n_segments) / m_slots.size();
 
+	srv_stats.aio_requests.inc();
+
+#ifdef HAVE_IO_URING
+	if (m_io_uring != NULL) {
+		/* Requests posted with IORequest::DO_NOT_WAKE are
+		submitted as one batch by
+		os_aio_simulated_wake_handler_threads(). */
+		m_io_uring[io_ctx_index].queue(slot, slot->type.is_wake());
+
+		return(true);
+	}
+#endif /* HAVE_IO_URING */
+
 	int	ret = io_submit(m_aio_ctx[io_ctx_index], 1, &iocb);
 
+	srv_stats.aio_submit_calls.inc();
+
 	/* io_submit() returns number of successfully queued requests
 	or -errno. */
 
@@ -5750,6 +6200,9 @@ AIO::AIO(
 # ifdef LINUX_NATIVE_AIO
 	,m_aio_ctx(),
 	m_events(m_slots.size())
+#  ifdef HAVE_IO_URING
+	,m_io_uring()
+#  endif /* HAVE_IO_URING */
 # endif /* LINUX_NATIVE_AIO */
 {
 	ut_a(n > 0);
@@ -5814,6 +6267,43 @@ AIO::init_linux_native_aio()
 		return(DB_OUT_OF_MEMORY);
 	}
 
+#ifdef HAVE_IO_URING
+	if (srv_use_io_uring) {
+		if (init_io_uring()) {
+			return(DB_SUCCESS);
+		}
+
+		ib::warn()
+			<< "io_uring_setup() failed: errno=" << errno
+			<< ". Falling back to libaio. To get rid of this"
+			" warning, set innodb_use_io_uring = 0 in my.cnf";
+
+		srv_use_io_uring = FALSE;
+
+		/* Requests that are queued with IORequest::DO_NOT_WAKE
+		are only submitted while srv_use_io_uring is set: no
+		array may keep using io_uring. */
+		if (!io_uring_disable_all()) {
+			ut_free(m_aio_ctx);
+			m_aio_ctx = 0;
+			return(DB_SUCCESS);
+		}
+	}
+#endif /* HAVE_IO_URING */
+
+	if (!create_linux_io_ctxs()) {
+		ut_free(m_aio_ctx);
+		m_aio_ctx = 0;
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Create one libaio context per segment.
+@return false if Linux native AIO was disabled because of a failure */
+bool
+AIO::create_linux_io_ctxs()
+{
 	io_context**	ctx = m_aio_ctx;
 	ulint		max_events = slots_per_segment();
 
@@ -5836,15 +6326,122 @@ AIO::init_linux_native_aio()
 				<< "try increasing system "
 				<< "fs.aio-max-nr to 1048576 or larger or "
 				<< "setting innodb_use_native_aio = 0 in my.cnf";
-			ut_free(m_aio_ctx);
-			m_aio_ctx = 0;
 			srv_use_native_aio = FALSE;
-			return(DB_SUCCESS);
+			return(false);
 		}
 	}
 
-	return(DB_SUCCESS);
+	return(true);
+}
+
+# ifdef HAVE_IO_URING
+/** Create one io_uring per segment.
+@return true on success; on failure nothing is left allocated */
+bool
+AIO::init_io_uring()
+{
+	ut_a(m_io_uring == NULL);
+
+	/* Fail for every array that is created after s_reads. */
+	DBUG_EXECUTE_IF("io_uring_setup_fail_after_reads",
+			if (s_reads != NULL) {
+				errno = ENOMEM;
+				return(false);
+			});
+
+	LinuxIoUring*	rings = UT_NEW_ARRAY_NOKEY(LinuxIoUring, m_n_segments);
+	unsigned	entries = static_cast<unsigned>(slots_per_segment());
+
+	if (rings == NULL) {
+		errno = ENOMEM;
+		return(false);
+	}
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+
+		if (!rings[i].create(entries)) {
+			int	err = errno;
+
+			for (ulint j = 0; j <= i; ++j) {
+				rings[j].close();
+			}
+
+			UT_DELETE_ARRAY(rings);
+
+			errno = err;
+
+			return(false);
+		}
+	}
+
+	m_io_uring = rings;
+
+	return(true);
+}
+
+/** Close the io_uring of every segment */
+void
+AIO::close_io_uring()
+{
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		m_io_uring[i].close();
+	}
+
+	UT_DELETE_ARRAY(m_io_uring);
+	m_io_uring = NULL;
 }
+
+/** Switch the arrays that were created so far from io_uring to libaio,
+after io_uring could not be set up for a later array. No i/o has been
+posted yet: the arrays are created before any file is opened.
+@return false if Linux native AIO was disabled because of a failure */
+bool
+AIO::io_uring_disable_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes, s_sync };
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+		AIO*	array = arrays[i];
+
+		if (array == NULL || array->m_io_uring == NULL) {
+			continue;
+		}
+
+		ut_ad(array->m_n_reserved == 0);
+
+		array->close_io_uring();
+
+		if (!array->create_linux_io_ctxs()) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Submit the queued requests of all segments of the array */
+void
+AIO::io_uring_submit()
+{
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		m_io_uring[i].submit();
+	}
+}
+
+/** Submit the requests that were queued with IORequest::DO_NOT_WAKE in
+all io_uring AIO arrays. */
+void
+AIO::io_uring_submit_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes, s_sync };
+
+	for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+		if (arrays[i] != NULL && arrays[i]->m_io_uring != NULL) {
+			arrays[i]->io_uring_submit();
+		}
+	}
+}
+# endif /* HAVE_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 /** Initialise the array */
@@ -5916,6 +6513,12 @@ AIO::~AIO()
 		m_events.clear();
 		ut_free(m_aio_ctx);
 	}
+
+# ifdef HAVE_IO_URING
+	if (m_io_uring != NULL) {
+		close_io_uring();
+	}
+# endif /* HAVE_IO_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 	m_slots.clear();
@@ -5950,6 +6553,17 @@ AIO::start(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#if !defined(LINUX_NATIVE_AIO) || !defined(HAVE_IO_URING)
+	if (srv_use_io_uring) {
+		ib::warn() << "innodb_use_io_uring is ignored: this server"
+			" was built without io_uring support.";
+	}
+
+	srv_use_io_uring = FALSE;
+#else
+	srv_use_io_uring = srv_use_io_uring && srv_use_native_aio;
+#endif /* !LINUX_NATIVE_AIO || !HAVE_IO_URING */
+
 	srv_reset_io_thread_op_info();
 
 	s_reads = create(
@@ -6397,13 +7011,32 @@ AIO::wake_simulated_handler_thread(ulint global_segment, ulint segment)
 	release();
 }
 
+/** @return the name of the asynchronous I/O implementation in use */
+const char*
+os_aio_backend_name()
+{
+	if (!srv_use_native_aio) {
+		return("simulated");
+	}
+
+#ifdef _WIN32
+	return("windows");
+#else
+	return(srv_use_io_uring ? "io_uring" : "libaio");
+#endif /* _WIN32 */
+}
+
 /** Wakes up simulated aio i/o-handler threads if they have something to do. */
 void
 os_aio_simulated_wake_handler_threads()
 {
 	if (srv_use_native_aio) {
-		/* We do not use simulated aio: do nothing */
-
+		/* We do not use simulated aio. With io_uring, hand the
+		requests that were posted with IORequest::DO_NOT_WAKE to
+		the kernel as one batch. */
+#if defined(LINUX_NATIVE_AIO) && defined(HAVE_IO_URING)
+		AIO::io_uring_submit_all();
+#endif /* LINUX_NATIVE_AIO && HAVE_IO_URING */
 		return;
 	}
 
@@ -3440,6 +3440,10 @@ row_ins_index_entry_step(
 
 	err = row_ins_index_entry(node->index, node->entry, thr);
 
+	if (err == DB_SUCCESS) {
+		node->index->stat_modified();
+	}
+
 	DEBUG_SYNC_C_IF_THD(thr_get_trx(thr)->mysql_thd,
 			    "after_row_ins_index_entry_step");
 
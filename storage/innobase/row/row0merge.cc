@@ -66,208 +66,6 @@ float my_log2f(float n)
 /* Whether to disable file system cache */
 char	srv_disable_sort_file_cache;
 
-/** Class that caches index row tuples made from a single cluster
-index page scan, and then insert into corresponding index tree */
-class index_tuple_info_t {
-public:
-	/** constructor
-	@param[in]	heap	memory heap
-	@param[in]	index	index to be created */
-	index_tuple_info_t(
-		mem_heap_t*	heap,
-		dict_index_t*	index) UNIV_NOTHROW
-	{
-		m_heap = heap;
-		m_index = index;
-		m_dtuple_vec = UT_NEW_NOKEY(idx_tuple_vec());
-	}
-
-	/** destructor */
-	~index_tuple_info_t()
-	{
-		UT_DELETE(m_dtuple_vec);
-	}
-
-	/** Get the index object
-	@return the index object */
-	dict_index_t*   get_index() UNIV_NOTHROW
-	{
-		return(m_index);
-	}
-
-	/** Caches an index row into index tuple vector
-	@param[in]	row	table row
-	@param[in]	ext	externally stored column
-	prefixes, or NULL */
-	void add(
-		const dtuple_t*		row,
-		const row_ext_t*	ext) UNIV_NOTHROW
-	{
-		dtuple_t*	dtuple;
-
-		dtuple = row_build_index_entry(row, ext, m_index, m_heap);
-
-		ut_ad(dtuple);
-
-		m_dtuple_vec->push_back(dtuple);
-	}
-
-	/** Insert spatial index rows cached in vector into spatial index
-	@param[in]	trx_id		transaction id
-	@param[in,out]	row_heap	memory heap
-	@param[in]	pcur		cluster index scanning cursor
-	@param[in,out]	scan_mtr	mini-transaction for pcur
-	@param[out]	mtr_committed	whether scan_mtr got committed
-	@return DB_SUCCESS if successful, else error number */
-	dberr_t insert(
-		trx_id_t		trx_id,
-		mem_heap_t*		row_heap,
-		btr_pcur_t*		pcur,
-		mtr_t*			scan_mtr,
-		bool*			mtr_committed)
-	{
-		big_rec_t*      big_rec;
-		rec_t*          rec;
-		btr_cur_t       ins_cur;
-		mtr_t           mtr;
-		rtr_info_t      rtr_info;
-		ulint*		ins_offsets = NULL;
-		dberr_t		error = DB_SUCCESS;
-		dtuple_t*	dtuple;
-		ulint		count = 0;
-		const ulint	flag = BTR_NO_UNDO_LOG_FLAG
-				       | BTR_NO_LOCKING_FLAG
-				       | BTR_KEEP_SYS_FLAG | BTR_CREATE_FLAG;
-
-		ut_ad(dict_index_is_spatial(m_index));
-
-		DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
-			log_sys->check_flush_or_checkpoint = true;
-		);
-
-		for (idx_tuple_vec::iterator it = m_dtuple_vec->begin();
-		     it != m_dtuple_vec->end();
-		     ++it) {
-			dtuple = *it;
-			ut_ad(dtuple);
-
-			if (log_sys->check_flush_or_checkpoint) {
-				if (!(*mtr_committed)) {
-					btr_pcur_move_to_prev_on_page(pcur);
-					btr_pcur_store_position(pcur, scan_mtr);
-					mtr_commit(scan_mtr);
-					*mtr_committed = true;
-				}
-
-				log_free_check();
-			}
-
-			mtr.start();
-			mtr.set_named_space(m_index->space);
-
-			ins_cur.index = m_index;
-			rtr_init_rtr_info(&rtr_info, false, &ins_cur, m_index,
-					  false);
-			rtr_info_update_btr(&ins_cur, &rtr_info);
-
-			btr_cur_search_to_nth_level(m_index, 0, dtuple,
-						    PAGE_CUR_RTREE_INSERT,
-						    BTR_MODIFY_LEAF, &ins_cur,
-						    0, __FILE__, __LINE__,
-						    &mtr);
-
-			/* It need to update MBR in parent entry,
-			so change search mode to BTR_MODIFY_TREE */
-			if (rtr_info.mbr_adj) {
-				mtr_commit(&mtr);
-				rtr_clean_rtr_info(&rtr_info, true);
-				rtr_init_rtr_info(&rtr_info, false, &ins_cur,
-						  m_index, false);
-				rtr_info_update_btr(&ins_cur, &rtr_info);
-				mtr_start(&mtr);
-				mtr.set_named_space(m_index->space);
-				btr_cur_search_to_nth_level(
-					m_index, 0, dtuple,
-					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE, &ins_cur, 0,
-					__FILE__, __LINE__, &mtr);
-			}
-
-			error = btr_cur_optimistic_insert(
-				flag, &ins_cur, &ins_offsets, &row_heap,
-				dtuple, &rec, &big_rec, 0, NULL, &mtr);
-
-			if (error == DB_FAIL) {
-				ut_ad(!big_rec);
-				mtr.commit();
-				mtr.start();
-				mtr.set_named_space(m_index->space);
-
-				rtr_clean_rtr_info(&rtr_info, true);
-				rtr_init_rtr_info(&rtr_info, false,
-						  &ins_cur, m_index, false);
-
-				rtr_info_update_btr(&ins_cur, &rtr_info);
-				btr_cur_search_to_nth_level(
-					m_index, 0, dtuple,
-					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE,
-					&ins_cur, 0,
-					__FILE__, __LINE__, &mtr);
-
-
-				error = btr_cur_pessimistic_insert(
-						flag, &ins_cur, &ins_offsets,
-						&row_heap, dtuple, &rec,
-						&big_rec, 0, NULL, &mtr);
-			}
-
-			DBUG_EXECUTE_IF(
-				"row_merge_ins_spatial_fail",
-				error = DB_FAIL;
-			);
-
-			if (error == DB_SUCCESS) {
-				if (rtr_info.mbr_adj) {
-					error = rtr_ins_enlarge_mbr(
-							&ins_cur, NULL, &mtr);
-				}
-
-				if (error == DB_SUCCESS) {
-					page_update_max_trx_id(
-						btr_cur_get_block(&ins_cur),
-						btr_cur_get_page_zip(&ins_cur),
-						trx_id, &mtr);
-				}
-			}
-
-			mtr_commit(&mtr);
-
-			rtr_clean_rtr_info(&rtr_info, true);
-			count++;
-		}
-
-		m_dtuple_vec->clear();
-
-		return(error);
-	}
-
-private:
-	/** Cache index rows made from a cluster index scan. Usually
-	for rows on single cluster index page */
-	typedef std::vector<dtuple_t*, ut_allocator<dtuple_t*> >
-		idx_tuple_vec;
-
-	/** vector used to cache index rows made from cluster index scan */
-	idx_tuple_vec*		m_dtuple_vec;
-
-	/** the index being built */
-	dict_index_t*		m_index;
-
-	/** memory heap for creating index tuples */
-	mem_heap_t*		m_heap;
-};
-
 /* Maximum pending doc memory limit in bytes for a fts tokenization thread */
 #define FTS_PENDING_DOC_MEMORY_LIMIT	1000000
 
@@ -1568,12 +1366,10 @@ row_mtuple_cmp(
 		       n_unique, n_unique, *current_mtuple, *prev_mtuple, dup));
 }
 
-/** Insert cached spatial index rows.
-@param[in]	trx_id		transaction id
-@param[in]	sp_tuples	cached spatial rows
+/** Write the buffered spatial index entries to leaf pages, for those
+spatial indexes whose buffers are full.
+@param[in,out]	sp_bulks	R-tree bulk loads
 @param[in]	num_spatial	number of spatial indexes
-@param[in,out]	row_heap	heap for insert
-@param[in,out]	sp_heap		heap for tuples
 @param[in,out]	pcur		cluster index cursor
 @param[in,out]	mtr		mini transaction
 @param[in,out]	mtr_committed	whether scan_mtr got committed
@@ -1581,36 +1377,41 @@ row_mtuple_cmp(
 static
 dberr_t
 row_merge_spatial_rows(
-	trx_id_t		trx_id,
-	index_tuple_info_t**	sp_tuples,
+	RtrBulk**		sp_bulks,
 	ulint			num_spatial,
-	mem_heap_t*		row_heap,
-	mem_heap_t*		sp_heap,
 	btr_pcur_t*		pcur,
 	mtr_t*			mtr,
 	bool*			mtr_committed)
 {
-	dberr_t			err = DB_SUCCESS;
-
-	if (sp_tuples == NULL) {
+	if (sp_bulks == NULL) {
 		return(DB_SUCCESS);
 	}
 
-	ut_ad(sp_heap != NULL);
+	DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
+		log_sys->check_flush_or_checkpoint = true;
+	);
 
 	for (ulint j = 0; j < num_spatial; j++) {
-		err = sp_tuples[j]->insert(
-			trx_id, row_heap,
-			pcur, mtr, mtr_committed);
+		if (!sp_bulks[j]->isFull()) {
+			continue;
+		}
+
+		/* RtrBulk::flush() may call log_free_check(). */
+		if (!*mtr_committed) {
+			btr_pcur_move_to_prev_on_page(pcur);
+			btr_pcur_store_position(pcur, mtr);
+			mtr_commit(mtr);
+			*mtr_committed = true;
+		}
+
+		dberr_t	err = sp_bulks[j]->flush();
 
 		if (err != DB_SUCCESS) {
 			return(err);
 		}
 	}
 
-	mem_heap_empty(sp_heap);
-
-	return(err);
+	return(DB_SUCCESS);
 }
 
 /** Check if the geometry field is valid.
@@ -1722,8 +1523,7 @@ row_merge_read_clustered_index(
 	os_event_t		fts_parallel_sort_event = NULL;
 	ibool			fts_pll_sort = FALSE;
 	int64_t			sig_count = 0;
-	index_tuple_info_t**	sp_tuples = NULL;
-	mem_heap_t*		sp_heap = NULL;
+	RtrBulk**		sp_bulks = NULL;
 	ulint			num_spatial = 0;
 	BtrBulk*		clust_btr_bulk = NULL;
 	bool			clust_temp_file = false;
@@ -1808,19 +1608,17 @@ row_merge_read_clustered_index(
 	if (num_spatial > 0) {
 		ulint	count = 0;
 
-		sp_heap = mem_heap_create(512);
-
-		sp_tuples = static_cast<index_tuple_info_t**>(
-			ut_malloc_nokey(num_spatial
-					* sizeof(*sp_tuples)));
+		sp_bulks = static_cast<RtrBulk**>(
+			ut_malloc_nokey(num_spatial * sizeof(*sp_bulks)));
 
+		/* Spatial index entries are buffered in memory and
+		loaded in STR order, instead of being sorted. */
 		for (ulint i = 0; i < n_index; i++) {
 			if (dict_index_is_spatial(index[i])) {
-				sp_tuples[count]
-					= UT_NEW_NOKEY(
-						index_tuple_info_t(
-							sp_heap,
-							index[i]));
+				sp_bulks[count] = UT_NEW_NOKEY(
+					RtrBulk(index[i], trx->id, observer,
+						16 * srv_sort_buf_size));
+				sp_bulks[count]->init();
 				count++;
 			}
 		}
@@ -1939,12 +1737,11 @@ row_merge_read_clustered_index(
 				"ib_purge_on_create_index_page_switch",
 				dbug_run_purge = true;);
 
-			/* Insert the cached spatial index rows. */
+			/* Write the buffered spatial index entries. */
 			bool	mtr_committed = false;
 
 			err = row_merge_spatial_rows(
-				trx->id, sp_tuples, num_spatial,
-				row_heap, sp_heap, &pcur,
+				sp_bulks, num_spatial, &pcur,
 				&mtr, &mtr_committed);
 
 			if (err != DB_SUCCESS) {
@@ -2219,9 +2016,6 @@ row_merge_read_clustered_index(
 					continue;
 				}
 
-				ut_ad(sp_tuples[s_idx_cnt]->get_index()
-				      == buf->index);
-
 				/* If the geometry field is invalid, report
 				error. */
 				if (!row_geo_field_is_valid(row, buf->index)) {
@@ -2229,7 +2023,10 @@ row_merge_read_clustered_index(
 					break;
 				}
 
-				sp_tuples[s_idx_cnt]->add(row, ext);
+				sp_bulks[s_idx_cnt]->insert(
+					row_build_index_entry(
+						row, ext, buf->index,
+						row_heap));
 				s_idx_cnt++;
 
 				continue;
@@ -2334,25 +2131,6 @@ row_merge_read_clustered_index(
 					/* Temporary File is not used.
 					so insert sorted block to the index */
 					if (row != NULL) {
-						bool	mtr_committed = false;
-
-						/* We have to do insert the
-						cached spatial index rows, since
-						after the mtr_commit, the cluster
-						index page could be updated, then
-						the data in cached rows become
-						invalid. */
-						err = row_merge_spatial_rows(
-							trx->id, sp_tuples,
-							num_spatial,
-							row_heap, sp_heap,
-							&pcur, &mtr,
-							&mtr_committed);
-
-						if (err != DB_SUCCESS) {
-							goto func_exit;
-						}
-
 						/* We are not at the end of
 						the scan yet. We must
 						mtr_commit() in order to be
@@ -2362,14 +2140,12 @@ row_merge_read_clustered_index(
 						current row will be invalid, and
 						we must reread it on the next
 						loop iteration. */
-						if (!mtr_committed) {
-							btr_pcur_move_to_prev_on_page(
-								&pcur);
-							btr_pcur_store_position(
-								&pcur, &mtr);
+						btr_pcur_move_to_prev_on_page(
+							&pcur);
+						btr_pcur_store_position(
+							&pcur, &mtr);
 
-							mtr_commit(&mtr);
-						}
+						mtr_commit(&mtr);
 					}
 
 					mem_heap_empty(mtuple_heap);
@@ -2711,15 +2487,19 @@ row_merge_read_clustered_index(
 
 	btr_pcur_close(&pcur);
 
-	if (sp_tuples != NULL) {
+	if (sp_bulks != NULL) {
 		for (ulint i = 0; i < num_spatial; i++) {
-			UT_DELETE(sp_tuples[i]);
-		}
-		ut_free(sp_tuples);
-
-		if (sp_heap) {
-			mem_heap_free(sp_heap);
+			DBUG_EXECUTE_IF("row_merge_ins_spatial_fail",
+					if (err == DB_SUCCESS) {
+						err = DB_FAIL;
+					});
+
+			/* Write the remaining entries and the non-leaf
+			levels of the spatial index. */
+			err = sp_bulks[i]->finish(err);
+			UT_DELETE(sp_bulks[i]);
 		}
+		ut_free(sp_bulks);
 	}
 
 	/* Update the next Doc ID we used. Table should be locked, so
@@ -4607,31 +4387,19 @@ row_merge_build_indexes(
 
 	trx_start_if_not_started_xa(trx, true);
 
-	/* Check if we need a flush observer to flush dirty pages.
+	/* Create a flush observer to flush dirty pages.
 	Since we disable redo logging in bulk load, so we should flush
 	dirty pages before online log apply, because online log apply enables
 	redo logging(we can do further optimization here).
 	1. online add index: flush dirty pages right before row_log_apply().
 	2. table rebuild: flush dirty pages before row_log_table_apply().
 
-	we use bulk load to create all types of indexes except spatial index,
-	for which redo logging is enabled. If we create only spatial indexes,
-	we don't need to flush dirty pages at all. */
-	bool	need_flush_observer = (old_table != new_table);
-
-	for (i = 0; i < n_indexes; i++) {
-		if (!dict_index_is_spatial(indexes[i])) {
-			need_flush_observer = true;
-		}
-	}
-
-	FlushObserver*	flush_observer = NULL;
-	if (need_flush_observer) {
-		flush_observer = UT_NEW_NOKEY(
-			FlushObserver(new_table->space, trx, stage));
+	we use bulk load to create all types of indexes: BtrBulk for
+	B-trees and RtrBulk for spatial indexes. */
+	FlushObserver*	flush_observer = UT_NEW_NOKEY(
+		FlushObserver(new_table->space, trx, stage));
 
-		trx_set_flush_observer(trx, flush_observer);
-	}
+	trx_set_flush_observer(trx, flush_observer);
 
 	merge_files = static_cast<merge_file_t*>(
 		ut_malloc_nokey(n_indexes * sizeof *merge_files));
@@ -4922,7 +4690,6 @@ row_merge_build_indexes(
 			ut_ad(sort_idx->online_status
 			      == ONLINE_INDEX_COMPLETE);
 		} else {
-			ut_ad(need_flush_observer);
 			if (global_system_variables.log_warnings > 2) {
 				sql_print_information(
 					"InnoDB: Online DDL : Applying"
@@ -5020,8 +4787,6 @@ row_merge_build_indexes(
 	DBUG_EXECUTE_IF("ib_index_crash_after_bulk_load", DBUG_SUICIDE(););
 
 	if (flush_observer != NULL) {
-		ut_ad(need_flush_observer);
-
 		DBUG_EXECUTE_IF("ib_index_build_fail_before_flush",
 			error = DB_INTERRUPTED;
 		);
@@ -5050,3 +4815,490 @@ row_merge_build_indexes(
 
 	DBUG_RETURN(error);
 }
+
+/** Constructor.
+@param[in,out]	table		table to insert into
+@param[in,out]	mysql_table	MySQL table handle, for reporting
+				duplicate keys
+@param[in]	roll_ptr	roll pointer of the TRX_UNDO_EMPTY
+				undo log record */
+row_merge_bulk_t::row_merge_bulk_t(
+	dict_table_t*	table,
+	struct TABLE*	mysql_table,
+	roll_ptr_t	roll_ptr)
+	:
+	m_table(table),
+	m_mysql_table(mysql_table),
+	m_roll_ptr(roll_ptr),
+	m_n_index(UT_LIST_GET_LEN(table->indexes)),
+	m_observer(NULL),
+	m_tmpfd(-1),
+	m_block(NULL),
+	m_crypt_block(NULL),
+	m_heap(mem_heap_create(1024)),
+	m_autoinc(0)
+{
+	ut_ad(!dict_table_is_temporary(table));
+
+	m_buf = static_cast<row_merge_buf_t**>(
+		ut_malloc_nokey(m_n_index * sizeof *m_buf));
+	m_rtr_bulk = static_cast<RtrBulk**>(
+		ut_malloc_nokey(m_n_index * sizeof *m_rtr_bulk));
+	m_file = static_cast<merge_file_t*>(
+		ut_malloc_nokey(m_n_index * sizeof *m_file));
+
+	ulint	i = 0;
+
+	for (dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+		m_buf[i] = dict_index_is_spatial(index)
+			? NULL : row_merge_buf_create(index);
+		m_rtr_bulk[i] = NULL;
+		m_file[i].fd = -1;
+		m_file[i].offset = 0;
+		m_file[i].n_rec = 0;
+	}
+
+	ut_ad(i == m_n_index);
+}
+
+/** Destructor. Discards any rows that were not loaded. */
+row_merge_bulk_t::~row_merge_bulk_t()
+{
+	abort_spatial(DB_INTERRUPTED);
+
+	if (m_observer != NULL) {
+		/* Discard the pages that were written. */
+		m_observer->interrupted();
+		m_observer->flush();
+		UT_DELETE(m_observer);
+	}
+
+	for (ulint i = 0; i < m_n_index; i++) {
+		if (m_buf[i] != NULL) {
+			row_merge_buf_free(m_buf[i]);
+		}
+
+		row_merge_file_destroy(&m_file[i]);
+	}
+
+	row_merge_file_destroy_low(m_tmpfd);
+
+	ut_free(m_buf);
+	ut_free(m_rtr_bulk);
+	ut_free(m_file);
+	mem_heap_free(m_heap);
+
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+	if (m_block != NULL) {
+		alloc.deallocate_large(m_block, &m_block_pfx);
+	}
+
+	if (m_crypt_block != NULL) {
+		alloc.deallocate_large(m_crypt_block, &m_crypt_pfx);
+	}
+}
+
+/** Check if all indexes of a table are empty.
+@param[in,out]	table	table
+@param[in]	reset	whether to reinitialize root pages that
+			contain garbage of purged records;
+			the caller must hold LOCK_X on the table
+@return whether the table is empty */
+bool
+row_merge_bulk_t::is_empty(dict_table_t* table, bool reset)
+{
+	for (dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+		mtr_t	mtr;
+		bool	empty;
+		bool	garbage = false;
+
+		mtr.start();
+		mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+		if (const buf_block_t* root = btr_root_block_get(
+			    index, RW_S_LATCH, &mtr)) {
+			const page_t*	page = buf_block_get_frame(root);
+
+			empty = page_is_leaf(page)
+				&& page_get_n_recs(page) == 0;
+			garbage = page_dir_get_n_heap(page)
+				!= PAGE_HEAP_NO_USER_LOW;
+		} else {
+			empty = false;
+		}
+
+		mtr.commit();
+
+		if (!empty) {
+			return(false);
+		}
+
+		if (reset && garbage) {
+			/* BtrBulk::finish() copies the records to
+			a root page that must never have contained
+			any records. */
+			btr_empty_tree(index);
+		}
+	}
+
+	return(true);
+}
+
+/** Check if a row can be buffered. Rows that need off-page
+columns must be inserted normally, after finish().
+@param[in]	row	table row
+@return whether the clustered index record fits on a page */
+bool
+row_merge_bulk_t::fits(const dtuple_t* row)
+{
+	dict_index_t*	index = dict_table_get_first_index(m_table);
+
+	mem_heap_empty(m_heap);
+
+	const dtuple_t*	entry = row_build_index_entry(
+		row, NULL, index, m_heap);
+
+	return(entry != NULL
+	       && !page_zip_rec_needs_ext(
+		       rec_get_converted_size(index, entry, 0),
+		       dict_table_is_comp(m_table),
+		       dtuple_get_n_fields(entry),
+		       dict_table_page_size(m_table)));
+}
+
+/** Buffer a row. DB_TRX_ID, DB_ROLL_PTR and DB_ROW_ID are written
+to the row, which must point to ins_node_t::sys_buf.
+@param[in,out]	row	table row
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_t::add(dtuple_t* row, trx_t* trx)
+{
+	dict_index_t*	clust_index = dict_table_get_first_index(m_table);
+
+	trx_write_trx_id(static_cast<byte*>(dtuple_get_nth_field(
+		row, dict_table_get_sys_col_no(m_table, DATA_TRX_ID))->data),
+			 trx->id);
+	trx_write_roll_ptr(static_cast<byte*>(dtuple_get_nth_field(
+		row, dict_table_get_sys_col_no(m_table, DATA_ROLL_PTR))->data),
+			   m_roll_ptr);
+
+	if (!dict_index_is_unique(clust_index)) {
+		dict_sys_write_row_id(
+			static_cast<byte*>(dtuple_get_nth_field(
+				row, dict_table_get_sys_col_no(
+					m_table, DATA_ROW_ID))->data),
+			dict_sys_get_new_row_id());
+	}
+
+	if (unsigned ai = m_table->persistent_autoinc) {
+		const dfield_t*	dfield = dtuple_get_nth_field(
+			row, dict_col_get_no(
+				dict_index_get_nth_col(clust_index, ai - 1)));
+
+		if (!dfield_is_null(dfield)) {
+			ib_uint64_t	autoinc = row_parse_int(
+				static_cast<const byte*>(dfield->data),
+				dfield->len, dfield->type.mtype,
+				dfield->type.prtype & DATA_UNSIGNED);
+
+			if (autoinc > m_autoinc) {
+				m_autoinc = autoinc;
+			}
+		}
+	}
+
+	ulint	i = 0;
+
+	for (dict_index_t* index = clust_index; index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+		doc_id_t	doc_id = 0;
+		mem_heap_t*	v_heap = NULL;
+		dberr_t		err = DB_SUCCESS;
+
+		if (dict_index_is_spatial(index)) {
+			err = add_spatial(i, index, row, trx);
+
+			if (err != DB_SUCCESS) {
+				return(err);
+			}
+
+			continue;
+		}
+
+		if (row_merge_buf_add(m_buf[i], NULL, m_table, m_table,
+				      NULL, row, NULL, &doc_id, NULL, &err,
+				      &v_heap, m_mysql_table, trx)) {
+			ut_ad(err == DB_SUCCESS);
+			continue;
+		}
+
+		ut_ad(err == DB_SUCCESS);
+
+		/* The buffer is full. Write it out and retry. */
+		err = write_buffer(i, index, trx);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+
+		if (!row_merge_buf_add(m_buf[i], NULL, m_table, m_table,
+				       NULL, row, NULL, &doc_id, NULL, &err,
+				       &v_heap, m_mysql_table, trx)) {
+			/* An empty buffer should have enough
+			room for at least one record. */
+			ut_error;
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Buffer the entry of a spatial index, and write the buffered
+entries to leaf pages when the buffer is full.
+@param[in]	i	index number
+@param[in,out]	index	spatial index
+@param[in]	row	table row
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_t::add_spatial(
+	ulint		i,
+	dict_index_t*	index,
+	const dtuple_t*	row,
+	trx_t*		trx)
+{
+	if (!row_geo_field_is_valid(row, index)) {
+		return(DB_CANT_CREATE_GEOMETRY_OBJECT);
+	}
+
+	if (m_observer == NULL) {
+		m_observer = UT_NEW_NOKEY(
+			FlushObserver(m_table->space, trx, NULL));
+	}
+
+	if (m_rtr_bulk[i] == NULL) {
+		m_rtr_bulk[i] = UT_NEW_NOKEY(
+			RtrBulk(index, trx->id, m_observer,
+				16 * srv_sort_buf_size));
+		m_rtr_bulk[i]->init();
+	}
+
+	m_rtr_bulk[i]->insert(
+		row_build_index_entry(row, NULL, index, m_heap));
+
+	return(m_rtr_bulk[i]->isFull()
+	       ? m_rtr_bulk[i]->flush() : DB_SUCCESS);
+}
+
+/** Abort the loads of spatial indexes that were not finished.
+@param[in]	err	error code */
+void
+row_merge_bulk_t::abort_spatial(dberr_t err)
+{
+	ut_ad(err != DB_SUCCESS);
+
+	for (ulint i = 0; i < m_n_index; i++) {
+		if (m_rtr_bulk[i] != NULL) {
+			m_rtr_bulk[i]->finish(err);
+			UT_DELETE(m_rtr_bulk[i]);
+			m_rtr_bulk[i] = NULL;
+		}
+	}
+}
+
+/** Sort the buffer of an index and write it to the temporary file.
+@param[in]	i	index number
+@param[in,out]	index	index
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_t::write_buffer(ulint i, dict_index_t* index, trx_t* trx)
+{
+	row_merge_buf_t*	buf = m_buf[i];
+	merge_file_t*		file = &m_file[i];
+
+	if (dict_index_is_unique(index)) {
+		row_merge_dup_t	dup = {index, m_mysql_table, NULL, 0};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			trx->error_info = index;
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	if (m_block == NULL) {
+		ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+		m_block = alloc.allocate_large(
+			3 * srv_sort_buf_size, &m_block_pfx);
+
+		if (m_block == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+
+		if (log_tmp_is_encrypted()) {
+			m_crypt_block = alloc.allocate_large(
+				3 * srv_sort_buf_size, &m_crypt_pfx);
+
+			if (m_crypt_block == NULL) {
+				return(DB_OUT_OF_MEMORY);
+			}
+		}
+	}
+
+	if (row_merge_file_create_if_needed(
+		    file, &m_tmpfd, 0, thd_innodb_tmpdir(trx->mysql_thd))
+	    < 0) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	file->n_rec += buf->n_tuples;
+
+	row_merge_buf_write(buf, file, m_block);
+
+	if (!row_merge_write(file->fd, file->offset++, m_block,
+			     m_crypt_block, m_table->space)) {
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(&m_block[0], srv_sort_buf_size);
+
+	m_buf[i] = row_merge_buf_empty(buf);
+	srv_stats.n_bulk_insert_spills.inc();
+	return(DB_SUCCESS);
+}
+
+/** Load the buffered rows into the indexes.
+@param[in,out]	trx	transaction
+@return error code */
+dberr_t
+row_merge_bulk_t::finish(trx_t* trx)
+{
+	dberr_t		err = DB_SUCCESS;
+	ulint		i = 0;
+	/* Every row has a clustered index record. */
+	const ulint	n_rows = m_file[0].n_rec + m_buf[0]->n_tuples;
+
+	if (m_observer == NULL) {
+		m_observer = UT_NEW_NOKEY(
+			FlushObserver(m_table->space, trx, NULL));
+	}
+
+	for (dict_index_t* index = dict_table_get_first_index(m_table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+		row_merge_buf_t*	buf = m_buf[i];
+		merge_file_t*		file = &m_file[i];
+
+		if (dict_index_is_spatial(index)) {
+			if (m_rtr_bulk[i] != NULL) {
+				err = m_rtr_bulk[i]->finish(err);
+				UT_DELETE(m_rtr_bulk[i]);
+				m_rtr_bulk[i] = NULL;
+			}
+		} else if (file->fd < 0) {
+			/* All records are in the sort buffer. */
+			if (buf->n_tuples == 0) {
+				continue;
+			}
+
+			row_merge_dup_t	dup = {index, m_mysql_table, NULL, 0};
+
+			row_merge_buf_sort(
+				buf, dict_index_is_unique(index)
+				? &dup : NULL);
+
+			if (dup.n_dup) {
+				err = DB_DUPLICATE_KEY;
+			} else {
+				BtrBulk	btr_bulk(index, trx->id, m_observer);
+				btr_bulk.init();
+
+				err = row_merge_insert_index_tuples(
+					trx->id, index, m_table, -1, NULL,
+					buf, &btr_bulk, buf->n_tuples, 0, 0,
+					m_crypt_block, m_table->space);
+
+				err = btr_bulk.finish(err);
+			}
+		} else {
+			if (buf->n_tuples) {
+				err = write_buffer(i, index, trx);
+			}
+
+			if (err == DB_SUCCESS) {
+				row_merge_dup_t	dup = {
+					index, m_mysql_table, NULL, 0};
+
+				err = row_merge_sort(
+					trx, dict_index_is_unique(index)
+					? &dup : NULL,
+					file, m_block, &m_tmpfd, false,
+					0, 0, m_crypt_block,
+					m_table->space);
+			}
+
+			if (err == DB_SUCCESS) {
+				BtrBulk	btr_bulk(index, trx->id, m_observer);
+				btr_bulk.init();
+
+				err = row_merge_insert_index_tuples(
+					trx->id, index, m_table, file->fd,
+					m_block, NULL, &btr_bulk,
+					file->n_rec, 0, 0,
+					m_crypt_block, m_table->space);
+
+				err = btr_bulk.finish(err);
+			}
+
+			row_merge_file_destroy(file);
+		}
+
+		if (buf != NULL) {
+			m_buf[i] = row_merge_buf_empty(buf);
+		}
+
+		if (err != DB_SUCCESS) {
+			trx->error_info = index;
+			abort_spatial(err);
+			break;
+		}
+	}
+
+	/* On error, the caller will roll back to TRX_UNDO_EMPTY,
+	which empties all indexes again. */
+	m_observer->flush();
+	UT_DELETE(m_observer);
+	m_observer = NULL;
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	for (dict_index_t* index = dict_table_get_first_index(m_table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+		row_merge_write_redo(index);
+		/* row_ins_index_entry_step() was not called for the
+		rows; count them for the statistics recalculation. */
+		index->stat_modified(n_rows);
+	}
+
+	if (m_autoinc) {
+		btr_write_autoinc(dict_table_get_first_index(m_table),
+				  m_autoinc);
+	}
+
+	srv_stats.n_bulk_insert_rows.add(n_rows);
+	return(DB_SUCCESS);
+}
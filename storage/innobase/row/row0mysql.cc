@@ -985,6 +985,9 @@ row_prebuilt_free(
 		que_graph_free_recursive(prebuilt->ins_graph);
 	}
 
+	UT_DELETE(prebuilt->bulk_insert);
+	UT_DELETE(prebuilt->icp_filter);
+
 	if (prebuilt->sel_graph) {
 		que_graph_free_recursive(prebuilt->sel_graph);
 	}
@@ -1001,26 +1004,7 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			ulint	magic1 = mach_read_from_4(ptr);
-			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-
-			byte*	row = ptr;
-			ut_a(row == prebuilt->fetch_cache[i]);
-			ptr += prebuilt->mysql_row_len;
-
-			ulint	magic2 = mach_read_from_4(ptr);
-			ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-		}
-
-		ut_free(base);
-	}
+	row_sel_prefetch_cache_free(prebuilt);
 
 	if (prebuilt->rtr_info) {
 		rtr_clean_rtr_info(prebuilt->rtr_info, true);
@@ -1324,6 +1308,115 @@ row_mysql_get_table_status(
 	return(err);
 }
 
+/** Check if a bulk insert into an empty table can be used, and if so,
+lock the table exclusively and write the TRX_UNDO_EMPTY undo log record.
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in,out]	thr		query thread
+@return error code
+@retval DB_SUCCESS if prebuilt->bulk_insert was created,
+or if the rows must be inserted one by one */
+static
+dberr_t
+row_bulk_insert_start(
+	row_prebuilt_t*	prebuilt,
+	que_thr_t*	thr)
+{
+	trx_t*		trx = prebuilt->trx;
+	dict_table_t*	table = prebuilt->table;
+
+	ut_ad(!prebuilt->bulk_insert);
+
+	if (prebuilt->ignore_dup_key || trx->duplicates
+	    || dict_table_is_temporary(table) || table->skip_alter_undo
+	    || table->fts != NULL
+	    || (trx->check_foreigns && !table->foreign_set.empty())) {
+		return(DB_SUCCESS);
+	}
+
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+		if (dict_index_has_virtual(index)
+		    || dict_index_is_corrupted(index)
+		    || dict_index_is_online_ddl(index)
+		    || !index->is_committed()) {
+			return(DB_SUCCESS);
+		}
+	}
+
+	/* Unless the transaction already locked the table exclusively,
+	for example by LOCK TABLES, it has to be allowed to do so by
+	SET innodb_bulk_insert_lock_table=ON. The lock blocks other
+	transactions from the table until this one commits. */
+	const bool	locked = lock_table_has_x(trx, table);
+
+	if (!locked && !prebuilt->bulk_insert_lock) {
+		return(DB_SUCCESS);
+	}
+
+	/* Do not wait for an exclusive lock on a table that has rows. */
+	if (!row_merge_bulk_t::is_empty(table, false)) {
+		return(DB_SUCCESS);
+	}
+
+	if (!locked) {
+		dberr_t	err = lock_table_for_trx(table, trx, LOCK_X);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	if (!row_merge_bulk_t::is_empty(table, true)) {
+		return(DB_SUCCESS);
+	}
+
+	roll_ptr_t	roll_ptr;
+	dberr_t		err = trx_undo_report_row_operation(
+		thr, dict_table_get_first_index(table), NULL, NULL, 0,
+		NULL, NULL, &roll_ptr);
+
+	if (err == DB_SUCCESS) {
+		prebuilt->bulk_insert = UT_NEW_NOKEY(
+			row_merge_bulk_t(table, prebuilt->m_mysql_table,
+					 roll_ptr));
+	}
+
+	return(err);
+}
+
+/** Finish a bulk insert into an empty table that was started by
+row_insert_for_mysql() after ha_innobase::start_bulk_insert().
+@param[in,out]	prebuilt	prebuilt struct in MySQL handle
+@param[in]	discard		whether to discard the buffered rows
+				because the statement failed
+@return error code or DB_SUCCESS */
+dberr_t
+row_bulk_insert_end(row_prebuilt_t* prebuilt, bool discard)
+{
+	row_merge_bulk_t*	bulk = prebuilt->bulk_insert;
+	dberr_t			err = DB_SUCCESS;
+
+	prebuilt->bulk_insert_requested = false;
+
+	if (bulk == NULL) {
+		return(DB_SUCCESS);
+	}
+
+	prebuilt->bulk_insert = NULL;
+
+	if (!discard) {
+		trx_t*	trx = prebuilt->trx;
+
+		trx->op_info = "loading sorted rows";
+		err = bulk->finish(trx);
+		trx->op_info = "";
+	}
+
+	UT_DELETE(bulk);
+	return(err);
+}
+
 /** Does an insert for MySQL.
 @param[in]	mysql_rec	row in the MySQL format
 @param[in,out]	prebuilt	prebuilt struct in MySQL handle
@@ -1391,6 +1484,37 @@ row_insert_for_mysql(
 
 	thr = que_fork_get_first_thr(prebuilt->ins_graph);
 
+	if (prebuilt->bulk_insert_requested) {
+		prebuilt->bulk_insert_requested = false;
+		err = row_bulk_insert_start(prebuilt, thr);
+	} else {
+		err = DB_SUCCESS;
+	}
+
+	if (err == DB_SUCCESS && prebuilt->bulk_insert != NULL) {
+		if (prebuilt->bulk_insert->fits(node->row)) {
+			err = prebuilt->bulk_insert->add(node->row, trx);
+
+			if (err == DB_SUCCESS) {
+				goto inserted;
+			}
+		} else {
+			/* Load the buffered rows, and insert this
+			and any further rows one by one. */
+			err = row_bulk_insert_end(prebuilt, false);
+		}
+	}
+
+	if (err != DB_SUCCESS) {
+		trx->op_info = "";
+
+		if (blob_heap != NULL) {
+			mem_heap_free(blob_heap);
+		}
+
+		return(err);
+	}
+
 	if (prebuilt->sql_stat_start) {
 		node->state = INS_NODE_SET_IX_LOCK;
 		prebuilt->sql_stat_start = FALSE;
@@ -1506,6 +1630,7 @@ row_insert_for_mysql(
 
 	que_thr_stop_for_mysql_no_error(thr, trx);
 
+inserted:
 	if (table->is_system_db) {
 		srv_stats.n_system_rows_inserted.inc(size_t(trx->id));
 	} else {
@@ -58,6 +58,8 @@ Created 12/19/1997 Heikki Tuuri
 #include "srv0mon.h"
 #include "ut0new.h"
 
+#include <algorithm>
+
 /* Maximum number of rows to prefetch; MySQL interface has another parameter */
 #define SEL_MAX_N_PREFETCH	16
 
@@ -3769,8 +3771,42 @@ row_sel_dequeue_cached_row_for_mysql(
 	}
 }
 
+/** Free the fetch cache of a prebuilt struct, after checking the magic
+numbers around the cached rows.
+@param[in,out]	prebuilt	prebuilt struct */
+void
+row_sel_prefetch_cache_free(
+	row_prebuilt_t*	prebuilt)
+{
+	if (prebuilt->fetch_cache == NULL) {
+		return;
+	}
+
+	byte*	base = prebuilt->fetch_cache[0] - 4;
+	byte*	ptr = base;
+
+	for (ulint i = 0; i < prebuilt->fetch_cache_size; i++) {
+		ulint	magic1 = mach_read_from_4(ptr);
+		ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+
+		byte*	row = ptr;
+		ut_a(row == prebuilt->fetch_cache[i]);
+		ptr += prebuilt->mysql_row_len;
+
+		ulint	magic2 = mach_read_from_4(ptr);
+		ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
+		ptr += 4;
+	}
+
+	ut_free(base);
+	ut_free(prebuilt->fetch_cache);
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_size = 0;
+}
+
 /********************************************************************//**
-Initialise the prefetch cache. */
+Initialise the prefetch cache for prebuilt->fetch_cache_limit rows. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
@@ -3781,11 +3817,19 @@ row_sel_prefetch_cache_init(
 	ulint	sz;
 	byte*	ptr;
 
+	ut_ad(prebuilt->fetch_cache == NULL);
+
+	prebuilt->fetch_cache_size = prebuilt->fetch_cache_limit;
+	prebuilt->fetch_cache = static_cast<byte**>(
+		ut_malloc_nokey(prebuilt->fetch_cache_size * sizeof(byte*)));
+
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = prebuilt->fetch_cache_size * (prebuilt->mysql_row_len + 8);
+	ut_ad(prebuilt->fetch_cache_size == MYSQL_FETCH_CACHE_SIZE
+	      || sz <= MYSQL_FETCH_CACHE_MAX_BYTES);
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < prebuilt->fetch_cache_size; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3812,12 +3856,14 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
+		/* Allocate memory for the fetch cache, or grow it for a
+		larger batch. No rows are cached at this point. */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
+		row_sel_prefetch_cache_free(prebuilt);
 		row_sel_prefetch_cache_init(prebuilt);
 	}
 
@@ -3919,6 +3965,50 @@ row_sel_try_search_shortcut_for_mysql(
 }
 #endif /* BTR_CUR_HASH_ADAPT */
 
+/** Check a record against the compiled part of the pushed index condition.
+@param[in]	filter	compiled conditions
+@param[in]	rec	record in prebuilt->index
+@param[in]	offsets	rec_get_offsets(rec, prebuilt->index)
+@return whether the record may satisfy the index condition */
+static
+bool
+row_icp_filter_match(
+	const row_icp_filter_t*	filter,
+	const rec_t*		rec,
+	const ulint*		offsets)
+{
+	for (row_icp_filter_t::terms_t::const_iterator it
+		     = filter->terms.begin();
+	     it != filter->terms.end(); ++it) {
+		ulint		len;
+		const byte*	field = rec_get_nth_field(
+			rec, offsets, it->rec_field_no, &len);
+
+		if (len == UNIV_SQL_NULL) {
+			/* A comparison with NULL is never true. */
+			return(false);
+		}
+
+		ut_ad(len <= 8);
+
+		ib_uint64_t	key = row_icp_filter_t::key(
+			mach_read_int_type(field, len, it->is_unsigned),
+			it->is_unsigned);
+
+		if (key < it->low || key > it->high) {
+			return(false);
+		}
+
+		if (!it->in.empty()
+		    && !std::binary_search(it->in.begin(), it->in.end(),
+					   key)) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
 /*********************************************************************//**
 Check a pushed-down index condition.
 @return ICP_NO_MATCH, ICP_MATCH, or ICP_OUT_OF_RANGE */
@@ -3944,6 +4034,22 @@ row_search_idx_cond_check(
 		return(ICP_MATCH);
 	}
 
+	/* In a locking read, the record has already been locked, and
+	the scan must stop at the end of the range, which only the SQL
+	layer checks. Skipping the SQL layer would lock more records. */
+	if (row_icp_filter_t* filter = prebuilt->icp_filter) {
+		if (prebuilt->select_lock_type == LOCK_NONE
+		    && !row_icp_filter_match(filter, rec, offsets)
+		    && ++filter->n_skipped < ROW_ICP_FILTER_CHECK_INTERVAL) {
+			MONITOR_INC(MONITOR_ICP_ATTEMPTS);
+			MONITOR_INC(MONITOR_ICP_NO_MATCH);
+			srv_stats.n_icp_filter_rejected.inc();
+			return(innobase_index_cond_skip(prebuilt->idx_cond));
+		}
+
+		filter->n_skipped = 0;
+	}
+
 	MONITOR_INC(MONITOR_ICP_ATTEMPTS);
 
 	/* Convert to MySQL format those fields that are needed for
@@ -4177,6 +4283,7 @@ row_search_mvcc(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -4201,6 +4308,7 @@ row_search_mvcc(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -4212,7 +4320,8 @@ row_search_mvcc(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -4222,6 +4331,24 @@ row_search_mvcc(
 			goto func_exit;
 		}
 
+		if (prebuilt->n_rows_fetched >= MYSQL_FETCH_CACHE_THRESHOLD) {
+			/* The previous batch was consumed and the scan goes
+			on: fetch more rows per batch, so that the page latch
+			is acquired and the cursor restored less often. Wide
+			rows are cached in smaller batches. */
+			ulint	max_rows = ut_min(
+				ulint(srv_fetch_cache_max_rows),
+				ut_max(ulint(MYSQL_FETCH_CACHE_SIZE),
+				       ulint(MYSQL_FETCH_CACHE_MAX_BYTES)
+				       / (prebuilt->mysql_row_len + 8)));
+
+			if (prebuilt->fetch_cache_limit < max_rows) {
+				prebuilt->fetch_cache_limit = ut_min(
+					2 * prebuilt->fetch_cache_limit,
+					max_rows);
+			}
+		}
+
 		prebuilt->n_rows_fetched++;
 
 		if (prebuilt->n_rows_fetched > 1000000000) {
@@ -5380,7 +5507,7 @@ row_search_mvcc(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -5433,7 +5560,7 @@ row_search_mvcc(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
 			goto next_rec;
 		}
 
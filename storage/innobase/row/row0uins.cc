@@ -340,7 +340,7 @@ row_undo_ins_parse_undo_rec(
 
 	ptr = trx_undo_rec_get_pars(node->undo_rec, &type, &dummy,
 				    &dummy_extern, &undo_no, &table_id);
-	ut_ad(type == TRX_UNDO_INSERT_REC);
+	ut_ad(type == TRX_UNDO_INSERT_REC || type == TRX_UNDO_EMPTY);
 	node->rec_type = type;
 
 	node->update = NULL;
@@ -369,7 +369,9 @@ row_undo_ins_parse_undo_rec(
 		ut_ad(!node->table->skip_alter_undo);
 		clust_index = dict_table_get_first_index(node->table);
 
-		if (clust_index != NULL) {
+		if (type == TRX_UNDO_EMPTY) {
+			/* There is no row reference to parse. */
+		} else if (clust_index != NULL) {
 			ptr = trx_undo_rec_get_row_ref(
 				ptr, clust_index, &node->ref, node->heap);
 
@@ -481,6 +483,35 @@ row_undo_ins(
 		return(DB_SUCCESS);
 	}
 
+	if (node->rec_type == TRX_UNDO_EMPTY) {
+		/* Undo a bulk insert into an empty table by emptying
+		all the indexes. The table is locked exclusively. */
+		ut_ad(!dict_table_is_temporary(node->table));
+		ut_ad(node->table->id != DICT_INDEXES_ID);
+
+		for (dict_index_t* index
+			     = dict_table_get_first_index(node->table);
+		     index != NULL;
+		     index = dict_table_get_next_index(index)) {
+			if (!dict_index_is_corrupted(index)) {
+				log_free_check();
+				btr_empty_tree(index);
+			}
+		}
+
+		if (node->table->stat_initialized) {
+			node->table->stat_n_rows = 0;
+
+			if (!dict_locked) {
+				dict_stats_update_if_needed(node->table);
+			}
+		}
+
+		dict_table_close(node->table, dict_locked, FALSE);
+		node->table = NULL;
+		return(DB_SUCCESS);
+	}
+
 	/* Iterate over all the indexes and undo the insert.*/
 
 	node->index = dict_table_get_first_index(node->table);
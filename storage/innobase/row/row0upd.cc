@@ -2529,7 +2529,13 @@ row_upd_sec_step(
 	if (node->state == UPD_NODE_UPDATE_ALL_SEC
 	    || row_upd_changes_ord_field_binary(node->index, node->update,
 						thr, node->row, node->ext)) {
-		return(row_upd_sec_index_entry(node, thr));
+		dberr_t	err = row_upd_sec_index_entry(node, thr);
+
+		if (err == DB_SUCCESS) {
+			node->index->stat_modified();
+		}
+
+		return(err);
 	}
 
 	return(DB_SUCCESS);
@@ -3141,6 +3147,7 @@ row_upd_clust_step(
 			&mtr);
 
 		if (err == DB_SUCCESS) {
+			index->stat_modified();
 			node->state = UPD_NODE_UPDATE_ALL_SEC;
 			node->index = dict_table_get_next_index(index);
 		}
@@ -3194,6 +3201,7 @@ row_upd_clust_step(
 			goto exit_func;
 		}
 
+		index->stat_modified();
 		node->state = UPD_NODE_UPDATE_ALL_SEC;
 	} else {
 		err = row_upd_clust_rec(
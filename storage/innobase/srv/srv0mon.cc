@@ -864,6 +864,21 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DISPLAY_CURRENT,
 	 MONITOR_DEFAULT_START, MONITOR_DML_PURGE_DELAY},
 
+	{"purge_tables_batched", "purge",
+	 "Number of distinct tables in the purge batches",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_TABLES_BATCHED},
+
+	{"purge_nodes_used", "purge",
+	 "Number of purge nodes given undo log records in the purge batches",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_NODES_USED},
+
+	{"purge_threads_used", "purge",
+	 "Number of purge threads used for the current batch",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_THREADS},
+
 	{"purge_stop_count", "purge",
 	 "Number of times purge was stopped",
 	 MONITOR_DISPLAY_CURRENT,
@@ -174,6 +174,9 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
+/** innodb_use_io_uring; whether native AIO on Linux uses io_uring
+instead of libaio */
+my_bool	srv_use_io_uring;
 my_bool	srv_numa_interleave;
 /** innodb_use_trim; whether to use fallocate(PUNCH_HOLE) with
 page_compression */
@@ -182,6 +185,9 @@ my_bool	srv_use_trim;
 my_bool	srv_use_atomic_writes;
 /** innodb_compression_algorithm; used with page compression */
 ulong	innodb_compression_algorithm;
+/** innodb_compression_zstd_dictionary; whether zstd page compression
+trains a dictionary for each tablespace */
+my_bool	srv_zstd_dictionary;
 /** innodb_mtflush_threads; number of threads used for multi-threaded flush */
 long srv_mtflush_threads;
 /** innodb_use_mtflush; whether to use multi threaded flush. */
@@ -281,6 +287,10 @@ my_bool	srv_random_read_ahead;
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong	srv_read_ahead_threshold;
+/** innodb_fetch_cache_max_rows; the maximum number of rows that a
+consistent read converts to the MySQL format and caches in one batch
+while a scan goes on */
+ulong	srv_fetch_cache_max_rows = MYSQL_FETCH_CACHE_SIZE;
 
 /** innodb_change_buffer_max_size; maximum on-disk size of change
 buffer in terms of percentage of the buffer pool. */
@@ -380,6 +390,8 @@ my_bool		srv_stats_include_delete_marked;
 unsigned long long	srv_stats_persistent_sample_pages;
 /** innodb_stats_auto_recalc */
 my_bool		srv_stats_auto_recalc;
+/** innodb_stats_incremental_recalc */
+my_bool		srv_stats_incremental_recalc;
 
 /** innodb_stats_modified_counter; The number of rows modified before
 we calculate new statistics (default 0 = current limits) */
@@ -397,6 +409,11 @@ number of pages to use in LRU and flush_list batch flushing.
 The rest of the doublewrite buffer is used for single-page flushing. */
 ulong	srv_doublewrite_batch_size = 120;
 
+/** innodb_doublewrite_file: dedicated file for the doublewrite batches
+of each buffer pool instance, or NULL to use the doublewrite buffer in
+the system tablespace */
+char*	srv_doublewrite_file;
+
 /** innodb_replication_delay */
 ulong	srv_replication_delay;
 
@@ -663,6 +680,9 @@ and/or load it during startup. */
 char	srv_buffer_pool_dump_at_shutdown = TRUE;
 char	srv_buffer_pool_load_at_startup = TRUE;
 
+/** Number of threads that read pages during a buffer pool load */
+ulong	srv_buf_load_threads = 1;
+
 /** Slot index in the srv_sys.sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -1554,6 +1574,15 @@ srv_export_innodb_status(void)
 	export_vars.innodb_have_atomic_builtins = 0;
 #endif
 
+	export_vars.innodb_aio_backend = os_aio_backend_name();
+	export_vars.innodb_aio_requests = srv_stats.aio_requests;
+	export_vars.innodb_aio_submit_calls = srv_stats.aio_submit_calls;
+	export_vars.innodb_fts_top_k_queries = srv_stats.n_fts_top_k_queries;
+	export_vars.innodb_fts_top_k_requeries
+		= srv_stats.n_fts_top_k_requeries;
+	export_vars.innodb_icp_filter_rejected
+		= srv_stats.n_icp_filter_rejected;
+
 	export_vars.innodb_page_size = UNIV_PAGE_SIZE;
 
 	export_vars.innodb_log_waits = srv_stats.log_waits;
@@ -1607,6 +1636,10 @@ srv_export_innodb_status(void)
 
 	export_vars.innodb_rows_inserted = srv_stats.n_rows_inserted;
 
+	export_vars.innodb_bulk_insert_rows = srv_stats.n_bulk_insert_rows;
+
+	export_vars.innodb_bulk_insert_spills = srv_stats.n_bulk_insert_spills;
+
 	export_vars.innodb_rows_updated = srv_stats.n_rows_updated;
 
 	export_vars.innodb_rows_deleted = srv_stats.n_rows_deleted;
@@ -1635,6 +1668,8 @@ srv_export_innodb_status(void)
 	export_vars.innodb_page_compressed_trim_op = srv_stats.page_compressed_trim_op;
 	export_vars.innodb_pages_page_decompressed = srv_stats.pages_page_decompressed;
 	export_vars.innodb_pages_page_compression_error = srv_stats.pages_page_compression_error;
+	export_vars.innodb_pages_zstd_dict_compressed = srv_stats.pages_zstd_dict_compressed;
+	export_vars.innodb_pages_zstd_dict_decompressed = srv_stats.pages_zstd_dict_decompressed;
 	export_vars.innodb_pages_decrypted = srv_stats.pages_decrypted;
 	export_vars.innodb_pages_encrypted = srv_stats.pages_encrypted;
 	export_vars.innodb_n_merge_blocks_encrypted = srv_stats.n_merge_blocks_encrypted;
@@ -2247,6 +2282,9 @@ srv_master_do_active_tasks(void)
 	MONITOR_INC_TIME_IN_MICRO_SECS(
 		MONITOR_SRV_IBUF_MERGE_MICROSECOND, counter_time);
 
+	srv_main_thread_op_info = "loading zstd dictionaries";
+	fil_zstd_dict_process();
+
 	/* Flush logs if needed */
 	srv_main_thread_op_info = "flushing log";
 	srv_sync_log_buffer_in_background();
@@ -2332,6 +2370,9 @@ srv_master_do_idle_tasks(void)
 	MONITOR_INC_TIME_IN_MICRO_SECS(
 		MONITOR_SRV_IBUF_MERGE_MICROSECOND, counter_time);
 
+	srv_main_thread_op_info = "loading zstd dictionaries";
+	fil_zstd_dict_process();
+
 	if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
 		return;
 	}
@@ -2664,9 +2705,26 @@ srv_do_purge(ulint* n_total_purged)
 	}
 
 	do {
-		if (trx_sys->rseg_history_len > rseg_history_len
-		    || (srv_max_purge_lag > 0
-			&& rseg_history_len > srv_max_purge_lag)) {
+		const ulint	history_len = trx_sys->rseg_history_len;
+		/* Threads needed for the history list: all of them when
+		purge is lagging behind innodb_max_purge_lag and DML is
+		about to be throttled by trx_purge_dml_delay(), else one
+		per innodb_purge_batch_size transactions in the history. */
+		const ulint	n_lag_threads =
+			srv_max_purge_lag > 0
+			&& history_len > srv_max_purge_lag
+			? n_threads
+			: ut_min(n_threads,
+				 1 + history_len / srv_purge_batch_size);
+
+		if (n_use_threads < n_lag_threads) {
+
+			/* Use all the threads needed at once instead of
+			adding them one batch at a time. */
+
+			n_use_threads = n_lag_threads;
+
+		} else if (history_len > rseg_history_len) {
 
 			/* History length is now longer than what it was
 			when we took the last snapshot. Use more threads. */
@@ -2676,7 +2734,7 @@ srv_do_purge(ulint* n_total_purged)
 			}
 
 		} else if (srv_check_activity(old_activity_count)
-			   && n_use_threads > 1) {
+			   && n_use_threads > n_lag_threads) {
 
 			/* History length same or smaller since last snapshot,
 			use fewer threads. */
@@ -2692,6 +2750,8 @@ srv_do_purge(ulint* n_total_purged)
 		ut_a(n_use_threads > 0);
 		ut_a(n_use_threads <= n_threads);
 
+		MONITOR_SET(MONITOR_PURGE_N_THREADS, n_use_threads);
+
 		/* Take a snapshot of the history list before purge. */
 		if ((rseg_history_len = trx_sys->rseg_history_len) == 0) {
 			break;
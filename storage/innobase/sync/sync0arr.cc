@@ -80,7 +80,14 @@ cell of wait array having one event.  Instead, now the event that a thread
 wants to wait on is embedded in the wait object (mutex or rw_lock). We still
 keep the global wait array for the sake of diagnostics and also to avoid
 infinite wait The error_monitor thread scans the global wait array to signal
-any waiting threads who have missed the signal. */
+any waiting threads who have missed the signal.
+
+On Linux, TTASEventMutex and rw_lock_t waiters sleep on a futex on the
+lock word instead (see sync_futex_waiter_t). They reserve a cell only
+after sleeping for SYNC_FUTEX_REGISTER_WAIT seconds, so that the cells
+are only used for the diagnostics of long semaphore waits and the
+global sync array mutex is not acquired on every wait. Debug builds
+reserve a cell for every wait, to check it for a deadlock. */
 
 typedef SyncArrayMutex::MutexType WaitMutex;
 typedef BlockSyncArrayMutex::MutexType BlockWaitMutex;
@@ -434,16 +441,14 @@ sync_array_free_cell(
 	cell = 0;
 }
 
-/******************************************************************//**
-This function should be called when a thread starts to wait on
-a wait array cell. In the debug version this function checks
-if the wait for a semaphore will result in a deadlock, in which
-case prints info and asserts. */
+/** Mark a reserved cell as waiting, without waiting for its event.
+In the debug version, checks if the wait will result in a deadlock.
+@param[in,out]	arr	wait array
+@param[in,out]	cell	the reserved cell */
 void
-sync_array_wait_event(
-/*==================*/
-	sync_array_t*	arr,	/*!< in: wait array */
-	sync_cell_t*&	cell)	/*!< in: index of the reserved cell */
+sync_array_wait_begin(
+	sync_array_t*	arr,
+	sync_cell_t*	cell)
 {
 	sync_array_enter(arr);
 
@@ -471,6 +476,20 @@ sync_array_wait_event(
 	rw_lock_debug_mutex_exit();
 #endif /* UNIV_DEBUG */
 	sync_array_exit(arr);
+}
+
+/******************************************************************//**
+This function should be called when a thread starts to wait on
+a wait array cell. In the debug version this function checks
+if the wait for a semaphore will result in a deadlock, in which
+case prints info and asserts. */
+void
+sync_array_wait_event(
+/*==================*/
+	sync_array_t*	arr,	/*!< in: wait array */
+	sync_cell_t*&	cell)	/*!< in: index of the reserved cell */
+{
+	sync_array_wait_begin(arr, cell);
 
 	os_event_wait_low(sync_cell_get_event(cell), cell->signal_count);
 
@@ -479,6 +498,48 @@ sync_array_wait_event(
 	cell = 0;
 }
 
+#ifdef HAVE_IB_LINUX_FUTEX
+/** Sleep until the futex word is woken up, or until it does not
+hold the expected value. The caller must recheck the lock, as the
+wake-up can also be spurious.
+@param[in]	word	futex word
+@param[in]	val	expected value of the word */
+void
+sync_futex_waiter_t::wait(int32* word, int32 val)
+{
+#ifdef UNIV_DEBUG
+	/* Like sync_array_wait_event(), reserve a cell and check for a
+	deadlock before every sleep. */
+	m_arr = sync_array_get_and_reserve_cell(
+		m_object, m_type, m_file, m_line, &m_cell);
+	sync_array_wait_begin(m_arr, m_cell);
+
+	syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+
+	sync_array_free_cell(m_arr, m_cell);
+#else
+	if (m_cell == NULL) {
+		struct timespec	timeout = { SYNC_FUTEX_REGISTER_WAIT, 0 };
+
+		if (syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, val,
+			    &timeout, NULL, 0) == 0
+		    || errno != ETIMEDOUT) {
+			return;
+		}
+
+		/* The wait is taking long. Make it visible to
+		sync_array_print_long_waits(). */
+		m_arr = sync_array_get_and_reserve_cell(
+			m_object, m_type, m_file, m_line, &m_cell);
+		m_cell->reservation_time -= SYNC_FUTEX_REGISTER_WAIT;
+		sync_array_wait_begin(m_arr, m_cell);
+	}
+
+	syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+#endif /* UNIV_DEBUG */
+}
+#endif /* HAVE_IB_LINUX_FUTEX */
+
 /******************************************************************//**
 Reports info of a wait array cell. */
 static
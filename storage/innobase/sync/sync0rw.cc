@@ -145,6 +145,24 @@ wait_ex_event:	A thread may only wait on the wait_ex_event after it has
 		These restrictions force the above ordering.
 		Immediately before sending the wake-up signal, we should:
 		   Verify lock_word == 0 (waiting thread holds x_lock)
+
+With HAVE_IB_LINUX_FUTEX, the threads do not wait on event or
+wait_ex_event but sleep on a futex, and reserve a sync array cell only
+for waits that take longer than SYNC_FUTEX_REGISTER_WAIT seconds (for
+every wait in debug builds):
+		Read and write waiters read waiters_seq before setting
+		waiters to 1, and sleep while waiters_seq has that value.
+		The unlocker that resets waiters to 0 increments
+		waiters_seq and wakes up all of them. Like the
+		signal_count of event, this keeps a waiter from missing
+		a wake-up that was sent after it set waiters but before
+		it went to sleep, even if another thread has set waiters
+		again in the meantime.
+		The next writer sleeps on lock_word while it has the value
+		that the writer last saw, following the rules for
+		wait_ex_event above. lock_word cannot return to an earlier
+		value while the readers exit, so the wake-up sent by the last
+		reader cannot be missed.
 */
 
 rw_lock_stats_t		rw_lock_stats;
@@ -216,6 +234,9 @@ rw_lock_create_func(
 
 	lock->lock_word = X_LOCK_DECR;
 	lock->waiters = 0;
+#ifdef HAVE_IB_LINUX_FUTEX
+	lock->waiters_seq = 0;
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 	lock->sx_recursive = 0;
 	lock->writer_thread= 0;
@@ -302,7 +323,11 @@ rw_lock_s_lock_spin(
 	unsigned	line)	/*!< in: line where requested */
 {
 	ulint		i = 0;	/* spin round count */
+#ifdef HAVE_IB_LINUX_FUTEX
+	sync_futex_waiter_t	waiter(lock, RW_LOCK_S, file_name, line);
+#else
 	sync_array_t*	sync_arr;
+#endif /* HAVE_IB_LINUX_FUTEX */
 	ulint		spin_count = 0;
 	uint64_t	count_os_wait = 0;
 
@@ -351,10 +376,17 @@ rw_lock_s_lock_spin(
 
 		++count_os_wait;
 
+#ifndef HAVE_IB_LINUX_FUTEX
 		sync_cell_t*	cell;
 
 		sync_arr = sync_array_get_and_reserve_cell(
 				lock, RW_LOCK_S, file_name, line, &cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
+
+#ifdef HAVE_IB_LINUX_FUTEX
+		const int32	seq = my_atomic_load32(
+			rw_lock_waiters_futex(lock));
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 		/* Set waiters before checking lock_word to ensure wake-up
 		signal is sent. This may lead to some unnecessary signals. */
@@ -362,7 +394,9 @@ rw_lock_s_lock_spin(
 
 		if (rw_lock_s_lock_low(lock, pass, file_name, line)) {
 
+#ifndef HAVE_IB_LINUX_FUTEX
 			sync_array_free_cell(sync_arr, cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
 
 			if (count_os_wait > 0) {
 
@@ -388,7 +422,11 @@ rw_lock_s_lock_spin(
 		}
 #endif
 #endif
+#ifdef HAVE_IB_LINUX_FUTEX
+		waiter.wait(rw_lock_waiters_futex(lock), seq);
+#else
 		sync_array_wait_event(sync_arr, cell);
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 		i = 0;
 
@@ -433,7 +471,11 @@ rw_lock_x_lock_wait_func(
 {
 	ulint		i = 0;
 	ulint		n_spins = 0;
+#ifdef HAVE_IB_LINUX_FUTEX
+	sync_futex_waiter_t	waiter(lock, RW_LOCK_X_WAIT, file_name, line);
+#else
 	sync_array_t*	sync_arr;
+#endif /* HAVE_IB_LINUX_FUTEX */
 	uint64_t	count_os_wait = 0;
 
 	ut_ad(lock->lock_word <= threshold);
@@ -455,15 +497,19 @@ rw_lock_x_lock_wait_func(
 		/* If there is still a reader, then go to sleep.*/
 		++n_spins;
 
+#ifndef HAVE_IB_LINUX_FUTEX
 		sync_cell_t*	cell;
 
 		sync_arr = sync_array_get_and_reserve_cell(
 			lock, RW_LOCK_X_WAIT, file_name, line, &cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
+
+		const lint	lock_word = lock->lock_word;
 
 		i = 0;
 
 		/* Check lock_word to ensure wake-up isn't missed.*/
-		if (lock->lock_word < threshold) {
+		if (lock_word < threshold) {
 
 			++count_os_wait;
 
@@ -474,7 +520,12 @@ rw_lock_x_lock_wait_func(
 					lock, pass, RW_LOCK_X_WAIT,
 					file_name, line));
 
+#ifdef HAVE_IB_LINUX_FUTEX
+			waiter.wait(rw_lock_word_futex(lock),
+				    static_cast<int32>(lock_word));
+#else
 			sync_array_wait_event(sync_arr, cell);
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 			ut_d(rw_lock_remove_debug_info(
 					lock, pass, RW_LOCK_X_WAIT));
@@ -483,7 +534,9 @@ rw_lock_x_lock_wait_func(
 			We must pass the while-loop check to proceed.*/
 
 		} else {
+#ifndef HAVE_IB_LINUX_FUTEX
 			sync_array_free_cell(sync_arr, cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
 			break;
 		}
 		HMT_low();
@@ -680,7 +733,11 @@ rw_lock_x_lock_func(
 	unsigned	line)	/*!< in: line where requested */
 {
 	ulint		i = 0;
+#ifdef HAVE_IB_LINUX_FUTEX
+	sync_futex_waiter_t	waiter(lock, RW_LOCK_X, file_name, line);
+#else
 	sync_array_t*	sync_arr;
+#endif /* HAVE_IB_LINUX_FUTEX */
 	ulint		spin_count = 0;
 	uint64_t	count_os_wait = 0;
 
@@ -730,17 +787,25 @@ rw_lock_x_lock_func(
 		}
 	}
 
+#ifndef HAVE_IB_LINUX_FUTEX
 	sync_cell_t*	cell;
 
 	sync_arr = sync_array_get_and_reserve_cell(
 			lock, RW_LOCK_X, file_name, line, &cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
+
+#ifdef HAVE_IB_LINUX_FUTEX
+	const int32	seq = my_atomic_load32(rw_lock_waiters_futex(lock));
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 	/* Waiters must be set before checking lock_word, to ensure signal
 	is sent. This could lead to a few unnecessary wake-up signals. */
 	my_atomic_fas32((int32*) &lock->waiters, 1);
 
 	if (rw_lock_x_lock_low(lock, pass, file_name, line)) {
+#ifndef HAVE_IB_LINUX_FUTEX
 		sync_array_free_cell(sync_arr, cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
 
 		if (count_os_wait > 0) {
 			lock->count_os_wait +=
@@ -756,7 +821,11 @@ rw_lock_x_lock_func(
 
 	++count_os_wait;
 
+#ifdef HAVE_IB_LINUX_FUTEX
+	waiter.wait(rw_lock_waiters_futex(lock), seq);
+#else
 	sync_array_wait_event(sync_arr, cell);
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 	i = 0;
 
@@ -783,7 +852,11 @@ rw_lock_sx_lock_func(
 
 {
 	ulint		i = 0;
+#ifdef HAVE_IB_LINUX_FUTEX
+	sync_futex_waiter_t	waiter(lock, RW_LOCK_SX, file_name, line);
+#else
 	sync_array_t*	sync_arr;
+#endif /* HAVE_IB_LINUX_FUTEX */
 	ulint		spin_count = 0;
 	uint64_t	count_os_wait = 0;
 	ulint		spin_wait_count = 0;
@@ -835,10 +908,16 @@ rw_lock_sx_lock_func(
 		}
 	}
 
+#ifndef HAVE_IB_LINUX_FUTEX
 	sync_cell_t*	cell;
 
 	sync_arr = sync_array_get_and_reserve_cell(
 			lock, RW_LOCK_SX, file_name, line, &cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
+
+#ifdef HAVE_IB_LINUX_FUTEX
+	const int32	seq = my_atomic_load32(rw_lock_waiters_futex(lock));
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 	/* Waiters must be set before checking lock_word, to ensure signal
 	is sent. This could lead to a few unnecessary wake-up signals. */
@@ -846,7 +925,9 @@ rw_lock_sx_lock_func(
 
 	if (rw_lock_sx_lock_low(lock, pass, file_name, line)) {
 
+#ifndef HAVE_IB_LINUX_FUTEX
 		sync_array_free_cell(sync_arr, cell);
+#endif /* !HAVE_IB_LINUX_FUTEX */
 
 		if (count_os_wait > 0) {
 			lock->count_os_wait +=
@@ -863,7 +944,11 @@ rw_lock_sx_lock_func(
 
 	++count_os_wait;
 
+#ifdef HAVE_IB_LINUX_FUTEX
+	waiter.wait(rw_lock_waiters_futex(lock), seq);
+#else
 	sync_array_wait_event(sync_arr, cell);
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 	i = 0;
 
@@ -202,7 +202,7 @@ purge_sys_t::purge_sys_t()
 	: sess(sess_open()), latch(), event(os_event_create(0)),
 	  n_stop(0), running(false), state(PURGE_STATE_INIT),
 	  query(trx_purge_graph_build(sess)),
-	  view(), n_submitted(0), n_completed(0),
+	  heap(mem_heap_create(4096)), view(), n_submitted(0), n_completed(0),
 	  iter(), limit(),
 #ifdef UNIV_DEBUG
 	  done(),
@@ -222,6 +222,7 @@ purge_sys_t::~purge_sys_t()
 	ut_ad(this == purge_sys);
 
 	que_graph_free(query);
+	mem_heap_free(heap);
 	ut_a(sess->trx->id == 0);
 	sess->trx->state = TRX_STATE_NOT_STARTED;
 	sess_close(sess);
@@ -1446,6 +1447,22 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Purge node of a table in a purge batch */
+struct purge_table_node_t {
+	/** purge node which is given the records of the table */
+	purge_node_t*	node;
+	/** number of records of the table given to the node */
+	ulint		n_recs;
+};
+
+/** Assignment of the tables of a purge batch to purge nodes */
+typedef std::map<
+	table_id_t,
+	purge_table_node_t,
+	std::less<table_id_t>,
+	ut_allocator<std::pair<const table_id_t, purge_table_node_t> > >
+	purge_table_node_map_t;
+
 /*******************************************************************//**
 This function runs a purge batch.
 @return number of undo log pages handled in the batch */
@@ -1488,26 +1505,31 @@ trx_purge_attach_undo_recs(
 	ut_a(i == n_purge_threads);
 
 	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
+	to a per purge node vector. The records of a table within the
+	batch are assigned to the same purge node, so that the workers
+	do not contend for the same index pages and table latches.
+	Tables are distributed round-robin among the nodes. A table
+	moves to the next node after n_table_recs records, so that a
+	single hot table is still purged by all the threads. */
 	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
 	ut_a(n_thrs > 0 && thr != NULL);
 
 	ut_ad(trx_purge_check_limit());
 
+	/* The copies of the undo log records of the previous batch
+	are no longer needed: all workers have completed. */
+	mem_heap_empty(purge_sys->heap);
+
+	purge_table_node_map_t	table_node_map;
+	const ulint		n_table_recs = ut_max(
+		batch_size / n_purge_threads, ulint(1));
+	ulint			n_nodes_used = 0;
+
 	i = 0;
 
 	for (;;) {
 		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_purge_rec_t		purge_rec;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1517,39 +1539,69 @@ trx_purge_attach_undo_recs(
 		}
 
 		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled,
+			purge_sys->heap);
 
-		if (purge_rec->undo_rec != NULL) {
+		if (purge_rec.undo_rec == NULL) {
+			break;
+		}
 
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
+		if (purge_rec.undo_rec == &trx_purge_dummy_rec) {
+			/* Nothing to purge in the indexes; any node
+			will do. */
+			node = static_cast<purge_node_t*>(thr->child);
+		} else {
+			purge_table_node_t&	table_node = table_node_map[
+				trx_undo_rec_get_table_id(purge_rec.undo_rec)];
+
+			if (table_node.node == NULL
+			    || table_node.n_recs == n_table_recs) {
+				/* First record of this table in the
+				batch, or the node has its share of the
+				table: assign the table to the next node. */
+				table_node.node = static_cast<purge_node_t*>(
+					thr->child);
+				table_node.n_recs = 0;
+
+				thr = UT_LIST_GET_NEXT(thrs, thr);
+
+				if (!(++i % n_purge_threads)) {
+					thr = UT_LIST_GET_FIRST(
+						purge_sys->query->thrs);
+				}
+
+				ut_a(thr != NULL);
 			}
 
-			ib_vector_push(node->undo_recs, purge_rec);
+			table_node.n_recs++;
+			node = table_node.node;
+		}
 
-			if (n_pages_handled >= batch_size) {
+		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
 
-				break;
-			}
+		if (node->undo_recs == NULL) {
+			n_nodes_used++;
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
 		} else {
-			break;
+			ut_a(!ib_vector_is_empty(node->undo_recs));
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		ib_vector_push(node->undo_recs, &purge_rec);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
-		}
+		if (n_pages_handled >= batch_size) {
 
-		ut_a(thr != NULL);
+			break;
+		}
 	}
 
+	MONITOR_INC_VALUE(MONITOR_PURGE_N_TABLES_BATCHED,
+			  table_node_map.size());
+	MONITOR_INC_VALUE(MONITOR_PURGE_N_NODES_USED, n_nodes_used);
+
 	ut_ad(trx_purge_check_limit());
 
 	return(n_pages_handled);
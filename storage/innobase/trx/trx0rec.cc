@@ -451,7 +451,8 @@ trx_undo_report_insert_virtual(
 }
 
 /**********************************************************************//**
-Reports in the undo log of an insert of a clustered index record.
+Reports in the undo log of an insert of a clustered index record,
+or of a bulk insert into an empty table.
 @return offset of the inserted entry on the page if succeed, 0 if fail */
 static
 ulint
@@ -461,7 +462,8 @@ trx_undo_page_report_insert(
 	trx_t*		trx,		/*!< in: transaction */
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: index entry which will be
-					inserted to the clustered index */
+					inserted to the clustered index,
+					or NULL for TRX_UNDO_EMPTY */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	ulint		first_free;
@@ -489,9 +491,16 @@ trx_undo_page_report_insert(
 	ptr += 2;
 
 	/* Store first some general parameters to the undo log */
-	*ptr++ = TRX_UNDO_INSERT_REC;
+	*ptr++ = clust_entry ? TRX_UNDO_INSERT_REC : TRX_UNDO_EMPTY;
 	ptr += mach_u64_write_much_compressed(ptr, trx->undo_no);
 	ptr += mach_u64_write_much_compressed(ptr, index->table->id);
+
+	if (clust_entry == NULL) {
+		/* The table was empty; rollback will empty it again. */
+		return(trx_undo_page_set_next_prev_and_add(
+			       undo_page, ptr, mtr));
+	}
+
 	/*----------------------------------------*/
 	/* Store then the fields required to uniquely determine the record
 	to be inserted in the clustered index */
@@ -1893,7 +1902,9 @@ trx_undo_report_row_operation(
 	dict_index_t*	index,		/*!< in: clustered index */
 	const dtuple_t*	clust_entry,	/*!< in: in the case of an insert,
 					index entry to insert into the
-					clustered index; in updates,
+					clustered index, or NULL for a
+					bulk insert into an empty table
+					(TRX_UNDO_EMPTY); in updates,
 					may contain a clustered index
 					record tuple that also contains
 					virtual columns of the table;
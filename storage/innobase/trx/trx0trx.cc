@@ -732,6 +732,7 @@ trx_resurrect_table_locks(
 	page_t*			undo_page;
 	trx_undo_rec_t*		undo_rec;
 	table_id_set		tables;
+	table_id_set		x_tables;
 
 	ut_ad(undo == undo_ptr->insert_undo || undo == undo_ptr->update_undo);
 
@@ -768,6 +769,12 @@ trx_resurrect_table_locks(
 			&updated_extern, &undo_no, &table_id);
 		tables.insert(table_id);
 
+		if (type == TRX_UNDO_EMPTY) {
+			/* A bulk insert into an empty table was
+			covered by an exclusive table lock. */
+			x_tables.insert(table_id);
+		}
+
 		undo_rec = trx_undo_get_prev_rec(
 			undo_rec, undo->hdr_page_no,
 			undo->hdr_offset, false, &mtr);
@@ -790,13 +797,16 @@ trx_resurrect_table_locks(
 			if (trx->state == TRX_STATE_PREPARED) {
 				trx->mod_tables.insert(table);
 			}
-			lock_table_ix_resurrect(table, trx);
+			const bool	x = x_tables.find(*i)
+				!= x_tables.end();
+
+			lock_table_resurrect(table, trx, x ? LOCK_X : LOCK_IX);
 
 			DBUG_PRINT("ib_trx",
 				   ("resurrect" TRX_ID_FMT
-				    "  table '%s' IX lock from %s undo",
+				    "  table '%s' %s lock from %s undo",
 				    trx_get_id_for_print(trx),
-				    table->name.m_name,
+				    table->name.m_name, x ? "X" : "IX",
 				    undo == undo_ptr->insert_undo
 				    ? "insert" : "update"));
 
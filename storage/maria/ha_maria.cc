@@ -58,6 +58,7 @@ C_MODE_END
 #define THD_TRN (*(TRN **)thd_ha_data(thd, maria_hton))
 
 ulong pagecache_division_limit, pagecache_age_threshold, pagecache_file_hash_size;
+ulong pagecache_partitions;
 ulonglong pagecache_buffer_size;
 const char *zerofill_error_msg=
   "Table is from another system and must be zerofilled or repaired to be "
@@ -255,6 +256,14 @@ static MYSQL_SYSVAR_ULONG(pagecache_file_hash_size, pagecache_file_hash_size,
        "value is probably 1/10 of number of possible open Aria files.", 0,0,
        512, 128, 16384, 1);
 
+static MYSQL_SYSVAR_ULONG(pagecache_partitions, pagecache_partitions,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "Number of partitions of the Aria page cache. Every partition has its "
+       "own lock, LRU chain and list of changed blocks, which lowers the "
+       "contention between threads using Aria tables. 1 means that the page "
+       "cache is not partitioned.", 0, 0,
+       1, 1, 64, 1);
+
 static MYSQL_SYSVAR_SET(recover_options, maria_recover_options, PLUGIN_VAR_OPCMDARG,
        "Specifies how corrupted tables should be automatically repaired",
        NULL, NULL, HA_RECOVER_BACKUP|HA_RECOVER_QUICK, &maria_recover_typelib);
@@ -278,6 +287,16 @@ static MYSQL_SYSVAR_ENUM(sync_log_dir, sync_log_dir, PLUGIN_VAR_RQCMDARG,
        "creation", NULL, NULL, TRANSLOG_SYNC_DIR_NEWFILE,
        &maria_sync_log_dir_typelib);
 
+static MYSQL_SYSVAR_ULONGLONG(tmp_table_pagecache_size,
+       maria_tmp_table_pagecache_size, PLUGIN_VAR_RQCMDARG,
+       "If not 0, every internal temporary Aria table gets a page cache of "
+       "its own instead of using the page cache of all tables. The cache "
+       "grows with the table up to this size, but not beyond "
+       "tmp_disk_table_size, and is counted as memory of the session. "
+       "This keeps big temporary tables from evicting pages of other tables "
+       "and a temporary table that fits in its cache is never written to "
+       "disk.", 0, 0, 0, 0, ~(ulonglong) 0, 8192);
+
 #ifdef USE_ARIA_FOR_TMP_TABLES
 #define USE_ARIA_FOR_TMP_TABLES_VAL 1
 #else
@@ -325,6 +344,7 @@ static PSI_cond_info all_aria_conds[]=
   { &key_SHARE_key_del_cond, "SHARE::key_del_cond", 0},
   { &key_SERVICE_THREAD_CONTROL_cond, "SERVICE_THREAD_CONTROL::COND_control", 0},
   { &key_SORT_INFO_cond, "SORT_INFO::cond", 0},
+  { &key_SORT_INFO_row_cond, "SORT_INFO::row_cond", 0},
   { &key_SHARE_BITMAP_cond, "BITMAP::bitmap_cond", 0},
   { &key_TRANSLOG_BUFFER_waiting_filling_buffer, "TRANSLOG_BUFFER::waiting_filling_buffer", 0},
   { &key_TRANSLOG_BUFFER_prev_sent_to_disk_cond, "TRANSLOG_BUFFER::prev_sent_to_disk_cond", 0},
@@ -343,7 +363,8 @@ static PSI_thread_info all_aria_threads[]=
 {
   { &key_thread_checkpoint, "checkpoint_background", PSI_FLAG_GLOBAL},
   { &key_thread_soft_sync, "soft_sync_background", PSI_FLAG_GLOBAL},
-  { &key_thread_find_all_keys, "thr_find_all_keys", 0}
+  { &key_thread_find_all_keys, "thr_find_all_keys", 0},
+  { &key_thread_read_rows, "thr_read_rows", 0}
 };
 
 static PSI_file_info all_aria_files[]=
@@ -1648,9 +1669,7 @@ int ha_maria::repair(THD *thd, HA_CHECK *param, bool do_optimize)
       local_testflag |= T_STATISTICS;
       param->testflag |= T_STATISTICS;           // We get this for free
       statistics_done= 1;
-      /* TODO: Remove BLOCK_RECORD test when parallel works with blocks */
-      if (THDVAR(thd,repair_threads) > 1 &&
-          share->data_file_type != BLOCK_RECORD)
+      if (THDVAR(thd,repair_threads) > 1)
       {
         char buf[40];
         /* TODO: respect maria_repair_threads variable */
@@ -3594,6 +3613,7 @@ static int ha_maria_init(void *p)
   maria_hton->flags= HTON_CAN_RECREATE | HTON_SUPPORT_LOG_TABLES;
   bzero(maria_log_pagecache, sizeof(*maria_log_pagecache));
   maria_tmpdir= &mysql_tmpdir_list;             /* For REDO */
+  maria_pagecache->param_partitions= (uint) pagecache_partitions;
   res= maria_upgrade() || maria_init() || ma_control_file_open(TRUE, TRUE) ||
     ((force_start_after_recovery_failures != 0) &&
      mark_recovery_start(log_dir)) ||
@@ -3716,11 +3736,13 @@ struct st_mysql_sys_var* system_variables[]= {
   MYSQL_SYSVAR(pagecache_buffer_size),
   MYSQL_SYSVAR(pagecache_division_limit),
   MYSQL_SYSVAR(pagecache_file_hash_size),
+  MYSQL_SYSVAR(pagecache_partitions),
   MYSQL_SYSVAR(recover_options),
   MYSQL_SYSVAR(repair_threads),
   MYSQL_SYSVAR(sort_buffer_size),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(sync_log_dir),
+  MYSQL_SYSVAR(tmp_table_pagecache_size),
   MYSQL_SYSVAR(used_for_temp_tables),
   MYSQL_SYSVAR(encrypt_tables),
   NULL
@@ -3840,14 +3862,32 @@ static void update_log_file_size(MYSQL_THD thd,
 }
 
 
+static SHOW_VAR pagecache_status_variables[]= {
+  {"blocks_not_flushed", (char*) &maria_pagecache_var.global_blocks_changed, SHOW_LONG},
+  {"blocks_unused",      (char*) &maria_pagecache_var.blocks_unused, SHOW_LONG},
+  {"blocks_used",        (char*) &maria_pagecache_var.blocks_used, SHOW_LONG},
+  {"read_requests",      (char*) &maria_pagecache_var.global_cache_r_requests, SHOW_LONGLONG},
+  {"reads",              (char*) &maria_pagecache_var.global_cache_read, SHOW_LONGLONG},
+  {"write_requests",     (char*) &maria_pagecache_var.global_cache_w_requests, SHOW_LONGLONG},
+  {"writes",             (char*) &maria_pagecache_var.global_cache_write, SHOW_LONGLONG},
+  {NullS, NullS, SHOW_LONG}
+};
+
+/* The statistics of a partitioned page cache are summed when shown */
+static int show_pagecache_vars(THD *thd, SHOW_VAR *var, char *buff)
+{
+  pagecache_update_stats(maria_pagecache);
+  var->type= SHOW_ARRAY;
+  var->value= (char*) pagecache_status_variables;
+  return 0;
+}
+
 SHOW_VAR status_variables[]= {
-  {"pagecache_blocks_not_flushed", (char*) &maria_pagecache_var.global_blocks_changed, SHOW_LONG},
-  {"pagecache_blocks_unused",      (char*) &maria_pagecache_var.blocks_unused, SHOW_LONG},
-  {"pagecache_blocks_used",        (char*) &maria_pagecache_var.blocks_used, SHOW_LONG},
-  {"pagecache_read_requests",      (char*) &maria_pagecache_var.global_cache_r_requests, SHOW_LONGLONG},
-  {"pagecache_reads",              (char*) &maria_pagecache_var.global_cache_read, SHOW_LONGLONG},
-  {"pagecache_write_requests",     (char*) &maria_pagecache_var.global_cache_w_requests, SHOW_LONGLONG},
-  {"pagecache_writes",             (char*) &maria_pagecache_var.global_cache_write, SHOW_LONGLONG},
+  {"pagecache",                    (char*) &show_pagecache_vars, SHOW_FUNC},
+  {"transaction_log_group_commit_followers",
+   (char*) &translog_group_commit_followers, SHOW_LONGLONG},
+  {"transaction_log_group_commits", (char*) &translog_group_commits,
+   SHOW_LONGLONG},
   {"transaction_log_syncs",        (char*) &translog_syncs, SHOW_LONGLONG},
   {NullS, NullS, SHOW_LONG}
 };
@@ -84,6 +84,10 @@ static int sort_delete_record(MARIA_SORT_PARAM *sort_param);
 /*static int _ma_flush_pending_blocks(HA_CHECK *param);*/
 static SORT_KEY_BLOCKS	*alloc_key_blocks(HA_CHECK *param, uint blocks,
 					  uint buffer_length);
+static SORT_ROW_BATCH *alloc_row_batches(HA_CHECK *param);
+static void free_row_batches(SORT_ROW_BATCH *batch);
+static pthread_handler_t _ma_thr_read_rows(void *arg);
+static int sort_get_next_row(MARIA_SORT_PARAM *sort_param);
 static ha_checksum maria_byte_checksum(const uchar *buf, uint length);
 static void set_data_file_type(MARIA_SORT_INFO *sort_info, MARIA_SHARE *share);
 static void restore_data_file_type(MARIA_SHARE *share);
@@ -3733,12 +3737,12 @@ int maria_repair_by_sort(HA_CHECK *param, register MARIA_HA *info,
     }
   }
 
-  if (!(sort_info.key_block=
+  if (!(sort_param.key_block=
 	alloc_key_blocks(param,
 			 (uint) param->sort_key_blocks,
 			 share->base.max_key_block_length)))
     goto err;
-  sort_info.key_block_end=sort_info.key_block+param->sort_key_blocks;
+  sort_param.key_block_end=sort_param.key_block+param->sort_key_blocks;
 
   if (share->data_file_type != BLOCK_RECORD)
   {
@@ -4139,7 +4143,7 @@ int maria_repair_by_sort(HA_CHECK *param, register MARIA_HA *info,
 
   my_free(sort_param.rec_buff);
   my_free(sort_param.record);
-  my_free(sort_info.key_block);
+  my_free(sort_param.key_block);
   my_free(sort_info.ft_buf);
   my_free(sort_info.buff);
   DBUG_RETURN(got_error);
@@ -4161,27 +4165,14 @@ int maria_repair_by_sort(HA_CHECK *param, register MARIA_HA *info,
     Each key is handled by a separate thread.
     TODO: make a number of threads a parameter
 
-    In parallel repair we use one thread per index. There are two modes:
-
-    Quick
-
-      Only the indexes are rebuilt. All threads share a read buffer.
-      Every thread that needs fresh data in the buffer enters the shared
-      cache lock. The last thread joining the lock reads the buffer from
-      the data file and wakes all other threads.
-
-    Non-quick
-
-      The data file is rebuilt and all indexes are rebuilt to point to
-      the new record positions. One thread is the master thread. It
-      reads from the old data file and writes to the new data file. It
-      also creates one of the indexes. The other threads read from a
-      buffer which is filled by the master. If they need fresh data,
-      they enter the shared cache lock. If the masters write buffer is
-      full, it flushes it to the new data file and enters the shared
-      cache lock too. When all threads joined in the lock, the master
-      copies its write buffer to the read buffer for the other threads
-      and wakes them.
+    In parallel repair we use one thread per index and one reader
+    thread. The reader thread reads and unpacks every row once and,
+    in non-quick mode, writes it to the new data file. It passes the
+    rows with their new positions in batches to the index threads
+    (see _ma_thr_read_rows()), which make and sort the keys, merge
+    their sort files and write their indexes. Only the fulltext
+    indexes, which share sort_info->ft_buf, are written afterwards,
+    one at a time, by _ma_thr_write_keys().
 
   RESULT
     0	ok
@@ -4196,20 +4187,18 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
   ha_rows start_records;
   my_off_t new_header_length,del;
   File new_file;
-  MARIA_SORT_PARAM *sort_param=0, tmp_sort_param;
+  MARIA_SORT_PARAM *sort_param=0, *read_param=0, tmp_sort_param;
   MARIA_SHARE *share= info->s;
   double  *rec_per_key_part;
   HA_KEYSEG *keyseg;
   char llbuff[22];
-  IO_CACHE new_data_cache; /* For non-quick repair. */
-  IO_CACHE_SHARE io_share;
   MARIA_SORT_INFO sort_info;
   MARIA_SHARE backup_share;
   ulonglong UNINIT_VAR(key_map);
   pthread_attr_t thr_attr;
   myf sync_dir= ((share->now_transactional && !share->temporary) ?
                  MY_SYNC_DIR : 0);
-  my_bool reenable_logging= 0;
+  my_bool reenable_logging= 0, scan_inited= 0, new_data_handle;
   DBUG_ENTER("maria_repair_parallel");
 
   got_error= 1;
@@ -4221,7 +4210,6 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     printf("Data records: %s\n", llstr(start_records, llbuff));
   }
 
-  bzero(&new_data_cache, sizeof(new_data_cache));
   if (initialize_variables_for_repair(param, &sort_info, &tmp_sort_param, info,
                                       rep_quick, &backup_share))
     goto err;
@@ -4233,52 +4221,26 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
                       share->pack.header_length);
 
   /*
-    Quick repair (not touching data file, rebuilding indexes):
-    {
-      Read cache is (HA_CHECK *param)->read_cache using info->dfile.file.
-    }
-
-    Non-quick repair (rebuilding data file and indexes):
-    {
-      Master thread:
-
-        Read  cache is (HA_CHECK *param)->read_cache using info->dfile.file.
-        Write cache is (MARIA_INFO *info)->rec_cache using new_file.
-
-      Slave threads:
-
-        Read cache is new_data_cache synced to master rec_cache.
-
-      The final assignment of the filedescriptor for rec_cache is done
-      after the cache creation.
-
-      Don't check file size on new_data_cache, as the resulting file size
-      is not known yet.
-
-      As rec_cache and new_data_cache are synced, write_buffer_length is
-      used for the read cache 'new_data_cache'. Both start at the same
-      position 'new_header_length'.
-    }
+    Only the reader thread uses the data file. It reads with
+    param->read_cache, or with maria_scan() for BLOCK_RECORD. In
+    non-quick repair it writes the new data file with info->rec_cache,
+    or through a new handler if the new file has BLOCK_RECORD format.
   */
   DBUG_PRINT("info", ("is quick repair: %d", (int) rep_quick));
-  if (!rep_quick)
-    my_b_clear(&new_data_cache);
+  new_data_handle= (!rep_quick &&
+                    sort_info.new_data_file_type == BLOCK_RECORD);
 
   /* Initialize pthread structures before goto err. */
   mysql_mutex_init(key_SORT_INFO_mutex, &sort_info.mutex, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_SORT_INFO_cond, &sort_info.cond, 0);
+  mysql_cond_init(key_SORT_INFO_row_cond, &sort_info.row_cond, 0);
 
-  if (!(sort_info.key_block=
-	alloc_key_blocks(param, (uint) param->sort_key_blocks,
-			 share->base.max_key_block_length)))
-    goto err;
-
-  if (init_io_cache(&param->read_cache, info->dfile.file,
+  if (sort_info.org_data_file_type != BLOCK_RECORD &&
+      init_io_cache(&param->read_cache, info->dfile.file,
                     (uint) param->read_buffer_length,
                     READ_CACHE, share->pack.header_length, 1, MYF(MY_WME)))
     goto err;
 
-  sort_info.key_block_end=sort_info.key_block+param->sort_key_blocks;
   info->opt_flag|=WRITE_CACHE_USED;
   info->rec_cache.file= info->dfile.file;         /* for sort_delete_record */
 
@@ -4301,22 +4263,18 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
         maria_filecopy(param, new_file, info->dfile.file,0L,new_header_length,
                        "datafile-header"))
       goto err;
-    if (param->testflag & T_UNPACK)
-      restore_data_file_type(share);
     share->state.dellink= HA_OFFSET_ERROR;
 
-    if (init_io_cache(&new_data_cache, -1,
-                        (uint) param->write_buffer_length,
-                        READ_CACHE, new_header_length, 1,
-                        MYF(MY_WME | MY_DONT_CHECK_FILESIZE)))
-      goto err;
-
-    if (init_io_cache(&info->rec_cache, new_file,
+    if (!new_data_handle)
+    {
+      if (param->testflag & T_UNPACK)
+        restore_data_file_type(share);
+      if (init_io_cache(&info->rec_cache, new_file,
                         (uint) param->write_buffer_length,
                         WRITE_CACHE, new_header_length, 1,
                         MYF(MY_WME | MY_WAIT_IF_FULL) & param->myf_rw))
-      goto err;
-
+        goto err;
+    }
   }
 
   /* Optionally drop indexes and optionally modify the key_map. */
@@ -4330,30 +4288,18 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
 
   param->read_cache.end_of_file= sort_info.filelength;
 
-  /*
-    +1 below is required hack for parallel repair mode.
-    The share->state.state.records value, that is compared later
-    to sort_info.max_records and cannot exceed it, is
-    increased in sort_key_write. In maria_repair_by_sort, sort_key_write
-    is called after sort_key_read, where the comparison is performed,
-    but in parallel mode master thread can call sort_key_write
-    before some other repair thread calls sort_key_read.
-    Furthermore I'm not even sure +1 would be enough.
-    May be sort_info.max_records shold be always set to max value in
-    parallel mode.
-  */
-  sort_info.max_records++;
-
   del=share->state.state.del;
 
+  /* One MARIA_SORT_PARAM for each key and one for the reader thread */
   if (!(sort_param=(MARIA_SORT_PARAM *)
-        my_malloc((uint) share->base.keys *
+        my_malloc((uint) (share->base.keys + 1) *
 		  (sizeof(MARIA_SORT_PARAM) + share->base.pack_reclength),
 		  MYF(MY_ZEROFILL))))
   {
     _ma_check_print_error(param,"Not enough memory for key!");
     goto err;
   }
+  read_param= sort_param + share->base.keys;
   total_key_length=0;
   rec_per_key_part= param->new_rec_per_key_part;
   share->state.state.records=share->state.state.del=share->state.split=0;
@@ -4382,6 +4328,13 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     istep=1;
     if ((!(param->testflag & T_SILENT)))
       printf ("- Fixing index %d\n",key+1);
+    /* Each key thread writes its own index pages */
+    if (!(sort_param[i].key_block=
+          alloc_key_blocks(param, (uint) param->sort_key_blocks,
+                           share->base.max_key_block_length)))
+      goto err;
+    sort_param[i].key_block_end= (sort_param[i].key_block +
+                                  param->sort_key_blocks);
     if (sort_param[i].keyinfo->flag & HA_FULLTEXT)
     {
       sort_param[i].key_read=sort_maria_ft_key_read;
@@ -4403,7 +4356,7 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     sort_param[i].filepos=new_header_length;
     sort_param[i].max_pos=sort_param[i].pos=share->pack.header_length;
 
-    sort_param[i].record= (((uchar *)(sort_param+share->base.keys))+
+    sort_param[i].record= (((uchar *)(sort_param+share->base.keys+1))+
                           (share->base.pack_reclength * i));
     if (_ma_alloc_buffer(&sort_param[i].rec_buff, &sort_param[i].rec_buff_size,
                          share->base.default_rec_buff_size))
@@ -4436,50 +4389,50 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     }
   }
   sort_info.total_keys=i;
-  sort_param[0].master= 1;
-  sort_param[0].fix_datafile= ! rep_quick;
-  sort_param[0].calc_checksum= MY_TEST(param->testflag & T_CALC_CHECKSUM);
+
+  read_param->sort_info= &sort_info;
+  read_param->master= 1;
+  read_param->fix_datafile= ! rep_quick;
+  read_param->calc_checksum= MY_TEST(param->testflag & T_CALC_CHECKSUM);
+  read_param->filepos= new_header_length;
+  read_param->max_pos= read_param->pos= share->pack.header_length;
+  read_param->record= (((uchar *)(sort_param+share->base.keys+1))+
+                       (share->base.pack_reclength * share->base.keys));
+  read_param->read_cache= param->read_cache;
+  if (_ma_alloc_buffer(&read_param->rec_buff, &read_param->rec_buff_size,
+                       share->base.default_rec_buff_size))
+  {
+    _ma_check_print_error(param,"Not enough memory!");
+    goto err;
+  }
+  if (new_data_handle)
+  {
+    /* Sets read_param->filepos after the bitmap page */
+    if (create_new_data_handle(read_param, new_file))
+      goto err;
+    sort_info.new_info->rec_cache.file= new_file;
+  }
+  if (!(sort_info.row_batch= alloc_row_batches(param)))
+    goto err;
+  if (sort_info.org_data_file_type == BLOCK_RECORD)
+  {
+    if (maria_scan_init(info))
+      goto err;
+    scan_inited= 1;
+  }
 
   if (!maria_ftparser_alloc_param(info))
     goto err;
 
   sort_info.got_error=0;
+  sort_info.row_readers= sort_info.total_keys;
   mysql_mutex_lock(&sort_info.mutex);
 
-  /*
-    Initialize the I/O cache share for use with the read caches and, in
-    case of non-quick repair, the write cache. When all threads join on
-    the cache lock, the writer copies the write cache contents to the
-    read caches.
-  */
-  if (i > 1)
-  {
-    if (rep_quick)
-      init_io_cache_share(&param->read_cache, &io_share, NULL, i);
-    else
-      init_io_cache_share(&new_data_cache, &io_share, &info->rec_cache, i);
-  }
-  else
-    io_share.total_threads= 0; /* share not used */
-
   (void) pthread_attr_init(&thr_attr);
   (void) pthread_attr_setdetachstate(&thr_attr,PTHREAD_CREATE_DETACHED);
 
   for (i=0 ; i < sort_info.total_keys ; i++)
   {
-    /*
-      Copy the properly initialized IO_CACHE structure so that every
-      thread has its own copy. In quick mode param->read_cache is shared
-      for use by all threads. In non-quick mode all threads but the
-      first copy the shared new_data_cache, which is synchronized to the
-      write cache of the first thread. The first thread copies
-      param->read_cache, which is not shared.
-    */
-    sort_param[i].read_cache= ((rep_quick || !i) ? param->read_cache :
-                               new_data_cache);
-    DBUG_PRINT("io_cache_share", ("thread: %u  read_cache: %p",
-                                  i, &sort_param[i].read_cache));
-
     /*
       two approaches: the same amount of memory for each thread
       or the memory for the same number of keys for each thread...
@@ -4497,21 +4450,33 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
 	                    _ma_thr_find_all_keys, (void *) (sort_param+i)))
     {
       _ma_check_print_error(param,"Cannot start a repair thread");
-      /* Cleanup: Detach from the share. Avoid others to be blocked. */
-      if (io_share.total_threads)
-        remove_io_thread(&sort_param[i].read_cache);
       DBUG_PRINT("error", ("Cannot start a repair thread"));
       sort_info.got_error=1;
     }
     else
       sort_info.threads_running++;
   }
+  if (mysql_thread_create(key_thread_read_rows,
+                          &read_param->thr, &thr_attr,
+                          _ma_thr_read_rows, (void *) read_param))
+  {
+    _ma_check_print_error(param,"Cannot start a repair thread");
+    sort_info.got_error=1;
+    mysql_cond_broadcast(&sort_info.row_cond);
+  }
+  else
+    sort_info.threads_running++;
   (void) pthread_attr_destroy(&thr_attr);
 
   /* waiting for all threads to finish */
   while (sort_info.threads_running)
     mysql_cond_wait(&sort_info.cond, &sort_info.mutex);
   mysql_mutex_unlock(&sort_info.mutex);
+  if (scan_inited)
+  {
+    scan_inited= 0;
+    maria_scan_end(info);
+  }
 
   if ((got_error= _ma_thr_write_keys(sort_param)))
   {
@@ -4523,15 +4488,14 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
   if (_ma_flush_table_files_before_swap(param, info))
     goto err;
 
-  if (sort_param[0].fix_datafile)
+  if (read_param->fix_datafile)
   {
     /*
       Append some nulls to the end of a memory mapped file. Destroy the
-      write cache. The master thread did already detach from the share
-      by remove_io_thread() in sort.c:thr_find_all_keys().
+      write cache.
     */
     if (maria_write_data_suffix(&sort_info,1) ||
-        end_io_cache(&info->rec_cache))
+        end_io_cache(&sort_info.new_info->rec_cache))
       goto err;
     if (param->testflag & T_SAFE_REPAIR)
     {
@@ -4547,19 +4511,49 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
         goto err;
       }
     }
-    share->state.state.data_file_length= sort_param->filepos;
     /* Only whole records */
     share->state.version= (ulong) time((time_t*) 0);
-    /*
-      Exchange the data file descriptor of the table, so that we use the
-      new file from now on.
-     */
-    mysql_file_close(info->dfile.file, MYF(0));
-    info->dfile.file= new_file;
-    share->pack.header_length=(ulong) new_header_length;
+    if (sort_info.new_info != info)
+    {
+      /* The rows were written through the new handler, as in repair_by_sort */
+      MARIA_STATE_INFO save_state;
+      sort_info.new_info->s->state.state.data_file_length= read_param->filepos;
+      save_state= sort_info.new_info->s->state;
+      if (maria_close(sort_info.new_info))
+      {
+        _ma_check_print_error(param, "Got error %d on close", my_errno);
+        goto err;
+      }
+      copy_data_file_state(&share->state, &save_state);
+      new_file= -1;
+      sort_info.new_info= info;
+      info->rec_cache.file= info->dfile.file;
+      change_data_file_descriptor(info, -1);
+      if (maria_change_to_newfile(share->data_file_name.str, MARIA_NAME_DEXT,
+                                  DATA_TMP_EXT, param->backup_time,
+                                  (param->testflag & T_BACKUP_DATA ?
+                                   MYF(MY_REDEL_MAKE_BACKUP): MYF(0)) |
+                                  sync_dir) ||
+          _ma_open_datafile(info, share))
+      {
+        _ma_check_print_error(param, "Couldn't change to new data file");
+        goto err;
+      }
+    }
+    else
+    {
+      share->state.state.data_file_length= read_param->filepos;
+      /*
+        Exchange the data file descriptor of the table, so that we use the
+        new file from now on.
+      */
+      mysql_file_close(info->dfile.file, MYF(0));
+      info->dfile.file= new_file;
+      share->pack.header_length=(ulong) new_header_length;
+    }
   }
   else
-    share->state.state.data_file_length=sort_param->max_pos;
+    share->state.state.data_file_length=read_param->max_pos;
 
   if (rep_quick && del+sort_info.dupp != share->state.state.del)
   {
@@ -4611,25 +4605,15 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     *info->state= *info->state_start= share->state.state;
 
 err:
+  if (scan_inited)
+    maria_scan_end(info);
   _ma_reset_state(info);
 
-  /*
-    Destroy the write cache. The master thread did already detach from
-    the share by remove_io_thread() or it was not yet started (if the
-    error happend before creating the thread).
-  */
+  /* Destroy the write cache */
   end_io_cache(&sort_info.new_info->rec_cache);
   end_io_cache(&param->read_cache);
   info->opt_flag&= ~(READ_CACHE_USED | WRITE_CACHE_USED);
   sort_info.new_info->opt_flag&= ~(READ_CACHE_USED | WRITE_CACHE_USED);
-  /*
-    Destroy the new data cache in case of non-quick repair. All slave
-    threads did either detach from the share by remove_io_thread()
-    already or they were not yet started (if the error happend before
-    creating the threads).
-  */
-  if (!rep_quick && my_b_inited(&new_data_cache))
-    end_io_cache(&new_data_cache);
   if (!got_error)
   {
     /* Replace the actual file with the temporary file */
@@ -4651,6 +4635,11 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     if (! param->error_printed)
       _ma_check_print_error(param,"%d when fixing table",my_errno);
     (void)_ma_flush_table_files_before_swap(param, info);
+    if (sort_info.new_info && sort_info.new_info != sort_info.info)
+    {
+      unuse_data_file_descriptor(sort_info.new_info);
+      maria_close(sort_info.new_info);
+    }
     if (new_file >= 0)
     {
       mysql_file_close(new_file,MYF(0));
@@ -4667,6 +4656,7 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
     share->state.changed&= ~(STATE_NOT_OPTIMIZED_ROWS | STATE_NOT_ZEROFILLED |
                              STATE_NOT_MOVABLE);
 
+  mysql_cond_destroy (&sort_info.row_cond);
   mysql_cond_destroy (&sort_info.cond);
   mysql_mutex_destroy(&sort_info.mutex);
 
@@ -4676,7 +4666,13 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
   restore_table_state_after_repair(info, &backup_share);
 
   my_free(sort_info.ft_buf);
-  my_free(sort_info.key_block);
+  free_row_batches(sort_info.row_batch);
+  if (read_param)
+  {
+    for (i= 0; i < share->base.keys; i++)
+      my_free(sort_param[i].key_block);
+    my_free(read_param->rec_buff);
+  }
   my_free(sort_param);
   my_free(sort_info.buff);
   if (!got_error && (param->testflag & T_UNPACK))
@@ -4684,6 +4680,242 @@ int maria_repair_parallel(HA_CHECK *param, register MARIA_HA *info,
   DBUG_RETURN(got_error);
 }
 
+/*
+  Get the length of a row in a batch of parallel repair
+
+  NOTES
+    A row is stored as the position that the keys point to, the
+    unpacked record and the data of the BLOBs of the record.
+*/
+
+static size_t sort_row_length(MARIA_SHARE *share, const uchar *record)
+{
+  size_t length= sizeof(my_off_t) + share->base.reclength;
+  MARIA_BLOB *blob, *end;
+
+  for (blob= share->blobs, end= blob + share->base.blobs; blob < end; blob++)
+    length+= _ma_calc_blob_length(blob->pack_length, record + blob->offset);
+  return ALIGN_SIZE(length);
+}
+
+
+/*
+  Wait until the next batch of parallel repair is read by all key threads
+
+  RETURN
+    The batch, or 0 if some thread got an error
+*/
+
+static SORT_ROW_BATCH *get_free_row_batch(MARIA_SORT_INFO *sort_info)
+{
+  SORT_ROW_BATCH *batch= (sort_info->row_batch +
+                          sort_info->row_batches_filled % SORT_ROW_BATCHES);
+
+  mysql_mutex_lock(&sort_info->mutex);
+  while (batch->readers && !sort_info->got_error)
+    mysql_cond_wait(&sort_info->row_cond, &sort_info->mutex);
+  mysql_mutex_unlock(&sort_info->mutex);
+  if (sort_info->got_error)
+    return 0;
+  batch->used= 0;
+  return batch;
+}
+
+
+	/* Give a filled batch of rows to the key threads */
+
+static void put_row_batch(MARIA_SORT_INFO *sort_info, SORT_ROW_BATCH *batch)
+{
+  mysql_mutex_lock(&sort_info->mutex);
+  batch->readers= sort_info->row_readers;
+  sort_info->row_batches_filled++;
+  mysql_cond_broadcast(&sort_info->row_cond);
+  mysql_mutex_unlock(&sort_info->mutex);
+}
+
+
+/*
+  Read all rows for the key threads of maria_repair_parallel()
+
+  SYNOPSIS
+    _ma_thr_read_rows()
+    arg                 MARIA_SORT_PARAM of the reader
+
+  NOTES
+    Each row is read and unpacked, and in non-quick repair written to the
+    new data file, by this thread only. The rows are passed in batches
+    to the key threads, which read them with sort_get_next_row(). When
+    all rows are read, or on error, sort_info->rows_eof is set.
+*/
+
+static pthread_handler_t _ma_thr_read_rows(void *arg)
+{
+  MARIA_SORT_PARAM *sort_param= (MARIA_SORT_PARAM*) arg;
+  MARIA_SORT_INFO *sort_info= sort_param->sort_info;
+  MARIA_HA *info= sort_info->info;
+  MARIA_SHARE *share= info->s;
+  SORT_ROW_BATCH *batch= 0;
+  int error;
+
+  if ((error= my_thread_init()))
+    goto end;
+
+  while (!(error= sort_info->got_error) &&
+         !(error= sort_get_next_record(sort_param)))
+  {
+    size_t length;
+    uchar *pos;
+    MARIA_BLOB *blob, *blob_end;
+
+    if (sort_info->new_info->s->state.state.records ==
+        sort_info->max_records)
+    {
+      _ma_check_print_error(sort_info->param,
+                            "Found too many records; Can't continue");
+      error= 1;
+      break;
+    }
+    /* Sets current_filepos to where the keys should point */
+    if ((error= _ma_sort_write_record(sort_param)))
+      break;
+
+    length= sort_row_length(share, sort_param->record);
+    if (batch && batch->used + length > batch->length)
+    {
+      put_row_batch(sort_info, batch);
+      batch= 0;
+    }
+    if (!batch && !(batch= get_free_row_batch(sort_info)))
+    {
+      error= 1;
+      break;
+    }
+    if (length > batch->length)
+    {
+      /* A row with big BLOBs */
+      if (!(pos= (uchar*) my_realloc(batch->buff, length, MYF(MY_WME))))
+      {
+        _ma_check_print_error(sort_info->param,"Not enough memory!");
+        error= 1;
+        break;
+      }
+      batch->buff= pos;
+      batch->length= length;
+    }
+
+    pos= batch->buff + batch->used;
+    memcpy(pos, &sort_param->current_filepos, sizeof(my_off_t));
+    pos+= sizeof(my_off_t);
+    memcpy(pos, sort_param->record, share->base.reclength);
+    pos+= share->base.reclength;
+    for (blob= share->blobs, blob_end= blob + share->base.blobs;
+         blob < blob_end;
+         blob++)
+    {
+      ulong blob_length= _ma_calc_blob_length(blob->pack_length,
+                                              sort_param->record +
+                                              blob->offset);
+      uchar *data;
+      memcpy(&data, sort_param->record + blob->offset + blob->pack_length,
+             sizeof(char*));
+      memcpy(pos, data, blob_length);
+      pos+= blob_length;
+    }
+    batch->used+= length;
+  }
+  if (batch && batch->used && error < 0)
+    put_row_batch(sort_info, batch);
+
+end:
+  mysql_mutex_lock(&sort_info->mutex);
+  if (error > 0)
+    sort_info->got_error= 1;
+  sort_info->rows_eof= 1;
+  mysql_cond_broadcast(&sort_info->row_cond);
+  if (!--sort_info->threads_running)
+    mysql_cond_signal(&sort_info->cond);
+  mysql_mutex_unlock(&sort_info->mutex);
+
+  my_thread_end();
+  return NULL;
+}
+
+
+/*
+  Get the next row read by _ma_thr_read_rows()
+
+  SYNOPSIS
+    sort_get_next_row()
+      sort_param                Information about and for the sort process
+
+  RETURN
+    -1          end of file
+    0           ok
+                sort_param->record contains the row, with BLOBs that
+                point into the batch
+                sort_param->current_filepos is the position of the row
+    > 0         error
+*/
+
+static int sort_get_next_row(MARIA_SORT_PARAM *sort_param)
+{
+  MARIA_SORT_INFO *sort_info= sort_param->sort_info;
+  MARIA_SHARE *share= sort_info->info->s;
+  MARIA_BLOB *blob, *blob_end;
+  uchar *pos;
+
+  if (sort_param->row_pos == sort_param->row_end)
+  {
+    SORT_ROW_BATCH *batch;
+    int error= 0;
+
+    mysql_mutex_lock(&sort_info->mutex);
+    if (sort_param->row_end)
+    {
+      /* Done with the current batch */
+      batch= (sort_info->row_batch +
+              sort_param->row_batch++ % SORT_ROW_BATCHES);
+      if (!--batch->readers)
+        mysql_cond_broadcast(&sort_info->row_cond);
+      sort_param->row_pos= sort_param->row_end= 0;
+    }
+    while (sort_param->row_batch == sort_info->row_batches_filled &&
+           !sort_info->rows_eof && !sort_info->got_error)
+      mysql_cond_wait(&sort_info->row_cond, &sort_info->mutex);
+    if (sort_info->got_error)
+      error= 1;
+    else if (sort_param->row_batch == sort_info->row_batches_filled)
+      error= -1;                                /* End of file */
+    else
+    {
+      batch= sort_info->row_batch + sort_param->row_batch % SORT_ROW_BATCHES;
+      sort_param->row_pos= batch->buff;
+      sort_param->row_end= batch->buff + batch->used;
+    }
+    mysql_mutex_unlock(&sort_info->mutex);
+    if (error)
+      return error;
+  }
+
+  pos= sort_param->row_pos;
+  memcpy(&sort_param->current_filepos, pos, sizeof(my_off_t));
+  pos+= sizeof(my_off_t);
+  memcpy(sort_param->record, pos, share->base.reclength);
+  pos+= share->base.reclength;
+  for (blob= share->blobs, blob_end= blob + share->base.blobs;
+       blob < blob_end;
+       blob++)
+  {
+    memcpy(sort_param->record + blob->offset + blob->pack_length, &pos,
+           sizeof(char*));
+    pos+= _ma_calc_blob_length(blob->pack_length,
+                               sort_param->record + blob->offset);
+  }
+  sort_param->row_pos+= ALIGN_SIZE((size_t) (pos - sort_param->row_pos));
+  return 0;
+}
+
+
 	/* Read next record and return next key */
 
 static int sort_key_read(MARIA_SORT_PARAM *sort_param, uchar *key)
@@ -4694,17 +4926,26 @@ static int sort_key_read(MARIA_SORT_PARAM *sort_param, uchar *key)
   MARIA_KEY int_key;
   DBUG_ENTER("sort_key_read");
 
-  if ((error=sort_get_next_record(sort_param)))
-    DBUG_RETURN(error);
-  if (info->s->state.state.records == sort_info->max_records)
+  if (sort_info->row_batch)
   {
-    _ma_check_print_error(sort_info->param,
-			 "Key %d - Found too many records; Can't continue",
-                         sort_param->key+1);
-    DBUG_RETURN(1);
+    /* Parallel repair; The row is checked by _ma_thr_read_rows() */
+    if ((error=sort_get_next_row(sort_param)))
+      DBUG_RETURN(error);
+  }
+  else
+  {
+    if ((error=sort_get_next_record(sort_param)))
+      DBUG_RETURN(error);
+    if (info->s->state.state.records == sort_info->max_records)
+    {
+      _ma_check_print_error(sort_info->param,
+                            "Key %d - Found too many records; Can't continue",
+                            sort_param->key+1);
+      DBUG_RETURN(1);
+    }
+    if (_ma_sort_write_record(sort_param))
+      DBUG_RETURN(1);
   }
-  if (_ma_sort_write_record(sort_param))
-    DBUG_RETURN(1);
 
   (*info->s->keyinfo[sort_param->key].make_key)(info, &int_key,
                                                 sort_param->key, key,
@@ -4734,10 +4975,18 @@ static int sort_maria_ft_key_read(MARIA_SORT_PARAM *sort_param, uchar *key)
     for (;;)
     {
       free_root(&sort_param->wordroot, MYF(MY_MARK_BLOCKS_FREE));
-      if ((error=sort_get_next_record(sort_param)))
-        DBUG_RETURN(error);
-      if ((error= _ma_sort_write_record(sort_param)))
-        DBUG_RETURN(error);
+      if (sort_info->row_batch)
+      {
+        if ((error=sort_get_next_row(sort_param)))
+          DBUG_RETURN(error);
+      }
+      else
+      {
+        if ((error=sort_get_next_record(sort_param)))
+          DBUG_RETURN(error);
+        if ((error= _ma_sort_write_record(sort_param)))
+          DBUG_RETURN(error);
+      }
       if (!(wptr= _ma_ft_parserecord(info,sort_param->key,sort_param->record,
                                      &sort_param->wordroot)))
 
@@ -4782,21 +5031,7 @@ static int sort_maria_ft_key_read(MARIA_SORT_PARAM *sort_param, uchar *key)
       sort_param                Information about and for the sort process
 
   NOTES
-    Dynamic Records With Non-Quick Parallel Repair
-
-    For non-quick parallel repair we use a synchronized read/write
-    cache. This means that one thread is the master who fixes the data
-    file by reading each record from the old data file and writing it
-    to the new data file. By doing this the records in the new data
-    file are written contiguously. Whenever the write buffer is full,
-    it is copied to the read buffer. The slaves read from the read
-    buffer, which is not associated with a file. Thus read_cache.file
-    is -1. When using _mi_read_cache(), the slaves must always set
-    flag to READING_NEXT so that the function never tries to read from
-    file. This is safe because the records are contiguous. There is no
-    need to read outside the cache. This condition is evaluated in the
-    variable 'parallel_flag' for quick reference. read_cache.file must
-    be >= 0 in every other case.
+    In parallel repair this is only called by _ma_thr_read_rows().
 
   RETURN
     -1          end of file
@@ -4810,7 +5045,6 @@ static int sort_maria_ft_key_read(MARIA_SORT_PARAM *sort_param, uchar *key)
 static int sort_get_next_record(MARIA_SORT_PARAM *sort_param)
 {
   int searching;
-  int parallel_flag;
   uint found_record,b_type,left_length;
   my_off_t pos;
   MARIA_BLOCK_INFO block_info;
@@ -4952,7 +5186,6 @@ static int sort_get_next_record(MARIA_SORT_PARAM *sort_param)
     pos=sort_param->pos;
     param->progress= pos;
     searching=(sort_param->fix_datafile && (param->testflag & T_EXTEND));
-    parallel_flag= (sort_param->read_cache.file < 0) ? READING_NEXT : 0;
     for (;;)
     {
       found_record=block_info.second_read= 0;
@@ -4983,7 +5216,7 @@ static int sort_get_next_record(MARIA_SORT_PARAM *sort_param)
                            block_info.header, pos,
 			   MARIA_BLOCK_INFO_HEADER_LENGTH,
 			   (! found_record ? READING_NEXT : 0) |
-			   parallel_flag | READING_HEADER))
+			   READING_HEADER))
 	{
 	  if (found_record)
 	  {
@@ -5195,8 +5428,7 @@ static int sort_get_next_record(MARIA_SORT_PARAM *sort_param)
         if (block_info.data_len &&
             _ma_read_cache(info, &sort_param->read_cache,to,block_info.filepos,
                            block_info.data_len,
-                           (found_record == 1 ? READING_NEXT : 0) |
-                           parallel_flag))
+                           (found_record == 1 ? READING_NEXT : 0)))
 	{
 	  _ma_check_print_info(param,
 			      "Read error for block at: %s (error: %d); "
@@ -5351,7 +5583,7 @@ static int sort_get_next_record(MARIA_SORT_PARAM *sort_param)
    @param sort_param                Sort parameters.
 
    @note
-   This is only called by a master thread if parallel repair is used.
+   This is only called by the reader thread if parallel repair is used.
 
    @return
    @retval  0   OK
@@ -5502,21 +5734,21 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
   HA_CHECK *param= sort_info->param;
   int cmp;
 
-  if (sort_info->key_block->inited)
+  if (sort_param->key_block->inited)
   {
-    cmp= ha_key_cmp(sort_param->seg, sort_info->key_block->lastkey,
+    cmp= ha_key_cmp(sort_param->seg, sort_param->key_block->lastkey,
                     a, USE_WHOLE_KEY,
                     SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT,
                     diff_pos);
     if (param->stats_method == MI_STATS_METHOD_NULLS_NOT_EQUAL)
-      ha_key_cmp(sort_param->seg, sort_info->key_block->lastkey,
+      ha_key_cmp(sort_param->seg, sort_param->key_block->lastkey,
                  a, USE_WHOLE_KEY,
                  SEARCH_FIND | SEARCH_NULL_ARE_NOT_EQUAL, diff_pos);
     else if (param->stats_method == MI_STATS_METHOD_IGNORE_NULLS)
     {
       diff_pos[0]= maria_collect_stats_nonulls_next(sort_param->seg,
                                                  sort_param->notnull,
-                                                 sort_info->key_block->lastkey,
+                                                 sort_param->key_block->lastkey,
                                                  a);
     }
     sort_param->unique[diff_pos[0]-1]++;
@@ -5530,8 +5762,12 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
   }
   if ((sort_param->keyinfo->flag & HA_NOSAME) && cmp == 0)
   {
+    int error;
     DBUG_EXECUTE("key", _ma_print_keydata(DBUG_FILE, sort_param->seg, a,
                                           USE_WHOLE_KEY););
+    /* The key threads of parallel repair write their indexes at once */
+    if (!sort_param->master)
+      mysql_mutex_lock(&sort_info->mutex);
     sort_info->dupp++;
     sort_info->info->cur_row.lastpos= get_record_for_key(sort_param->keyinfo,
                                                          a);
@@ -5544,13 +5780,16 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
                             sort_param->key + 1,
                             llstr(sort_info->info->cur_row.lastpos, llbuff),
                             llstr(get_record_for_key(sort_param->keyinfo,
-                                                     sort_info->key_block->
+                                                     sort_param->key_block->
                                                      lastkey),
                                   llbuff2));
     param->testflag|=T_RETRY_WITHOUT_QUICK;
     if (sort_info->param->testflag & T_VERBOSE)
       _ma_print_keydata(stdout,sort_param->seg, a, USE_WHOLE_KEY);
-    return (sort_delete_record(sort_param));
+    error= sort_delete_record(sort_param);
+    if (!sort_param->master)
+      mysql_mutex_unlock(&sort_info->mutex);
+    return error;
   }
 #ifndef DBUG_OFF
   if (cmp > 0)
@@ -5560,7 +5799,7 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
     return(1);
   }
 #endif
-  return (sort_insert_key(sort_param, sort_info->key_block,
+  return (sort_insert_key(sort_param, sort_param->key_block,
 			  a, HA_OFFSET_ERROR));
 } /* sort_key_write */
 
@@ -5568,7 +5807,7 @@ static int sort_key_write(MARIA_SORT_PARAM *sort_param, const uchar *a)
 int _ma_sort_ft_buf_flush(MARIA_SORT_PARAM *sort_param)
 {
   MARIA_SORT_INFO *sort_info=sort_param->sort_info;
-  SORT_KEY_BLOCKS *key_block=sort_info->key_block;
+  SORT_KEY_BLOCKS *key_block=sort_param->key_block;
   MARIA_SHARE *share=sort_info->info->s;
   uint val_off, val_len;
   int error;
@@ -5601,12 +5840,12 @@ int _ma_sort_ft_buf_flush(MARIA_SORT_PARAM *sort_param)
   _ma_dpointer(sort_info->info->s, maria_ft_buf->lastkey+val_off+HA_FT_WLEN,
       share->state.key_root[sort_param->key]);
   /* restoring first level tree data in sort_info/sort_param */
-  sort_info->key_block=sort_info->key_block_end- sort_info->param->sort_key_blocks;
+  sort_param->key_block=sort_param->key_block_end- sort_info->param->sort_key_blocks;
   sort_param->keyinfo=share->keyinfo+sort_param->key;
   share->state.key_root[sort_param->key]=HA_OFFSET_ERROR;
   /* writing lastkey in first-level tree */
   return error ? error :
-                 sort_insert_key(sort_param,sort_info->key_block,
+                 sort_insert_key(sort_param,sort_param->key_block,
                                  maria_ft_buf->lastkey,HA_OFFSET_ERROR);
 }
 
@@ -5617,7 +5856,7 @@ static int sort_maria_ft_key_write(MARIA_SORT_PARAM *sort_param,
   uint a_len, val_off, val_len, error;
   MARIA_SORT_INFO *sort_info= sort_param->sort_info;
   SORT_FT_BUF *ft_buf= sort_info->ft_buf;
-  SORT_KEY_BLOCKS *key_block= sort_info->key_block;
+  SORT_KEY_BLOCKS *key_block= sort_param->key_block;
   MARIA_SHARE *share= sort_info->info->s;
 
   val_len=HA_FT_WLEN+share->rec_reflength;
@@ -5669,7 +5908,7 @@ static int sort_maria_ft_key_write(MARIA_SORT_PARAM *sort_param,
 
     while (key_block->inited)
       key_block++;
-    sort_info->key_block=key_block;
+    sort_param->key_block=key_block;
     sort_param->keyinfo= &share->ft2_keyinfo;
     ft_buf->count=(uint)(ft_buf->buf - p)/val_len;
 
@@ -5717,6 +5956,54 @@ static my_off_t get_record_for_key(MARIA_KEYDEF *keyinfo,
 
 /* Insert a key in sort-key-blocks */
 
+/*
+  Write a filled key block to a new page of the index file
+
+  NOTES
+    The key threads of parallel repair write their indexes at the same
+    time. They allocate the pages through the shared MARIA_HA, which is
+    protected by sort_info->mutex.
+
+  RETURN
+    HA_OFFSET_ERROR  error
+    #                position of the page
+*/
+
+static my_off_t sort_write_key_page(MARIA_SORT_PARAM *sort_param, uchar *buff)
+{
+  MARIA_SORT_INFO *sort_info= sort_param->sort_info;
+  MARIA_HA *info= sort_info->info;
+  MARIA_SHARE *share= info->s;
+  MARIA_KEYDEF *keyinfo= sort_param->keyinfo;
+  MARIA_PINNED_PAGE tmp_page_link, *page_link= &tmp_page_link;
+  my_off_t filepos;
+
+  if (!sort_param->master)
+    mysql_mutex_lock(&sort_info->mutex);
+  if ((filepos= _ma_new(info, DFLT_INIT_HITS, &page_link)) != HA_OFFSET_ERROR)
+  {
+    /* If we read the page from the key cache, we have to write it back */
+    if (page_link->changed)
+    {
+      MARIA_PAGE page;
+      pop_dynamic(&info->pinned_pages);
+      _ma_page_setup(&page, info, keyinfo, filepos, buff);
+      if (_ma_write_keypage(&page, PAGECACHE_LOCK_WRITE_UNLOCK,
+                            DFLT_INIT_HITS))
+        filepos= HA_OFFSET_ERROR;
+    }
+    else if (write_page(share, share->kfile.file, buff,
+                        keyinfo->block_length, filepos,
+                        sort_info->param->myf_rw))
+      filepos= HA_OFFSET_ERROR;
+  }
+  _ma_fast_unlock_key_del(info);
+  if (!sort_param->master)
+    mysql_mutex_unlock(&sort_info->mutex);
+  return filepos;
+}
+
+
 static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
 			   register SORT_KEY_BLOCKS *key_block,
                            const uchar *key,
@@ -5729,7 +6016,6 @@ static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
   MARIA_KEYDEF *keyinfo=sort_param->keyinfo;
   MARIA_SORT_INFO *sort_info= sort_param->sort_info;
   HA_CHECK *param=sort_info->param;
-  MARIA_PINNED_PAGE tmp_page_link, *page_link= &tmp_page_link;
   MARIA_KEY tmp_key;
   MARIA_HA *info= sort_info->info;
   MARIA_SHARE *share= info->s;
@@ -5737,13 +6023,13 @@ static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
 
   anc_buff= key_block->buff;
   lastkey=key_block->lastkey;
-  nod_flag= (key_block == sort_info->key_block ? 0 :
+  nod_flag= (key_block == sort_param->key_block ? 0 :
 	     share->base.key_reflength);
 
   if (!key_block->inited)
   {
     key_block->inited=1;
-    if (key_block == sort_info->key_block_end)
+    if (key_block == sort_param->key_block_end)
     {
       _ma_check_print_error(param,
                             "To many key-block-levels; "
@@ -5791,25 +6077,9 @@ static int sort_insert_key(MARIA_SORT_PARAM *sort_param,
   _ma_store_page_used(share, anc_buff, key_block->last_length);
   bzero(anc_buff+key_block->last_length,
 	keyinfo->block_length- key_block->last_length);
-  if ((filepos= _ma_new(info, DFLT_INIT_HITS, &page_link)) == HA_OFFSET_ERROR)
+  if ((filepos= sort_write_key_page(sort_param, anc_buff)) ==
+      HA_OFFSET_ERROR)
     DBUG_RETURN(1);
-  _ma_fast_unlock_key_del(info);
-
-  /* If we read the page from the key cache, we have to write it back to it */
-  if (page_link->changed)
-  {
-    MARIA_PAGE page;
-    pop_dynamic(&info->pinned_pages);
-    _ma_page_setup(&page, info, keyinfo, filepos, anc_buff);
-    if (_ma_write_keypage(&page, PAGECACHE_LOCK_WRITE_UNLOCK, DFLT_INIT_HITS))
-      DBUG_RETURN(1);
-  }
-  else
-  {
-    if (write_page(share, share->kfile.file, anc_buff,
-                   keyinfo->block_length, filepos, param->myf_rw))
-      DBUG_RETURN(1);
-  }
   DBUG_DUMP("buff", anc_buff, _ma_get_page_used(share, anc_buff));
 
 	/* Write separator-key to block in next level */
@@ -5903,52 +6173,27 @@ int _ma_flush_pending_blocks(MARIA_SORT_PARAM *sort_param)
   my_off_t filepos;
   SORT_KEY_BLOCKS *key_block;
   MARIA_SORT_INFO *sort_info= sort_param->sort_info;
-  myf myf_rw=sort_info->param->myf_rw;
   MARIA_HA *info=sort_info->info;
   MARIA_KEYDEF *keyinfo=sort_param->keyinfo;
-  MARIA_PINNED_PAGE tmp_page_link, *page_link= &tmp_page_link;
   DBUG_ENTER("_ma_flush_pending_blocks");
 
   filepos= HA_OFFSET_ERROR;			/* if empty file */
   nod_flag=0;
-  for (key_block=sort_info->key_block ; key_block->inited ; key_block++)
+  for (key_block=sort_param->key_block ; key_block->inited ; key_block++)
   {
     key_block->inited=0;
     length= _ma_get_page_used(info->s, key_block->buff);
     if (nod_flag)
       _ma_kpointer(info,key_block->end_pos,filepos);
     bzero(key_block->buff+length, keyinfo->block_length-length);
-    if ((filepos= _ma_new(info, DFLT_INIT_HITS, &page_link)) ==
+    if ((filepos= sort_write_key_page(sort_param, key_block->buff)) ==
         HA_OFFSET_ERROR)
-      goto err;
-
-    /* If we read the page from the key cache, we have to write it back */
-    if (page_link->changed)
-    {
-      MARIA_PAGE page;
-      pop_dynamic(&info->pinned_pages);
-
-      _ma_page_setup(&page, info, keyinfo, filepos, key_block->buff);
-      if (_ma_write_keypage(&page, PAGECACHE_LOCK_WRITE_UNLOCK,
-                            DFLT_INIT_HITS))
-	goto err;
-    }
-    else
-    {
-      if (write_page(info->s, info->s->kfile.file, key_block->buff,
-                     keyinfo->block_length, filepos, myf_rw))
-        goto err;
-    }
+      DBUG_RETURN(1);
     DBUG_DUMP("buff",key_block->buff,length);
     nod_flag=1;
   }
   info->s->state.key_root[sort_param->key]=filepos; /* Last is root for tree */
-  _ma_fast_unlock_key_del(info);
   DBUG_RETURN(0);
-
-err:
-  _ma_fast_unlock_key_del(info);
-  DBUG_RETURN(1);
 } /* _ma_flush_pending_blocks */
 
 	/* alloc space and pointers for key_blocks */
@@ -5976,6 +6221,46 @@ static SORT_KEY_BLOCKS *alloc_key_blocks(HA_CHECK *param, uint blocks,
 } /* alloc_key_blocks */
 
 
+	/* alloc the row batches of parallel repair */
+
+static SORT_ROW_BATCH *alloc_row_batches(HA_CHECK *param)
+{
+  uint i;
+  SORT_ROW_BATCH *batch;
+  DBUG_ENTER("alloc_row_batches");
+
+  if ((batch= (SORT_ROW_BATCH*) my_malloc(sizeof(SORT_ROW_BATCH) *
+                                          SORT_ROW_BATCHES,
+                                          MYF(MY_ZEROFILL))))
+  {
+    for (i=0 ; i < SORT_ROW_BATCHES ; i++)
+    {
+      batch[i].length= (size_t) param->read_buffer_length;
+      if (!(batch[i].buff= (uchar*) my_malloc(batch[i].length, MYF(0))))
+      {
+        free_row_batches(batch);
+        batch= 0;
+        break;
+      }
+    }
+  }
+  if (!batch)
+    _ma_check_print_error(param,"Not enough memory for row batches");
+  DBUG_RETURN(batch);
+} /* alloc_row_batches */
+
+
+static void free_row_batches(SORT_ROW_BATCH *batch)
+{
+  uint i;
+  if (!batch)
+    return;
+  for (i=0 ; i < SORT_ROW_BATCHES ; i++)
+    my_free(batch[i].buff);
+  my_free(batch);
+}
+
+
 	/* Check if file is almost full */
 
 int maria_test_if_almost_full(MARIA_HA *info)
@@ -551,8 +551,7 @@ pthread_handler_t ma_checkpoint_background(void *arg)
   size_t sleeps, sleep_time;
   TRANSLOG_ADDRESS log_horizon_at_last_checkpoint=
     translog_get_horizon();
-  ulonglong pagecache_flushes_at_last_checkpoint=
-    maria_pagecache->global_cache_write;
+  ulonglong pagecache_flushes_at_last_checkpoint;
   uint UNINIT_VAR(pages_bunch_size);
   struct st_filter_param filter_param;
   PAGECACHE_FILE *UNINIT_VAR(dfile); /**< data file currently being flushed */
@@ -572,6 +571,8 @@ pthread_handler_t ma_checkpoint_background(void *arg)
   */
   sleeps= 1;
   pages_to_flush_before_next_checkpoint= 0;
+  pagecache_update_stats(maria_pagecache);
+  pagecache_flushes_at_last_checkpoint= maria_pagecache->global_cache_write;
 
   for(;;) /* iterations of checkpoints and dirty page flushing */
   {
@@ -590,6 +591,7 @@ pthread_handler_t ma_checkpoint_background(void *arg)
       }
       {
         TRANSLOG_ADDRESS horizon= translog_get_horizon();
+        pagecache_update_stats(maria_pagecache);
 
         /*
           With background flushing evenly distributed over the time
@@ -626,6 +628,7 @@ pthread_handler_t ma_checkpoint_background(void *arg)
           below is possibly greater than last_checkpoint_lsn.
         */
         log_horizon_at_last_checkpoint= translog_get_horizon();
+        pagecache_update_stats(maria_pagecache);
         pagecache_flushes_at_last_checkpoint=
           maria_pagecache->global_cache_write;
         /*
@@ -168,6 +168,7 @@ int maria_close(register MARIA_HA *info)
       if (mysql_file_close(share->kfile.file, MYF(0)))
         error= my_errno;
     }
+    _ma_end_private_pagecache(share);
     thr_lock_delete(&share->lock);
     mysql_mutex_destroy(&share->key_del_lock);
 
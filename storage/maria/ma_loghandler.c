@@ -358,11 +358,11 @@ struct st_translog_descriptor
   my_bool is_everything_flushed;
   /* True when flush pass is in progress */
   my_bool flush_in_progress;
-  /* The flush number (used to distinguish two flushes goes one by one) */
-  volatile int flush_no;
-  /* Next flush pass variables */
+  /*
+    Commit queue: maximum LSN that threads waiting for the current flush
+    pass need flushed. The leader of the next pass flushes up to it.
+  */
   TRANSLOG_ADDRESS next_pass_max_lsn;
-  pthread_t max_lsn_requester;
 };
 
 static struct st_translog_descriptor log_descriptor;
@@ -399,6 +399,9 @@ static uint32 group_commit_wait= 0;
 
 enum enum_translog_status translog_status= TRANSLOG_UNINITED;
 ulonglong translog_syncs= 0; /* Number of sync()s */
+ulonglong translog_group_commits= 0; /* Number of flush passes */
+/* Number of translog_flush() calls done by a pass of another thread */
+ulonglong translog_group_commit_followers= 0;
 
 /* time of last flush */
 static ulonglong flush_start= 0;
@@ -3574,13 +3577,13 @@ my_bool translog_init_with_table(const char *directory,
   DBUG_ENTER("translog_init_with_table");
 
   translog_syncs= 0;
+  translog_group_commits= translog_group_commit_followers= 0;
   flush_start= 0;
   id_to_share= NULL;
 
   log_descriptor.directory_fd= -1;
   log_descriptor.is_everything_flushed= 1;
   log_descriptor.flush_in_progress= 0;
-  log_descriptor.flush_no= 0;
   log_descriptor.next_pass_max_lsn= LSN_IMPOSSIBLE;
 
   /* Normally in Aria this this calls translog_table_init() */
@@ -7640,49 +7643,53 @@ static void translog_force_current_buffer_to_finish()
 
 
 /**
-  @brief Waits while given lsn will be flushed
+  @brief Joins the commit queue and waits for a flush pass of other thread
 
   @param  lsn            log record serial number up to which (inclusive)
                          the log has to be flushed
-*/
 
-void  translog_flush_wait_for_end(LSN lsn)
-{
-  DBUG_ENTER("translog_flush_wait_for_end");
-  DBUG_PRINT("enter", ("LSN: " LSN_FMT, LSN_IN_PARTS(lsn)));
-  mysql_mutex_assert_owner(&log_descriptor.log_flush_lock);
-  while (cmp_translog_addr(log_descriptor.flushed, lsn) < 0)
-    mysql_cond_wait(&log_descriptor.log_flush_cond,
-                      &log_descriptor.log_flush_lock);
-  DBUG_VOID_RETURN;
-}
+  @note The goal of the next flush pass is set to lsn (if it is maximum).
+  Every time a pass ends the thread checks if lsn is flushed. If it is not
+  and no other thread started a new pass, this thread has to be the leader
+  of the next pass.
 
-
-/**
-  @brief Sets goal for the next flush pass and waits for this pass end.
-
-  @param  lsn            log record serial number up to which (inclusive)
-                         the log has to be flushed
+  @return Operation status
+    @retval 1      lsn is flushed
+    @retval 0      the caller is the leader of the next flush pass
 */
 
-void translog_flush_set_new_goal_and_wait(TRANSLOG_ADDRESS lsn)
+static my_bool translog_flush_wait_in_group(TRANSLOG_ADDRESS lsn)
 {
-  int flush_no= log_descriptor.flush_no;
-  DBUG_ENTER("translog_flush_set_new_goal_and_wait");
+  DBUG_ENTER("translog_flush_wait_in_group");
   DBUG_PRINT("enter", ("LSN: " LSN_FMT, LSN_IN_PARTS(lsn)));
   mysql_mutex_assert_owner(&log_descriptor.log_flush_lock);
+
+  translog_lock();
+  /* fix lsn if it was horizon */
+  if (cmp_translog_addr(lsn, log_descriptor.bc.buffer->last_lsn) > 0)
+    lsn= BUFFER_MAX_LSN(log_descriptor.bc.buffer);
+  translog_unlock();
+
+  /*
+    The goal is taken by the leader of the next pass (or of this pass
+    if hard group commit is on), so it is set only once.
+  */
   if (cmp_translog_addr(lsn, log_descriptor.next_pass_max_lsn) > 0)
   {
     log_descriptor.next_pass_max_lsn= lsn;
-    log_descriptor.max_lsn_requester= pthread_self();
     mysql_cond_broadcast(&log_descriptor.new_goal_cond);
   }
-  while (flush_no == log_descriptor.flush_no)
+  do
   {
     mysql_cond_wait(&log_descriptor.log_flush_cond,
-                      &log_descriptor.log_flush_lock);
-  }
-  DBUG_VOID_RETURN;
+                    &log_descriptor.log_flush_lock);
+    if (cmp_translog_addr(log_descriptor.flushed, lsn) >= 0)
+    {
+      translog_group_commit_followers++;
+      DBUG_RETURN(1);
+    }
+  } while (log_descriptor.flush_in_progress);
+  DBUG_RETURN(0);
 }
 
 
@@ -7880,9 +7887,12 @@ void translog_flush_buffers(TRANSLOG_ADDRESS *lsn,
   @note
 
   - Non group commit logic: Commits made in passes. Thread which started
-  flush first is performing actual flush, other threads sets new goal (LSN)
-  of the next pass (if it is maximum) and waits for the pass end or just
-  wait for the pass end.
+  flush first is the leader and performs the actual flush. Threads which
+  come during the pass are followers: they put their LSN in the commit
+  queue (the goal of the next pass, if it is maximum) and wait for the
+  pass end. Followers which LSN was flushed return, one of the others
+  becomes the leader of the next pass and flushes and sync()s the log
+  for all of them at once.
 
   - If hard group commit enabled and rate set to zero:
   The first thread sends all changed buffers to disk. This is repeated
@@ -7933,26 +7943,16 @@ my_bool translog_flush(TRANSLOG_ADDRESS lsn)
     mysql_mutex_unlock(&log_descriptor.log_flush_lock);
     DBUG_RETURN(0);
   }
-  if (log_descriptor.flush_in_progress)
+  if (log_descriptor.flush_in_progress &&
+      translog_flush_wait_in_group(lsn))
   {
-    translog_lock();
-    /* fix lsn if it was horizon */
-    if (cmp_translog_addr(lsn, log_descriptor.bc.buffer->last_lsn) > 0)
-      lsn= BUFFER_MAX_LSN(log_descriptor.bc.buffer);
-    translog_unlock();
-    translog_flush_set_new_goal_and_wait(lsn);
-    if (!pthread_equal(log_descriptor.max_lsn_requester, pthread_self()))
-    {
-      /*
-        translog_flush_wait_for_end() release log_flush_lock while is
-        waiting then acquire it again
-      */
-      translog_flush_wait_for_end(lsn);
-      mysql_mutex_unlock(&log_descriptor.log_flush_lock);
-      DBUG_RETURN(0);
-    }
-    log_descriptor.next_pass_max_lsn= LSN_IMPOSSIBLE;
+    mysql_mutex_unlock(&log_descriptor.log_flush_lock);
+    DBUG_RETURN(0);
   }
+  /* Take the whole commit queue in this pass */
+  if (cmp_translog_addr(log_descriptor.next_pass_max_lsn, lsn) > 0)
+    lsn= log_descriptor.next_pass_max_lsn;
+  log_descriptor.next_pass_max_lsn= LSN_IMPOSSIBLE;
   log_descriptor.flush_in_progress= 1;
   flush_horizon= log_descriptor.previous_flush_horizon;
   DBUG_PRINT("info", ("flush_in_progress is set, flush_horizon: " LSN_FMT,
@@ -8016,8 +8016,6 @@ my_bool translog_flush(TRANSLOG_ADDRESS lsn)
     /* take next goal */
     lsn= log_descriptor.next_pass_max_lsn;
     log_descriptor.next_pass_max_lsn= LSN_IMPOSSIBLE;
-    /* prevent other thread from continue */
-    log_descriptor.max_lsn_requester= pthread_self();
     DBUG_PRINT("info", ("flush took next goal: " LSN_FMT,
                         LSN_IN_PARTS(lsn)));
     mysql_mutex_unlock(&log_descriptor.log_flush_lock);
@@ -8066,11 +8064,11 @@ my_bool translog_flush(TRANSLOG_ADDRESS lsn)
 
   mysql_mutex_lock(&log_descriptor.log_flush_lock);
   log_descriptor.previous_flush_horizon= flush_horizon;
+  translog_group_commits++;
 out:
   if (sent_to_disk != LSN_IMPOSSIBLE)
     log_descriptor.flushed= sent_to_disk;
   log_descriptor.flush_in_progress= 0;
-  log_descriptor.flush_no++;
   DBUG_PRINT("info", ("flush_in_progress is dropped"));
   mysql_mutex_unlock(&log_descriptor.log_flush_lock);
   mysql_cond_broadcast(&log_descriptor.log_flush_cond);
@@ -610,6 +610,8 @@ MARIA_HA *maria_open(const char *name, int mode, uint open_flags)
     errpos= 4;
 
     *share=share_buff;
+    if (internal_table && maria_tmp_table_pagecache_size)
+      _ma_init_private_pagecache(share);
     memcpy((char*) share->state.rec_per_key_part,
 	   (char*) rec_per_key_part, sizeof(double)*key_parts);
     memcpy((char*) share->state.nulls_per_key_part,
@@ -1087,6 +1089,7 @@ MARIA_HA *maria_open(const char *name, int mode, uint open_flags)
     (*share->once_end)(share);
     /* fall through */
   case 4:
+    _ma_end_private_pagecache(share);
     ma_crypt_free(share);
     my_free(share);
     /* fall through */
@@ -1968,6 +1971,152 @@ int _ma_open_keyfile(MARIA_SHARE *share)
 }
 
 
+/*
+  Create the private page cache of an internal temporary table
+
+  SYNOPSIS
+    new_private_pagecache()
+    share		Share of the table
+    size		Memory to use for the cache
+
+  RETURN
+    the cache, or NULL if it can't be created
+*/
+
+static PAGECACHE *new_private_pagecache(MARIA_SHARE *share, size_t size)
+{
+  PAGECACHE *pagecache;
+
+  if (!(pagecache= (PAGECACHE*) my_malloc(sizeof(*pagecache),
+                                          MYF(MY_ZEROFILL |
+                                              MY_THREAD_SPECIFIC))))
+    return NULL;
+  pagecache->malloc_flags= MY_THREAD_SPECIFIC;
+  if (!init_pagecache(pagecache, size, 0, 0, share->base.block_size, 0, 0))
+  {
+    my_free(pagecache);
+    return NULL;
+  }
+  return pagecache;
+}
+
+
+/*
+  The largest private page cache of an internal temporary table
+
+  NOTES
+    A table can't get bigger than tmp_disk_table_size, which the server
+    gives as the max_data_file_length of the table.
+*/
+
+static size_t private_pagecache_max_size(MARIA_SHARE *share)
+{
+  ulonglong size= MY_MIN(maria_tmp_table_pagecache_size,
+                         share->base.max_data_file_length);
+  return (size_t) MY_MIN(size, SIZE_T_MAX);
+}
+
+
+/*
+  Give an internal temporary table a page cache of its own
+
+  SYNOPSIS
+    _ma_init_private_pagecache()
+    share		Share of the table, not yet used
+
+  NOTES
+    The pages of the table are then never in maria_pagecache, so a big
+    temporary table can't evict the pages of other tables and is not
+    slowed down by other threads using maria_pagecache. As the changed
+    pages of a temporary table are never flushed at close, a table that
+    fits in the cache is never written to disk.
+    The cache starts with room for a few pages only and is made bigger
+    by _ma_grow_private_pagecache() as the table grows, up to
+    aria_tmp_table_pagecache_size. Its memory is counted as memory of
+    the thread.
+    If the cache can't be created, the table uses share->pagecache as
+    before.
+*/
+
+void _ma_init_private_pagecache(MARIA_SHARE *share)
+{
+  PAGECACHE *pagecache;
+  /* init_pagecache() needs room for at least 8 blocks */
+  size_t size= 16 * (size_t) share->base.block_size;
+  DBUG_ENTER("_ma_init_private_pagecache");
+  DBUG_ASSERT(share->internal_table);
+
+  if (!(pagecache= new_private_pagecache(share, size)))
+    DBUG_VOID_RETURN;
+  share->pagecache= pagecache;
+  share->private_pagecache= 1;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Double the private page cache of a table that doesn't fit in it
+
+  SYNOPSIS
+    _ma_grow_private_pagecache()
+    info		Table handler, with no pinned pages
+
+  NOTES
+    The pages of the table are flushed to the files and read into the
+    new cache when they are used again. As the cache is doubled, a page
+    is written at most once per doubling. If the bigger cache can't be
+    created, the table keeps the old one.
+
+  RETURN
+    0  ok
+    #  error number
+*/
+
+int _ma_grow_private_pagecache(MARIA_HA *info)
+{
+  MARIA_SHARE *share= info->s;
+  PAGECACHE *old_pagecache= share->pagecache, *pagecache;
+  size_t max_size= private_pagecache_max_size(share);
+  size_t size;
+  DBUG_ENTER("_ma_grow_private_pagecache");
+  DBUG_ASSERT(share->private_pagecache);
+
+  if (old_pagecache->mem_size >= max_size)
+    DBUG_RETURN(0);
+  size= MY_MIN(old_pagecache->mem_size * 2, max_size);
+  if (_ma_flush_table_files(info, MARIA_FLUSH_DATA | MARIA_FLUSH_INDEX,
+                            FLUSH_RELEASE, FLUSH_RELEASE))
+    DBUG_RETURN(my_errno);
+  if ((pagecache= new_private_pagecache(share, size)))
+  {
+    DBUG_PRINT("info", ("page cache size: %zu", size));
+    end_pagecache(old_pagecache, 1);
+    my_free(old_pagecache);
+    share->pagecache= pagecache;
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Free the page cache created by _ma_init_private_pagecache()
+
+  NOTES
+    All pages of the table must have been flushed or dropped from the cache.
+*/
+
+void _ma_end_private_pagecache(MARIA_SHARE *share)
+{
+  if (share->private_pagecache)
+  {
+    end_pagecache(share->pagecache, 1);
+    my_free(share->pagecache);
+    share->pagecache= maria_pagecache;
+    share->private_pagecache= 0;
+  }
+}
+
+
 /*
   Disable all indexes.
 
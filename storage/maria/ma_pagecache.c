@@ -505,6 +505,20 @@ static void test_key_cache(PAGECACHE *pagecache,
                                     (size_t) (f).file) & (p->hash_entries-1))
 #define FILE_HASH(f,cache) ((uint) (f).file & (cache->changed_blocks_hash_size-1))
 
+/*
+  Partition of a partitioned page cache which holds a page. The position is
+  scrambled so that the pages of one partition still use all buckets of the
+  hash of the partition.
+*/
+#define PAGECACHE_PARTITION(p, f, pos)                                        \
+  ((p)->partition +                                                           \
+   (uint) (((((ulonglong) (pos) + (ulonglong) (f).file) *                     \
+             0x9E3779B97F4A7C15ULL) >> 40) % (p)->partitions))
+#define PAGECACHE_BLOCK_PARTITION(p, block)                                   \
+  PAGECACHE_PARTITION(p, (block)->hash_link->file, (block)->hash_link->pageno)
+/* Minimum number of blocks that a partition must have room for */
+#define MIN_PAGECACHE_PARTITION_BLOCKS 16
+
 #define DEFAULT_PAGECACHE_DEBUG_LOG  "pagecache_debug.log"
 
 #if defined(PAGECACHE_DEBUG) && ! defined(PAGECACHE_DEBUG_LOG)
@@ -718,6 +732,93 @@ static inline uint next_power(uint value)
 }
 
 
+/*
+  Initialize a partitioned page cache
+
+  SYNOPSIS
+    init_partitioned_pagecache()
+    pagecache			pointer to a page cache data structure
+    partitions			number of partitions
+    others			as for init_pagecache()
+
+  NOTES
+    Every partition is a page cache of its own, with its own lock, hash,
+    LRU chain and changed blocks, and gets an equal share of use_mem.
+    A page is cached in the partition given by PAGECACHE_PARTITION().
+    Only the parameters and the statistics of the top structure are used.
+
+  RETURN VALUE
+    total number of blocks in the partitions, if successful,
+    0 - otherwise.
+*/
+
+static size_t init_partitioned_pagecache(PAGECACHE *pagecache,
+                                         uint partitions, size_t use_mem,
+                                         uint division_limit,
+                                         uint age_threshold,
+                                         uint block_size,
+                                         uint changed_blocks_hash_size,
+                                         myf my_readwrite_flags)
+{
+  size_t blocks= 0;
+  uint i;
+  DBUG_ENTER("init_partitioned_pagecache");
+  DBUG_PRINT("enter", ("partitions: %u", partitions));
+
+  if (pagecache->inited && pagecache->disk_blocks > 0)
+  {
+    DBUG_PRINT("warning",("key cache already in use"));
+    DBUG_RETURN(0);
+  }
+  if (!pagecache->inited)
+  {
+    /* The mutex of the top structure protects only its statistics */
+    if (mysql_mutex_init(key_PAGECACHE_cache_lock, &pagecache->cache_lock,
+                         MY_MUTEX_INIT_FAST))
+      DBUG_RETURN(0);
+    pagecache->inited= 1;
+  }
+  if (!(pagecache->partition= (PAGECACHE*) my_malloc(sizeof(PAGECACHE) *
+                                                     partitions,
+                                                     MYF(MY_WME |
+                                                         MY_ZEROFILL))))
+    DBUG_RETURN(0);
+
+  for (i= 0; i < partitions; i++)
+  {
+    size_t partition_blocks;
+    if (!(partition_blocks=
+          init_pagecache(pagecache->partition + i, use_mem / partitions,
+                         division_limit, age_threshold, block_size,
+                         changed_blocks_hash_size / partitions,
+                         my_readwrite_flags)))
+    {
+      int error= my_errno;
+      while (i--)
+        end_pagecache(pagecache->partition + i, 1);
+      my_free(pagecache->partition);
+      pagecache->partition= NULL;
+      my_errno= error;
+      DBUG_RETURN(0);
+    }
+    blocks+= partition_blocks;
+  }
+
+  pagecache->partitions= partitions;
+  pagecache->global_cache_w_requests= pagecache->global_cache_r_requests= 0;
+  pagecache->global_cache_read= pagecache->global_cache_write= 0;
+  pagecache->mem_size= use_mem;
+  pagecache->block_size= block_size;
+  pagecache->shift= my_bit_log2(block_size);
+  pagecache->readwrite_flags= my_readwrite_flags | MY_NABP | MY_WAIT_IF_FULL;
+  pagecache->org_readwrite_flags= pagecache->readwrite_flags;
+  pagecache->disk_blocks= pagecache->blocks= blocks;
+  pagecache->blocks_unused= blocks;
+  pagecache->can_be_used= 1;
+  DBUG_RETURN(blocks);
+}
+
+
 /*
   Initialize a page cache
 
@@ -744,6 +845,8 @@ static inline uint next_power(uint value)
     It's assumed that no two threads call this function simultaneously
     referring to the same key cache handle.
 
+    pagecache->malloc_flags are added to the flags of all memory of the
+    cache, so MY_THREAD_SPECIFIC accounts it to the current thread.
 */
 
 size_t init_pagecache(PAGECACHE *pagecache, size_t use_mem,
@@ -756,6 +859,20 @@ size_t init_pagecache(PAGECACHE *pagecache, size_t use_mem,
   DBUG_ENTER("init_pagecache");
   DBUG_ASSERT(block_size >= 512);
 
+  if (pagecache->param_partitions > 1)
+  {
+    /* Don't make partitions too small to be of any use */
+    uint partitions= (uint) MY_MIN(pagecache->param_partitions,
+                                   use_mem / (MIN_PAGECACHE_PARTITION_BLOCKS *
+                                              (size_t) block_size));
+    if (partitions > 1)
+      DBUG_RETURN(init_partitioned_pagecache(pagecache, partitions, use_mem,
+                                             division_limit, age_threshold,
+                                             block_size,
+                                             changed_blocks_hash_size,
+                                             my_readwrite_flags));
+  }
+
   PAGECACHE_DEBUG_OPEN;
   if (pagecache->inited && pagecache->disk_blocks > 0)
   {
@@ -773,7 +890,9 @@ size_t init_pagecache(PAGECACHE *pagecache, size_t use_mem,
         my_hash_init(&pagecache->files_in_flush, &my_charset_bin, 32,
                      offsetof(struct st_file_in_flush, file),
                      sizeof(((struct st_file_in_flush *)NULL)->file),
-                     NULL, NULL, 0))
+                     NULL, NULL,
+                     (pagecache->malloc_flags & MY_THREAD_SPECIFIC ?
+                      HASH_THREAD_SPECIFIC : 0)))
       goto err;
     pagecache->inited= 1;
     pagecache->in_init= 0;
@@ -828,13 +947,13 @@ size_t init_pagecache(PAGECACHE *pagecache, size_t use_mem,
     /* Allocate memory for cache page buffers */
     if ((pagecache->block_mem=
       my_large_malloc(blocks * pagecache->block_size,
-                         MYF(MY_WME))))
+                      MYF(MY_WME) | pagecache->malloc_flags)))
     {
       /*
         Allocate memory for blocks, hash_links and hash entries;
         For each block 2 hash links are allocated
       */
-      if (my_multi_malloc_large(MYF(MY_ZEROFILL),
+      if (my_multi_malloc_large(MYF(MY_ZEROFILL) | pagecache->malloc_flags,
                                 &pagecache->block_root,
                                 (ulonglong) (blocks *
                                              sizeof(PAGECACHE_BLOCK_LINK)),
@@ -1004,6 +1123,24 @@ size_t resize_pagecache(PAGECACHE *pagecache,
     DBUG_RETURN(pagecache->disk_blocks);
   }
 
+  if (pagecache->partitions)
+  {
+    /* Every partition keeps an equal share of the memory */
+    uint i;
+    blocks= 0;
+    for (i= 0; i < pagecache->partitions; i++)
+      blocks+= resize_pagecache(pagecache->partition + i,
+                                use_mem / pagecache->partitions,
+                                division_limit, age_threshold,
+                                changed_blocks_hash_size /
+                                pagecache->partitions);
+    pagecache_pthread_mutex_lock(&pagecache->cache_lock);
+    pagecache->mem_size= use_mem;
+    pagecache->disk_blocks= pagecache->blocks= blocks;
+    pagecache_pthread_mutex_unlock(&pagecache->cache_lock);
+    DBUG_RETURN(blocks);
+  }
+
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
 
   wqueue= &pagecache->resize_queue;
@@ -1106,6 +1243,15 @@ void change_pagecache_param(PAGECACHE *pagecache, uint division_limit,
 {
   DBUG_ENTER("change_pagecache_param");
 
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      change_pagecache_param(pagecache->partition + i, division_limit,
+                             age_threshold);
+    DBUG_VOID_RETURN;
+  }
+
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   if (division_limit)
     pagecache->min_warm_blocks= (pagecache->disk_blocks *
@@ -1126,6 +1272,13 @@ void change_pagecache_param(PAGECACHE *pagecache, uint division_limit,
 void check_pagecache_is_cleaned_up(PAGECACHE *pagecache)
 {
   DBUG_ENTER("check_pagecache_is_cleaned_up");
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      check_pagecache_is_cleaned_up(pagecache->partition + i);
+    DBUG_VOID_RETURN;
+  }
   /*
     Ensure we called inc_counter_for_resize_op and dec_counter_for_resize_op
     the same number of times. (If not, a resize() could never happen.
@@ -1169,6 +1322,24 @@ void end_pagecache(PAGECACHE *pagecache, my_bool cleanup)
   if (!pagecache->inited)
     DBUG_VOID_RETURN;
 
+  if (pagecache->partitions)
+  {
+    uint i;
+    /* The partitions are always freed, a new init may make other ones */
+    for (i= 0; i < pagecache->partitions; i++)
+      end_pagecache(pagecache->partition + i, 1);
+    my_free(pagecache->partition);
+    pagecache->partition= NULL;
+    pagecache->partitions= 0;
+    pagecache->disk_blocks= -1;
+    if (cleanup)
+    {
+      mysql_mutex_destroy(&pagecache->cache_lock);
+      pagecache->inited= pagecache->can_be_used= 0;
+    }
+    DBUG_VOID_RETURN;
+  }
+
   if (pagecache->disk_blocks > 0)
   {
 #ifndef DBUG_OFF
@@ -2678,6 +2849,7 @@ static my_bool make_lock_and_pin(PAGECACHE *pagecache,
       pagecache           pointer to a page cache data structure
       block               block to which buffer the data is to be read
       primary             <-> the current thread will read the data
+      readwrite_flags     flags for the read from the file
 
   RETURN VALUE
     None
@@ -2693,7 +2865,8 @@ static my_bool make_lock_and_pin(PAGECACHE *pagecache,
 
 static void read_block(PAGECACHE *pagecache,
                        PAGECACHE_BLOCK_LINK *block,
-                       my_bool primary)
+                       my_bool primary,
+                       myf readwrite_flags)
 {
   DBUG_ENTER("read_block");
   DBUG_PRINT("enter", ("read block: %p  primary: %d", block, primary));
@@ -2722,7 +2895,7 @@ static void read_block(PAGECACHE *pagecache,
       error= pagecache_fread(pagecache, &block->hash_link->file,
                              args.page,
                              block->hash_link->pageno,
-                             pagecache->readwrite_flags);
+                             readwrite_flags);
     }
     error= (*block->hash_link->file.post_read_hook)(error != 0, &args);
     pagecache_pthread_mutex_lock(&pagecache->cache_lock);
@@ -2843,6 +3016,8 @@ void pagecache_unlock(PAGECACHE *pagecache,
   PAGECACHE_BLOCK_LINK *block;
   int page_st;
   DBUG_ENTER("pagecache_unlock");
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_PARTITION(pagecache, *file, pageno);
   DBUG_PRINT("enter", ("fd: %u  page: %lu  %s  %s",
                        (uint) file->file, (ulong) pageno,
                        page_cache_page_lock_str[lock],
@@ -2937,6 +3112,8 @@ void pagecache_unpin(PAGECACHE *pagecache,
   PAGECACHE_BLOCK_LINK *block;
   int page_st;
   DBUG_ENTER("pagecache_unpin");
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_PARTITION(pagecache, *file, pageno);
   DBUG_PRINT("enter", ("fd: %u  page: %lu",
                        (uint) file->file, (ulong) pageno));
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
@@ -3014,6 +3191,8 @@ void pagecache_unlock_by_link(PAGECACHE *pagecache,
                               my_bool any)
 {
   DBUG_ENTER("pagecache_unlock_by_link");
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_BLOCK_PARTITION(pagecache, block);
   DBUG_PRINT("enter", ("block: %p  fd: %u  page: %lu  changed: %d  %s  %s",
                        block, (uint) block->hash_link->file.file,
                        (ulong) block->hash_link->pageno, was_changed,
@@ -3125,6 +3304,8 @@ void pagecache_unpin_by_link(PAGECACHE *pagecache,
                              LSN lsn)
 {
   DBUG_ENTER("pagecache_unpin_by_link");
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_BLOCK_PARTITION(pagecache, block);
   DBUG_PRINT("enter", ("block: %p  fd: %u page: %lu",
                        block, (uint) block->hash_link->file.file,
                        (ulong) block->hash_link->pageno));
@@ -3345,6 +3526,8 @@ uchar *pagecache_read(PAGECACHE *pagecache,
     unlock_pin= lock_to_pin[buff==0][lock].unlock_pin;
   PAGECACHE_BLOCK_LINK *fake_link;
   my_bool reg_request;
+  /* Read before the partition is chosen, see ma_blockrec.c */
+  myf readwrite_flags= pagecache->readwrite_flags;
 #ifndef DBUG_OFF
   char llbuf[22];
   DBUG_ENTER("pagecache_read");
@@ -3363,6 +3546,9 @@ uchar *pagecache_read(PAGECACHE *pagecache,
   DBUG_ASSERT(pageno < ((1ULL) << 40));
 #endif
 
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_PARTITION(pagecache, *file, pageno);
+
   if (!page_link)
     page_link= &fake_link;
   *page_link= 0;                                 /* Catch errors */
@@ -3398,7 +3584,7 @@ uchar *pagecache_read(PAGECACHE *pagecache,
     {
       /* The requested page is to be read into the block buffer */
       read_block(pagecache, block,
-                 (my_bool)(page_st == PAGE_TO_BE_READ));
+                 (my_bool)(page_st == PAGE_TO_BE_READ), readwrite_flags);
       DBUG_PRINT("info", ("read is done"));
     }
     /*
@@ -3520,7 +3706,7 @@ uchar *pagecache_read(PAGECACHE *pagecache,
     if (!error)
     {
       error= pagecache_fread(pagecache, file, args.page, pageno,
-                             pagecache->readwrite_flags) != 0;
+                             readwrite_flags) != 0;
     }
     error= (* file->post_read_hook)(error, &args);
   }
@@ -3686,6 +3872,8 @@ my_bool pagecache_delete_by_link(PAGECACHE *pagecache,
   my_bool error= 0;
   enum pagecache_page_pin pin= PAGECACHE_PIN_LEFT_PINNED;
   DBUG_ENTER("pagecache_delete_by_link");
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_BLOCK_PARTITION(pagecache, block);
   DBUG_PRINT("enter", ("fd: %d block %p  %s  %s",
                        block->hash_link->file.file,
                        block,
@@ -3799,6 +3987,8 @@ my_bool pagecache_delete(PAGECACHE *pagecache,
   my_bool error= 0;
   enum pagecache_page_pin pin= lock_to_pin_one_phase[lock];
   DBUG_ENTER("pagecache_delete");
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_PARTITION(pagecache, *file, pageno);
   DBUG_PRINT("enter", ("fd: %u  page: %lu  %s  %s",
                        (uint) file->file, (ulong) pageno,
                        page_cache_page_lock_str[lock],
@@ -3992,6 +4182,9 @@ my_bool pagecache_write_part(PAGECACHE *pagecache,
   DBUG_ASSERT(pageno < ((1ULL) << 40));
 #endif
 
+  if (pagecache->partitions)
+    pagecache= PAGECACHE_PARTITION(pagecache, *file, pageno);
+
   if (!page_link)
     page_link= &fake_link;
   *page_link= 0;
@@ -4044,7 +4237,8 @@ my_bool pagecache_write_part(PAGECACHE *pagecache,
     {
       /* The requested page is to be read into the block buffer */
       read_block(pagecache, block,
-                 (my_bool)(page_st == PAGE_TO_BE_READ));
+                 (my_bool)(page_st == PAGE_TO_BE_READ),
+                 pagecache->readwrite_flags);
       DBUG_PRINT("info", ("read is done"));
     }
     else if (page_st == PAGE_TO_BE_READ)
@@ -4828,6 +5022,16 @@ int flush_pagecache_blocks_with_filter(PAGECACHE *pagecache,
 
   if (pagecache->disk_blocks <= 0)
     DBUG_RETURN(0);
+  if (pagecache->partitions)
+  {
+    uint i;
+    res= 0;
+    for (i= 0; i < pagecache->partitions; i++)
+      res|= flush_pagecache_blocks_with_filter(pagecache->partition + i,
+                                               file, type, filter,
+                                               filter_arg);
+    DBUG_RETURN(res);
+  }
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   inc_counter_for_resize_op(pagecache);
   res= flush_pagecache_blocks_int(pagecache, file, type, filter, filter_arg);
@@ -4863,6 +5067,15 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
     DBUG_RETURN(0);
   }
   DBUG_PRINT("info", ("Resetting counters for key cache %s.", name));
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      reset_pagecache_counters(name, pagecache->partition + i);
+    /* Sum the counters of the partitions again, under the lock */
+    pagecache_update_stats(pagecache);
+    DBUG_RETURN(0);
+  }
 
   pagecache->global_blocks_changed= 0;   /* Key_blocks_not_flushed */
   pagecache->global_cache_r_requests= 0; /* Key_read_requests */
@@ -4893,6 +5106,10 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
      @retval 1      Error
 */
 
+static my_bool
+collect_changed_blocks_of_partitions(PAGECACHE *pagecache, LEX_STRING *str,
+                                     LSN *min_rec_lsn);
+
 my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
                                                   LEX_STRING *str,
                                                   LSN *min_rec_lsn)
@@ -4905,6 +5122,9 @@ my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
   DBUG_ENTER("pagecache_collect_changed_blocks_with_LSN");
 
   DBUG_ASSERT(NULL == str->str);
+  if (pagecache->partitions)
+    DBUG_RETURN(collect_changed_blocks_of_partitions(pagecache, str,
+                                                     min_rec_lsn));
   /*
     We lock the entire cache but will be quick, just reading/writing a few MBs
     of memory at most.
@@ -5027,6 +5247,121 @@ my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
 }
 
 
+/**
+   @brief Collects the dirty pages of all partitions of a page cache
+
+   The list of every partition is collected as by
+   pagecache_collect_changed_blocks_with_lsn() and the lists are
+   concatenated, so the result has the same format as for a cache which is
+   not partitioned.
+
+   @return Operation status
+     @retval 0      OK
+     @retval 1      Error
+*/
+
+static my_bool
+collect_changed_blocks_of_partitions(PAGECACHE *pagecache, LEX_STRING *str,
+                                     LSN *min_rec_lsn)
+{
+  LEX_STRING *lists;
+  ulonglong stored_list_size= 0;
+  size_t length= 8;
+  LSN minimum_rec_lsn= LSN_MAX;
+  my_bool error= 0;
+  char *ptr;
+  uint i;
+  DBUG_ENTER("collect_changed_blocks_of_partitions");
+
+  if (!(lists= (LEX_STRING*) my_malloc(sizeof(LEX_STRING) *
+                                       pagecache->partitions,
+                                       MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  for (i= 0; i < pagecache->partitions; i++)
+  {
+    LSN rec_lsn;
+    if (pagecache_collect_changed_blocks_with_lsn(pagecache->partition + i,
+                                                  lists + i, &rec_lsn))
+      goto err;
+    if (cmp_translog_addr(rec_lsn, minimum_rec_lsn) < 0)
+      minimum_rec_lsn= rec_lsn;
+    stored_list_size+= uint8korr(lists[i].str);
+    length+= lists[i].length - 8;
+  }
+
+  if (NULL == (str->str= my_malloc(length, MYF(MY_WME))))
+    goto err;
+  str->length= length;
+  ptr= str->str;
+  int8store(ptr, stored_list_size);
+  ptr+= 8;
+  for (i= 0; i < pagecache->partitions; i++)
+  {
+    memcpy(ptr, lists[i].str + 8, lists[i].length - 8);
+    ptr+= lists[i].length - 8;
+  }
+  DBUG_PRINT("info", ("found %llu dirty pages", stored_list_size));
+
+end:
+  for (i= 0; i < pagecache->partitions; i++)
+    my_free(lists[i].str);
+  my_free(lists);
+  *min_rec_lsn= minimum_rec_lsn;
+  DBUG_RETURN(error);
+
+err:
+  error= 1;
+  goto end;
+}
+
+
+/*
+  Sum the statistics of the partitions of a page cache
+
+  SYNOPSIS
+    pagecache_update_stats()
+    pagecache		page cache handle
+
+  NOTES
+    The statistics of a partitioned page cache are kept by the partitions.
+    This stores their sums in the statistics variables of the top
+    structure, which are what SHOW STATUS and the checkpoint read.
+    The sums are stored under the mutex of the top structure, as the
+    checkpoint and SHOW STATUS can do this at the same time.
+    Does nothing for a page cache which is not partitioned.
+*/
+
+void pagecache_update_stats(PAGECACHE *pagecache)
+{
+  size_t blocks_changed= 0, blocks_used= 0, blocks_unused= 0;
+  ulonglong w_requests= 0, writes= 0, r_requests= 0, reads= 0;
+  uint i;
+
+  if (!pagecache->partitions)
+    return;
+  for (i= 0; i < pagecache->partitions; i++)
+  {
+    PAGECACHE *partition= pagecache->partition + i;
+    blocks_changed+= partition->global_blocks_changed;
+    blocks_used+=    partition->blocks_used;
+    blocks_unused+=  partition->blocks_unused;
+    w_requests+=     partition->global_cache_w_requests;
+    writes+=         partition->global_cache_write;
+    r_requests+=     partition->global_cache_r_requests;
+    reads+=          partition->global_cache_read;
+  }
+  pagecache_pthread_mutex_lock(&pagecache->cache_lock);
+  pagecache->global_blocks_changed=   blocks_changed;
+  pagecache->blocks_used=             blocks_used;
+  pagecache->blocks_unused=           blocks_unused;
+  pagecache->global_cache_w_requests= w_requests;
+  pagecache->global_cache_write=      writes;
+  pagecache->global_cache_r_requests= r_requests;
+  pagecache->global_cache_read=       reads;
+  pagecache_pthread_mutex_unlock(&pagecache->cache_lock);
+}
+
+
 #ifndef DBUG_OFF
 
 /**
@@ -5037,6 +5372,14 @@ void pagecache_file_no_dirty_page(PAGECACHE *pagecache, PAGECACHE_FILE *file)
 {
   File fd= file->file;
   PAGECACHE_BLOCK_LINK *block;
+
+  if (pagecache->partitions)
+  {
+    uint i;
+    for (i= 0; i < pagecache->partitions; i++)
+      pagecache_file_no_dirty_page(pagecache->partition + i, file);
+    return;
+  }
   for (block= pagecache->changed_blocks[FILE_HASH(*file, pagecache)];
        block != NULL;
        block= block->next_changed)
@@ -173,6 +173,7 @@ typedef struct st_pagecache
   size_t param_block_size;       /* size of the blocks in the key cache      */
   size_t param_division_limit;   /* min. percentage of warm blocks           */
   size_t param_age_threshold;    /* determines when hot block is downgraded  */
+  uint param_partitions;         /* number of partitions to create           */
 
   /* Statistics variables. These are reset in reset_pagecache_counters().    */
   size_t global_blocks_changed;	/* number of currently dirty blocks          */
@@ -184,12 +185,15 @@ typedef struct st_pagecache
   uint shift;                       /* block size = 2 ^ shift                */
   myf  readwrite_flags;             /* Flags to pread/pwrite() */
   myf  org_readwrite_flags;         /* Flags to pread/pwrite() at init */
+  myf  malloc_flags;                /* Extra flags for the cache memory */
   my_bool inited;
   my_bool resize_in_flush;       /* true during flush of resize operation    */
   my_bool can_be_used;           /* usage of cache for read/write is allowed */
   my_bool in_init;		/* Set to 1 in MySQL during init/resize     */
   my_bool extra_debug;	        /* set to 1 if one wants extra logging */
   HASH    files_in_flush;       /**< files in flush_pagecache_blocks_int() */
+  struct st_pagecache *partition; /* partitions, if the cache is partitioned */
+  uint partitions;              /* number of partitions, 0 if not partitioned */
 } PAGECACHE;
 
 /** @brief Return values for PAGECACHE_FLUSH_FILTER */
@@ -312,6 +316,7 @@ extern my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
                                                          LEX_STRING *str,
                                                          LSN *min_lsn);
 extern int reset_pagecache_counters(const char *name, PAGECACHE *pagecache);
+extern void pagecache_update_stats(PAGECACHE *pagecache);
 extern uchar *pagecache_block_link_to_buffer(PAGECACHE_BLOCK_LINK *block);
 
 extern uint pagecache_pagelevel(PAGECACHE_BLOCK_LINK *block);
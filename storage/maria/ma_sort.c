@@ -366,6 +366,46 @@ static ha_rows find_all_keys(MARIA_SORT_PARAM *info, ha_rows keys,
 } /* find_all_keys */
 
 
+/*
+  Write the index of a key thread: all keys if they fit in the sort
+  buffer, or else with the last merge of the sort file
+
+  SYNOPSIS
+    thr_write_index()
+    sort_param          Sort parameters of the key
+    keys                Number of keys that fit in sort_param->sort_keys
+*/
+
+static my_bool thr_write_index(MARIA_SORT_PARAM *sort_param, ha_keys keys)
+{
+  HA_CHECK *param= sort_param->sort_info->param;
+  uint maxbuffer;
+
+  if (!sort_param->buffpek.elements)
+  {
+    if (param->testflag & T_VERBOSE)
+      my_fprintf(stdout, "Key %d  - Dumping %llu keys\n",
+                 sort_param->key + 1, (ulonglong) sort_param->keys);
+    return (write_index(sort_param, sort_param->sort_keys,
+                        sort_param->keys) ||
+            _ma_flush_pending_blocks(sort_param));
+  }
+  maxbuffer= (uint) sort_param->buffpek.elements - 1;
+  keys= (keys * (sort_param->key_length + sizeof(char*))) /
+    sort_param->key_length;
+  if (flush_io_cache(&sort_param->tempfile) ||
+      reinit_io_cache(&sort_param->tempfile, READ_CACHE, 0L, 0, 0))
+    return 1;
+  if (param->testflag & T_VERBOSE)
+    my_fprintf(stdout, "Key %d  - Last merge and dumping keys\n",
+               sort_param->key + 1);
+  return (merge_index(sort_param, keys, sort_param->sort_keys,
+                      dynamic_element(&sort_param->buffpek, 0, BUFFPEK *),
+                      maxbuffer, &sort_param->tempfile) ||
+          _ma_flush_pending_blocks(sort_param));
+}
+
+
 static my_bool _ma_thr_find_all_keys_exec(MARIA_SORT_PARAM* sort_param)
 {
   int error= 0;
@@ -501,10 +541,34 @@ static my_bool _ma_thr_find_all_keys_exec(MARIA_SORT_PARAM* sort_param)
                                &sort_param->tempfile))
       goto err;
     sort_param->keys= (uint)((sort_param->buffpek.elements - 1) * (keys - 1) + idx);
+
+    /* Merge to less than MERGEBUFF2 buffers for the last merge */
+    maxbuffer= (uint) sort_param->buffpek.elements - 1;
+    if (maxbuffer >= MERGEBUFF2)
+    {
+      if (sort_param->sort_info->param->testflag & T_VERBOSE)
+        my_fprintf(stdout,
+                   "Key %d  - Merging %llu keys\n",
+                   sort_param->key + 1, (ulonglong) sort_param->keys);
+      if (merge_many_buff(sort_param, keys, sort_keys,
+                          dynamic_element(&sort_param->buffpek, 0, BUFFPEK *),
+                          &maxbuffer, &sort_param->tempfile))
+        goto err;
+      sort_param->buffpek.elements= maxbuffer + 1;
+    }
   }
   else
     sort_param->keys= (uint)idx;
 
+  /*
+    Write the index here, in parallel with the other keys. Fulltext
+    indexes share sort_info->ft_buf, so they are written later by
+    _ma_thr_write_keys().
+  */
+  if (!(sort_param->keyinfo->flag & HA_FULLTEXT) &&
+      thr_write_index(sort_param, keys))
+    goto err;
+
   DBUG_RETURN(FALSE);
 
 err:
@@ -532,25 +596,14 @@ pthread_handler_t _ma_thr_find_all_keys(void *arg)
      Thread must clean up after itself.
   */
   free_root(&sort_param->wordroot, MYF(0));
-  /*
-    Detach from the share if the writer is involved. Avoid others to
-    be blocked. This includes a flush of the write buffer. This will
-    also indicate EOF to the readers.
-    That means that a writer always gets here first and readers -
-    only when they see EOF. But if a reader finishes prematurely
-    because of an error it may reach this earlier - don't allow it
-    to detach the writer thread.
-  */
-  if (sort_param->master && sort_param->sort_info->info->rec_cache.share)
-    remove_io_thread(&sort_param->sort_info->info->rec_cache);
-
-  /* Readers detach from the share if any. Avoid others to be blocked. */
-  if (sort_param->read_cache.share)
-    remove_io_thread(&sort_param->read_cache);
 
   mysql_mutex_lock(&sort_param->sort_info->mutex);
   if (error)
+  {
     sort_param->sort_info->got_error= 1;
+    /* The reader thread may wait for this thread to read a batch */
+    mysql_cond_broadcast(&sort_param->sort_info->row_cond);
+  }
 
   if (!--sort_param->sort_info->threads_running)
     mysql_cond_signal(&sort_param->sort_info->cond);
@@ -589,7 +642,8 @@ int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
     {
       maria_set_key_active(share->state.key_map, sinfo->key);
 
-      if (!sinfo->buffpek.elements)
+      /* Other indexes were written by _ma_thr_find_all_keys() */
+      if ((sinfo->keyinfo->flag & HA_FULLTEXT) && !sinfo->buffpek.elements)
       {
         if (param->testflag & T_VERBOSE)
         {
@@ -622,7 +676,7 @@ int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
 
     set_sort_param_read_write(sinfo);
 
-    if (sinfo->buffpek.elements)
+    if ((sinfo->keyinfo->flag & HA_FULLTEXT) && sinfo->buffpek.elements)
     {
       uint maxbuffer=sinfo->buffpek.elements-1;
       if (!mergebuf)
@@ -641,20 +695,8 @@ int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
         }
       }
       keys=length/sinfo->key_length;
-      if (maxbuffer >= MERGEBUFF2)
-      {
-        if (param->testflag & T_VERBOSE)
-          my_fprintf(stdout,
-                     "Key %d  - Merging %llu keys\n",
-                     sinfo->key+1, (ulonglong) sinfo->keys);
-        if (merge_many_buff(sinfo, keys, (uchar **)mergebuf,
-			    dynamic_element(&sinfo->buffpek, 0, BUFFPEK *),
-			    &maxbuffer, &sinfo->tempfile))
-        {
-          got_error=1;
-          continue;
-        }
-      }
+      /* Merged to less than MERGEBUFF2 buffers by _ma_thr_find_all_keys() */
+      DBUG_ASSERT(maxbuffer < MERGEBUFF2);
       if (flush_io_cache(&sinfo->tempfile) ||
           reinit_io_cache(&sinfo->tempfile,READ_CACHE,0L,0,0))
       {
@@ -714,7 +756,8 @@ int _ma_thr_write_keys(MARIA_SORT_PARAM *sort_param)
                              param->stats_method ==
                              MI_STATS_METHOD_IGNORE_NULLS ?
                              sinfo->notnull : NULL,
-                             (ulonglong) share->state.state.records);
+                             (ulonglong) sort_info->new_info->s->
+                             state.state.records);
 
   }
   my_free(mergebuf);
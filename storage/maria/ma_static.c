@@ -51,6 +51,8 @@ ulong maria_concurrent_insert= 2;
 #endif
 
 my_off_t maria_max_temp_length= MAX_FILE_SIZE;
+/* Size of the page cache of its own of an internal temporary table */
+ulonglong maria_tmp_table_pagecache_size= 0;
 ulong    maria_bulk_insert_tree_size=8192*1024;
 ulong    maria_data_pointer_size= 6;
 
@@ -126,7 +128,7 @@ PSI_mutex_key key_SHARE_BITMAP_lock, key_SORT_INFO_mutex,
               key_LOCK_trn_list, key_TRN_state_lock;
 
 PSI_cond_key key_SHARE_key_del_cond, key_SERVICE_THREAD_CONTROL_cond,
-             key_SORT_INFO_cond, key_SHARE_BITMAP_cond,
+             key_SORT_INFO_cond, key_SORT_INFO_row_cond, key_SHARE_BITMAP_cond,
              key_COND_soft_sync, key_TRANSLOG_BUFFER_waiting_filling_buffer,
              key_TRANSLOG_BUFFER_prev_sent_to_disk_cond,
              key_TRANSLOG_DESCRIPTOR_log_flush_cond,
@@ -136,7 +138,7 @@ PSI_rwlock_key key_KEYINFO_root_lock, key_SHARE_mmap_lock,
                key_TRANSLOG_DESCRIPTOR_open_files_lock;
 
 PSI_thread_key key_thread_checkpoint, key_thread_find_all_keys,
-               key_thread_soft_sync;
+               key_thread_read_rows, key_thread_soft_sync;
 
 PSI_file_key key_file_translog, key_file_kfile, key_file_dfile,
              key_file_control, key_file_tmp;
@@ -122,6 +122,13 @@ int maria_write(MARIA_HA *info, uchar *record)
   }
   if (_ma_mark_file_changed(share))
     goto err2;
+  if (share->private_pagecache &&
+      share->state.state.key_file_length +
+      (share->data_file_type == BLOCK_RECORD ?
+       share->state.state.data_file_length : 0) >
+      share->pagecache->mem_size &&
+      (my_errno= _ma_grow_private_pagecache(info)))
+    goto err2;
 
   /* Calculate and check all unique constraints */
 
@@ -1769,7 +1776,8 @@ int maria_init_bulk_insert(MARIA_HA *info, size_t cache_size, ha_rows rows)
                 cache_size * key[i].maxlength,
                 cache_size * key[i].maxlength, 0,
 		(qsort_cmp2)keys_compare,
-		(tree_element_free) keys_free, (void *)params++, MYF(0));
+		(tree_element_free) keys_free, (void *)params++,
+                MYF(MY_TREE_BTREE));
     }
     else
      info->bulk_insert[i].root=0;
@@ -1054,12 +1054,6 @@ static int maria_chk(HA_CHECK *param, char *filename)
       error= 1;
       goto end2;
     }
-    /* We can't do parallel repair with BLOCK_RECORD yet */
-    if (param->testflag & T_REP_PARALLEL)
-    {
-      param->testflag&= ~T_REP_PARALLEL;
-      param->testflag|= T_REP_BY_SORT;
-    }
   }
 
   /*
@@ -61,7 +61,6 @@ typedef struct st_maria_sort_info
   MARIA_HA *info, *new_info;
   HA_CHECK *param;
   char *buff;
-  SORT_KEY_BLOCKS *key_block, *key_block_end;
   SORT_FT_BUF *ft_buf;
   my_off_t filelength, dupp, buff_length;
   pgcache_page_no_t page;
@@ -71,6 +70,12 @@ typedef struct st_maria_sort_info
   uint threads_running;
   myf myf_rw;
   enum data_file_type new_data_file_type, org_data_file_type;
+  /* Rows read once for all key threads in parallel repair */
+  mysql_cond_t row_cond;
+  SORT_ROW_BATCH *row_batch;
+  ulonglong row_batches_filled;
+  uint row_readers;
+  my_bool rows_eof;
 } MARIA_SORT_INFO;
 
 typedef struct st_maria_sort_param
@@ -84,6 +89,7 @@ typedef struct st_maria_sort_param
   MARIA_SORT_INFO *sort_info;
   HA_KEYSEG *seg;
   uchar **sort_keys;
+  SORT_KEY_BLOCKS *key_block, *key_block_end; /* Index pages being built */
   uchar *rec_buff;
   void *wordlist, *wordptr;
   MEM_ROOT wordroot;
@@ -99,6 +105,8 @@ typedef struct st_maria_sort_param
   ulonglong sortbuff_size;
 
   MARIA_RECORD_POS pos,max_pos,filepos,start_recpos, current_filepos;
+  ulonglong row_batch;                  /* Next batch in parallel repair */
+  uchar *row_pos, *row_end;             /* Rows left in the current batch */
   uint key, key_length,real_key_length;
   uint maxbuffers, keys, find_length, sort_keys_length;
   my_bool fix_datafile, master;
@@ -480,6 +488,7 @@ typedef struct st_maria_share
     global_changed,			/* If changed since open */
     not_flushed;
   my_bool internal_table;               /* Internal tmp table */
+  my_bool private_pagecache;            /* pagecache is owned by the table */
   my_bool lock_key_trees;               /* If we have to lock trees on read */
   my_bool non_transactional_concurrent_insert;
   my_bool delay_key_write;
@@ -933,6 +942,7 @@ extern my_bool maria_inited, maria_in_ha_maria, maria_recovery_changed_data;
 extern my_bool maria_recovery_verbose, maria_checkpoint_disabled;
 extern my_bool maria_assert_if_crashed_table;
 extern ulong maria_checkpoint_min_log_activity;
+extern ulonglong maria_tmp_table_pagecache_size;
 extern HASH maria_stored_state;
 extern int (*maria_create_trn_hook)(MARIA_HA *);
 extern my_bool (*ma_killed)(MARIA_HA *);
@@ -955,7 +965,8 @@ extern PSI_mutex_key key_SHARE_BITMAP_lock, key_SORT_INFO_mutex,
 extern PSI_mutex_key key_CRYPT_DATA_lock;
 
 extern PSI_cond_key key_SHARE_key_del_cond, key_SERVICE_THREAD_CONTROL_cond,
-                    key_SORT_INFO_cond, key_SHARE_BITMAP_cond,
+                    key_SORT_INFO_cond, key_SORT_INFO_row_cond,
+                    key_SHARE_BITMAP_cond,
                     key_COND_soft_sync, key_TRANSLOG_BUFFER_waiting_filling_buffer,
                     key_TRANSLOG_BUFFER_prev_sent_to_disk_cond,
                     key_TRANSLOG_DESCRIPTOR_log_flush_cond,
@@ -965,7 +976,7 @@ extern PSI_rwlock_key key_KEYINFO_root_lock, key_SHARE_mmap_lock,
                       key_TRANSLOG_DESCRIPTOR_open_files_lock;
 
 extern PSI_thread_key key_thread_checkpoint, key_thread_find_all_keys,
-                      key_thread_soft_sync;
+                      key_thread_read_rows, key_thread_soft_sync;
 
 extern PSI_file_key key_file_translog, key_file_kfile, key_file_dfile,
                     key_file_control, key_file_tmp;
@@ -1350,6 +1361,9 @@ extern MARIA_HA *_ma_test_if_reopen(const char *filename);
 my_bool _ma_check_table_is_closed(const char *name, const char *where);
 int _ma_open_datafile(MARIA_HA *info, MARIA_SHARE *share);
 int _ma_open_keyfile(MARIA_SHARE *share);
+void _ma_init_private_pagecache(MARIA_SHARE *share);
+int _ma_grow_private_pagecache(MARIA_HA *info);
+void _ma_end_private_pagecache(MARIA_SHARE *share);
 void _ma_setup_functions(register MARIA_SHARE *share);
 my_bool _ma_dynmap_file(MARIA_HA *info, my_off_t size);
 void _ma_remap_file(MARIA_HA *info, my_off_t size);
@@ -186,7 +186,7 @@ int trnman_init(TrID initial_trid)
   pool= 0;
   global_trid_generator= initial_trid;
   trid_min_read_from= initial_trid;
-  lf_hash_init(&trid_to_trn, sizeof(TRN*), LF_HASH_UNIQUE,
+  lf_hash_init(&trid_to_trn, sizeof(TRN*), LF_HASH_UNIQUE | LF_HASH_BUCKETS,
                0, 0, trn_get_hash_key, 0);
   DBUG_PRINT("info", ("mysql_mutex_init LOCK_trn_list"));
   mysql_mutex_init(key_LOCK_trn_list, &LOCK_trn_list, MY_MUTEX_INIT_FAST);
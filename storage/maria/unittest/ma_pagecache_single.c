@@ -35,6 +35,12 @@ static const char* default_dbug_option;
 #define SKIP_BIG_TESTS(X) /* no-op */
 #endif
 
+#ifdef TEST_PARTITIONS
+#define PARTITION_TESTS 1
+#else
+#define PARTITION_TESTS 0
+#endif
+
 static const char *base_file1_name= "page_cache_test_file_1";
 static const char *base_file2_name= "page_cache_test_file_2";
 static char file1_name[FN_REFLEN], file2_name[FN_REFLEN];
@@ -44,6 +50,18 @@ static pthread_mutex_t LOCK_thread_count;
 static uint thread_count;
 static PAGECACHE pagecache;
 
+#ifndef DBUG_OFF
+/* Number of dirty blocks of the page cache or of all its partitions */
+static size_t blocks_changed()
+{
+  size_t blocks= pagecache.blocks_changed;
+  uint i;
+  for (i= 0; i < pagecache.partitions; i++)
+    blocks+= pagecache.partition[i].blocks_changed;
+  return blocks;
+}
+#endif
+
 /*
   File contance descriptors
 */
@@ -203,13 +221,13 @@ int simple_read_change_write_read_test()
                  0);
   ok((res= MY_TEST(memcmp(buffr, buffw, TEST_PAGE_SIZE) == 0)),
      "Simple read-change-write-read page ");
-  DBUG_ASSERT(pagecache.blocks_changed == 1);
+  DBUG_ASSERT(blocks_changed() == 1);
   if (flush_pagecache_blocks(&pagecache, &file1, FLUSH_FORCE_WRITE))
   {
     diag("Got error during flushing pagecache\n");
     exit(1);
   }
-  DBUG_ASSERT(pagecache.blocks_changed == 0);
+  DBUG_ASSERT(blocks_changed() == 0);
   ok((res2= MY_TEST(test_file(file1, file1_name, TEST_PAGE_SIZE, TEST_PAGE_SIZE,
                               simple_read_change_write_read_test_file))),
      "Simple read-change-write-read page file");
@@ -744,8 +762,8 @@ int main(int argc __attribute__((unused)),
   DBUG_ENTER("main");
   DBUG_PRINT("info", ("Main thread: %s\n", my_thread_name()));
 
-  plan(18);
-  SKIP_BIG_TESTS(18)
+  plan(18 + PARTITION_TESTS);
+  SKIP_BIG_TESTS(18 + PARTITION_TESTS)
   {
   char *test_dirname= create_tmpdir(argv[0]);
   fn_format(file1_name, base_file1_name, test_dirname, "", MYF(0));
@@ -802,6 +820,10 @@ int main(int argc __attribute__((unused)),
   thr_setconcurrency(2);
 #endif
 
+#ifdef TEST_PARTITIONS
+  pagecache.param_partitions= TEST_PARTITIONS;
+#endif
+
   if ((pagen= init_pagecache(&pagecache, PCACHE_SIZE, 0, 0,
                              TEST_PAGE_SIZE, 0, MYF(MY_WME))) == 0)
   {
@@ -835,6 +857,25 @@ int main(int argc __attribute__((unused)),
   pthread_mutex_unlock(&LOCK_thread_count);
   DBUG_PRINT("info", ("thread ended"));
 
+#ifdef TEST_PARTITIONS
+  {
+    /* The pages of the file must have been spread over all partitions */
+    ulonglong r_requests= 0;
+    uint i, used= 0;
+    for (i= 0; i < pagecache.partitions; i++)
+    {
+      r_requests+= pagecache.partition[i].global_cache_r_requests;
+      if (pagecache.partition[i].global_cache_r_requests &&
+          pagecache.partition[i].global_cache_w_requests)
+        used++;
+    }
+    pagecache_update_stats(&pagecache);
+    ok(pagecache.partitions == TEST_PARTITIONS && used == TEST_PARTITIONS &&
+       pagecache.global_cache_r_requests == r_requests,
+       "Pages in all %u partitions", pagecache.partitions);
+  }
+#endif
+
   end_pagecache(&pagecache, 1);
   DBUG_PRINT("info", ("Page cache ended"));
 
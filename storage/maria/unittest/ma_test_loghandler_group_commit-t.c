@@ -0,0 +1,167 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  Test of group commit in translog_flush(): many threads write a record
+  and flush the log up to it, as a commit does. This is done without and
+  with hard group commit.
+*/
+
+#include "../maria_def.h"
+#include <stdio.h>
+#include <errno.h>
+#include <tap.h>
+#include "../trnman.h"
+
+extern my_bool maria_log_remove(const char *testdir);
+extern char *create_tmpdir(const char *progname);
+extern void translog_example_table_init();
+
+#define PCACHE_SIZE (1024*1024*10)
+#define LOG_FILE_SIZE (1024L*1024L*1024L + 1024L*1024L*512)
+#define LOG_FLAGS 0
+
+#define COMMITTERS 8
+#define COMMITS 1000
+
+static pthread_mutex_t LOCK_errors;
+static uint errors;
+
+
+static void *test_thread_committer(void *arg)
+{
+  uint num= *((uint*) arg);
+  uint i, err= 0;
+  LSN lsn;
+  TRN trn;
+  uchar long_tr_id[6];
+  LEX_CUSTRING parts[TRANSLOG_INTERNAL_PARTS + 1];
+
+  my_thread_init();
+  bzero(&trn, sizeof(trn));
+  trn.short_id= num;
+  trn.first_undo_lsn= TRANSACTION_LOGGED_LONG_ID;
+  for (i= 0; i < COMMITS; i++)
+  {
+    int2store(long_tr_id, num);
+    int4store(long_tr_id + 2, i);
+    parts[TRANSLOG_INTERNAL_PARTS + 0].str= long_tr_id;
+    parts[TRANSLOG_INTERNAL_PARTS + 0].length= 6;
+    if (translog_write_record(&lsn, LOGREC_FIXED_RECORD_0LSN_EXAMPLE,
+                              &trn, NULL, 6, TRANSLOG_INTERNAL_PARTS + 1,
+                              parts, NULL, NULL) ||
+        translog_flush(lsn))
+    {
+      fprintf(stderr, "Commit #%u of thread %u failed\n", i, num);
+      err++;
+      break;
+    }
+  }
+
+  pthread_mutex_lock(&LOCK_errors);
+  errors+= err;
+  pthread_mutex_unlock(&LOCK_errors);
+  my_thread_end();
+  return 0;
+}
+
+
+static void test_group_commit(const char *name)
+{
+  pthread_t tid[COMMITTERS];
+  uint nums[COMMITTERS];
+  uint i;
+
+  errors= 0;
+  translog_group_commits= translog_group_commit_followers= 0;
+  for (i= 0; i < COMMITTERS; i++)
+  {
+    nums[i]= i;
+    if (pthread_create(tid + i, NULL, test_thread_committer, nums + i))
+    {
+      fprintf(stderr, "Can't create thread (%d)\n", errno);
+      exit(1);
+    }
+  }
+  for (i= 0; i < COMMITTERS; i++)
+    pthread_join(tid[i], NULL);
+
+  ok(errors == 0, "%s: commits", name);
+  diag("%s: flush passes: %llu  followers: %llu", name,
+       translog_group_commits, translog_group_commit_followers);
+  /* Every commit either found its LSN flushed, led a pass or followed one */
+  ok(translog_group_commits > 0 &&
+     translog_group_commits + translog_group_commit_followers <=
+     COMMITTERS * COMMITS, "%s: group commit counters", name);
+}
+
+
+int main(int argc __attribute__((unused)), char *argv[])
+{
+  PAGECACHE pagecache;
+  MY_INIT(argv[0]);
+
+  plan(4);
+  /* We don't need to do physical syncs in this test */
+  my_disable_sync= 1;
+
+  bzero(&pagecache, sizeof(pagecache));
+  maria_data_root= create_tmpdir(argv[0]);
+  if (maria_log_remove(0))
+    exit(1);
+
+  pthread_mutex_init(&LOCK_errors, MY_MUTEX_INIT_FAST);
+
+  if (ma_control_file_open(TRUE, TRUE))
+  {
+    fprintf(stderr, "Can't init control file (%d)\n", errno);
+    exit(1);
+  }
+  if (init_pagecache(&pagecache, PCACHE_SIZE, 0, 0,
+                     TRANSLOG_PAGE_SIZE, 0, 0) == 0)
+  {
+    fprintf(stderr, "Got error: init_pagecache() (errno: %d)\n", errno);
+    exit(1);
+  }
+  if (translog_init_with_table(maria_data_root, LOG_FILE_SIZE, 50112, 0,
+                               &pagecache, LOG_FLAGS, 0,
+                               &translog_example_table_init, 0))
+  {
+    fprintf(stderr, "Can't init loghandler (%d)\n", errno);
+    exit(1);
+  }
+  /* Suppressing of automatic record writing */
+  dummy_transaction_object.first_undo_lsn|= TRANSACTION_LOGGED_LONG_ID;
+
+  test_group_commit("no group commit");
+  translog_set_group_commit_interval(1000);
+  translog_hard_group_commit(TRUE);
+  test_group_commit("hard group commit");
+  translog_hard_group_commit(FALSE);
+
+  translog_destroy();
+  end_pagecache(&pagecache, 1);
+  ma_control_file_end();
+  pthread_mutex_destroy(&LOCK_errors);
+  if (maria_log_remove(maria_data_root))
+    exit(1);
+
+  my_uuid_end();
+  my_free_open_file_info();
+  my_end(0);
+  return(exit_status());
+}
+
+#include "../ma_check_standalone.h"
@@ -73,6 +73,10 @@ static int sort_insert_key(MI_SORT_PARAM  *, SORT_KEY_BLOCKS *, uchar *, my_off_
 static int sort_delete_record(MI_SORT_PARAM *sort_param);
 /*static int flush_pending_blocks(HA_CHECK *param);*/
 static SORT_KEY_BLOCKS	*alloc_key_blocks(HA_CHECK *, uint, uint);
+static SORT_ROW_BATCH *alloc_row_batches(HA_CHECK *param);
+static void free_row_batches(SORT_ROW_BATCH *batch);
+static pthread_handler_t mi_thr_read_rows(void *arg);
+static int sort_get_next_row(MI_SORT_PARAM *sort_param);
 static ha_checksum mi_byte_checksum(const uchar *buf, uint length);
 static void set_data_file_type(MI_SORT_INFO *sort_info, MYISAM_SHARE *share);
 static int replace_data_file(HA_CHECK *param, MI_INFO *info, File new_file);
@@ -2219,7 +2223,7 @@ int mi_repair_by_sort(HA_CHECK *param, register MI_INFO *info,
   bzero((char*)&sort_info,sizeof(sort_info));
   bzero((char *)&sort_param, sizeof(sort_param));
 
-  if (!(sort_info.key_block=
+  if (!(sort_param.key_block=
 	alloc_key_blocks(param,
 			 (uint) param->sort_key_blocks,
 			 share->base.max_key_block_length)))
@@ -2230,7 +2234,7 @@ int mi_repair_by_sort(HA_CHECK *param, register MI_INFO *info,
 		       READ_CACHE,share->pack.header_length,1,MYF(MY_WME)))
     goto err;
 
-  sort_info.key_block_end=sort_info.key_block+param->sort_key_blocks;
+  sort_param.key_block_end=sort_param.key_block+param->sort_key_blocks;
   info->opt_flag|=WRITE_CACHE_USED;
 
   if (!mi_alloc_rec_buff(info, -1, &sort_param.record) ||
@@ -2551,7 +2555,7 @@ int mi_repair_by_sort(HA_CHECK *param, register MI_INFO *info,
 
   my_free(mi_get_rec_buff_ptr(info, sort_param.rec_buff));
   my_free(mi_get_rec_buff_ptr(info, sort_param.record));
-  my_free(sort_info.key_block);
+  my_free(sort_param.key_block);
   my_free(sort_info.ft_buf);
   my_free(sort_info.buff);
   (void) end_io_cache(&param->read_cache);
@@ -2579,27 +2583,14 @@ int mi_repair_by_sort(HA_CHECK *param, register MI_INFO *info,
     Each key is handled by a separate thread.
     TODO: make a number of threads a parameter
 
-    In parallel repair we use one thread per index. There are two modes:
-
-    Quick
-
-      Only the indexes are rebuilt. All threads share a read buffer.
-      Every thread that needs fresh data in the buffer enters the shared
-      cache lock. The last thread joining the lock reads the buffer from
-      the data file and wakes all other threads.
-
-    Non-quick
-
-      The data file is rebuilt and all indexes are rebuilt to point to
-      the new record positions. One thread is the master thread. It
-      reads from the old data file and writes to the new data file. It
-      also creates one of the indexes. The other threads read from a
-      buffer which is filled by the master. If they need fresh data,
-      they enter the shared cache lock. If the masters write buffer is
-      full, it flushes it to the new data file and enters the shared
-      cache lock too. When all threads joined in the lock, the master
-      copies its write buffer to the read buffer for the other threads
-      and wakes them.
+    In parallel repair we use one thread per index and one reader
+    thread. The reader thread reads and unpacks every row once and,
+    in non-quick mode, writes it to the new data file. It passes the
+    rows with their new positions in batches to the index threads
+    (see mi_thr_read_rows()), which make and sort the keys, merge
+    their sort files and write their indexes. Only the fulltext
+    indexes, which share sort_info->ft_buf, are written afterwards,
+    one at a time, by thr_write_keys().
 
   RESULT
     0	ok
@@ -2615,13 +2606,11 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
   ha_rows start_records;
   my_off_t new_header_length,del;
   File new_file;
-  MI_SORT_PARAM *sort_param=0;
+  MI_SORT_PARAM *sort_param=0, *read_param=0;
   MYISAM_SHARE *share=info->s;
   ulong   *rec_per_key_part;
   HA_KEYSEG *keyseg;
   char llbuff[22];
-  IO_CACHE new_data_cache; /* For non-quick repair. */
-  IO_CACHE_SHARE io_share;
   MI_SORT_INFO sort_info;
   ulonglong UNINIT_VAR(key_map);
   pthread_attr_t thr_attr;
@@ -2648,56 +2637,26 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     param->testflag|=T_CALC_CHECKSUM;
 
   /*
-    Quick repair (not touching data file, rebuilding indexes):
-    {
-      Read  cache is (HA_CHECK *param)->read_cache using info->dfile.
-    }
-
-    Non-quick repair (rebuilding data file and indexes):
-    {
-      Master thread:
-
-        Read  cache is (HA_CHECK *param)->read_cache using info->dfile.
-        Write cache is (MI_INFO   *info)->rec_cache  using new_file.
-
-      Slave threads:
-
-        Read  cache is new_data_cache synced to master rec_cache.
-
-      The final assignment of the filedescriptor for rec_cache is done
-      after the cache creation.
-
-      Don't check file size on new_data_cache, as the resulting file size
-      is not known yet.
-
-      As rec_cache and new_data_cache are synced, write_buffer_length is
-      used for the read cache 'new_data_cache'. Both start at the same
-      position 'new_header_length'.
-    }
+    Only the reader thread uses the data file. It reads with
+    param->read_cache and, in non-quick repair, writes the new data
+    file with info->rec_cache.
   */
   DBUG_PRINT("info", ("is quick repair: %d", rep_quick));
   bzero((char*)&sort_info,sizeof(sort_info));
-  if (!rep_quick)
-    my_b_clear(&new_data_cache);
   /* Initialize pthread structures before goto err. */
   mysql_mutex_init(mi_key_mutex_MI_SORT_INFO_mutex,
                    &sort_info.mutex, MY_MUTEX_INIT_FAST);
   mysql_cond_init(mi_key_cond_MI_SORT_INFO_cond, &sort_info.cond, 0);
+  mysql_cond_init(mi_key_cond_MI_SORT_INFO_row_cond, &sort_info.row_cond, 0);
   mysql_mutex_init(mi_key_mutex_MI_CHECK_print_msg,
                    &param->print_msg_mutex, MY_MUTEX_INIT_FAST);
   param->need_print_msg_lock= 1;
 
-  if (!(sort_info.key_block=
-	alloc_key_blocks(param, (uint) param->sort_key_blocks,
-			 share->base.max_key_block_length)))
-    goto err;
-
   if (init_io_cache(&param->read_cache, info->dfile,
                     (uint) param->read_buffer_length,
                     READ_CACHE, share->pack.header_length, 1, MYF(MY_WME)))
     goto err;
 
-  sort_info.key_block_end=sort_info.key_block+param->sort_key_blocks;
   info->opt_flag|=WRITE_CACHE_USED;
 
   if (!rep_quick)
@@ -2730,12 +2689,6 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
                       WRITE_CACHE, new_header_length, 1,
                       MYF(MY_WME | MY_WAIT_IF_FULL) & param->myf_rw))
       goto err;
-
-    if (init_io_cache(&new_data_cache, -1,
-                      (uint) param->write_buffer_length,
-                      READ_CACHE, new_header_length, 1,
-                      MYF(MY_WME | MY_DONT_CHECK_FILESIZE)))
-      goto err;
   }
 
   info->update= (short) (HA_STATE_CHANGED | HA_STATE_ROW_CHANGED);
@@ -2764,20 +2717,8 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     rec_length=share->base.min_block_length;
   else
     rec_length=share->base.pack_reclength;
-  /*
-    +1 below is required hack for parallel repair mode.
-    The info->state->records value, that is compared later
-    to sort_info.max_records and cannot exceed it, is
-    increased in sort_key_write. In mi_repair_by_sort, sort_key_write
-    is called after sort_key_read, where the comparison is performed,
-    but in parallel mode master thread can call sort_key_write
-    before some other repair thread calls sort_key_read.
-    Furthermore I'm not even sure +1 would be enough.
-    May be sort_info.max_records shold be always set to max value in
-    parallel mode.
-  */
   sort_info.max_records=
-    ((param->testflag & T_CREATE_MISSING_KEYS) ? info->state->records + 1:
+    ((param->testflag & T_CREATE_MISSING_KEYS) ? info->state->records :
      (ha_rows) (sort_info.filelength/rec_length+1));
 
   del=info->state->del;
@@ -2786,14 +2727,16 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
   max_pack_reclength= MY_MAX(share->base.pack_reclength, share->vreclength);
   if (share->options & HA_OPTION_COMPRESS_RECORD)
     set_if_bigger(max_pack_reclength, share->max_pack_length);
+  /* One MI_SORT_PARAM for each key and one for the reader thread */
   if (!(sort_param=(MI_SORT_PARAM *)
-        my_malloc((uint) share->base.keys *
+        my_malloc((uint) (share->base.keys + 1) *
 		  (sizeof(MI_SORT_PARAM) + max_pack_reclength),
 		  MYF(MY_ZEROFILL))))
   {
     mi_check_print_error(param,"Not enough memory for key!");
     goto err;
   }
+  read_param= sort_param + share->base.keys;
   total_key_length=0;
   rec_per_key_part= param->rec_per_key_part;
   info->state->records=info->state->del=share->state.split=0;
@@ -2822,6 +2765,13 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     istep=1;
     if ((!(param->testflag & T_SILENT)))
       printf ("- Fixing index %d\n",key+1);
+    /* Each key thread writes its own index pages */
+    if (!(sort_param[i].key_block=
+          alloc_key_blocks(param, (uint) param->sort_key_blocks,
+                           share->base.max_key_block_length)))
+      goto err;
+    sort_param[i].key_block_end= (sort_param[i].key_block +
+                                  param->sort_key_blocks);
     if (sort_param[i].keyinfo->flag & HA_FULLTEXT)
     {
       sort_param[i].key_read=sort_ft_key_read;
@@ -2843,7 +2793,7 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     sort_param[i].filepos=new_header_length;
     sort_param[i].max_pos=sort_param[i].pos=share->pack.header_length;
 
-    sort_param[i].record= (((uchar *)(sort_param+share->base.keys))+
+    sort_param[i].record= (((uchar *)(sort_param+share->base.keys+1))+
 			   (max_pack_reclength * i));
     if (!mi_alloc_rec_buff(info, -1, &sort_param[i].rec_buff))
     {
@@ -2875,50 +2825,36 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     }
   }
   sort_info.total_keys=i;
-  sort_param[0].master= 1;
-  sort_param[0].fix_datafile= (my_bool)(! rep_quick);
-  sort_param[0].calc_checksum= MY_TEST(param->testflag & T_CALC_CHECKSUM);
+
+  read_param->sort_info= &sort_info;
+  read_param->master= 1;
+  read_param->fix_datafile= (my_bool)(! rep_quick);
+  read_param->calc_checksum= MY_TEST(param->testflag & T_CALC_CHECKSUM);
+  read_param->filepos= new_header_length;
+  read_param->max_pos= read_param->pos= share->pack.header_length;
+  read_param->record= (((uchar *)(sort_param+share->base.keys+1))+
+                       (max_pack_reclength * share->base.keys));
+  read_param->read_cache= param->read_cache;
+  if (!mi_alloc_rec_buff(info, -1, &read_param->rec_buff))
+  {
+    mi_check_print_error(param,"Not enough memory!");
+    goto err;
+  }
+  if (!(sort_info.row_batch= alloc_row_batches(param)))
+    goto err;
 
   if (!ftparser_alloc_param(info))
     goto err;
 
   sort_info.got_error=0;
+  sort_info.row_readers= sort_info.total_keys;
   mysql_mutex_lock(&sort_info.mutex);
 
-  /*
-    Initialize the I/O cache share for use with the read caches and, in
-    case of non-quick repair, the write cache. When all threads join on
-    the cache lock, the writer copies the write cache contents to the
-    read caches.
-  */
-  if (i > 1)
-  {
-    if (rep_quick)
-      init_io_cache_share(&param->read_cache, &io_share, NULL, i);
-    else
-      init_io_cache_share(&new_data_cache, &io_share, &info->rec_cache, i);
-  }
-  else
-    io_share.total_threads= 0; /* share not used */
-
   (void) pthread_attr_init(&thr_attr);
   (void) pthread_attr_setdetachstate(&thr_attr,PTHREAD_CREATE_DETACHED);
 
   for (i=0 ; i < sort_info.total_keys ; i++)
   {
-    /*
-      Copy the properly initialized IO_CACHE structure so that every
-      thread has its own copy. In quick mode param->read_cache is shared
-      for use by all threads. In non-quick mode all threads but the
-      first copy the shared new_data_cache, which is synchronized to the
-      write cache of the first thread. The first thread copies
-      param->read_cache, which is not shared.
-    */
-    sort_param[i].read_cache= ((rep_quick || !i) ? param->read_cache :
-                               new_data_cache);
-    DBUG_PRINT("io_cache_share", ("thread: %u  read_cache: %p",
-                                  i, &sort_param[i].read_cache));
-
     /*
       two approaches: the same amount of memory for each thread
       or the memory for the same number of keys for each thread...
@@ -2938,15 +2874,23 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     {
       mi_check_print_error(param,"Cannot start a repair thread (errno= %d)",
                            error);
-      /* Cleanup: Detach from the share. Avoid others to be blocked. */
-      if (io_share.total_threads)
-        remove_io_thread(&sort_param[i].read_cache);
       DBUG_PRINT("error", ("Cannot start a repair thread"));
       sort_info.got_error=1;
     }
     else
       sort_info.threads_running++;
   }
+  if ((error= mysql_thread_create(mi_key_thread_read_rows,
+                                  &read_param->thr, &thr_attr,
+                                  mi_thr_read_rows, (void *) read_param)))
+  {
+    mi_check_print_error(param,"Cannot start a repair thread (errno= %d)",
+                         error);
+    sort_info.got_error=1;
+    mysql_cond_broadcast(&sort_info.row_cond);
+  }
+  else
+    sort_info.threads_running++;
   (void) pthread_attr_destroy(&thr_attr);
 
   /* waiting for all threads to finish */
@@ -2961,12 +2905,11 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
   }
   got_error=1;				/* Assume the following may go wrong */
 
-  if (sort_param[0].fix_datafile)
+  if (read_param->fix_datafile)
   {
     /*
       Append some nuls to the end of a memory mapped file. Destroy the
-      write cache. The master thread did already detach from the share
-      by remove_io_thread() in sort.c:thr_find_all_keys().
+      write cache.
     */
     if (write_data_suffix(&sort_info,1) || end_io_cache(&info->rec_cache))
       goto err;
@@ -2980,7 +2923,7 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
       }
     }
     share->state.state.data_file_length= info->state->data_file_length=
-      sort_param->filepos;
+      read_param->filepos;
     /* Only whole records */
     share->state.version=(ulong) time((time_t*) 0);
 
@@ -2995,7 +2938,7 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     share->pack.header_length=(ulong) new_header_length;
   }
   else
-    info->state->data_file_length=sort_param->max_pos;
+    info->state->data_file_length=read_param->max_pos;
 
   if (rep_quick && del+sort_info.dupp != info->state->del)
   {
@@ -3046,20 +2989,8 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
 err:
   got_error|= flush_blocks(param, share->key_cache, share->kfile,
                            &share->dirty_part_map);
-  /*
-    Destroy the write cache. The master thread did already detach from
-    the share by remove_io_thread() or it was not yet started (if the
-    error happend before creating the thread).
-  */
+  /* Destroy the write cache */
   (void) end_io_cache(&info->rec_cache);
-  /*
-    Destroy the new data cache in case of non-quick repair. All slave
-    threads did either detach from the share by remove_io_thread()
-    already or they were not yet started (if the error happend before
-    creating the threads).
-  */
-  if (!rep_quick && my_b_inited(&new_data_cache))
-    (void) end_io_cache(&new_data_cache);
   if (!got_error)
   {
     /* Replace the actual file with the temporary file */
@@ -3090,13 +3021,20 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
     share->state.changed&= ~STATE_NOT_OPTIMIZED_KEYS;
   share->state.changed|=STATE_NOT_SORTED_PAGES;
 
+  mysql_cond_destroy(&sort_info.row_cond);
   mysql_cond_destroy(&sort_info.cond);
   mysql_mutex_destroy(&sort_info.mutex);
   mysql_mutex_destroy(&param->print_msg_mutex);
   param->need_print_msg_lock= 0;
 
   my_free(sort_info.ft_buf);
-  my_free(sort_info.key_block);
+  free_row_batches(sort_info.row_batch);
+  if (read_param)
+  {
+    for (i= 0; i < share->base.keys; i++)
+      my_free(sort_param[i].key_block);
+    my_free(mi_get_rec_buff_ptr(info, read_param->rec_buff));
+  }
   my_free(sort_param);
   my_free(sort_info.buff);
   (void) end_io_cache(&param->read_cache);
@@ -3109,6 +3047,243 @@ int mi_repair_parallel(HA_CHECK *param, register MI_INFO *info,
   DBUG_RETURN(got_error);
 }
 
+/*
+  Get the length of a row in a batch of parallel repair
+
+  NOTES
+    A row is stored as the position that the keys point to, the
+    unpacked record and the data of the BLOBs of the record.
+*/
+
+static size_t sort_row_length(MI_INFO *info, const uchar *record)
+{
+  size_t length= sizeof(my_off_t) + info->s->base.reclength;
+  MI_BLOB *blob, *end;
+
+  for (blob= info->blobs, end= blob + info->s->base.blobs; blob < end; blob++)
+    length+= _mi_calc_blob_length(blob->pack_length, record + blob->offset);
+  return ALIGN_SIZE(length);
+}
+
+
+/*
+  Wait until the next batch of parallel repair is read by all key threads
+
+  RETURN
+    The batch, or 0 if some thread got an error
+*/
+
+static SORT_ROW_BATCH *get_free_row_batch(MI_SORT_INFO *sort_info)
+{
+  SORT_ROW_BATCH *batch= (sort_info->row_batch +
+                          sort_info->row_batches_filled % SORT_ROW_BATCHES);
+
+  mysql_mutex_lock(&sort_info->mutex);
+  while (batch->readers && !sort_info->got_error)
+    mysql_cond_wait(&sort_info->row_cond, &sort_info->mutex);
+  mysql_mutex_unlock(&sort_info->mutex);
+  if (sort_info->got_error)
+    return 0;
+  batch->used= 0;
+  return batch;
+}
+
+
+	/* Give a filled batch of rows to the key threads */
+
+static void put_row_batch(MI_SORT_INFO *sort_info, SORT_ROW_BATCH *batch)
+{
+  mysql_mutex_lock(&sort_info->mutex);
+  batch->readers= sort_info->row_readers;
+  sort_info->row_batches_filled++;
+  mysql_cond_broadcast(&sort_info->row_cond);
+  mysql_mutex_unlock(&sort_info->mutex);
+}
+
+
+/*
+  Read all rows for the key threads of mi_repair_parallel()
+
+  SYNOPSIS
+    mi_thr_read_rows()
+    arg                 MI_SORT_PARAM of the reader
+
+  NOTES
+    Each row is read and unpacked, and in non-quick repair written to the
+    new data file, by this thread only. The rows are passed in batches
+    to the key threads, which read them with sort_get_next_row(). When
+    all rows are read, or on error, sort_info->rows_eof is set.
+*/
+
+static pthread_handler_t mi_thr_read_rows(void *arg)
+{
+  MI_SORT_PARAM *sort_param= (MI_SORT_PARAM*) arg;
+  MI_SORT_INFO *sort_info= sort_param->sort_info;
+  MI_INFO *info= sort_info->info;
+  SORT_ROW_BATCH *batch= 0;
+  int error;
+
+  if ((error= my_thread_init()))
+    goto end;
+
+  while (!(error= sort_info->got_error) &&
+         !(error= sort_get_next_record(sort_param)))
+  {
+    my_off_t filepos;
+    size_t length;
+    uchar *pos;
+    MI_BLOB *blob, *blob_end;
+
+    if (info->state->records == sort_info->max_records)
+    {
+      my_errno= HA_ERR_WRONG_IN_RECORD;
+      mi_check_print_error(sort_info->param,
+                           "Found too many records; Can't continue");
+      error= 1;
+      break;
+    }
+    /* The keys point to where the row is written to the new data file */
+    filepos= sort_param->filepos;
+    if ((error= sort_write_record(sort_param)))
+      break;
+
+    length= sort_row_length(info, sort_param->record);
+    if (batch && batch->used + length > batch->length)
+    {
+      put_row_batch(sort_info, batch);
+      batch= 0;
+    }
+    if (!batch && !(batch= get_free_row_batch(sort_info)))
+    {
+      error= 1;
+      break;
+    }
+    if (length > batch->length)
+    {
+      /* A row with big BLOBs */
+      if (!(pos= (uchar*) my_realloc(batch->buff, length, MYF(MY_WME))))
+      {
+        mi_check_print_error(sort_info->param,"Not enough memory!");
+        error= 1;
+        break;
+      }
+      batch->buff= pos;
+      batch->length= length;
+    }
+
+    pos= batch->buff + batch->used;
+    memcpy(pos, &filepos, sizeof(filepos));
+    pos+= sizeof(filepos);
+    memcpy(pos, sort_param->record, info->s->base.reclength);
+    pos+= info->s->base.reclength;
+    for (blob= info->blobs, blob_end= blob + info->s->base.blobs;
+         blob < blob_end;
+         blob++)
+    {
+      ulong blob_length= _mi_calc_blob_length(blob->pack_length,
+                                              sort_param->record +
+                                              blob->offset);
+      uchar *data;
+      memcpy(&data, sort_param->record + blob->offset + blob->pack_length,
+             sizeof(char*));
+      memcpy(pos, data, blob_length);
+      pos+= blob_length;
+    }
+    batch->used+= length;
+  }
+  if (batch && batch->used && error < 0)
+    put_row_batch(sort_info, batch);
+
+end:
+  mysql_mutex_lock(&sort_info->mutex);
+  if (error > 0)
+    sort_info->got_error= 1;
+  sort_info->rows_eof= 1;
+  mysql_cond_broadcast(&sort_info->row_cond);
+  if (!--sort_info->threads_running)
+    mysql_cond_signal(&sort_info->cond);
+  mysql_mutex_unlock(&sort_info->mutex);
+
+  my_thread_end();
+  return NULL;
+}
+
+
+/*
+  Get the next row read by mi_thr_read_rows()
+
+  SYNOPSIS
+    sort_get_next_row()
+      sort_param                Information about and for the sort process
+
+  RETURN
+    -1          end of file
+    0           ok
+                sort_param->record contains the row, with BLOBs that
+                point into the batch
+                sort_param->filepos is the position of the row
+    > 0         error
+*/
+
+static int sort_get_next_row(MI_SORT_PARAM *sort_param)
+{
+  MI_SORT_INFO *sort_info= sort_param->sort_info;
+  MI_INFO *info= sort_info->info;
+  MI_BLOB *blob, *blob_end;
+  uchar *pos;
+
+  if (sort_param->row_pos == sort_param->row_end)
+  {
+    SORT_ROW_BATCH *batch;
+    int error= 0;
+
+    mysql_mutex_lock(&sort_info->mutex);
+    if (sort_param->row_end)
+    {
+      /* Done with the current batch */
+      batch= (sort_info->row_batch +
+              sort_param->row_batch++ % SORT_ROW_BATCHES);
+      if (!--batch->readers)
+        mysql_cond_broadcast(&sort_info->row_cond);
+      sort_param->row_pos= sort_param->row_end= 0;
+    }
+    while (sort_param->row_batch == sort_info->row_batches_filled &&
+           !sort_info->rows_eof && !sort_info->got_error)
+      mysql_cond_wait(&sort_info->row_cond, &sort_info->mutex);
+    if (sort_info->got_error)
+      error= 1;
+    else if (sort_param->row_batch == sort_info->row_batches_filled)
+      error= -1;                                /* End of file */
+    else
+    {
+      batch= sort_info->row_batch + sort_param->row_batch % SORT_ROW_BATCHES;
+      sort_param->row_pos= batch->buff;
+      sort_param->row_end= batch->buff + batch->used;
+    }
+    mysql_mutex_unlock(&sort_info->mutex);
+    if (error)
+      return error;
+  }
+
+  pos= sort_param->row_pos;
+  memcpy(&sort_param->filepos, pos, sizeof(sort_param->filepos));
+  pos+= sizeof(sort_param->filepos);
+  memcpy(sort_param->record, pos, info->s->base.reclength);
+  pos+= info->s->base.reclength;
+  for (blob= info->blobs, blob_end= blob + info->s->base.blobs;
+       blob < blob_end;
+       blob++)
+  {
+    memcpy(sort_param->record + blob->offset + blob->pack_length, &pos,
+           sizeof(char*));
+    pos+= _mi_calc_blob_length(blob->pack_length,
+                               sort_param->record + blob->offset);
+  }
+  sort_param->row_pos+= ALIGN_SIZE((size_t) (pos - sort_param->row_pos));
+  return 0;
+}
+
+
 	/* Read next record and return next key */
 
 static int sort_key_read(MI_SORT_PARAM *sort_param, void *key)
@@ -3118,21 +3293,30 @@ static int sort_key_read(MI_SORT_PARAM *sort_param, void *key)
   MI_INFO *info=sort_info->info;
   DBUG_ENTER("sort_key_read");
 
-  if ((error=sort_get_next_record(sort_param)))
+  if (sort_info->row_batch)
   {
-    DBUG_ASSERT(error < 0 ||
-                sort_info->param->error_printed ||
-                sort_info->param->warning_printed ||
-                sort_info->param->note_printed);
-    DBUG_RETURN(error);
+    /* Parallel repair; The row is checked by mi_thr_read_rows() */
+    if ((error=sort_get_next_row(sort_param)))
+      DBUG_RETURN(error);
   }
-  if (info->state->records == sort_info->max_records)
+  else
   {
-    my_errno= HA_ERR_WRONG_IN_RECORD;
-    mi_check_print_error(sort_info->param,
-			 "Key %d - Found too many records; Can't continue",
-                         sort_param->key+1);
-    DBUG_RETURN(1);
+    if ((error=sort_get_next_record(sort_param)))
+    {
+      DBUG_ASSERT(error < 0 ||
+                  sort_info->param->error_printed ||
+                  sort_info->param->warning_printed ||
+                  sort_info->param->note_printed);
+      DBUG_RETURN(error);
+    }
+    if (info->state->records == sort_info->max_records)
+    {
+      my_errno= HA_ERR_WRONG_IN_RECORD;
+      mi_check_print_error(sort_info->param,
+                           "Key %d - Found too many records; Can't continue",
+                           sort_param->key+1);
+      DBUG_RETURN(1);
+    }
   }
   sort_param->real_key_length=
     (info->s->rec_reflength+
@@ -3158,7 +3342,8 @@ static int sort_ft_key_read(MI_SORT_PARAM *sort_param, void *key)
     for (;;)
     {
       free_root(&sort_param->wordroot, MYF(MY_MARK_BLOCKS_FREE));
-      if ((error=sort_get_next_record(sort_param)))
+      if ((error= (sort_info->row_batch ? sort_get_next_row(sort_param) :
+                   sort_get_next_record(sort_param))))
         DBUG_RETURN(error);
       if (!(wptr=_mi_ft_parserecord(info,sort_param->key,sort_param->record,
                                     &sort_param->wordroot)))
@@ -3204,22 +3389,7 @@ static int sort_ft_key_read(MI_SORT_PARAM *sort_param, void *key)
       sort_param                Information about and for the sort process
 
   NOTE
-
-    Dynamic Records With Non-Quick Parallel Repair
-
-      For non-quick parallel repair we use a synchronized read/write
-      cache. This means that one thread is the master who fixes the data
-      file by reading each record from the old data file and writing it
-      to the new data file. By doing this the records in the new data
-      file are written contiguously. Whenever the write buffer is full,
-      it is copied to the read buffer. The slaves read from the read
-      buffer, which is not associated with a file. Thus read_cache.file
-      is -1. When using _mi_read_cache(), the slaves must always set
-      flag to READING_NEXT so that the function never tries to read from
-      file. This is safe because the records are contiguous. There is no
-      need to read outside the cache. This condition is evaluated in the
-      variable 'parallel_flag' for quick reference. read_cache.file must
-      be >= 0 in every other case.
+    In parallel repair this is only called by mi_thr_read_rows().
 
   RETURN
     -1          end of file
@@ -3230,7 +3400,6 @@ static int sort_ft_key_read(MI_SORT_PARAM *sort_param, void *key)
 static int sort_get_next_record(MI_SORT_PARAM *sort_param)
 {
   int searching;
-  int parallel_flag;
   uint found_record,b_type,left_length;
   my_off_t pos;
   uchar *UNINIT_VAR(to);
@@ -3286,7 +3455,6 @@ static int sort_get_next_record(MI_SORT_PARAM *sort_param)
   case DYNAMIC_RECORD:
     pos=sort_param->pos;
     searching=(sort_param->fix_datafile && (param->testflag & T_EXTEND));
-    parallel_flag= (sort_param->read_cache.file < 0) ? READING_NEXT : 0;
     for (;;)
     {
       found_record=block_info.second_read= 0;
@@ -3317,7 +3485,7 @@ static int sort_get_next_record(MI_SORT_PARAM *sort_param)
                            (uchar*) block_info.header,pos,
 			   MI_BLOCK_INFO_HEADER_LENGTH,
 			   (! found_record ? READING_NEXT : 0) |
-                           parallel_flag | READING_HEADER))
+                           READING_HEADER))
 	{
 	  if (found_record)
 	  {
@@ -3526,8 +3694,7 @@ static int sort_get_next_record(MI_SORT_PARAM *sort_param)
         if (block_info.data_len &&
             _mi_read_cache(&sort_param->read_cache,to,block_info.filepos,
                            block_info.data_len,
-                           (found_record == 1 ? READING_NEXT : 0) |
-                           parallel_flag))
+                           (found_record == 1 ? READING_NEXT : 0)))
 	{
 	  mi_check_print_info(param,
 			      "Read error for block at: %s (error: %d); Skipped",
@@ -3804,21 +3971,21 @@ static int sort_key_write(MI_SORT_PARAM *sort_param, const void *a)
   HA_CHECK *param= sort_info->param;
   int cmp;
 
-  if (sort_info->key_block->inited)
+  if (sort_param->key_block->inited)
   {
-    cmp=ha_key_cmp(sort_param->seg, (uchar*) sort_info->key_block->lastkey,
+    cmp=ha_key_cmp(sort_param->seg, (uchar*) sort_param->key_block->lastkey,
 		   (uchar*) a, USE_WHOLE_KEY,
                    SEARCH_FIND | SEARCH_UPDATE | SEARCH_INSERT,
 		   diff_pos);
     if (param->stats_method == MI_STATS_METHOD_NULLS_NOT_EQUAL)
-      ha_key_cmp(sort_param->seg, (uchar*) sort_info->key_block->lastkey,
+      ha_key_cmp(sort_param->seg, (uchar*) sort_param->key_block->lastkey,
                  (uchar*) a, USE_WHOLE_KEY, 
                  SEARCH_FIND | SEARCH_NULL_ARE_NOT_EQUAL, diff_pos);
     else if (param->stats_method == MI_STATS_METHOD_IGNORE_NULLS)
     {
       diff_pos[0]= mi_collect_stats_nonulls_next(sort_param->seg,
                                                  sort_param->notnull,
-                                                 (uchar*) sort_info->
+                                                 (uchar*) sort_param->
                                                  key_block->lastkey,
                                                  (uchar*)a);
     }
@@ -3833,6 +4000,10 @@ static int sort_key_write(MI_SORT_PARAM *sort_param, const void *a)
   }
   if ((sort_param->keyinfo->flag & HA_NOSAME) && cmp == 0)
   {
+    int error;
+    /* The key threads of parallel repair write their indexes at once */
+    if (!sort_param->master)
+      mysql_mutex_lock(&sort_info->mutex);
     sort_info->dupp++;
     sort_info->info->lastpos=get_record_for_key(sort_info->info,
 						sort_param->keyinfo,
@@ -3845,13 +4016,16 @@ static int sort_key_write(MI_SORT_PARAM *sort_param, const void *a)
 			   llstr(sort_info->info->lastpos,llbuff),
 			   llstr(get_record_for_key(sort_info->info,
 						    sort_param->keyinfo,
-						    (uchar*) sort_info->
+						    (uchar*) sort_param->
                                                     key_block->lastkey),
 				 llbuff2));
     param->testflag|=T_RETRY_WITHOUT_QUICK;
     if (sort_info->param->testflag & T_VERBOSE)
       _mi_print_key(stdout,sort_param->seg,(uchar*) a, USE_WHOLE_KEY);
-    return (sort_delete_record(sort_param));
+    error= sort_delete_record(sort_param);
+    if (!sort_param->master)
+      mysql_mutex_unlock(&sort_info->mutex);
+    return error;
   }
 #ifndef DBUG_OFF
   if (cmp > 0)
@@ -3861,14 +4035,14 @@ static int sort_key_write(MI_SORT_PARAM *sort_param, const void *a)
     return(1);
   }
 #endif
-  return (sort_insert_key(sort_param,sort_info->key_block,
+  return (sort_insert_key(sort_param,sort_param->key_block,
 			  (uchar*) a, HA_OFFSET_ERROR));
 } /* sort_key_write */
 
 int sort_ft_buf_flush(MI_SORT_PARAM *sort_param)
 {
   MI_SORT_INFO *sort_info=sort_param->sort_info;
-  SORT_KEY_BLOCKS *key_block=sort_info->key_block;
+  SORT_KEY_BLOCKS *key_block=sort_param->key_block;
   MYISAM_SHARE *share=sort_info->info->s;
   uint val_off, val_len;
   int error;
@@ -3901,12 +4075,12 @@ int sort_ft_buf_flush(MI_SORT_PARAM *sort_param)
   _mi_dpointer(sort_info->info, (uchar*) ft_buf->lastkey+val_off+HA_FT_WLEN,
                share->state.key_root[sort_param->key]);
   /* restoring first level tree data in sort_info/sort_param */
-  sort_info->key_block=sort_info->key_block_end- sort_info->param->sort_key_blocks;
+  sort_param->key_block=sort_param->key_block_end- sort_info->param->sort_key_blocks;
   sort_param->keyinfo=share->keyinfo+sort_param->key;
   share->state.key_root[sort_param->key]=HA_OFFSET_ERROR;
   /* writing lastkey in first-level tree */
   return error ? error :
-                 sort_insert_key(sort_param,sort_info->key_block,
+                 sort_insert_key(sort_param,sort_param->key_block,
                                  (uchar*) ft_buf->lastkey,HA_OFFSET_ERROR);
 }
 
@@ -3916,7 +4090,7 @@ static int sort_ft_key_write(MI_SORT_PARAM *sort_param, const void *a)
   uchar *p;
   MI_SORT_INFO *sort_info=sort_param->sort_info;
   SORT_FT_BUF *ft_buf=sort_info->ft_buf;
-  SORT_KEY_BLOCKS *key_block=sort_info->key_block;
+  SORT_KEY_BLOCKS *key_block=sort_param->key_block;
 
   val_len= HA_FT_WLEN + sort_info->info->s->rec_reflength;
   get_key_full_length_rdonly(a_len, (uchar *)a);
@@ -3966,7 +4140,7 @@ static int sort_ft_key_write(MI_SORT_PARAM *sort_param, const void *a)
 
     while (key_block->inited)
       key_block++;
-    sort_info->key_block=key_block;
+    sort_param->key_block=key_block;
     sort_param->keyinfo=& sort_info->info->s->ft2_keyinfo;
     ft_buf->count=(int)((uchar*) ft_buf->buf - p)/val_len;
 
@@ -4009,12 +4183,54 @@ static my_off_t get_record_for_key(MI_INFO *info, MI_KEYDEF *keyinfo,
 
 	/* Insert a key in sort-key-blocks */
 
+/*
+  Write a filled key block to a new page of the index file
+
+  NOTES
+    The key threads of parallel repair write their indexes at the same
+    time. They allocate the pages through the shared MI_INFO, which is
+    protected by sort_info->mutex.
+
+  RETURN
+    HA_OFFSET_ERROR  error
+    #                position of the page
+*/
+
+static my_off_t sort_write_key_page(MI_SORT_PARAM *sort_param, uchar *buff)
+{
+  MI_SORT_INFO *sort_info= sort_param->sort_info;
+  MI_INFO *info= sort_info->info;
+  MI_KEYDEF *keyinfo= sort_param->keyinfo;
+  my_off_t filepos, key_file_length;
+
+  if (!sort_param->master)
+    mysql_mutex_lock(&sort_info->mutex);
+  key_file_length=info->state->key_file_length;
+  if ((filepos=_mi_new(info,keyinfo,DFLT_INIT_HITS)) != HA_OFFSET_ERROR)
+  {
+    /* If we read the page from the key cache, we have to write it back */
+    if (key_file_length == info->state->key_file_length)
+    {
+      if (_mi_write_keypage(info, keyinfo, filepos, DFLT_INIT_HITS, buff))
+        filepos= HA_OFFSET_ERROR;
+    }
+    else if (mysql_file_pwrite(info->s->kfile, buff,
+                               (uint) keyinfo->block_length, filepos,
+                               sort_info->param->myf_rw))
+      filepos= HA_OFFSET_ERROR;
+  }
+  if (!sort_param->master)
+    mysql_mutex_unlock(&sort_info->mutex);
+  return filepos;
+}
+
+
 static int sort_insert_key(MI_SORT_PARAM *sort_param,
 			   register SORT_KEY_BLOCKS *key_block, uchar *key,
 			   my_off_t prev_block)
 {
   uint a_length,t_length,nod_flag;
-  my_off_t filepos,key_file_length;
+  my_off_t filepos;
   uchar *anc_buff,*lastkey;
   MI_KEY_PARAM s_temp;
   MI_INFO *info;
@@ -4026,13 +4242,13 @@ static int sort_insert_key(MI_SORT_PARAM *sort_param,
   anc_buff= (uchar*) key_block->buff;
   info=sort_info->info;
   lastkey= (uchar*) key_block->lastkey;
-  nod_flag= (key_block == sort_info->key_block ? 0 :
+  nod_flag= (key_block == sort_param->key_block ? 0 :
 	     info->s->base.key_reflength);
 
   if (!key_block->inited)
   {
     key_block->inited=1;
-    if (key_block == sort_info->key_block_end)
+    if (key_block == sort_param->key_block_end)
     {
       mi_check_print_error(param,"To many key-block-levels; Try increasing sort_key_blocks");
       DBUG_RETURN(1);
@@ -4066,19 +4282,8 @@ static int sort_insert_key(MI_SORT_PARAM *sort_param,
   mi_putint(anc_buff,key_block->last_length,nod_flag);
   bzero((uchar*) anc_buff+key_block->last_length,
 	keyinfo->block_length- key_block->last_length);
-  key_file_length=info->state->key_file_length;
-  if ((filepos=_mi_new(info,keyinfo,DFLT_INIT_HITS)) == HA_OFFSET_ERROR)
-    DBUG_RETURN(1);
-
-  /* If we read the page from the key cache, we have to write it back to it */
-  if (key_file_length == info->state->key_file_length)
-  {
-    if (_mi_write_keypage(info, keyinfo, filepos, DFLT_INIT_HITS, anc_buff))
-      DBUG_RETURN(1);
-  }
-  else if (mysql_file_pwrite(info->s->kfile, (uchar*) anc_buff,
-                             (uint) keyinfo->block_length, filepos,
-                             param->myf_rw))
+  if ((filepos= sort_write_key_page(sort_param, anc_buff)) ==
+      HA_OFFSET_ERROR)
     DBUG_RETURN(1);
   DBUG_DUMP("buff",(uchar*) anc_buff,mi_getint(anc_buff));
 
@@ -4155,36 +4360,24 @@ static int sort_delete_record(MI_SORT_PARAM *sort_param)
 int flush_pending_blocks(MI_SORT_PARAM *sort_param)
 {
   uint nod_flag,length;
-  my_off_t filepos,key_file_length;
+  my_off_t filepos;
   SORT_KEY_BLOCKS *key_block;
   MI_SORT_INFO *sort_info= sort_param->sort_info;
-  myf myf_rw=sort_info->param->myf_rw;
   MI_INFO *info=sort_info->info;
   MI_KEYDEF *keyinfo=sort_param->keyinfo;
   DBUG_ENTER("flush_pending_blocks");
 
   filepos= HA_OFFSET_ERROR;			/* if empty file */
   nod_flag=0;
-  for (key_block=sort_info->key_block ; key_block->inited ; key_block++)
+  for (key_block=sort_param->key_block ; key_block->inited ; key_block++)
   {
     key_block->inited=0;
     length=mi_getint(key_block->buff);
     if (nod_flag)
       _mi_kpointer(info,(uchar*) key_block->end_pos,filepos);
-    key_file_length=info->state->key_file_length;
     bzero((uchar*) key_block->buff+length, keyinfo->block_length-length);
-    if ((filepos=_mi_new(info,keyinfo,DFLT_INIT_HITS)) == HA_OFFSET_ERROR)
-      DBUG_RETURN(1);
-
-    /* If we read the page from the key cache, we have to write it back */
-    if (key_file_length == info->state->key_file_length)
-    {
-      if (_mi_write_keypage(info, keyinfo, filepos,
-                            DFLT_INIT_HITS, (uchar*) key_block->buff))
-	DBUG_RETURN(1);
-    }
-    else if (mysql_file_pwrite(info->s->kfile, (uchar*) key_block->buff,
-                               (uint) keyinfo->block_length, filepos, myf_rw))
+    if ((filepos= sort_write_key_page(sort_param, (uchar*) key_block->buff)) ==
+        HA_OFFSET_ERROR)
       DBUG_RETURN(1);
     DBUG_DUMP("buff",(uchar*) key_block->buff,length);
     nod_flag=1;
@@ -4218,6 +4411,46 @@ static SORT_KEY_BLOCKS *alloc_key_blocks(HA_CHECK *param, uint blocks,
 } /* alloc_key_blocks */
 
 
+	/* alloc the row batches of parallel repair */
+
+static SORT_ROW_BATCH *alloc_row_batches(HA_CHECK *param)
+{
+  uint i;
+  SORT_ROW_BATCH *batch;
+  DBUG_ENTER("alloc_row_batches");
+
+  if ((batch= (SORT_ROW_BATCH*) my_malloc(sizeof(SORT_ROW_BATCH) *
+                                          SORT_ROW_BATCHES,
+                                          MYF(MY_ZEROFILL))))
+  {
+    for (i=0 ; i < SORT_ROW_BATCHES ; i++)
+    {
+      batch[i].length= (size_t) param->read_buffer_length;
+      if (!(batch[i].buff= (uchar*) my_malloc(batch[i].length, MYF(0))))
+      {
+        free_row_batches(batch);
+        batch= 0;
+        break;
+      }
+    }
+  }
+  if (!batch)
+    mi_check_print_error(param,"Not enough memory for row batches");
+  DBUG_RETURN(batch);
+} /* alloc_row_batches */
+
+
+static void free_row_batches(SORT_ROW_BATCH *batch)
+{
+  uint i;
+  if (!batch)
+    return;
+  for (i=0 ; i < SORT_ROW_BATCHES ; i++)
+    my_free(batch[i].buff);
+  my_free(batch);
+}
+
+
 	/* Check if file is almost full */
 
 int test_if_almost_full(MI_INFO *info)
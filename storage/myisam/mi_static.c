@@ -81,11 +81,12 @@ static PSI_rwlock_info all_myisam_rwlocks[]=
   { &mi_key_rwlock_MYISAM_SHARE_mmap_lock, "MYISAM_SHARE::mmap_lock", 0}
 };
 
-PSI_cond_key mi_key_cond_MI_SORT_INFO_cond;
+PSI_cond_key mi_key_cond_MI_SORT_INFO_cond, mi_key_cond_MI_SORT_INFO_row_cond;
 
 static PSI_cond_info all_myisam_conds[]=
 {
-  { &mi_key_cond_MI_SORT_INFO_cond, "MI_SORT_INFO::cond", 0}
+  { &mi_key_cond_MI_SORT_INFO_cond, "MI_SORT_INFO::cond", 0},
+  { &mi_key_cond_MI_SORT_INFO_row_cond, "MI_SORT_INFO::row_cond", 0}
 };
 
 PSI_file_key mi_key_file_datatmp, mi_key_file_dfile, mi_key_file_kfile,
@@ -99,11 +100,12 @@ static PSI_file_info all_myisam_files[]=
   { & mi_key_file_log, "log", 0}
 };
 
-PSI_thread_key mi_key_thread_find_all_keys;
+PSI_thread_key mi_key_thread_find_all_keys, mi_key_thread_read_rows;
 
 static PSI_thread_info all_myisam_threads[]=
 {
   { &mi_key_thread_find_all_keys, "find_all_keys", 0},
+  { &mi_key_thread_read_rows, "read_rows", 0},
 };
 
 void init_myisam_psi_keys()
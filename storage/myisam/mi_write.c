@@ -1015,7 +1015,8 @@ int mi_init_bulk_insert(MI_INFO *info, size_t cache_size, ha_rows rows)
                 cache_size * key[i].maxlength,
                 cache_size * key[i].maxlength, 0,
 		(qsort_cmp2)keys_compare,
-		(tree_element_free) keys_free, (void *)params++, MYF(0));
+		(tree_element_free) keys_free, (void *)params++,
+                MYF(MY_TREE_BTREE));
     }
     else
      info->bulk_insert[i].root=0;
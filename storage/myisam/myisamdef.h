@@ -742,12 +742,13 @@ extern PSI_mutex_key mi_key_mutex_MYISAM_SHARE_intern_lock,
 extern PSI_rwlock_key mi_key_rwlock_MYISAM_SHARE_key_root_lock,
   mi_key_rwlock_MYISAM_SHARE_mmap_lock;
 
-extern PSI_cond_key mi_key_cond_MI_SORT_INFO_cond;
+extern PSI_cond_key mi_key_cond_MI_SORT_INFO_cond,
+  mi_key_cond_MI_SORT_INFO_row_cond;
 
 extern PSI_file_key mi_key_file_datatmp, mi_key_file_dfile, mi_key_file_kfile,
   mi_key_file_log;
 
-extern PSI_thread_key mi_key_thread_find_all_keys;
+extern PSI_thread_key mi_key_thread_find_all_keys, mi_key_thread_read_rows;
 
 void init_myisam_psi_keys();
 #endif /* HAVE_PSI_INTERFACE */
@@ -25,7 +25,8 @@
 
 int32 inserts= 0, N;
 LF_ALLOCATOR lf_allocator;
-LF_HASH lf_hash;
+LF_HASH lf_hash, lf_hash_buckets;
+LF_HASH *hash;                  /* the hash that test_lf_hash() uses */
 
 int with_my_thread_init=0;
 
@@ -130,7 +131,7 @@ pthread_handler_t test_lf_hash(void *arg)
   if (with_my_thread_init)
     my_thread_init();
 
-  pins= lf_hash_get_pins(&lf_hash);
+  pins= lf_hash_get_pins(hash);
 
   for (x= ((int)(intptr)(&m)); m ; m--)
   {
@@ -140,7 +141,7 @@ pthread_handler_t test_lf_hash(void *arg)
     {
       x= (x*(m+i)+0x87654321) & INT_MAX32;
       z= (x<0) ? -x : x;
-      if (lf_hash_insert(&lf_hash, pins, &z))
+      if (lf_hash_insert(hash, pins, &z))
       {
         sum+= z;
         ins++;
@@ -148,7 +149,7 @@ pthread_handler_t test_lf_hash(void *arg)
       else
       {
         int unused= 0;
-        lf_hash_iterate(&lf_hash, pins, do_sum, &unused);
+        lf_hash_iterate(hash, pins, do_sum, &unused);
         scans++;
       }
     }
@@ -156,7 +157,7 @@ pthread_handler_t test_lf_hash(void *arg)
     {
       y= (y*(m+i)+0x87654321) & INT_MAX32;
       z= (y<0) ? -y : y;
-      if (lf_hash_delete(&lf_hash, pins, (uchar *)&z, sizeof(z)))
+      if (lf_hash_delete(hash, pins, (uchar *)&z, sizeof(z)))
         sum-= z;
     }
   }
@@ -168,9 +169,9 @@ pthread_handler_t test_lf_hash(void *arg)
   if (--N == 0)
   {
     diag("%d mallocs, %d pins in stack, %d hash size, %d inserts, %d scans",
-         lf_hash.alloc.mallocs, lf_hash.alloc.pinbox.pins_in_array,
-         lf_hash.size, inserts, scans);
-    bad|= lf_hash.count;
+         hash->alloc.mallocs, hash->alloc.pinbox.pins_in_array,
+         hash->size, inserts, scans);
+    bad|= hash->count;
   }
   if (!--running_threads) pthread_cond_signal(&cond);
   pthread_mutex_unlock(&mutex);
@@ -180,13 +181,82 @@ pthread_handler_t test_lf_hash(void *arg)
 }
 
 
+
+/*
+  lookups of keys that are in the hash, to compare the speed of
+  the split-ordered list and of LF_HASH_BUCKETS
+*/
+#define N_TLH_KEYS 10000
+pthread_handler_t test_lf_hash_search(void *arg)
+{
+  int    m= (*(int *)arg)/100;
+  int32 x, z, found= 0;
+  LF_PINS *pins;
+
+  pins= lf_hash_get_pins(hash);
+  for (x= ((int)(intptr)(&m)); m ; m--)
+  {
+    int i;
+    for (i= 0; i < N_TLH_KEYS; i++)
+    {
+      x= (x*(m+i)+0x87654321) & INT_MAX32;
+      z= x % (2*N_TLH_KEYS);
+      if (lf_hash_search(hash, pins, &z, sizeof(z)))
+      {
+        lf_hash_search_unpin(pins);
+        found+= z & 1;
+      }
+      else
+        found+= !(z & 1);
+    }
+  }
+  lf_hash_put_pins(pins);
+  pthread_mutex_lock(&mutex);
+  bad+= found != (*(int *)arg)/100 * N_TLH_KEYS;
+  if (!--running_threads) pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  return 0;
+}
+
+
+/* put the odd numbers below 2*N_TLH_KEYS in the hash */
+static void fill_hash(LF_HASH *h)
+{
+  LF_PINS *pins= lf_hash_get_pins(h);
+  int32 i;
+  for (i= 1; i < 2*N_TLH_KEYS; i+= 2)
+    lf_hash_insert(h, pins, &i);
+  lf_hash_put_pins(pins);
+}
+
+
+/*
+  delete what fill_hash() inserted: the hash must shrink back, and the
+  replaced tables must be freed, as nothing has them pinned
+*/
+static void test_lf_hash_shrink(LF_HASH *h)
+{
+  LF_PINS *pins= lf_hash_get_pins(h);
+  int32 i, size= h->size;
+  int not_deleted= 0;
+  for (i= 1; i < 2*N_TLH_KEYS; i+= 2)
+    not_deleted+= lf_hash_delete(h, pins, &i, sizeof(i)) != 0;
+  lf_hash_put_pins(pins);
+  ok(!not_deleted && h->size < size / 64 && !h->retired,
+     "lf_hash buckets shrank from %d to %d buckets (%d not deleted)",
+     size, h->size, not_deleted);
+}
+
+
 void do_tests()
 {
-  plan(7);
+  plan(12);
 
   lf_alloc_init(&lf_allocator, sizeof(TLA), offsetof(TLA, not_used));
   lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE, 0, sizeof(int), 0,
                &my_charset_bin);
+  lf_hash_init(&lf_hash_buckets, sizeof(int), LF_HASH_UNIQUE | LF_HASH_BUCKETS,
+               0, sizeof(int), 0, &my_charset_bin);
 
   bad= my_atomic_initialize();
   ok(!bad, "my_atomic_initialize() returned %d", bad);
@@ -194,14 +264,29 @@ void do_tests()
   with_my_thread_init= 1;
   test_concurrently("lf_pinbox (with my_thread_init)", test_lf_pinbox, N= THREADS, CYCLES);
   test_concurrently("lf_alloc (with my_thread_init)",  test_lf_alloc,  N= THREADS, CYCLES);
+  hash= &lf_hash;
   test_concurrently("lf_hash (with my_thread_init)",   test_lf_hash,   N= THREADS, CYCLES);
+  hash= &lf_hash_buckets;
+  test_concurrently("lf_hash buckets (with my_thread_init)", test_lf_hash, N= THREADS, CYCLES);
 
   with_my_thread_init= 0;
   test_concurrently("lf_pinbox (without my_thread_init)", test_lf_pinbox, N= THREADS, CYCLES);
   test_concurrently("lf_alloc (without my_thread_init)",  test_lf_alloc,  N= THREADS, CYCLES);
+  hash= &lf_hash;
   test_concurrently("lf_hash (without my_thread_init)",   test_lf_hash,   N= THREADS, CYCLES);
+  hash= &lf_hash_buckets;
+  test_concurrently("lf_hash buckets (without my_thread_init)", test_lf_hash, N= THREADS, CYCLES);
+
+  hash= &lf_hash;
+  fill_hash(hash);
+  test_concurrently("lf_hash_search", test_lf_hash_search, THREADS, CYCLES);
+  hash= &lf_hash_buckets;
+  fill_hash(hash);
+  test_concurrently("lf_hash_search buckets", test_lf_hash_search, THREADS, CYCLES);
+  test_lf_hash_shrink(hash);
 
   lf_hash_destroy(&lf_hash);
+  lf_hash_destroy(&lf_hash_buckets);
   lf_alloc_destroy(&lf_allocator);
 }
 
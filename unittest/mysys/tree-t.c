@@ -0,0 +1,258 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Test of TREE stored as a red-black tree and as a B-tree (MY_TREE_BTREE).
+  Also prints the time of insert, search and walk for both, as
+  a microbenchmark.
+*/
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_tree.h>
+#include <tap.h>
+
+#define KEYS 200000
+#define STRING_KEYS 2000
+
+static ulonglong *keys;
+
+static int cmp_ulonglong(void *arg __attribute__((unused)),
+                         const void *a, const void *b)
+{
+  ulonglong x= *(const ulonglong*) a, y= *(const ulonglong*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static int cmp_string(void *arg __attribute__((unused)),
+                      const void *a, const void *b)
+{
+  return strcmp((const char*) a, (const char*) b);
+}
+
+typedef struct st_walk_state
+{
+  ulonglong last;
+  ulonglong elements, total_count;
+  my_bool   in_order;
+} WALK_STATE;
+
+static int walk_check(void *key, element_count count, void *arg)
+{
+  WALK_STATE *state= (WALK_STATE*) arg;
+  ulonglong value= *(ulonglong*) key;
+  if (state->elements && value <= state->last)
+    state->in_order= 0;
+  state->last= value;
+  state->elements++;
+  state->total_count+= count;
+  return 0;
+}
+
+static int walk_check_reverse(void *key, element_count count, void *arg)
+{
+  WALK_STATE *state= (WALK_STATE*) arg;
+  ulonglong value= *(ulonglong*) key;
+  if (state->elements && value >= state->last)
+    state->in_order= 0;
+  state->last= value;
+  state->elements++;
+  state->total_count+= count;
+  return 0;
+}
+
+static int walk_stop(void *key __attribute__((unused)),
+                     element_count count __attribute__((unused)),
+                     void *arg)
+{
+  return ++*(uint*) arg == 10;
+}
+
+
+/* Insert KEYS random numbers (with duplicates) and check the tree */
+
+static void test_numbers(myf flags, const char *name)
+{
+  TREE tree;
+  WALK_STATE state;
+  ulonglong start, insert_time, search_time, walk_time, missing= 0;
+  uint i, found= 0, stopped= 0;
+
+  init_tree(&tree, 0, 0, sizeof(ulonglong), cmp_ulonglong, NULL, NULL,
+            flags);
+
+  start= my_interval_timer();
+  for (i= 0; i < KEYS; i++)
+  {
+    if (!tree_insert(&tree, keys + i, 0, NULL))
+      break;
+  }
+  insert_time= my_interval_timer() - start;
+  ok(i == KEYS, "%s: insert", name);
+
+  start= my_interval_timer();
+  for (i= 0; i < KEYS; i++)
+  {
+    ulonglong *res= (ulonglong*) tree_search(&tree, keys + i, NULL);
+    found+= res && *res == keys[i];
+  }
+  search_time= my_interval_timer() - start;
+  ok(found == KEYS, "%s: search of inserted keys", name);
+  for (i= 0; i < 1000; i++)
+  {
+    ulonglong key= ((ulonglong) i << 40) | 1;     /* Inserted keys are even */
+    missing+= tree_search(&tree, &key, NULL) != 0;
+  }
+  ok(missing == 0, "%s: search of missing keys", name);
+
+  bzero(&state, sizeof(state));
+  state.in_order= 1;
+  start= my_interval_timer();
+  tree_walk(&tree, walk_check, &state, left_root_right);
+  walk_time= my_interval_timer() - start;
+  ok(state.in_order && state.elements == tree.elements_in_tree &&
+     state.total_count == KEYS, "%s: walk left_root_right", name);
+
+  bzero(&state, sizeof(state));
+  state.in_order= 1;
+  tree_walk(&tree, walk_check_reverse, &state, right_root_left);
+  ok(state.in_order && state.elements == tree.elements_in_tree &&
+     state.total_count == KEYS, "%s: walk right_root_left", name);
+
+  tree_walk(&tree, walk_stop, &stopped, left_root_right);
+  ok(stopped == 10, "%s: walk stops on error", name);
+
+  diag("%-8s %u elements: insert %llu ms, search %llu ms, walk %llu ms",
+       name, tree.elements_in_tree, insert_time / 1000000,
+       search_time / 1000000, walk_time / 1000000);
+
+  reset_tree(&tree);
+  ok(tree.elements_in_tree == 0 &&
+     !tree_search(&tree, keys, NULL) &&
+     tree_insert(&tree, keys, 0, NULL) &&
+     tree_search(&tree, keys, NULL), "%s: reset_tree", name);
+  delete_tree(&tree);
+}
+
+
+/* Variable length keys with TREE_NO_DUPS */
+
+static void test_strings(myf flags, const char *name)
+{
+  TREE tree;
+  char buff[32];
+  uint i, inserted= 0, dups= 0, found= 0;
+
+  init_tree(&tree, 0, 0, 0, cmp_string, NULL, NULL, flags);
+  tree.flag= TREE_NO_DUPS;
+  for (i= 0; i < STRING_KEYS; i++)
+  {
+    uint length= (uint) my_snprintf(buff, sizeof(buff), "key-%u",
+                                    (i * 7919) % STRING_KEYS);
+    inserted+= tree_insert(&tree, buff, length + 1, NULL) != 0;
+  }
+  for (i= 0; i < STRING_KEYS; i += 2)
+  {
+    uint length= (uint) my_snprintf(buff, sizeof(buff), "key-%u", i);
+    dups+= tree_insert(&tree, buff, length + 1, NULL) == 0;
+  }
+  for (i= 0; i < STRING_KEYS; i++)
+  {
+    char *res;
+    my_snprintf(buff, sizeof(buff), "key-%u", i);
+    res= (char*) tree_search(&tree, buff, NULL);
+    found+= res && res != buff && !strcmp(res, buff);
+  }
+  ok(inserted == STRING_KEYS && dups == STRING_KEYS / 2 &&
+     found == STRING_KEYS && tree.elements_in_tree == STRING_KEYS,
+     "%s: variable length keys", name);
+  delete_tree(&tree);
+}
+
+
+/* memory_limit with a free function, as used by MyISAM bulk insert */
+
+static ulonglong freed_elements, freed_out_of_order;
+static ulonglong last_freed;
+static uint free_inits, free_ends;
+
+static void free_check(void *key, TREE_FREE mode,
+                       void *arg __attribute__((unused)))
+{
+  switch (mode) {
+  case free_init:
+    free_inits++;
+    last_freed= 0;
+    break;
+  case free_free:
+    if (*(ulonglong*) key < last_freed)
+      freed_out_of_order++;
+    last_freed= *(ulonglong*) key;
+    freed_elements++;
+    break;
+  case free_end:
+    free_ends++;
+    break;
+  }
+}
+
+static void test_memory_limit(myf flags, const char *name)
+{
+  TREE tree;
+  uint i, failed= 0;
+
+  freed_elements= freed_out_of_order= 0;
+  free_inits= free_ends= 0;
+  init_tree(&tree, 8192, 65536, sizeof(ulonglong), cmp_ulonglong,
+            free_check, NULL, flags);
+  for (i= 0; i < KEYS / 10; i++)
+  {
+    failed+= !tree_insert(&tree, keys + i, 0, NULL);
+    failed+= tree.allocated > 65536 + 8192;
+  }
+  delete_tree(&tree);
+  ok(!failed && free_inits > 1 && free_inits == free_ends &&
+     !freed_out_of_order && freed_elements <= KEYS / 10 &&
+     freed_elements > KEYS / 20, "%s: memory_limit", name);
+}
+
+
+int main(int argc __attribute__((unused)), char **argv)
+{
+  uint i;
+  ulonglong seed= 1;
+
+  MY_INIT(argv[0]);
+  plan(18);
+
+  keys= (ulonglong*) my_malloc(KEYS * sizeof(ulonglong), MYF(MY_FAE));
+  for (i= 0; i < KEYS; i++)
+  {
+    seed= seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    /* Even values, with about 10% duplicates */
+    keys[i]= ((seed >> 20) % (KEYS * 9ULL)) * 2;
+  }
+
+  test_numbers(0, "rb-tree");
+  test_numbers(MY_TREE_BTREE, "b-tree");
+  test_strings(0, "rb-tree");
+  test_strings(MY_TREE_BTREE, "b-tree");
+  test_memory_limit(0, "rb-tree");
+  test_memory_limit(MY_TREE_BTREE, "b-tree");
+
+  my_free(keys);
+  my_end(0);
+  return exit_status();
+}
@@ -187,10 +187,81 @@ void mdev9044()
   close_cached_file(&info);
 }
 
+/* byte at file position pos in async_io_cache() */
+static uchar async_byte(my_off_t pos)
+{
+  return (uchar) (pos % 251);
+}
+
+void async_io_cache()
+{
+  int res;
+  uint i, bad= 0;
+  uchar buf[CACHE_SIZE * 3];
+  my_off_t pos= 0, length;
+  ulong reads, writes;
+
+  diag("io_cache with read-ahead and write-behind");
+
+  res= init_io_cache_async(2);
+  ok(res == 0, "init_io_cache_async");
+
+  res= open_cached_file(&info, 0, 0, CACHE_SIZE, 0) ||
+       reinit_io_cache(&info, WRITE_CACHE, 0, 1, 0);
+  ok(res == 0 && !info.async, "no async io without MY_ASYNC_IO" INFO_TAIL);
+  close_cached_file(&info);
+
+  res= open_cached_file(&info, 0, 0, CACHE_SIZE, MYF(MY_ASYNC_IO)) ||
+       reinit_io_cache(&info, WRITE_CACHE, 0, 1, 0);
+  ok(res == 0 && info.async, "open_cached_file with async io" INFO_TAIL);
+  writes= my_io_cache_async_writes;
+  reads= my_io_cache_async_reads;
+
+  for (i= 0; i < 200; i++)
+  {
+    size_t part= (i * 7919) % sizeof(buf), j;
+    for (j= 0; j < part; j++)
+      buf[j]= async_byte(pos + j);
+    res|= my_b_write(&info, buf, part);
+    pos+= part;
+  }
+  length= pos;
+  ok(res == 0 && my_b_tell(&info) == length, "writes" INFO_TAIL);
+  ok(my_io_cache_async_writes > writes, "writes behind" INFO_TAIL);
+
+  res= reinit_io_cache(&info, READ_CACHE, 0, 1, 0);
+  ok(res == 0 && info.async, "reinit READ_CACHE with async io" INFO_TAIL);
+
+  for (pos= 0, i= 0; pos < length; i++)
+  {
+    size_t part= (size_t) MY_MIN((i * 104729) % sizeof(buf), length - pos), j;
+    if (my_b_read(&info, buf, part))
+      break;
+    for (j= 0; j < part; j++)
+      bad+= buf[j] != async_byte(pos + j);
+    pos+= part;
+  }
+  ok(pos == length && !bad && my_b_read(&info, buf, 1),
+     "read back and EOF" INFO_TAIL);
+  ok(my_io_cache_async_reads > reads, "reads ahead" INFO_TAIL);
+
+  my_b_seek(&info, length / 3);
+  res= my_b_read(&info, buf, CACHE_SIZE * 2);
+  for (i= 0; i < CACHE_SIZE * 2; i++)
+    bad+= buf[i] != async_byte(length / 3 + i);
+  ok(res == 0 && !bad, "read after seek" INFO_TAIL);
+
+  res= reinit_io_cache(&info, READ_CACHE, 0, 0, 0);
+  ok(res == 0 && !info.async, "reinit without async io" INFO_TAIL);
+
+  close_cached_file(&info);
+  end_io_cache_async();
+}
+
 int main(int argc __attribute__((unused)),char *argv[])
 {
   MY_INIT(argv[0]);
-  plan(29);
+  plan(39);
 
   /* temp files with and without encryption */
   encrypt_tmp_files= 1;
@@ -202,6 +273,8 @@ int main(int argc __attribute__((unused)),char *argv[])
   /* regression tests */
   mdev9044();
 
+  async_io_cache();
+
   my_end(0);
   return exit_status();
 }